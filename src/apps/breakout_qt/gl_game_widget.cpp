@@ -2,8 +2,8 @@
 #include <QKeyEvent>
 #include <QMouseEvent>
 #include <QPainter>
-#include <QDateTime>
 #include <QSurfaceFormat>
+#include <foundation/trace.h>
 #include <cmath>
 #include <algorithm>
 
@@ -26,7 +26,7 @@ GLGameWidget::GLGameWidget(QWidget *parent)
     timer_ = new QTimer(this);
     connect(timer_, &QTimer::timeout, this, &GLGameWidget::gameLoop);
     
-    lastFrameTime_ = QDateTime::currentMSecsSinceEpoch();
+    lastFrameTime_ = foundation::TscClock::now_ns();
     
     reset();
 }
@@ -131,6 +131,8 @@ void GLGameWidget::resizeGL(int w, int h) {
 }
 
 void GLGameWidget::paintGL() {
+    FTRACE_ZONE("paintGL");
+    frameArena_.reset();
     glClear(GL_COLOR_BUFFER_BIT);
     
     shaderProgram_->bind();
@@ -178,7 +180,7 @@ void GLGameWidget::renderQuad(float x, float y, float w, float h,
 void GLGameWidget::renderCircle(float x, float y, float radius, 
                                 float r, float g, float b, float a) {
     const int segments = 32;
-    std::vector<float> vertices;
+    std::pmr::vector<float> vertices(&frameArena_);
     vertices.reserve(segments * 3 * 6); // 3 vertices per triangle, 6 floats per vertex
     
     for (int i = 0; i < segments; ++i) {
@@ -352,6 +354,7 @@ void GLGameWidget::launchBall() {
 }
 
 void GLGameWidget::updateBall() {
+    FTRACE_ZONE("updateBall");
     if (!ball_.launched) {
         ball_.pos.x = paddle_.x;
         ball_.pos.y = paddle_.y - paddle_.height / 2 - ball_.radius - 2;
@@ -461,6 +464,7 @@ void GLGameWidget::checkBrickCollision() {
 }
 
 void GLGameWidget::checkCollisions() {
+    FTRACE_ZONE("checkCollisions");
     checkPaddleCollision();
     checkBrickCollision();
 }
@@ -485,6 +489,7 @@ void GLGameWidget::spawnParticles(float x, float y, float r, float g, float b) {
 }
 
 void GLGameWidget::updateParticles(float deltaTime) {
+    FTRACE_ZONE("updateParticles");
     for (auto& p : particles_) {
         if (p.life <= 0.0f) continue;
         
@@ -515,8 +520,9 @@ void GLGameWidget::nextLevel() {
 }
 
 void GLGameWidget::gameLoop() {
-    qint64 currentTime = QDateTime::currentMSecsSinceEpoch();
-    deltaTime_ = (currentTime - lastFrameTime_) / 1000.0f;
+    FTRACE_ZONE("gameLoop");
+    uint64_t currentTime = foundation::TscClock::now_ns();
+    deltaTime_ = (currentTime - lastFrameTime_) / 1e9f;
     lastFrameTime_ = currentTime;
     
     if (state_ == GameState::PLAYING) {
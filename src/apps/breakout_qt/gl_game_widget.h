@@ -8,6 +8,8 @@
 #include <QMatrix4x4>
 #include <vector>
 #include <memory>
+#include <foundation/arena.h>
+#include <foundation/clock.h>
 #include "game_types.h"
 
 class GLGameWidget : public QOpenGLWidget, protected QOpenGLFunctions_3_3_Core {
@@ -89,11 +91,12 @@ private:
     std::unique_ptr<QOpenGLShaderProgram> shaderProgram_;
     std::unique_ptr<QOpenGLBuffer> vbo_;
     std::unique_ptr<QOpenGLVertexArrayObject> vao_;
+    foundation::Arena frameArena_;  // Vertex scratch for one frame; reset by paintGL
     QMatrix4x4 projection_;
     
     // Timing
     QTimer *timer_;
-    qint64 lastFrameTime_;
+    uint64_t lastFrameTime_;  // TscClock nanoseconds
     float deltaTime_;
     int frameCount_;
     float fps_;
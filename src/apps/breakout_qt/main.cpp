@@ -3,6 +3,7 @@
 #include <QApplication>
 #include <QCommandLineParser>
 #include <QSurfaceFormat>
+#include <foundation/trace.h>
 #include <spdlog/spdlog.h>
 
 int main(int argc, char *argv[]) {
@@ -26,6 +27,11 @@ int main(int argc, char *argv[]) {
     
     parser.process(app);
     
+    // Frame timings: kill -USR2 <pid> dumps the recent gameLoop and paintGL
+    // zones as Chrome trace JSON to the working directory, as does a crash
+    foundation::set_trace_thread_name("gui");
+    foundation::install_trace_dumps();
+    
     // Determine rendering mode
     bool useOpenGL = true; // Default to OpenGL
     
@@ -1,44 +1,106 @@
+#include <network/async_queue.h>
+#include <network/buffer_pool.h>
+#include <network/frame_codec.h>
+#include <network/framed_reader.h>
+#include <network/write_request_pool.h>
 #include <uv.h>
 #include <spdlog/spdlog.h>
 #include <fmt/core.h>
 #include <iostream>
 #include <string>
+#include <string_view>
 #include <thread>
 #include <atomic>
+#include <cstring>
+#include <memory>
 
 uv_loop_t* loop;
 uv_tcp_t client;
 std::atomic<bool> running{true};
+network::FrameMode framing = network::FrameMode::LengthPrefixed;
+network::BufferPool buffer_pool;
+std::unique_ptr<network::FramedReader> reader;
+bool connected = false;
+
+// A line typed on the input thread, handed to the loop thread to send
+struct OutgoingLine : network::MpscNode {
+    std::string text;
+    bool quit = false;
+};
+std::unique_ptr<network::AsyncQueue<OutgoingLine>> outbox;
+
+void send_frame(std::string_view body) {
+    // The request owns the encoded frame until the write completes
+    auto* request = new network::WriteRequest;
+    request->payloads[0] = network::encode_frame(framing, body);
+    request->payload_count = 1;
+    uv_buf_t buf = uv_buf_init(const_cast<char*>(request->payloads[0].data()),
+                              request->payloads[0].size());
+    uv_write(&request->req, (uv_stream_t*)&client, &buf, 1,
+        [](uv_write_t* req, int status) {
+            if (status < 0) {
+                spdlog::error("Write error: {}", uv_strerror(status));
+            }
+            delete network::WriteRequest::from(req);
+        });
+}
+
+// Loop thread: close the socket so uv_run() returns
+void shutdown_client() {
+    running = false;
+    connected = false;
+    if (!uv_is_closing((uv_handle_t*)&client)) {
+        if (reader) {
+            reader->release();
+        }
+        uv_close((uv_handle_t*)&client, nullptr);
+    }
+}
+
+void on_outgoing(std::unique_ptr<OutgoingLine> line) {
+    if (line->quit) {
+        shutdown_client();
+    } else if (connected) {
+        send_frame(line->text);
+    } else {
+        spdlog::warn("Not connected yet, dropping message");
+    }
+}
 
 void alloc_buffer(uv_handle_t* handle, size_t suggested_size, uv_buf_t* buf) {
-    buf->base = new char[suggested_size];
-    buf->len = suggested_size;
+    *buf = reader->prepare();
 }
 
 void on_read(uv_stream_t* stream, ssize_t nread, const uv_buf_t* buf) {
-    if (nread < 0) {
-        if (nread != UV_EOF) {
-            spdlog::error("Read error: {}", uv_strerror(nread));
-        }
-        spdlog::info("Disconnected from server");
-        running = false;
-        uv_close((uv_handle_t*)stream, nullptr);
-        delete[] buf->base;
+    if (nread == 0) {
         return;
     }
-    
+
     if (nread > 0) {
-        std::string msg(buf->base, nread);
-        std::cout << msg << std::flush;
+        bool ok = reader->commit(nread, [](std::string_view frame) {
+            if (frame.empty()) {
+                send_frame({});  // Answer the server's heartbeat
+                return;
+            }
+            std::cout << frame << '\n';
+        });
+        std::cout << std::flush;
+        if (ok) {
+            return;
+        }
+        spdlog::error("Malformed frame from server");
+    } else if (nread != UV_EOF) {
+        spdlog::error("Read error: {}", uv_strerror(nread));
     }
-    
-    delete[] buf->base;
+
+    spdlog::info("Disconnected from server");
+    shutdown_client();
 }
 
 void on_connect(uv_connect_t* req, int status) {
     if (status < 0) {
         spdlog::error("Connection failed: {}", uv_strerror(status));
-        running = false;
+        shutdown_client();
         delete req;
         return;
     }
@@ -49,33 +111,28 @@ void on_connect(uv_connect_t* req, int status) {
     fmt::print("Type 'quit' to exit.\n");
     fmt::print("================================\n\n");
     
+    connected = true;
     uv_read_start(req->handle, alloc_buffer, on_read);
     delete req;
 }
 
+// Input thread: never touches libuv handles, only posts to the outbox
 void stdin_reader() {
     std::string line;
     while (running && std::getline(std::cin, line)) {
         if (line == "quit" || line == "exit") {
-            running = false;
-            uv_stop(loop);
             break;
         }
-        
         if (!line.empty()) {
-            line += "\n";
-            uv_buf_t buf = uv_buf_init(const_cast<char*>(line.c_str()), 
-                                      line.length());
-            uv_write_t* req = new uv_write_t;
-            uv_write(req, (uv_stream_t*)&client, &buf, 1, 
-                [](uv_write_t* req, int status) {
-                    if (status < 0) {
-                        spdlog::error("Write error: {}", uv_strerror(status));
-                    }
-                    delete req;
-                });
+            auto outgoing = std::make_unique<OutgoingLine>();
+            outgoing->text = std::move(line);
+            outbox->post(std::move(outgoing));
         }
     }
+    // Quit or end of input
+    auto quit = std::make_unique<OutgoingLine>();
+    quit->quit = true;
+    outbox->post(std::move(quit));
 }
 
 int main(int argc, char** argv) {
@@ -84,12 +141,28 @@ int main(int argc, char** argv) {
     const char* host = "127.0.0.1";
     int port = 8888;
     
-    if (argc >= 2) host = argv[1];
-    if (argc >= 3) port = std::atoi(argv[2]);
+    // Positional host/port; --text talks to a server started with --text
+    int positional = 0;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--text") == 0) {
+            framing = network::FrameMode::NewlineDelimited;
+        } else if (positional++ == 0) {
+            host = argv[i];
+        } else {
+            port = std::atoi(argv[i]);
+        }
+    }
+    
+    reader = std::make_unique<network::FramedReader>(
+        buffer_pool, network::FrameDecoder(framing), 64 * 1024);
     
     loop = uv_default_loop();
     
     uv_tcp_init(loop, &client);
+    outbox = std::make_unique<network::AsyncQueue<OutgoingLine>>(loop, on_outgoing);
+    // The input thread may post until it is joined, so the mailbox stays
+    // open past the socket but must not keep the loop alive on its own
+    uv_unref((uv_handle_t*)outbox->handle());
     
     struct sockaddr_in dest;
     uv_ip4_addr(host, port, &dest);
@@ -109,6 +182,10 @@ int main(int argc, char** argv) {
     if (input_thread.joinable()) {
         input_thread.join();
     }
+    outbox->close();
+    uv_run(loop, UV_RUN_DEFAULT);
+    outbox.reset();  // Drops anything posted after the socket closed
+    uv_loop_close(loop);
     
     spdlog::info("Chat client terminated");
     return 0;
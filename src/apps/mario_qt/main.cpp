@@ -1,6 +1,7 @@
 #include "mario_game_widget.h"
 #include <QApplication>
 #include <QSurfaceFormat>
+#include <foundation/trace.h>
 #include <spdlog/spdlog.h>
 
 int main(int argc, char *argv[]) {
@@ -10,6 +11,11 @@ int main(int argc, char *argv[]) {
     app.setApplicationName("Super Mario");
     app.setApplicationVersion("1.0");
     
+    // Frame timings: kill -USR2 <pid> dumps the recent gameLoop and paintGL
+    // zones as Chrome trace JSON to the working directory, as does a crash
+    foundation::set_trace_thread_name("gui");
+    foundation::install_trace_dumps();
+    
     // Configure OpenGL surface format
     QSurfaceFormat format;
     format.setVersion(3, 3);
@@ -1,8 +1,8 @@
 #include "mario_game_widget.h"
 #include <QKeyEvent>
 #include <QPainter>
-#include <QDateTime>
 #include <QSurfaceFormat>
+#include <foundation/trace.h>
 #include <cmath>
 #include <algorithm>
 
@@ -24,7 +24,7 @@ MarioGameWidget::MarioGameWidget(QWidget *parent)
     timer_ = new QTimer(this);
     connect(timer_, &QTimer::timeout, this, &MarioGameWidget::gameLoop);
     
-    lastFrameTime_ = QDateTime::currentMSecsSinceEpoch();
+    lastFrameTime_ = foundation::TscClock::now_ns();
     
     reset();
 }
@@ -156,6 +156,8 @@ void MarioGameWidget::resizeGL(int w, int h) {
 }
 
 void MarioGameWidget::paintGL() {
+    FTRACE_ZONE("paintGL");
+    frameArena_.reset();
     glClear(GL_COLOR_BUFFER_BIT);
     
     shaderProgram_->bind();
@@ -183,8 +185,9 @@ void MarioGameWidget::paintGL() {
 }
 
 void MarioGameWidget::gameLoop() {
-    qint64 currentTime = QDateTime::currentMSecsSinceEpoch();
-    deltaTime_ = (currentTime - lastFrameTime_) / 1000.0f;
+    FTRACE_ZONE("gameLoop");
+    uint64_t currentTime = foundation::TscClock::now_ns();
+    deltaTime_ = (currentTime - lastFrameTime_) / 1e9f;
     lastFrameTime_ = currentTime;
     
     if (state_ == GameState::PLAYING) {
@@ -201,6 +204,7 @@ void MarioGameWidget::gameLoop() {
 }
 
 void MarioGameWidget::updatePlayer(float deltaTime) {
+    FTRACE_ZONE("updatePlayer");
     // Horizontal movement
     if (leftPressed_ && !rightPressed_) {
         player_.velocity.x -= GameConst::MOVE_ACCELERATION;
@@ -266,6 +270,7 @@ void MarioGameWidget::updatePlayer(float deltaTime) {
 }
 
 void MarioGameWidget::updateEnemies(float deltaTime) {
+    FTRACE_ZONE("updateEnemies");
     for (auto& enemy : enemies_) {
         if (!enemy.alive) continue;
         
@@ -290,6 +295,7 @@ void MarioGameWidget::updateEnemies(float deltaTime) {
 }
 
 void MarioGameWidget::updateParticles(float deltaTime) {
+    FTRACE_ZONE("updateParticles");
     for (auto& p : particles_) {
         if (p.life <= 0.0f) continue;
         
@@ -306,6 +312,7 @@ void MarioGameWidget::updateParticles(float deltaTime) {
 }
 
 void MarioGameWidget::updateCamera() {
+    FTRACE_ZONE("updateCamera");
     // Camera follows player with dead zone
     float targetX = player_.position.x - GameConst::VIEWPORT_WIDTH / 2.0f + player_.size.x / 2.0f;
     
@@ -325,6 +332,7 @@ void MarioGameWidget::updateCamera() {
 }
 
 void MarioGameWidget::checkCollisions() {
+    FTRACE_ZONE("checkCollisions");
     // Player vs Enemies
     for (auto& enemy : enemies_) {
         if (!enemy.alive) continue;
@@ -408,7 +416,7 @@ void MarioGameWidget::renderQuad(vec2 pos, vec2 size, float r, float g, float b,
 
 void MarioGameWidget::renderCircle(vec2 pos, float radius, float r, float g, float b, float a) {
     const int segments = 20;
-    std::vector<float> vertices;
+    std::pmr::vector<float> vertices(&frameArena_);
     vertices.reserve(segments * 3 * 6);
     
     for (int i = 0; i < segments; ++i) {
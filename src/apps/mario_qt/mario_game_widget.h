@@ -7,6 +7,8 @@
 #include <QTimer>
 #include <QMatrix4x4>
 #include <memory>
+#include <foundation/arena.h>
+#include <foundation/clock.h>
 #include <vector>
 #include "game_types.h"
 #include "level_data.h"
@@ -78,12 +80,13 @@ private:
     std::unique_ptr<QOpenGLShaderProgram> shaderProgram_;
     std::unique_ptr<QOpenGLBuffer> vbo_;
     std::unique_ptr<QOpenGLVertexArrayObject> vao_;
+    foundation::Arena frameArena_;  // Vertex scratch for one frame; reset by paintGL
     QMatrix4x4 projection_;
     QMatrix4x4 view_;
     
     // Timing
     QTimer *timer_;
-    qint64 lastFrameTime_;
+    uint64_t lastFrameTime_;  // TscClock nanoseconds
     float deltaTime_;
     int frameCount_;
     float fps_;
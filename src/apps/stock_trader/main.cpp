@@ -1,5 +1,6 @@
 #include "market_data.h"
 #include "portfolio.h"
+#include <foundation/logger.h>
 #include <spdlog/spdlog.h>
 #include <fmt/core.h>
 #include <iostream>
@@ -30,16 +31,17 @@ void displayMarket(MarketData& market) {
     fmt::print("{}\n", std::string(34, '-'));
     
     for (const auto& sym : symbols) {
-        Stock stock = market.getQuote(sym);
-        std::string change_str = fmt::format("{:+.2f}%", stock.change_percent);
+        const Stock* stock = market.getQuote(sym);
+        std::string change_str = fmt::format("{:+.2f}%", stock->change_percent);
         fmt::print("{:<8} ${:>11.2f} {:>12}\n", 
-                  stock.symbol, stock.price, change_str);
+                  stock->symbol, stock->price, change_str);
     }
     fmt::print("===================================\n\n");
 }
 
 int main() {
     spdlog::info("Starting Stock Trading Simulator...");
+    foundation::start_async_logger();
     
     MarketData market;
     Portfolio portfolio(100000.0);  // $100,000 starting cash
@@ -87,18 +89,18 @@ int main() {
                 fmt::print("Enter number of shares: ");
                 std::cin >> shares;
                 
-                Stock stock = market.getQuote(symbol);
-                if (stock.price == 0.0) {
+                const Stock* stock = market.getQuote(symbol);
+                if (!stock) {
                     fmt::print("Unknown symbol: {}\n", symbol);
                 } else {
-                    double cost = shares * stock.price;
+                    double cost = shares * stock->price;
                     fmt::print("Buy {} shares of {} @ ${:.2f} = ${:.2f}\n", 
-                              shares, symbol, stock.price, cost);
+                              shares, symbol, stock->price, cost);
                     fmt::print("Confirm? (y/n): ");
                     char confirm;
                     std::cin >> confirm;
                     if (confirm == 'y' || confirm == 'Y') {
-                        if (portfolio.buy(symbol, shares, stock.price)) {
+                        if (portfolio.buy(symbol, shares, stock->price)) {
                             fmt::print("✅ Order executed!\n");
                         } else {
                             fmt::print("❌ Order failed!\n");
@@ -116,18 +118,18 @@ int main() {
                 fmt::print("Enter number of shares: ");
                 std::cin >> shares;
                 
-                Stock stock = market.getQuote(symbol);
-                if (stock.price == 0.0) {
+                const Stock* stock = market.getQuote(symbol);
+                if (!stock) {
                     fmt::print("Unknown symbol: {}\n", symbol);
                 } else {
-                    double proceeds = shares * stock.price;
+                    double proceeds = shares * stock->price;
                     fmt::print("Sell {} shares of {} @ ${:.2f} = ${:.2f}\n", 
-                              shares, symbol, stock.price, proceeds);
+                              shares, symbol, stock->price, proceeds);
                     fmt::print("Confirm? (y/n): ");
                     char confirm;
                     std::cin >> confirm;
                     if (confirm == 'y' || confirm == 'Y') {
-                        if (portfolio.sell(symbol, shares, stock.price)) {
+                        if (portfolio.sell(symbol, shares, stock->price)) {
                             fmt::print("✅ Order executed!\n");
                         } else {
                             fmt::print("❌ Order failed!\n");
@@ -149,6 +151,7 @@ int main() {
         }
     }
     
+    foundation::stop_async_logger();
     spdlog::info("Stock Trading Simulator terminated");
     return 0;
 }
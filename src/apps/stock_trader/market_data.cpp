@@ -6,24 +6,31 @@ MarketData::MarketData()
       price_change_(-0.02, 0.02) {
     
     // Initialize with popular US stocks
-    stocks_["AAPL"] = {"AAPL", 185.50, 0.0};
-    stocks_["MSFT"] = {"MSFT", 380.20, 0.0};
-    stocks_["GOOGL"] = {"GOOGL", 140.75, 0.0};
-    stocks_["AMZN"] = {"AMZN", 155.30, 0.0};
-    stocks_["TSLA"] = {"TSLA", 245.60, 0.0};
-    stocks_["NVDA"] = {"NVDA", 495.80, 0.0};
-    stocks_["META"] = {"META", 355.25, 0.0};
-    stocks_["NFLX"] = {"NFLX", 485.90, 0.0};
+    addStock("AAPL", 185.50);
+    addStock("MSFT", 380.20);
+    addStock("GOOGL", 140.75);
+    addStock("AMZN", 155.30);
+    addStock("TSLA", 245.60);
+    addStock("NVDA", 495.80);
+    addStock("META", 355.25);
+    addStock("NFLX", 485.90);
     
     spdlog::info("Market data initialized with {} stocks", stocks_.size());
 }
 
-Stock MarketData::getQuote(const std::string& symbol) {
-    auto it = stocks_.find(symbol);
-    if (it != stocks_.end()) {
-        return it->second;
-    }
-    return {"", 0.0, 0.0};
+void MarketData::addStock(std::string_view symbol, double price) {
+    const foundation::SymbolId id = foundation::symbols().intern(symbol);
+    stocks_[id] = {id, foundation::symbols().name(id), price, 0.0};
+}
+
+const Stock* MarketData::getQuote(foundation::SymbolId id) const {
+    auto it = stocks_.find(id);
+    return it != stocks_.end() ? &it->second : nullptr;
+}
+
+const Stock* MarketData::getQuote(std::string_view symbol) const {
+    const foundation::SymbolId id = foundation::symbols().find(symbol);
+    return id != foundation::NO_SYMBOL ? getQuote(id) : nullptr;
 }
 
 void MarketData::updatePrices() {
@@ -1,10 +1,12 @@
 #pragma once
-#include <string>
-#include <unordered_map>
+#include <foundation/flat_hash_map.h>
+#include <foundation/symbol_table.h>
+#include <string_view>
 #include <random>
 
 struct Stock {
-    std::string symbol;
+    foundation::SymbolId id;
+    std::string_view symbol;    // Interned, so valid for the whole run
     double price;
     double change_percent;
 };
@@ -13,11 +15,15 @@ class MarketData {
 public:
     MarketData();
     
-    Stock getQuote(const std::string& symbol);
+    // nullptr for symbols that are not listed
+    const Stock* getQuote(foundation::SymbolId id) const;
+    const Stock* getQuote(std::string_view symbol) const;
     void updatePrices(); // Simulate price changes
     
 private:
-    std::unordered_map<std::string, Stock> stocks_;
+    void addStock(std::string_view symbol, double price);
+
+    foundation::FlatHashMap<foundation::SymbolId, Stock> stocks_;
     std::mt19937 rng_;
     std::uniform_real_distribution<> price_change_;
 };
@@ -1,8 +1,10 @@
 #include "portfolio.h"
+#include <foundation/logger.h>
 #include <spdlog/spdlog.h>
 #include <fmt/core.h>
 #include <iostream>
 #include <iomanip>
+#include <iterator>
 
 Portfolio::Portfolio(double initial_cash) : cash_(initial_cash) {
     spdlog::info("Portfolio initialized with ${:.2f}", cash_);
@@ -12,35 +14,37 @@ bool Portfolio::buy(const std::string& symbol, int shares, double price) {
     double cost = shares * price;
     
     if (cost > cash_) {
-        spdlog::warn("Insufficient funds to buy {} shares of {}", shares, symbol);
+        FLOG_WARN("Insufficient funds to buy {} shares of {}", shares, symbol);
         return false;
     }
     
     cash_ -= cost;
     
-    auto& pos = positions_[symbol];
+    const foundation::SymbolId id = foundation::symbols().intern(symbol);
+    auto& pos = positions_[id];
     if (pos.shares > 0) {
         // Update average cost
         double total_cost = (pos.avg_cost * pos.shares) + cost;
         pos.shares += shares;
         pos.avg_cost = total_cost / pos.shares;
     } else {
-        pos.symbol = symbol;
+        pos.id = id;
+        pos.symbol = foundation::symbols().name(id);
         pos.shares = shares;
         pos.avg_cost = price;
     }
     
-    std::string tx = fmt::format("BUY {} x{} @ ${:.2f}", symbol, shares, price);
-    transaction_history_.push_back(tx);
-    spdlog::info("{}", tx);
+    std::pmr::string& tx = transaction_history_.emplace_back();
+    fmt::format_to(std::back_inserter(tx), "BUY {} x{} @ ${:.2f}", symbol, shares, price);
+    FLOG_INFO("BUY {} x{} @ ${:.2f}", symbol, shares, price);
     
     return true;
 }
 
 bool Portfolio::sell(const std::string& symbol, int shares, double price) {
-    auto it = positions_.find(symbol);
+    auto it = positions_.find(foundation::symbols().find(symbol));
     if (it == positions_.end() || it->second.shares < shares) {
-        spdlog::warn("Insufficient shares to sell {} of {}", shares, symbol);
+        FLOG_WARN("Insufficient shares to sell {} of {}", shares, symbol);
         return false;
     }
     
@@ -51,9 +55,9 @@ bool Portfolio::sell(const std::string& symbol, int shares, double price) {
         positions_.erase(it);
     }
     
-    std::string tx = fmt::format("SELL {} x{} @ ${:.2f}", symbol, shares, price);
-    transaction_history_.push_back(tx);
-    spdlog::info("{}", tx);
+    std::pmr::string& tx = transaction_history_.emplace_back();
+    fmt::format_to(std::back_inserter(tx), "SELL {} x{} @ ${:.2f}", symbol, shares, price);
+    FLOG_INFO("SELL {} x{} @ ${:.2f}", symbol, shares, price);
     
     return true;
 }
@@ -64,9 +68,8 @@ void Portfolio::displayPortfolio(MarketData& market) {
     std::cout << "Cash: $" << cash_ << "\n";
     
     double holdings_value = 0.0;
-    for (const auto& [symbol, pos] : positions_) {
-        Stock stock = market.getQuote(symbol);
-        holdings_value += pos.getCurrentValue(stock.price);
+    for (const auto& [id, pos] : positions_) {
+        holdings_value += pos.getCurrentValue(currentPrice(market, id));
     }
     
     double total = cash_ + holdings_value;
@@ -92,15 +95,15 @@ void Portfolio::displayPositions(MarketData& market) {
     std::cout << std::string(66, '-') << "\n";
     
     std::cout << std::fixed << std::setprecision(2);
-    for (const auto& [symbol, pos] : positions_) {
-        Stock stock = market.getQuote(symbol);
-        double value = pos.getCurrentValue(stock.price);
-        double pl = pos.getProfitLoss(stock.price);
+    for (const auto& [id, pos] : positions_) {
+        double price = currentPrice(market, id);
+        double value = pos.getCurrentValue(price);
+        double pl = pos.getProfitLoss(price);
         
-        std::cout << std::left << std::setw(8) << symbol
+        std::cout << std::left << std::setw(8) << pos.symbol
                   << std::right << std::setw(10) << pos.shares
                   << std::setw(12) << pos.avg_cost
-                  << std::setw(12) << stock.price
+                  << std::setw(12) << price
                   << std::setw(12) << value
                   << std::setw(12) << pl << "\n";
     }
@@ -109,9 +112,13 @@ void Portfolio::displayPositions(MarketData& market) {
 
 double Portfolio::getTotalValue(MarketData& market) const {
     double total = cash_;
-    for (const auto& [symbol, pos] : positions_) {
-        Stock stock = market.getQuote(symbol);
-        total += pos.getCurrentValue(stock.price);
+    for (const auto& [id, pos] : positions_) {
+        total += pos.getCurrentValue(currentPrice(market, id));
     }
     return total;
 }
+
+double Portfolio::currentPrice(const MarketData& market, foundation::SymbolId id) {
+    const Stock* stock = market.getQuote(id);
+    return stock ? stock->price : 0.0;
+}
@@ -1,10 +1,15 @@
 #pragma once
 #include "market_data.h"
-#include <unordered_map>
+#include <foundation/arena.h>
+#include <foundation/flat_hash_map.h>
+#include <foundation/symbol_table.h>
+#include <string>
+#include <string_view>
 #include <vector>
 
 struct Position {
-    std::string symbol;
+    foundation::SymbolId id;
+    std::string_view symbol;
     int shares;
     double avg_cost;
     
@@ -31,7 +36,11 @@ public:
     double getTotalValue(MarketData& market) const;
     
 private:
+    static double currentPrice(const MarketData& market, foundation::SymbolId id);
+
+
     double cash_;
-    std::unordered_map<std::string, Position> positions_;
-    std::vector<std::string> transaction_history_;
+    foundation::FlatHashMap<foundation::SymbolId, Position> positions_;
+    foundation::Arena history_arena_;  // Append-only, so nothing is ever freed early
+    std::pmr::vector<std::pmr::string> transaction_history_{&history_arena_};
 };
@@ -0,0 +1,104 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace foundation {
+
+    struct ArenaOptions {
+        size_t block_bytes = 64 * 1024;             // Size of each upstream block
+        size_t max_retained_bytes = 4 * 1024 * 1024;    // Blocks kept across reset()
+    };
+
+    struct ArenaStats {
+        uint64_t allocations = 0;
+        uint64_t resets = 0;
+        uint64_t upstream_allocations = 0;
+        size_t bytes_used = 0;          // Since the last reset
+        size_t bytes_reserved = 0;      // Held in blocks
+    };
+
+    /**
+     * @brief Bump allocator for memory that dies all at once: a frame, a
+     *        request, or an append-only container.
+     *
+     * allocate() advances a pointer inside the current block; deallocate()
+     * does nothing. reset() rewinds to the first block and keeps up to
+     * `max_retained_bytes` of blocks, so a workload that resets once per
+     * frame stops reaching the upstream allocator after the first frame.
+     * Unlike std::pmr::monotonic_buffer_resource, whose release() hands
+     * everything back, the blocks are reused.
+     *
+     * Derives from std::pmr::memory_resource, so std::pmr containers can
+     * allocate from it. Not thread-safe.
+     */
+    class Arena : public std::pmr::memory_resource {
+    public:
+        explicit Arena(ArenaOptions options = {},
+                       std::pmr::memory_resource* upstream = std::pmr::new_delete_resource());
+        ~Arena() override;
+
+        Arena(const Arena&) = delete;
+        Arena& operator=(const Arena&) = delete;
+
+        /**
+         * @brief `bytes` of storage aligned to `alignment` (a power of two),
+         *        valid until the next reset().
+         */
+        void* allocate(size_t bytes, size_t alignment = alignof(std::max_align_t)) {
+            const uintptr_t cursor = reinterpret_cast<uintptr_t>(cursor_);
+            const uintptr_t aligned = (cursor + alignment - 1) & ~(alignment - 1);
+            if (aligned + bytes <= reinterpret_cast<uintptr_t>(end_) && cursor_) {
+                cursor_ = reinterpret_cast<char*>(aligned + bytes);
+                stats_.allocations++;
+                return reinterpret_cast<void*>(aligned);
+            }
+            return allocate_slow(bytes, alignment);
+        }
+
+        /**
+         * @brief Construct a T in the arena. Its destructor is never run,
+         *        so T must be trivially destructible.
+         */
+        template <typename T, typename... Args>
+        T* create(Args&&... args) {
+            static_assert(std::is_trivially_destructible_v<T>, "Arena never runs destructors");
+            return new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+        }
+
+        /**
+         * @brief Invalidate every allocation and start again from the first
+         *        block.
+         */
+        void reset();
+
+        ArenaStats stats() const;
+
+    protected:
+        void* do_allocate(size_t bytes, size_t alignment) override { return allocate(bytes, alignment); }
+        void do_deallocate(void*, size_t, size_t) override {}
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+    private:
+        struct Block {
+            char* data;
+            size_t size;
+        };
+
+        void* allocate_slow(size_t bytes, size_t alignment);
+
+        ArenaOptions options_;
+        std::pmr::memory_resource* upstream_;
+        std::vector<Block> blocks_;
+        size_t current_ = 0;            // Index of the block cursor_ points into
+        char* cursor_ = nullptr;
+        char* end_ = nullptr;
+        size_t used_before_current_ = 0;   // Bytes consumed in earlier blocks since reset
+        ArenaStats stats_;
+    };
+
+}
@@ -0,0 +1,88 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#define FOUNDATION_HAS_RDTSC 1
+#else
+#define FOUNDATION_HAS_RDTSC 0
+#endif
+
+namespace foundation {
+
+    struct TscCalibration {
+        bool tsc = false;           // Invariant TSC in use; otherwise ticks are steady_clock nanoseconds
+        uint64_t ns_per_tick_q32 = uint64_t(1) << 32;   // Nanoseconds per tick, 32.32 fixed point
+        double ticks_per_ns = 1.0;
+    };
+
+    /**
+     * @brief Measure the TSC against steady_clock for `window`. Called once
+     *        by TscClock on first use; exposed for tests and tools.
+     */
+    TscCalibration calibrate_tsc(std::chrono::microseconds window = std::chrono::milliseconds(2));
+
+    /**
+     * @brief Steady clock read from the CPU's time-stamp counter.
+     *
+     * On x86-64 with an invariant TSC, ticks() is one rdtsc (~10 ns with no
+     * system call), and ticks are converted to nanoseconds with a
+     * multiply and shift, calibrated against steady_clock the first time the
+     * clock is used. Elsewhere ticks() falls back to steady_clock and a tick
+     * is a nanosecond. Meets the std::chrono Clock requirements.
+     */
+    class TscClock {
+    public:
+        using rep = int64_t;
+        using period = std::nano;
+        using duration = std::chrono::nanoseconds;
+        using time_point = std::chrono::time_point<TscClock>;
+        static constexpr bool is_steady = true;
+
+        static uint64_t ticks() {
+#if FOUNDATION_HAS_RDTSC
+            if (calibration().tsc) {
+                return __rdtsc();
+            }
+#endif
+            return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                             std::chrono::steady_clock::now().time_since_epoch())
+                                             .count());
+        }
+
+        static uint64_t to_ns(uint64_t ticks) {
+            // 64x32.32 multiply in two halves, so no 128-bit type is needed
+            const uint64_t scale = calibration().ns_per_tick_q32;
+            return (ticks >> 32) * scale + (((ticks & 0xffffffffu) * scale) >> 32);
+        }
+
+        static uint64_t now_ns() { return to_ns(ticks()); }
+
+        static time_point now() { return time_point(duration(static_cast<rep>(now_ns()))); }
+
+        static const TscCalibration& calibration() {
+            static const TscCalibration calibration = calibrate_tsc();
+            return calibration;
+        }
+    };
+
+    /**
+     * @brief Nanoseconds since construction or the last restart().
+     */
+    class Stopwatch {
+    public:
+        Stopwatch() : start_(TscClock::ticks()) {}
+
+        void restart() { start_ = TscClock::ticks(); }
+        uint64_t elapsed_ns() const { return TscClock::to_ns(TscClock::ticks() - start_); }
+
+    private:
+        uint64_t start_;
+    };
+
+}
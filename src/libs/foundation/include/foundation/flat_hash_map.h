@@ -0,0 +1,410 @@
+#pragma once
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <new>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define FOUNDATION_FLAT_MAP_SSE2 1
+#endif
+
+namespace foundation {
+
+    /**
+     * @brief Default FlatHashMap hasher: std::hash with its bits mixed, since
+     *        libstdc++ hashes integers to themselves and the map splits the
+     *        hash into a 7-bit tag and a group index.
+     */
+    template <typename K>
+    struct FlatHash {
+        size_t operator()(const K& key) const { return mix(std::hash<K>{}(key)); }
+
+        static size_t mix(uint64_t h) {
+            h *= 0x9E3779B97F4A7C15ull;
+            return static_cast<size_t>(h ^ (h >> 32));
+        }
+    };
+
+    // Strings hash as string_view, so lookups need not build a std::string
+    template <>
+    struct FlatHash<std::string> {
+        using is_transparent = void;
+        size_t operator()(std::string_view key) const {
+            return FlatHash<uint64_t>::mix(std::hash<std::string_view>{}(key));
+        }
+    };
+
+    template <>
+    struct FlatHash<std::string_view> : FlatHash<std::string> {};
+
+    namespace detail {
+        // Control byte per slot: EMPTY, DELETED, or 0-127 (the hash's low 7
+        // bits) when full. Both markers have the top bit set.
+        constexpr int8_t CTRL_EMPTY = -128;
+        constexpr int8_t CTRL_DELETED = -2;
+
+        // Sixteen control bytes examined at once; masks have bit i set for slot i
+        struct ProbeGroup {
+            static constexpr size_t WIDTH = 16;
+
+#ifdef FOUNDATION_FLAT_MAP_SSE2
+            explicit ProbeGroup(const int8_t* ctrl) : ctrl(_mm_load_si128(reinterpret_cast<const __m128i*>(ctrl))) {}
+
+            uint32_t match(int8_t tag) const {
+                return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(tag), ctrl)));
+            }
+            uint32_t match_empty() const { return match(CTRL_EMPTY); }
+            uint32_t match_free() const { return static_cast<uint32_t>(_mm_movemask_epi8(ctrl)); }
+
+            __m128i ctrl;
+#else
+            // Portable fallback; compilers vectorise these loops on NEON
+            explicit ProbeGroup(const int8_t* bytes) { std::memcpy(ctrl, bytes, WIDTH); }
+
+            uint32_t match(int8_t tag) const {
+                uint32_t mask = 0;
+                for (size_t i = 0; i < WIDTH; ++i) {
+                    mask |= uint32_t(ctrl[i] == tag) << i;
+                }
+                return mask;
+            }
+            uint32_t match_empty() const { return match(CTRL_EMPTY); }
+            uint32_t match_free() const {
+                uint32_t mask = 0;
+                for (size_t i = 0; i < WIDTH; ++i) {
+                    mask |= uint32_t(ctrl[i] < 0) << i;
+                }
+                return mask;
+            }
+
+            int8_t ctrl[WIDTH];
+#endif
+        };
+    }
+
+    /**
+     * @brief Open-addressing hash map in the Swiss-table style.
+     *
+     * Entries live inline in one array next to a byte of control metadata
+     * per slot. A lookup takes 7 bits of the hash as a tag and compares it
+     * against a whole group of 16 control bytes with one SSE2 instruction,
+     * so it usually touches one control line and one entry, with no node
+     * pointers to chase. The table doubles at 7/8 full; erase leaves a
+     * tombstone only where a probe could have passed through.
+     *
+     * Unlike std::unordered_map, inserting may move entries, which
+     * invalidates references and iterators; erase invalidates only the
+     * erased entry. With a transparent hasher (the default for strings),
+     * find() and friends accept any key type the hasher and `Eq` accept.
+     */
+    template <typename K, typename V, typename Hash = FlatHash<K>, typename Eq = std::equal_to<>>
+    class FlatHashMap {
+    public:
+        using key_type = K;
+        using mapped_type = V;
+        using value_type = std::pair<const K, V>;
+        using size_type = size_t;
+
+        template <bool Const>
+        class Iterator {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = FlatHashMap::value_type;
+            using difference_type = std::ptrdiff_t;
+            using reference = std::conditional_t<Const, const value_type&, value_type&>;
+            using pointer = std::conditional_t<Const, const value_type*, value_type*>;
+
+            Iterator() = default;
+            operator Iterator<true>() const { return Iterator<true>(map_, index_); }
+
+            reference operator*() const { return map_->slots_[index_]; }
+            pointer operator->() const { return &map_->slots_[index_]; }
+
+            Iterator& operator++() {
+                index_ = map_->next_full(index_ + 1);
+                return *this;
+            }
+            Iterator operator++(int) {
+                Iterator old = *this;
+                ++*this;
+                return old;
+            }
+
+            friend bool operator==(const Iterator& a, const Iterator& b) { return a.index_ == b.index_; }
+
+        private:
+            friend class FlatHashMap;
+            friend class Iterator<!Const>;
+            using Map = std::conditional_t<Const, const FlatHashMap, FlatHashMap>;
+
+            Iterator(Map* map, size_t index) : map_(map), index_(index) {}
+
+            Map* map_ = nullptr;
+            size_t index_ = 0;
+        };
+
+        using iterator = Iterator<false>;
+        using const_iterator = Iterator<true>;
+
+        FlatHashMap() = default;
+
+        explicit FlatHashMap(size_t expected) { reserve(expected); }
+
+        FlatHashMap(const FlatHashMap& other) {
+            reserve(other.size_);
+            for (const value_type& entry : other) {
+                emplace_new(hash_(entry.first), entry.first, entry.second);
+            }
+        }
+
+        FlatHashMap(FlatHashMap&& other) noexcept { swap(other); }
+
+        FlatHashMap& operator=(FlatHashMap other) noexcept {
+            swap(other);
+            return *this;
+        }
+
+        ~FlatHashMap() {
+            destroy_all();
+            release(ctrl_, capacity_);
+        }
+
+        void swap(FlatHashMap& other) noexcept {
+            std::swap(ctrl_, other.ctrl_);
+            std::swap(slots_, other.slots_);
+            std::swap(capacity_, other.capacity_);
+            std::swap(size_, other.size_);
+            std::swap(tombstones_, other.tombstones_);
+        }
+
+        iterator begin() { return {this, next_full(0)}; }
+        iterator end() { return {this, capacity_}; }
+        const_iterator begin() const { return {this, next_full(0)}; }
+        const_iterator end() const { return {this, capacity_}; }
+
+        size_t size() const { return size_; }
+        bool empty() const { return size_ == 0; }
+        size_t capacity() const { return capacity_; }
+
+        template <typename Q>
+        iterator find(const Q& key) {
+            return {this, find_index(key)};
+        }
+
+        template <typename Q>
+        const_iterator find(const Q& key) const {
+            return {this, find_index(key)};
+        }
+
+        template <typename Q>
+        bool contains(const Q& key) const {
+            return find_index(key) != capacity_;
+        }
+
+        /**
+         * @brief Entry for `key`, inserting `V(args...)` if there is none.
+         * @return The entry and whether it was inserted.
+         */
+        template <typename Q, typename... Args>
+        std::pair<iterator, bool> try_emplace(Q&& key, Args&&... args) {
+            const size_t hash = hash_(key);
+            if (const size_t index = find_index(key, hash); index != capacity_) {
+                return {iterator(this, index), false};
+            }
+            return {iterator(this, emplace_new(hash, std::forward<Q>(key), std::forward<Args>(args)...)), true};
+        }
+
+        template <typename Q>
+        V& operator[](Q&& key) {
+            return try_emplace(std::forward<Q>(key)).first->second;
+        }
+
+        template <typename Q>
+        size_t erase(const Q& key) {
+            const size_t index = find_index(key);
+            if (index == capacity_) {
+                return 0;
+            }
+            erase_index(index);
+            return 1;
+        }
+
+        void erase(iterator it) { erase_index(it.index_); }
+        void erase(const_iterator it) { erase_index(it.index_); }
+
+        void clear() {
+            destroy_all();
+            if (capacity_) {
+                std::memset(ctrl_, detail::CTRL_EMPTY, capacity_);
+            }
+            size_ = 0;
+            tombstones_ = 0;
+        }
+
+        /**
+         * @brief Make room for `count` entries without rehashing.
+         */
+        void reserve(size_t count) {
+            size_t capacity = detail::ProbeGroup::WIDTH;
+            while (capacity * 7 / 8 < count) {
+                capacity *= 2;
+            }
+            if (capacity > capacity_) {
+                rehash(capacity);
+            }
+        }
+
+    private:
+        static constexpr size_t WIDTH = detail::ProbeGroup::WIDTH;
+        static constexpr size_t SLOT_ALIGN = alignof(value_type) > WIDTH ? alignof(value_type) : WIDTH;
+
+        static int8_t tag(size_t hash) { return static_cast<int8_t>(hash & 0x7F); }
+
+        static size_t slots_offset(size_t capacity) {
+            return (capacity + alignof(value_type) - 1) / alignof(value_type) * alignof(value_type);
+        }
+
+        // Triangular probing over whole groups visits every group once
+        // when their count is a power of two
+        template <typename Fn>
+        size_t probe(size_t hash, Fn&& visit) const {
+            const size_t groups_mask = capacity_ / WIDTH - 1;
+            size_t group = (hash >> 7) & groups_mask;
+            for (size_t step = 1;; ++step) {
+                if (const size_t index = visit(group * WIDTH); index != SIZE_MAX) {
+                    return index;
+                }
+                group = (group + step) & groups_mask;
+            }
+        }
+
+        template <typename Q>
+        size_t find_index(const Q& key) const {
+            return find_index(key, hash_(key));
+        }
+
+        template <typename Q>
+        size_t find_index(const Q& key, size_t hash) const {
+            if (size_ == 0) {
+                return capacity_;
+            }
+            const int8_t h2 = tag(hash);
+            return probe(hash, [&](size_t base) {
+                const detail::ProbeGroup group(ctrl_ + base);
+                for (uint32_t mask = group.match(h2); mask; mask &= mask - 1) {
+                    const size_t index = base + std::countr_zero(mask);
+                    if (eq_(slots_[index].first, key)) {
+                        return index;
+                    }
+                }
+                return group.match_empty() ? capacity_ : SIZE_MAX;
+            });
+        }
+
+        size_t find_free(size_t hash) const {
+            return probe(hash, [&](size_t base) {
+                const uint32_t mask = detail::ProbeGroup(ctrl_ + base).match_free();
+                return mask ? base + std::countr_zero(mask) : SIZE_MAX;
+            });
+        }
+
+        template <typename Q, typename... Args>
+        size_t emplace_new(size_t hash, Q&& key, Args&&... args) {
+            if ((size_ + tombstones_ + 1) * 8 > capacity_ * 7) {
+                // Grow unless tombstones are most of the load; then clean up in place
+                rehash(capacity_ == 0 ? WIDTH : size_ * 16 >= capacity_ * 7 ? capacity_ * 2 : capacity_);
+            }
+            const size_t index = find_free(hash);
+            tombstones_ -= ctrl_[index] == detail::CTRL_DELETED;
+            ctrl_[index] = tag(hash);
+            new (&slots_[index]) value_type(std::piecewise_construct, std::forward_as_tuple(std::forward<Q>(key)),
+                                            std::forward_as_tuple(std::forward<Args>(args)...));
+            size_++;
+            return index;
+        }
+
+        void erase_index(size_t index) {
+            slots_[index].~value_type();
+            size_--;
+            // A group with an empty slot ends every probe that reaches it, so
+            // no probe can pass through this slot and a tombstone is not needed
+            const size_t base = index / WIDTH * WIDTH;
+            if (detail::ProbeGroup(ctrl_ + base).match_empty()) {
+                ctrl_[index] = detail::CTRL_EMPTY;
+            } else {
+                ctrl_[index] = detail::CTRL_DELETED;
+                tombstones_++;
+            }
+        }
+
+        size_t next_full(size_t index) const {
+            while (index < capacity_ && ctrl_[index] < 0) {
+                ++index;
+            }
+            return index;
+        }
+
+        void rehash(size_t capacity) {
+            int8_t* old_ctrl = ctrl_;
+            value_type* old_slots = slots_;
+            const size_t old_capacity = capacity_;
+
+            auto* memory = static_cast<std::byte*>(
+                ::operator new(slots_offset(capacity) + capacity * sizeof(value_type), std::align_val_t(SLOT_ALIGN)));
+            ctrl_ = reinterpret_cast<int8_t*>(memory);
+            slots_ = reinterpret_cast<value_type*>(memory + slots_offset(capacity));
+            capacity_ = capacity;
+            tombstones_ = 0;
+            std::memset(ctrl_, detail::CTRL_EMPTY, capacity);
+
+            for (size_t i = 0; i < old_capacity; ++i) {
+                if (old_ctrl[i] >= 0) {
+                    value_type& entry = old_slots[i];
+                    const size_t hash = hash_(entry.first);
+                    const size_t index = find_free(hash);
+                    ctrl_[index] = tag(hash);
+                    // Keys are const, so they are copied; values move
+                    new (&slots_[index]) value_type(entry.first, std::move(entry.second));
+                    entry.~value_type();
+                }
+            }
+            release(old_ctrl, old_capacity);
+        }
+
+        void destroy_all() {
+            if constexpr (!std::is_trivially_destructible_v<value_type>) {
+                for (size_t i = 0; i < capacity_; ++i) {
+                    if (ctrl_[i] >= 0) {
+                        slots_[i].~value_type();
+                    }
+                }
+            }
+        }
+
+        static void release(int8_t* ctrl, size_t capacity) {
+            if (ctrl) {
+                ::operator delete(ctrl, slots_offset(capacity) + capacity * sizeof(value_type),
+                                  std::align_val_t(SLOT_ALIGN));
+            }
+        }
+
+        int8_t* ctrl_ = nullptr;
+        value_type* slots_ = nullptr;
+        size_t capacity_ = 0;       // A power of two, at least one group, or 0
+        size_t size_ = 0;
+        size_t tombstones_ = 0;
+        [[no_unique_address]] Hash hash_;
+        [[no_unique_address]] Eq eq_;
+    };
+
+}
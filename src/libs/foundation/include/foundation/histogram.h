@@ -0,0 +1,148 @@
+#pragma once
+#include "foundation/per_thread.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+
+namespace foundation {
+
+    struct LatencySummary {
+        uint64_t count = 0;
+        uint64_t min = 0;
+        uint64_t max = 0;
+        double mean = 0;
+        uint64_t p50 = 0;
+        uint64_t p90 = 0;
+        uint64_t p99 = 0;
+        uint64_t p999 = 0;
+    };
+
+    /**
+     * @brief Log-linear (HDR-style) histogram of non-negative values: 64
+     *        sub-buckets per power of two, so percentiles are exact to
+     *        within about 1.6% over the whole 64-bit range.
+     *
+     * Not thread-safe; LatencyRecorder records from many threads and
+     * produces Histogram snapshots. Histograms merge by adding counts.
+     */
+    class Histogram {
+    public:
+        static constexpr size_t SUB_BITS = 6;
+        static constexpr size_t SUB_BUCKETS = size_t(1) << SUB_BITS;
+        static constexpr size_t BUCKETS = (64 - SUB_BITS + 1) * SUB_BUCKETS;
+
+        void record(uint64_t value) { record(value, 1); }
+
+        void record(uint64_t value, uint64_t count) {
+            counts_[bucket(value)] += count;
+            total_ += count;
+            sum_ += value * count;
+            min_ = std::min(min_, value);
+            max_ = std::max(max_, value);
+        }
+
+        void merge(const Histogram& other);
+        void reset();
+
+        uint64_t count() const { return total_; }
+        uint64_t sum() const { return sum_; }
+        uint64_t min() const { return total_ ? min_ : 0; }
+        uint64_t max() const { return max_; }
+        double mean() const { return total_ ? static_cast<double>(sum_) / static_cast<double>(total_) : 0; }
+
+        /**
+         * @brief Upper bound of the bucket holding the `p`-th percentile
+         *        (0 < p <= 100), capped at max(); 0 when empty.
+         */
+        uint64_t percentile(double p) const;
+
+        /**
+         * @brief Number of values in buckets whose upper bound is at most
+         *        `value`; exact when `value` is a bucket boundary.
+         */
+        uint64_t count_at_or_below(uint64_t value) const;
+
+        LatencySummary summary() const;
+
+        static size_t bucket(uint64_t value) {
+            if (value < SUB_BUCKETS) {
+                return static_cast<size_t>(value);
+            }
+            const size_t shift = static_cast<size_t>(std::bit_width(value)) - 1 - SUB_BITS;
+            return (shift + 1) * SUB_BUCKETS + ((value >> shift) & (SUB_BUCKETS - 1));
+        }
+
+        static uint64_t bucket_upper_bound(size_t index);
+
+    private:
+        friend class LatencyRecorder;
+
+        std::array<uint64_t, BUCKETS> counts_{};
+        uint64_t total_ = 0;
+        uint64_t sum_ = 0;
+        uint64_t min_ = UINT64_MAX;
+        uint64_t max_ = 0;
+    };
+
+    /**
+     * @brief "p50 1.2us p90 ... max ..." with nanosecond values scaled to
+     *        readable units.
+     */
+    std::string format_latency(const LatencySummary& summary);
+
+    namespace detail {
+        struct LatencyShard {
+            std::array<std::atomic<uint64_t>, Histogram::BUCKETS> counts{};
+            std::atomic<uint64_t> sum{0};
+            std::atomic<uint64_t> min{UINT64_MAX};
+            std::atomic<uint64_t> max{0};
+
+            // Single writer: plain increments, published with relaxed stores
+            static void bump(std::atomic<uint64_t>& counter, uint64_t by) {
+                counter.store(counter.load(std::memory_order_relaxed) + by, std::memory_order_relaxed);
+            }
+
+            void record(uint64_t value) {
+                bump(counts[Histogram::bucket(value)], 1);
+                bump(sum, value);
+                if (value < min.load(std::memory_order_relaxed)) {
+                    min.store(value, std::memory_order_relaxed);
+                }
+                if (value > max.load(std::memory_order_relaxed)) {
+                    max.store(value, std::memory_order_relaxed);
+                }
+            }
+        };
+    }
+
+    /**
+     * @brief Latency histogram that any number of threads record into
+     *        without locks or shared cache lines.
+     *
+     * Each thread records into its own shard, created on its first
+     * record(): relaxed loads and stores of counters only it writes, a
+     * few nanoseconds per value. snapshot() sums every shard, including
+     * those of threads that have exited, into a Histogram. Values are
+     * meant to be nanoseconds (see TscClock and Stopwatch).
+     */
+    class LatencyRecorder {
+    public:
+        explicit LatencyRecorder(std::string name = {}) : name_(std::move(name)) {}
+
+        void record(uint64_t value) { shards_.local().record(value); }
+
+        Histogram snapshot() const;
+
+        const std::string& name() const { return name_; }
+
+    private:
+        std::string name_;
+        PerThread<detail::LatencyShard> shards_;
+    };
+
+}
@@ -0,0 +1,98 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+
+namespace foundation {
+
+    enum class PageBacking {
+        HugeTlb,            // Reserved 2 MiB pages (MAP_HUGETLB)
+        TransparentHuge,    // Regular mapping with MADV_HUGEPAGE; the kernel backs what it can with 2 MiB pages
+        Regular,            // 4 KiB pages
+    };
+
+    const char* to_string(PageBacking backing);
+
+    struct HugePageOptions {
+        size_t bytes = 256 * 1024 * 1024;   // Rounded up to whole 2 MiB pages
+        bool prefault = true;               // Touch every page now rather than on first use
+        bool lock = false;                  // mlock the region; needs RLIMIT_MEMLOCK or CAP_IPC_LOCK
+        bool allow_fallback = true;         // Use transparent or regular pages if no hugetlb pages are free
+    };
+
+    struct HugePageStats {
+        PageBacking backing = PageBacking::Regular;
+        size_t bytes_reserved = 0;
+        size_t bytes_used = 0;
+        size_t fallback_bytes = 0;  // Requests that did not fit and went to the heap
+        bool locked = false;
+    };
+
+    /**
+     * @brief One up-front mapping, preferably of 2 MiB pages, carved into
+     *        allocations that live as long as the process.
+     *
+     * The constructor maps the whole region, tries MAP_HUGETLB, then
+     * MADV_HUGEPAGE, then plain pages, pre-faults it and optionally locks
+     * it, so the hot path sees neither first-touch page faults nor 4 KiB
+     * TLB entries. allocate() is a lock-free bump of a shared cursor;
+     * deallocate() of region memory does nothing, which suits pool chunks
+     * and rings that are never handed back. Requests that no longer fit
+     * go to the global heap. Thread-safe.
+     */
+    class HugePageRegion : public std::pmr::memory_resource {
+    public:
+        static constexpr size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+        explicit HugePageRegion(HugePageOptions options = {});
+        ~HugePageRegion() override;
+
+        HugePageRegion(const HugePageRegion&) = delete;
+        HugePageRegion& operator=(const HugePageRegion&) = delete;
+
+        /**
+         * @brief False if nothing could be mapped (every request then goes
+         *        to the heap), or if fallback was disallowed and no hugetlb
+         *        pages were free.
+         */
+        bool valid() const { return base_ != nullptr; }
+
+        bool contains(const void* p) const {
+            const auto* c = static_cast<const char*>(p);
+            return c >= base_ && c < base_ + bytes_;
+        }
+
+        HugePageStats stats() const;
+
+    private:
+        void* do_allocate(size_t bytes, size_t alignment) override;
+        void do_deallocate(void* p, size_t bytes, size_t alignment) override;
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+        char* base_ = nullptr;
+        size_t bytes_ = 0;
+        PageBacking backing_ = PageBacking::Regular;
+        bool locked_ = false;
+        alignas(64) std::atomic<size_t> used_{0};
+        std::atomic<size_t> fallback_bytes_{0};
+    };
+
+    /**
+     * @brief Create the process region that huge_page_resource() returns.
+     *        Call once at startup, before the pools it should feed are
+     *        first used; later calls are ignored.
+     * @return The region's stats (Regular backing with no bytes if it
+     *         could not be mapped).
+     */
+    HugePageStats enable_huge_pages(HugePageOptions options = {});
+
+    /**
+     * @brief The process region once enable_huge_pages() ran, otherwise
+     *        std::pmr::new_delete_resource(). FixedPool chunks, and so
+     *        pool_resource(), ObjectPool and PoolAllocated, draw from it,
+     *        as do trace rings.
+     */
+    std::pmr::memory_resource* huge_page_resource();
+
+}
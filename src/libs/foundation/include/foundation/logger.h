@@ -1,5 +1,425 @@
 #pragma once
+#include <spdlog/spdlog.h>
+#include <fmt/format.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <utility>
+#include <type_traits>
+
+// Calls below this level compile to nothing, arguments included; uses the
+// SPDLOG_LEVEL_* numbering (0 trace ... 5 critical)
+#ifndef FOUNDATION_LOG_ACTIVE_LEVEL
+#define FOUNDATION_LOG_ACTIVE_LEVEL SPDLOG_LEVEL_DEBUG
+#endif
 
 namespace foundation {
     void init_logger();
+
+    struct AsyncLoggerOptions {
+        size_t buffer_bytes = 1024 * 1024;      // Per thread; records that do not fit are dropped
+        uint32_t max_per_second = 0;            // Per call site; 0 disables rate limiting
+        std::chrono::microseconds idle_sleep{200};  // Backend poll interval when all buffers are empty
+    };
+
+    struct AsyncLoggerStats {
+        uint64_t records = 0;       // Written by the backend
+        uint64_t dropped = 0;       // Buffer full
+        uint64_t suppressed = 0;    // Rate-limited
+    };
+
+    /**
+     * @brief Start the background thread that formats FLOG_* records and
+     *        hands them to spdlog's default logger with their original
+     *        timestamps. Until it runs, FLOG_* log synchronously.
+     */
+    void start_async_logger(AsyncLoggerOptions options = {});
+
+    /**
+     * @brief Write everything logged so far and stop the thread.
+     */
+    void stop_async_logger();
+
+    /**
+     * @brief Block until every record logged before the call is written.
+     */
+    void flush_async_logger();
+
+    AsyncLoggerStats async_logger_stats();
+
+    /**
+     * @brief Specialise as std::true_type for a trivially copyable type that
+     *        holds all of its data, so FLOG_* copies its bytes and formats it
+     *        on the backend. Other class types are formatted on the calling
+     *        thread: their bytes may refer to memory that is gone by then
+     *        (std::span, fmt::join_view, ...).
+     */
+    template <typename T>
+    struct LogByValue : std::false_type {};
+
+    /**
+     * @brief One FLOG_* statement; a static per call site.
+     */
+    struct LogSite {
+        constexpr LogSite(spdlog::level::level_enum level, std::string_view format, const char* file, int line)
+            : level(level), format(format), file(file), line(line) {}
+
+        const spdlog::level::level_enum level;
+        const std::string_view format;
+        const char* const file;
+        const int line;
+
+        // Rate limiting; only touched when AsyncLoggerOptions::max_per_second is set
+        std::atomic<int64_t> window{0};
+        std::atomic<uint32_t> count{0};
+        std::atomic<uint32_t> suppressed{0};
+    };
+
+    namespace detail {
+        using DecodeFn = void (*)(const char* args, std::string_view format, fmt::memory_buffer& out);
+
+        struct RecordHeader {
+            uint32_t size;          // Whole record, 8-byte aligned; PADDING marks the unused end of the ring
+            uint32_t suppressed;    // Records of this site dropped by the rate limit just before this one
+            DecodeFn decode;
+            const LogSite* site;
+            int64_t timestamp_ns;   // system_clock
+        };
+
+        /**
+         * @brief Single-producer single-consumer ring of variable-size
+         *        records; the owning thread writes, the backend reads.
+         */
+        class LogBuffer {
+        public:
+            static constexpr uint32_t PADDING = 0x80000000u;
+
+            explicit LogBuffer(size_t capacity);
+            ~LogBuffer();
+
+            LogBuffer(const LogBuffer&) = delete;
+            LogBuffer& operator=(const LogBuffer&) = delete;
+
+            // Producer
+            char* reserve(size_t size) {
+                const uint64_t head = head_.load(std::memory_order_relaxed);
+                const size_t offset = static_cast<size_t>(head & mask_);
+                const size_t contiguous = mask_ + 1 - offset;
+                const size_t needed = contiguous < size ? contiguous + size : size;
+                if (head + needed - cached_tail_ > mask_ + 1) {
+                    cached_tail_ = tail_.load(std::memory_order_acquire);
+                    if (head + needed - cached_tail_ > mask_ + 1) {
+                        return nullptr;
+                    }
+                }
+                if (contiguous < size) {
+                    const uint32_t pad = static_cast<uint32_t>(contiguous) | PADDING;
+                    std::memcpy(data_ + offset, &pad, sizeof(pad));
+                    reserved_head_ = head + contiguous;
+                    return data_;
+                }
+                reserved_head_ = head;
+                return data_ + offset;
+            }
+
+            void commit(size_t size) { head_.store(reserved_head_ + size, std::memory_order_release); }
+
+            // Consumer
+            uint64_t head() const { return head_.load(std::memory_order_acquire); }
+            uint64_t tail() const { return tail_.load(std::memory_order_relaxed); }
+            const char* at(uint64_t position) const { return data_ + (position & mask_); }
+            void release(uint64_t position) { tail_.store(position, std::memory_order_release); }
+
+            std::atomic<bool> retired{false};   // Owning thread exited; freed once drained
+            std::atomic<bool> writing{false};   // Owner is between seeing the backend running and committing
+            std::atomic<uint64_t> dropped{0};
+
+        private:
+            char* data_;
+            size_t mask_;
+            alignas(64) std::atomic<uint64_t> head_{0};
+            uint64_t cached_tail_ = 0;
+            uint64_t reserved_head_ = 0;
+            alignas(64) std::atomic<uint64_t> tail_{0};
+        };
+
+        extern std::atomic<bool> async_running;
+        extern std::atomic<uint32_t> max_per_second;
+
+        LogBuffer* register_thread_buffer();
+
+        inline thread_local LogBuffer* current_buffer = nullptr;
+
+        inline LogBuffer* thread_buffer() {
+            LogBuffer* buffer = current_buffer;
+            return buffer ? buffer : register_thread_buffer();
+        }
+
+        inline int64_t now_ns() {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                       std::chrono::system_clock::now().time_since_epoch())
+                .count();
+        }
+
+        // Approximate per-second window shared by every thread logging at the site
+        inline bool admit(LogSite& site, int64_t now, uint32_t& suppressed) {
+            const uint32_t limit = max_per_second.load(std::memory_order_relaxed);
+            if (limit == 0) {
+                suppressed = 0;
+                return true;
+            }
+            const int64_t window = now / 1000000000;
+            if (site.window.load(std::memory_order_relaxed) != window) {
+                site.window.store(window, std::memory_order_relaxed);
+                site.count.store(0, std::memory_order_relaxed);
+            }
+            if (site.count.fetch_add(1, std::memory_order_relaxed) < limit) {
+                suppressed = site.suppressed.exchange(0, std::memory_order_relaxed);
+                return true;
+            }
+            site.suppressed.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        struct StringCodec {
+            static size_t size(std::string_view value) { return sizeof(uint32_t) + value.size(); }
+            static char* encode(char* p, std::string_view value) {
+                const auto n = static_cast<uint32_t>(value.size());
+                std::memcpy(p, &n, sizeof(n));
+                std::memcpy(p + sizeof(n), value.data(), n);
+                return p + sizeof(n) + n;
+            }
+            static std::string_view decode(const char*& p) {
+                uint32_t n;
+                std::memcpy(&n, p, sizeof(n));
+                std::string_view s(p + sizeof(n), n);
+                p += sizeof(n) + n;
+                return s;
+            }
+        };
+
+        // The replacement field of argument `index` in `format` as a format
+        // string of its own, e.g. "{:.3}"; "{}" if it has no spec, or a spec
+        // that refers to other arguments
+        inline std::string replacement_field(std::string_view format, size_t index) {
+            size_t next = 0;
+            for (size_t i = 0; i < format.size(); ++i) {
+                if (format[i] != '{') {
+                    continue;
+                }
+                if (i + 1 < format.size() && format[i + 1] == '{') {
+                    ++i;    // Escaped brace
+                    continue;
+                }
+                size_t end = i + 1;
+                for (int depth = 1; end < format.size(); ++end) {
+                    depth += format[end] == '{' ? 1 : format[end] == '}' ? -1 : 0;
+                    if (depth == 0) {
+                        break;
+                    }
+                }
+                const std::string_view field = format.substr(i + 1, end - i - 1);
+                const std::string_view id = field.substr(0, field.find(':'));
+                size_t arg = next++;
+                if (!id.empty()) {
+                    arg = 0;
+                    for (char c : id) {
+                        arg = c >= '0' && c <= '9' ? arg * 10 + static_cast<size_t>(c - '0') : SIZE_MAX;
+                    }
+                }
+                if (arg == index) {
+                    const std::string_view spec = field.substr(id.size());
+                    if (spec.empty() || spec.find('{') != std::string_view::npos) {
+                        return "{}";
+                    }
+                    return "{" + std::string(spec) + "}";
+                }
+                i = end;
+            }
+            return "{}";
+        }
+
+        // An argument formatted on the calling thread, spec and all; its own
+        // spec on the backend is already applied, so it is skipped
+        struct Preformatted {
+            std::string_view text;
+        };
+
+        // How one argument type is captured: arithmetic, enum and pointer
+        // values (and LogByValue types) by bytes, strings by length + bytes,
+        // anything else formatted on the calling thread with its own
+        // replacement field (the one case that is not deferred)
+        template <typename T, typename = void>
+        struct ArgCodec : StringCodec {
+            static std::string capture(const T& value, std::string_view format, size_t index) {
+                return fmt::format(fmt::runtime(replacement_field(format, index)), value);
+            }
+            static Preformatted decode(const char*& p) { return {StringCodec::decode(p)}; }
+        };
+
+        template <typename T>
+        struct ArgCodec<T, std::enable_if_t<std::is_convertible_v<const T&, std::string_view>>> : StringCodec {
+            static std::string_view capture(const T& value, std::string_view, size_t) {
+                if constexpr (std::is_pointer_v<T>) {
+                    return value ? std::string_view(value) : std::string_view("(null)");
+                } else {
+                    return std::string_view(value);
+                }
+            }
+        };
+
+        template <typename T>
+        constexpr bool by_value = (std::is_arithmetic_v<T> || std::is_enum_v<T> || std::is_pointer_v<T> ||
+                                   std::is_null_pointer_v<T> || LogByValue<T>::value) &&
+                                  !std::is_convertible_v<const T&, std::string_view>;
+
+        template <typename T>
+        struct ArgCodec<T, std::enable_if_t<by_value<T>>> {
+            static_assert(std::is_trivially_copyable_v<T>, "LogByValue types must be trivially copyable");
+
+            static const T& capture(const T& value, std::string_view, size_t) { return value; }
+            static size_t size(const T&) { return sizeof(T); }
+            static char* encode(char* p, const T& value) {
+                std::memcpy(p, &value, sizeof(T));
+                return p + sizeof(T);
+            }
+            static T decode(const char*& p) {
+                T value;
+                std::memcpy(static_cast<void*>(&value), p, sizeof(T));
+                p += sizeof(T);
+                return value;
+            }
+        };
+
+        template <typename T>
+        using Codec = ArgCodec<std::decay_t<T>>;
+
+        template <typename... Args>
+        void decode(const char* p, std::string_view format, fmt::memory_buffer& out) {
+            // Braced initialisation decodes left to right
+            std::tuple<decltype(Codec<Args>::decode(p))...> values{Codec<Args>::decode(p)...};
+            std::apply(
+                [&](const auto&... v) { fmt::vformat_to(std::back_inserter(out), format, fmt::make_format_args(v...)); },
+                values);
+        }
+
+        template <typename... Args, typename... Captured>
+        void write_record(LogBuffer* buffer, LogSite& site, int64_t now, uint32_t suppressed,
+                          const Captured&... captured) {
+            const size_t size =
+                (sizeof(RecordHeader) + (Codec<Args>::size(captured) + ... + 0) + 7) & ~size_t(7);
+            char* p = buffer->reserve(size);
+            if (!p) {
+                buffer->dropped.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            const RecordHeader header{static_cast<uint32_t>(size), suppressed, &decode<Args...>, &site, now};
+            std::memcpy(p, &header, sizeof(header));
+            p += sizeof(header);
+            ((p = Codec<Args>::encode(p, captured)), ...);
+            buffer->commit(size);
+        }
+
+        template <typename... Args>
+        void log_now(LogSite& site, fmt::format_string<Args...> format, Args&&... args) {
+            spdlog::default_logger_raw()->log(spdlog::source_loc{site.file, site.line, ""}, site.level, format,
+                                              std::forward<Args>(args)...);
+        }
+
+        template <typename... Args>
+        void log(LogSite& site, fmt::format_string<Args...> format, Args&&... args) {
+            if (!async_running.load(std::memory_order_relaxed)) {
+                log_now(site, format, std::forward<Args>(args)...);
+                return;
+            }
+            // stop_async_logger() clears async_running, then waits for every
+            // `writing` flag: a call either sees it stopped and logs here, or
+            // commits its record before the final drain
+            LogBuffer* buffer = thread_buffer();
+            buffer->writing.store(true, std::memory_order_seq_cst);
+            if (!async_running.load(std::memory_order_seq_cst)) {
+                buffer->writing.store(false, std::memory_order_relaxed);
+                log_now(site, format, std::forward<Args>(args)...);
+                return;
+            }
+            const int64_t now = now_ns();
+            uint32_t suppressed;
+            if (admit(site, now, suppressed)) {
+                // Argument indexes let a formatted argument find its own spec
+                [&]<size_t... I>(std::index_sequence<I...>) {
+                    write_record<Args...>(buffer, site, now, suppressed, Codec<Args>::capture(args, site.format, I)...);
+                }(std::index_sequence_for<Args...>{});
+            }
+            buffer->writing.store(false, std::memory_order_release);
+        }
+    }
 }
+
+template <>
+struct fmt::formatter<foundation::detail::Preformatted> {
+    // Skips the spec, consuming the automatic indexes of any nested fields
+    // (a dynamic width, say) as the compile-time check did
+    constexpr auto parse(fmt::format_parse_context& ctx) {
+        auto it = ctx.begin();
+        for (int depth = 0; it != ctx.end() && (*it != '}' || depth > 0); ++it) {
+            if (*it == '{') {
+                if (++depth == 1 && it + 1 != ctx.end() && *(it + 1) == '}') {
+                    ctx.next_arg_id();
+                }
+            } else if (*it == '}') {
+                --depth;
+            }
+        }
+        return it;
+    }
+
+    auto format(const foundation::detail::Preformatted& value, fmt::format_context& ctx) const {
+        return std::copy(value.text.begin(), value.text.end(), ctx.out());
+    }
+};
+
+#define FOUNDATION_LOG(level, format, ...)                                                              \
+    do {                                                                                              \
+        static ::foundation::LogSite foundation_log_site_{level, format, __FILE__, __LINE__};          \
+        if (::spdlog::default_logger_raw()->should_log(level)) {                                       \
+            ::foundation::detail::log(foundation_log_site_, format __VA_OPT__(, ) __VA_ARGS__);        \
+        }                                                                                             \
+    } while (0)
+
+#if FOUNDATION_LOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_TRACE
+#define FLOG_TRACE(...) FOUNDATION_LOG(::spdlog::level::trace, __VA_ARGS__)
+#else
+#define FLOG_TRACE(...) (void)0
+#endif
+
+#if FOUNDATION_LOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_DEBUG
+#define FLOG_DEBUG(...) FOUNDATION_LOG(::spdlog::level::debug, __VA_ARGS__)
+#else
+#define FLOG_DEBUG(...) (void)0
+#endif
+
+#if FOUNDATION_LOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_INFO
+#define FLOG_INFO(...) FOUNDATION_LOG(::spdlog::level::info, __VA_ARGS__)
+#else
+#define FLOG_INFO(...) (void)0
+#endif
+
+#if FOUNDATION_LOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_WARN
+#define FLOG_WARN(...) FOUNDATION_LOG(::spdlog::level::warn, __VA_ARGS__)
+#else
+#define FLOG_WARN(...) (void)0
+#endif
+
+#if FOUNDATION_LOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_ERROR
+#define FLOG_ERROR(...) FOUNDATION_LOG(::spdlog::level::err, __VA_ARGS__)
+#else
+#define FLOG_ERROR(...) (void)0
+#endif
+
+#define FLOG_CRITICAL(...) FOUNDATION_LOG(::spdlog::level::critical, __VA_ARGS__)
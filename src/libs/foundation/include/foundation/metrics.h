@@ -0,0 +1,126 @@
+#pragma once
+#include "foundation/histogram.h"
+#include "foundation/per_thread.h"
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace foundation {
+
+    using MetricLabels = std::vector<std::pair<std::string, std::string>>;
+
+    namespace detail {
+        struct alignas(64) CounterShard {
+            std::atomic<uint64_t> value{0};
+        };
+
+        struct alignas(64) GaugeShard {
+            std::atomic<int64_t> value{0};
+        };
+    }
+
+    /**
+     * @brief Monotonic count, sharded per thread: inc() is a relaxed load
+     *        and store on a cache line only the calling thread writes.
+     */
+    class Counter {
+    public:
+        void inc(uint64_t n = 1) {
+            auto& value = shards_.local().value;
+            value.store(value.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+        }
+
+        uint64_t value() const;
+
+    private:
+        PerThread<detail::CounterShard> shards_;
+    };
+
+    /**
+     * @brief Value that goes up and down, as the sum of per-thread shares.
+     *        add() moves the calling thread's share; set() replaces it, for
+     *        quantities each thread owns a part of (one event loop's queued
+     *        bytes, say).
+     */
+    class Gauge {
+    public:
+        void add(int64_t delta) {
+            auto& value = shards_.local().value;
+            value.store(value.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+        }
+
+        void set(int64_t value) { shards_.local().value.store(value, std::memory_order_relaxed); }
+
+        int64_t value() const;
+
+    private:
+        PerThread<detail::GaugeShard> shards_;
+    };
+
+    /**
+     * @brief Named counters, gauges and latency histograms, aggregated only
+     *        when rendered.
+     *
+     * Metrics are created once (typically at startup) and recorded into
+     * through the returned reference for the life of the registry; asking
+     * again for the same name and labels returns the same metric.
+     * Histograms are LatencyRecorders fed nanoseconds and exported in
+     * seconds. Registration and rendering take a lock; recording never
+     * does.
+     */
+    class MetricsRegistry {
+    public:
+        MetricsRegistry();
+        ~MetricsRegistry();
+
+        MetricsRegistry(const MetricsRegistry&) = delete;
+        MetricsRegistry& operator=(const MetricsRegistry&) = delete;
+
+        Counter& counter(std::string_view name, std::string_view help, const MetricLabels& labels = {});
+        Gauge& gauge(std::string_view name, std::string_view help, const MetricLabels& labels = {});
+        LatencyRecorder& histogram(std::string_view name, std::string_view help, const MetricLabels& labels = {});
+
+        /**
+         * @brief Every metric in the Prometheus text exposition format
+         *        (version 0.0.4).
+         */
+        std::string render_prometheus() const;
+
+        // Upper bounds, in seconds, of the exported histogram buckets
+        static const std::vector<double>& histogram_bounds();
+
+    private:
+        enum class Type { Counter, Gauge, Histogram };
+
+        struct Metric {
+            std::string labels;     // Rendered and escaped: a="b",c="d"
+            std::unique_ptr<Counter> counter;
+            std::unique_ptr<Gauge> gauge;
+            std::unique_ptr<LatencyRecorder> histogram;
+        };
+
+        struct Family {
+            Type type;
+            std::string help;
+            std::vector<std::unique_ptr<Metric>> metrics;
+        };
+
+        Metric& find_or_add(Type type, std::string_view name, std::string_view help, const MetricLabels& labels);
+
+        mutable std::mutex mutex_;
+        std::map<std::string, Family, std::less<>> families_;
+        std::vector<std::unique_ptr<Metric>> unexported_;    // Name clashed with a family of another type
+    };
+
+    /**
+     * @brief The process-wide registry servers export.
+     */
+    MetricsRegistry& metrics();
+
+}
@@ -0,0 +1,187 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace foundation {
+
+    struct PoolStats {
+        uint64_t chunks = 0;            // Upstream allocations; never returned
+        size_t bytes_reserved = 0;
+        size_t blocks_in_depot = 0;     // Free blocks not cached by any thread
+    };
+
+    /**
+     * @brief Shared state of one block size: the chunks carved into blocks
+     *        and the batches of free blocks that no thread is caching.
+     *        Only touched when a thread cache runs empty or overflows.
+     */
+    class PoolDepot {
+    public:
+        struct FreeBlock {
+            FreeBlock* next;
+        };
+
+        // What one thread holds for one depot
+        struct Cache {
+            FreeBlock* head = nullptr;
+            size_t count = 0;
+            PoolDepot* depot = nullptr;
+
+            ~Cache() {
+                if (depot) {
+                    depot->release_all(*this);
+                }
+            }
+        };
+
+        PoolDepot(size_t block_size, size_t block_align);
+
+        PoolDepot(const PoolDepot&) = delete;
+        PoolDepot& operator=(const PoolDepot&) = delete;
+
+        void* refill(Cache& cache);
+        void drain(Cache& cache);
+        void release_all(Cache& cache);
+
+        size_t block_size() const { return block_size_; }
+        size_t batch() const { return batch_; }
+        PoolStats stats() const;
+
+    private:
+        size_t block_size_;
+        size_t block_align_;
+        size_t batch_;                          // Blocks moved between a cache and the depot at once
+        mutable std::mutex mutex_;
+        std::vector<FreeBlock*> batches_;       // Each a list of exactly batch_ blocks
+        FreeBlock* loose_ = nullptr;            // From exiting threads; fewer than a batch each
+        size_t loose_count_ = 0;
+        PoolStats stats_;
+    };
+
+    /**
+     * @brief Fixed-size blocks with a free list per thread.
+     *
+     * allocate() and deallocate() pop and push a thread-local list; only
+     * when it runs empty or grows past two batches does the thread take or
+     * return a whole batch under the depot's lock. Blocks may be freed on
+     * any thread: they join that thread's list. Memory is kept for the
+     * life of the process; chunks come from huge_page_resource().
+     */
+    template <size_t BlockSize, size_t BlockAlign = alignof(std::max_align_t)>
+    class FixedPool {
+    public:
+        static constexpr size_t BLOCK_ALIGN = std::max(BlockAlign, alignof(PoolDepot::FreeBlock));
+        static constexpr size_t BLOCK_SIZE =
+            (std::max(BlockSize, sizeof(PoolDepot::FreeBlock)) + BLOCK_ALIGN - 1) / BLOCK_ALIGN * BLOCK_ALIGN;
+
+        static void* allocate() {
+            PoolDepot::Cache& cache = cache_;
+            PoolDepot::FreeBlock* block = cache.head;
+            if (block) {
+                cache.head = block->next;
+                cache.count--;
+                return block;
+            }
+            return depot().refill(cache);
+        }
+
+        static void deallocate(void* p) {
+            PoolDepot::Cache& cache = cache_;
+            auto* block = static_cast<PoolDepot::FreeBlock*>(p);
+            block->next = cache.head;
+            cache.head = block;
+            if (++cache.count > 2 * depot().batch()) {
+                depot().drain(cache);
+            }
+        }
+
+        static PoolStats stats() { return depot().stats(); }
+
+    private:
+        static PoolDepot& depot() {
+            // Never destroyed: thread caches return blocks to it at thread exit
+            static PoolDepot* depot = new PoolDepot(BLOCK_SIZE, BLOCK_ALIGN);
+            return *depot;
+        }
+
+        static inline thread_local PoolDepot::Cache cache_;
+    };
+
+    /**
+     * @brief Typed front end to FixedPool<sizeof(T), alignof(T)>.
+     */
+    template <typename T>
+    class ObjectPool {
+    public:
+        using Pool = FixedPool<sizeof(T), alignof(T)>;
+
+        struct Deleter {
+            void operator()(T* object) const { destroy(object); }
+        };
+
+        using Ptr = std::unique_ptr<T, Deleter>;
+
+        template <typename... Args>
+        static T* create(Args&&... args) {
+            void* memory = Pool::allocate();
+            try {
+                return new (memory) T(std::forward<Args>(args)...);
+            } catch (...) {
+                Pool::deallocate(memory);
+                throw;
+            }
+        }
+
+        static void destroy(T* object) {
+            if (object) {
+                object->~T();
+                Pool::deallocate(object);
+            }
+        }
+
+        template <typename... Args>
+        static Ptr make(Args&&... args) {
+            return Ptr(create(std::forward<Args>(args)...));
+        }
+    };
+
+    /**
+     * @brief Base that routes `new T` / `delete` through FixedPool, so
+     *        existing code (std::make_unique included) pools T unchanged.
+     *        Classes derived from T with a different size fall back to the
+     *        global allocator.
+     */
+    template <typename T>
+    struct PoolAllocated {
+        static void* operator new(size_t size) {
+            if (size != sizeof(T)) {
+                return ::operator new(size);
+            }
+            return FixedPool<sizeof(T), alignof(T)>::allocate();
+        }
+
+        static void operator delete(void* p, size_t size) {
+            if (size != sizeof(T)) {
+                ::operator delete(p);
+                return;
+            }
+            FixedPool<sizeof(T), alignof(T)>::deallocate(p);
+        }
+    };
+
+    /**
+     * @brief Process-wide std::pmr::memory_resource over FixedPools of
+     *        16 .. 1024 bytes; larger or over-aligned requests go to the
+     *        global heap. Thread-safe, with per-thread caches, so std::pmr
+     *        containers on any thread can share it.
+     */
+    std::pmr::memory_resource* pool_resource();
+
+}
@@ -0,0 +1,77 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace foundation {
+
+    namespace detail {
+        inline thread_local std::vector<void*> per_thread_shards;     // By PerThread id
+
+        inline size_t next_per_thread_id() {
+            static std::atomic<size_t> next{0};
+            return next.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * @brief One `Shard` for each thread that touches it, for values that
+     *        are written constantly and read rarely.
+     *
+     * local() returns the calling thread's shard, creating it on first use
+     * (the only time a lock is taken); afterwards it is a thread-local
+     * vector lookup. Readers visit every shard under the lock, including
+     * those of exited threads, which are kept until the PerThread is
+     * destroyed. Shards are written by their own thread only, so their
+     * members are typically atomics updated with relaxed stores.
+     */
+    template <typename Shard>
+    class PerThread {
+    public:
+        PerThread() : id_(detail::next_per_thread_id()) {}
+
+        PerThread(const PerThread&) = delete;
+        PerThread& operator=(const PerThread&) = delete;
+
+        Shard& local() {
+            const auto& table = detail::per_thread_shards;
+            if (id_ < table.size() && table[id_]) {
+                return *static_cast<Shard*>(table[id_]);
+            }
+            return add_shard();
+        }
+
+        template <typename Fn>
+        void for_each(Fn&& fn) const {
+            std::lock_guard lock(mutex_);
+            for (const auto& shard : shards_) {
+                fn(static_cast<const Shard&>(*shard));
+            }
+        }
+
+    private:
+        Shard& add_shard() {
+            auto shard = std::make_unique<Shard>();
+            Shard* raw = shard.get();
+            {
+                std::lock_guard lock(mutex_);
+                shards_.push_back(std::move(shard));
+            }
+            auto& table = detail::per_thread_shards;
+            if (table.size() <= id_) {
+                table.resize(id_ + 1, nullptr);
+            }
+            table[id_] = raw;
+            return *raw;
+        }
+
+        // Never reused, so a thread's table cannot point at a shard of a
+        // destroyed PerThread that another one now answers for
+        size_t id_;
+        mutable std::mutex mutex_;
+        std::vector<std::unique_ptr<Shard>> shards_;
+    };
+
+}
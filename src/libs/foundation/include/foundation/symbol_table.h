@@ -0,0 +1,80 @@
+#pragma once
+#include "foundation/arena.h"
+#include "foundation/flat_hash_map.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <shared_mutex>
+#include <string_view>
+
+namespace foundation {
+
+    /**
+     * @brief Dense id of an interned name; ids count up from 0 in the order
+     *        names were first interned.
+     */
+    using SymbolId = uint32_t;
+    inline constexpr SymbolId NO_SYMBOL = UINT32_MAX;
+
+    /**
+     * @brief Interns names (tickers, room names) as dense 32-bit ids.
+     *
+     * Hot code looks a name up once and then keys on the id: a plain
+     * integer to hash, compare, or index a vector with. intern() and find()
+     * may be called from any thread and take a shared lock on the way in
+     * (an exclusive one only for a new name). name() takes no lock; the
+     * bytes it returns are never moved or freed, so views into them stay
+     * valid for the table's lifetime.
+     */
+    class SymbolTable {
+    public:
+        static constexpr size_t MAX_SYMBOLS = size_t(1) << 22;
+
+        SymbolTable();
+        ~SymbolTable();
+
+        SymbolTable(const SymbolTable&) = delete;
+        SymbolTable& operator=(const SymbolTable&) = delete;
+
+        /**
+         * @return The id of `name`, assigning the next one if it is new, or
+         *         NO_SYMBOL once MAX_SYMBOLS names exist.
+         */
+        SymbolId intern(std::string_view name);
+
+        /**
+         * @return The id of `name`, or NO_SYMBOL if it was never interned.
+         */
+        SymbolId find(std::string_view name) const;
+
+        /**
+         * @brief The name of an id returned by intern(); empty for others.
+         */
+        std::string_view name(SymbolId id) const {
+            if (id >= size_.load(std::memory_order_acquire)) {
+                return {};
+            }
+            return chunks_[id >> CHUNK_BITS].load(std::memory_order_acquire)[id & (CHUNK_SIZE - 1)];
+        }
+
+        size_t size() const { return size_.load(std::memory_order_acquire); }
+
+    private:
+        // Names by id in fixed chunks, so readers never see storage move
+        static constexpr size_t CHUNK_BITS = 12;
+        static constexpr size_t CHUNK_SIZE = size_t(1) << CHUNK_BITS;
+
+        mutable std::shared_mutex mutex_;
+        FlatHashMap<std::string_view, SymbolId> ids_;   // Views into arena_
+        Arena arena_;
+        std::unique_ptr<std::atomic<std::string_view*>[]> chunks_;
+        std::atomic<uint32_t> size_{0};
+    };
+
+    /**
+     * @brief The process-wide symbol table.
+     */
+    SymbolTable& symbols();
+
+}
@@ -0,0 +1,241 @@
+#pragma once
+#include "foundation/object_pool.h"
+#include "foundation/work_stealing_deque.h"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace foundation {
+
+    class TaskGroup;
+
+    struct ThreadPoolOptions {
+        size_t threads = 0;         // 0 = std::thread::hardware_concurrency()
+        bool pin_workers = false;   // Worker i runs only on core (first_core + i) % cores (Linux)
+        size_t first_core = 0;
+        uint32_t spin_rounds = 64;  // Steal attempts by an idle worker before it parks
+    };
+
+    struct ThreadPoolStats {
+        uint64_t executed = 0;      // Tasks run by workers; helping waiters are not counted
+        uint64_t stolen = 0;        // Of those, taken from another worker's deque
+        uint64_t parked = 0;        // Times a worker went to sleep for lack of work
+    };
+
+    namespace detail {
+        // Type-erased callable with inline storage, so spawning a small
+        // lambda is one pooled allocation
+        struct Task : PoolAllocated<Task> {
+            static constexpr size_t INLINE_BYTES = 48;
+
+            template <typename Fn>
+            static Task* make(Fn&& fn, TaskGroup* group) {
+                using F = std::decay_t<Fn>;
+                auto* task = new Task;
+                task->group = group;
+                if constexpr (sizeof(F) <= INLINE_BYTES && alignof(F) <= alignof(std::max_align_t)) {
+                    new (task->storage) F(std::forward<Fn>(fn));
+                    task->invoke = [](Task& self) {
+                        F& f = *std::launder(reinterpret_cast<F*>(self.storage));
+                        f();
+                        f.~F();
+                    };
+                } else {
+                    new (task->storage) F*(new F(std::forward<Fn>(fn)));
+                    task->invoke = [](Task& self) {
+                        F* f = *std::launder(reinterpret_cast<F**>(self.storage));
+                        (*f)();
+                        delete f;
+                    };
+                }
+                return task;
+            }
+
+            void (*invoke)(Task&) = nullptr;
+            TaskGroup* group = nullptr;
+            alignas(std::max_align_t) unsigned char storage[INLINE_BYTES];
+        };
+    }
+
+    /**
+     * @brief Work-stealing thread pool.
+     *
+     * Every worker owns a Chase-Lev deque: tasks spawned on a worker go to
+     * the bottom of its own deque and are run newest-first, which keeps a
+     * recursive split cache-warm, while idle workers steal the oldest (and
+     * usually largest) task from a random victim. Tasks submitted from
+     * other threads go through a shared injection queue. A worker that
+     * finds nothing after `spin_rounds` attempts parks on a condition
+     * variable until new work is pushed.
+     *
+     * Tasks must not throw. The destructor runs every queued task, then
+     * joins the workers.
+     */
+    class ThreadPool {
+    public:
+        explicit ThreadPool(ThreadPoolOptions options = {});
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        /**
+         * @brief Run `fn` on some worker; nothing waits for it. Use a
+         *        TaskGroup to wait.
+         */
+        template <typename Fn>
+        void submit(Fn&& fn) {
+            push(detail::Task::make(std::forward<Fn>(fn), nullptr));
+        }
+
+        size_t size() const { return workers_.size(); }
+
+        ThreadPoolStats stats() const;
+
+        /**
+         * @brief The pool whose worker is calling, or nullptr.
+         */
+        static ThreadPool* current();
+
+    private:
+        friend class TaskGroup;
+        struct Worker;
+
+        void push(detail::Task* task);
+        detail::Task* find_task(Worker* self);
+        bool run_one();     // Run one queued task on the calling thread, if any
+        void execute(detail::Task* task);
+        void worker_main(Worker* self);
+        void wake_one();
+
+        static thread_local Worker* current_worker_;
+
+        ThreadPoolOptions options_;
+        std::vector<std::unique_ptr<Worker>> workers_;
+
+        std::mutex inject_mutex_;
+        std::deque<detail::Task*> injected_;
+        std::atomic<size_t> injected_count_{0};
+
+        std::mutex park_mutex_;
+        std::condition_variable park_cv_;
+        std::atomic<size_t> sleepers_{0};
+        size_t wake_tokens_ = 0;    // Under park_mutex_
+        bool stopping_ = false;     // Under park_mutex_
+    };
+
+    /**
+     * @brief Tasks that can be waited for together.
+     *
+     * wait() does not block a worker: it runs queued tasks (this group's or
+     * any other) until every task run() through the group has finished, so
+     * groups nest freely, e.g. a task that itself splits and waits.
+     */
+    class TaskGroup {
+    public:
+        explicit TaskGroup(ThreadPool& pool) : pool_(pool) {}
+
+        /**
+         * @brief Waits for outstanding tasks.
+         */
+        ~TaskGroup() { wait(); }
+
+        TaskGroup(const TaskGroup&) = delete;
+        TaskGroup& operator=(const TaskGroup&) = delete;
+
+        template <typename Fn>
+        void run(Fn&& fn) {
+            pending_.fetch_add(1, std::memory_order_relaxed);
+            pool_.push(detail::Task::make(std::forward<Fn>(fn), this));
+        }
+
+        void wait();
+
+        ThreadPool& pool() { return pool_; }
+
+    private:
+        friend class ThreadPool;
+
+        ThreadPool& pool_;
+        std::atomic<size_t> pending_{0};
+    };
+
+    namespace detail {
+        template <typename Fn>
+        void split_range(TaskGroup& group, size_t begin, size_t end, size_t grain, const Fn& fn) {
+            // Hand the upper halves to thieves and keep splitting the lower
+            while (end - begin > grain) {
+                const size_t mid = begin + (end - begin) / 2;
+                group.run([&group, mid, end, grain, &fn] { split_range(group, mid, end, grain, fn); });
+                end = mid;
+            }
+            fn(begin, end);
+        }
+
+        inline size_t default_grain(const ThreadPool& pool, size_t count) {
+            // About eight chunks per worker: enough to balance, few enough to be cheap
+            return std::max<size_t>(1, count / (pool.size() * 8));
+        }
+    }
+
+    /**
+     * @brief Call `fn(chunk_begin, chunk_end)` over [begin, end) in chunks of
+     *        at most `grain` indices (0 picks one), in parallel, and return
+     *        when all have run.
+     */
+    template <typename Fn>
+    void parallel_for(ThreadPool& pool, size_t begin, size_t end, size_t grain, Fn&& fn) {
+        if (begin >= end) {
+            return;
+        }
+        if (grain == 0) {
+            grain = detail::default_grain(pool, end - begin);
+        }
+        TaskGroup group(pool);
+        detail::split_range(group, begin, end, grain, fn);
+        group.wait();
+    }
+
+    /**
+     * @brief Fold `map(chunk_begin, chunk_end)` of each chunk of [begin, end)
+     *        with `combine`, starting from `identity`.
+     *
+     * Chunk boundaries depend only on `grain` (0 picks one from the pool
+     * size) and the partial results are combined in index order, so the
+     * result does not depend on scheduling, even for floating point.
+     */
+    template <typename T, typename Map, typename Combine>
+    T parallel_reduce(ThreadPool& pool, size_t begin, size_t end, size_t grain, T identity, Map&& map,
+                      Combine&& combine) {
+        if (begin >= end) {
+            return identity;
+        }
+        if (grain == 0) {
+            grain = detail::default_grain(pool, end - begin);
+        }
+        const size_t chunks = (end - begin + grain - 1) / grain;
+        std::vector<T> partials(chunks, identity);
+        parallel_for(pool, 0, chunks, 1, [&](size_t first, size_t last) {
+            for (size_t c = first; c < last; ++c) {
+                const size_t chunk_begin = begin + c * grain;
+                partials[c] = map(chunk_begin, std::min(end, chunk_begin + grain));
+            }
+        });
+        T result = std::move(identity);
+        for (T& partial : partials) {
+            result = combine(std::move(result), std::move(partial));
+        }
+        return result;
+    }
+
+}
@@ -0,0 +1,125 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace foundation {
+
+    enum class PollResult {
+        Idle,       // Nothing was ready
+        Worked,
+        Done,       // Stop the runner
+    };
+
+    struct ThreadRunnerOptions {
+        std::string name;                   // Thread and trace track name; the OS keeps 15 bytes
+        std::vector<int> cpus;              // Allowed CPUs; empty leaves affinity alone
+        int numa_node = -1;                 // Also limit to this node's CPUs and prefer its memory
+        int realtime_priority = 0;          // 1-99 runs under SCHED_FIFO (needs CAP_SYS_NICE); 0 keeps the default policy
+        bool busy_poll = false;             // Spin on poll(false) rather than letting poll(true) block
+        uint32_t min_pause = 1;             // Busy poll: pause instructions after an idle poll, doubling while idle...
+        uint32_t max_pause = 256;           // ...up to this many
+        uint32_t yield_after = 0;           // Busy poll: idle polls in a row before yielding the CPU each time; 0 never yields
+    };
+
+    struct ThreadRunnerStats {
+        uint64_t polls = 0;
+        uint64_t idle_polls = 0;
+        uint64_t busy_ns = 0;       // In polls that worked
+        uint64_t idle_ns = 0;       // In idle polls, blocked or backing off
+
+        double busy_ratio() const {
+            const uint64_t total = busy_ns + idle_ns;
+            return total ? static_cast<double>(busy_ns) / static_cast<double>(total) : 0.0;
+        }
+    };
+
+    /**
+     * @brief Drives a poll function on a thread placed as its options ask:
+     *        pinned to CPUs or a NUMA node, optionally under SCHED_FIFO.
+     *
+     * `poll(block)` handles whatever is ready and says whether there was
+     * any. In the default mode it is called with block = true and may wait
+     * for work; with `busy_poll` it is called with block = false in a tight
+     * loop, pausing with exponential backoff (and optionally yielding)
+     * while it comes back idle, so the thread never sleeps in the kernel.
+     * Each poll is timed with TscClock and counted as busy or idle, less
+     * what it reports as blocked(); stats() may be read from any thread.
+     */
+    class ThreadRunner {
+    public:
+        using Poll = std::function<PollResult(bool block)>;
+
+        explicit ThreadRunner(ThreadRunnerOptions options = {});
+        ~ThreadRunner();
+
+        ThreadRunner(const ThreadRunner&) = delete;
+        ThreadRunner& operator=(const ThreadRunner&) = delete;
+
+        /**
+         * @brief Place the calling thread and poll until `poll` returns Done.
+         */
+        void run(const Poll& poll);
+
+        /**
+         * @brief run() on a new thread.
+         */
+        void start(Poll poll);
+
+        /**
+         * @brief Wait for the thread started by start() to finish.
+         */
+        void join();
+
+        /**
+         * @brief From inside poll: `ns` of the current poll went to waiting
+         *        for work, and count as idle even if the poll worked.
+         */
+        void blocked(uint64_t ns) { blocked_ns_ += ns; }
+
+        ThreadRunnerStats stats() const;
+        const ThreadRunnerOptions& options() const { return options_; }
+
+    private:
+        // Owner-only counters, published with relaxed stores
+        static void add(std::atomic<uint64_t>& counter, uint64_t delta) {
+            counter.store(counter.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+        }
+
+        ThreadRunnerOptions options_;
+        std::thread thread_;
+        uint64_t blocked_ns_ = 0;   // Reported by the current poll; runner thread only
+        alignas(64) std::atomic<uint64_t> polls_{0};
+        std::atomic<uint64_t> idle_polls_{0};
+        std::atomic<uint64_t> busy_ticks_{0};
+        std::atomic<uint64_t> idle_ticks_{0};
+    };
+
+    /**
+     * @brief Apply the name, CPU, NUMA and scheduling settings of `options`
+     *        to the calling thread; what the OS refuses is logged and skipped.
+     */
+    void place_current_thread(const ThreadRunnerOptions& options);
+
+    /**
+     * @brief Restrict the calling thread to `cpus`. Logs and returns false
+     *        if the OS refuses or cannot pin threads.
+     */
+    bool pin_current_thread(const std::vector<int>& cpus);
+
+    /**
+     * @brief The CPUs of NUMA node `node`, from sysfs; empty if unknown.
+     */
+    std::vector<int> numa_node_cpus(int node);
+
+    /**
+     * @brief Parse a CPU list such as "0-3,8,10-11". Malformed, reversed
+     *        or out of range (CPU_SETSIZE and up) items are skipped.
+     */
+    std::vector<int> parse_cpu_list(std::string_view list);
+
+}
@@ -0,0 +1,128 @@
+#pragma once
+#include "foundation/clock.h"
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// With 0, FTRACE_ZONE compiles to nothing; the dump functions remain and
+// write a trace with no events
+#ifndef FOUNDATION_TRACE_ENABLED
+#define FOUNDATION_TRACE_ENABLED 1
+#endif
+
+namespace foundation {
+
+    struct TraceDumpOptions {
+        std::string directory = ".";    // Dumps are written as trace-<pid>-<n>.json, or trace-<pid>-crash.json
+        bool on_signal = true;          // SIGUSR2 writes a dump from a background thread
+        bool on_crash = true;           // SIGSEGV, SIGBUS, SIGFPE, SIGILL and SIGABRT write one before dying
+    };
+
+    /**
+     * @brief Label the calling thread's track in dumps (up to 31 bytes).
+     */
+    void set_trace_thread_name(std::string_view name);
+
+    /**
+     * @brief Every zone still held in the rings, as Chrome trace event JSON
+     *        (loads in chrome://tracing and ui.perfetto.dev).
+     */
+    std::string trace_json();
+
+    /**
+     * @brief Write trace_json() to `path` without allocating or locking, so
+     *        it is safe in a signal handler. False if the file cannot be
+     *        written.
+     */
+    bool write_trace(const char* path);
+
+    /**
+     * @brief Dump on SIGUSR2 and on crash signals as `options` asks. Call
+     *        once, early; POSIX only. For crash dumps the calling thread and
+     *        every thread that starts tracing afterwards get an alternate
+     *        signal stack, so a stack overflow is dumped too.
+     */
+    void install_trace_dumps(TraceDumpOptions options = {});
+
+    namespace detail {
+        struct TraceEvent {
+            std::atomic<const char*> name{nullptr};
+            std::atomic<uint64_t> begin{0};     // TscClock ticks
+            std::atomic<uint64_t> end{0};
+        };
+
+        /**
+         * @brief Fixed ring of the owning thread's most recent zones. Only
+         *        the owner writes; a dump reads concurrently and drops
+         *        what was overwritten under it.
+         */
+        class TraceRing {
+        public:
+            static constexpr size_t CAPACITY = 8192;    // Events per thread; older ones are overwritten
+
+            void push(const char* name, uint64_t begin, uint64_t end) {
+                const uint64_t head = head_.load(std::memory_order_relaxed);
+                // Orders the previous head store before these slot stores, so
+                // a reader that sees them also sees a head that retires the slot
+                std::atomic_thread_fence(std::memory_order_release);
+                TraceEvent& event = events_[head & (CAPACITY - 1)];
+                event.name.store(name, std::memory_order_relaxed);
+                event.begin.store(begin, std::memory_order_relaxed);
+                event.end.store(end, std::memory_order_relaxed);
+                head_.store(head + 1, std::memory_order_release);
+            }
+
+            uint64_t head() const { return head_.load(std::memory_order_acquire); }
+            const TraceEvent& at(uint64_t index) const { return events_[index & (CAPACITY - 1)]; }
+
+            std::atomic<bool> in_use{false};    // Cleared when the owning thread exits; the ring is then reused
+            std::atomic<uint64_t> start{0};     // First index written by the current owner
+            std::atomic<uint32_t> tid{0};
+            std::array<std::atomic<char>, 32> name{};
+
+        private:
+            std::array<TraceEvent, CAPACITY> events_;
+            alignas(64) std::atomic<uint64_t> head_{0};
+        };
+
+        TraceRing* register_trace_ring();
+
+        inline thread_local TraceRing* current_trace_ring = nullptr;
+
+        inline TraceRing& trace_ring() {
+            TraceRing* ring = current_trace_ring;
+            return ring ? *ring : *register_trace_ring();
+        }
+    }
+
+    /**
+     * @brief Records [construction, destruction) of a scope as one event in
+     *        the thread's ring: two rdtsc reads and three relaxed stores.
+     *        `name` must outlive the process (a string literal).
+     */
+    class TraceZone {
+    public:
+        explicit TraceZone(const char* name) : name_(name), begin_(TscClock::ticks()) {}
+        ~TraceZone() { detail::trace_ring().push(name_, begin_, TscClock::ticks()); }
+
+        TraceZone(const TraceZone&) = delete;
+        TraceZone& operator=(const TraceZone&) = delete;
+
+    private:
+        const char* name_;
+        uint64_t begin_;
+    };
+
+}
+
+#define FOUNDATION_TRACE_CONCAT_(a, b) a##b
+#define FOUNDATION_TRACE_CONCAT(a, b) FOUNDATION_TRACE_CONCAT_(a, b)
+
+#if FOUNDATION_TRACE_ENABLED
+#define FTRACE_ZONE(name) const ::foundation::TraceZone FOUNDATION_TRACE_CONCAT(ftrace_zone_, __LINE__)(name)
+#else
+#define FTRACE_ZONE(name) static_cast<void>(0)
+#endif
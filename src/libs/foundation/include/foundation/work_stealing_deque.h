@@ -0,0 +1,135 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace foundation {
+
+    /**
+     * @brief Chase-Lev work-stealing deque of `T*` (Lê et al., "Correct and
+     *        Efficient Work-Stealing for Weak Memory Models", 2013).
+     *
+     * The owning thread push()es and pop()s at the bottom without atomic
+     * read-modify-writes except when racing for the last item; any thread
+     * may steal() from the top with one CAS. The ring doubles when full;
+     * replaced rings are kept until destruction because a thief may still
+     * be reading one. Empty (or a lost race) is reported as nullptr.
+     */
+    template <typename T>
+    class WorkStealingDeque {
+    public:
+        explicit WorkStealingDeque(size_t capacity = 256) {
+            size_t size = 1;
+            while (size < capacity) {
+                size <<= 1;
+            }
+            rings_.push_back(std::make_unique<Ring>(size));
+            ring_.store(rings_.back().get(), std::memory_order_relaxed);
+        }
+
+        WorkStealingDeque(const WorkStealingDeque&) = delete;
+        WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+
+        /**
+         * @brief Owner only.
+         */
+        void push(T* item) {
+            const int64_t b = bottom_.load(std::memory_order_relaxed);
+            const int64_t t = top_.load(std::memory_order_acquire);
+            Ring* ring = ring_.load(std::memory_order_relaxed);
+            if (b - t > static_cast<int64_t>(ring->mask)) {
+                ring = grow(ring, t, b);
+            }
+            ring->put(b, item);
+            // Publishes the item to thieves, which load bottom_ with acquire
+            bottom_.store(b + 1, std::memory_order_release);
+        }
+
+        /**
+         * @brief Owner only; takes the most recently pushed item.
+         */
+        T* pop() {
+            const int64_t b = bottom_.load(std::memory_order_relaxed) - 1;
+            Ring* ring = ring_.load(std::memory_order_relaxed);
+            bottom_.store(b, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            int64_t t = top_.load(std::memory_order_relaxed);
+            if (t > b) {
+                bottom_.store(b + 1, std::memory_order_relaxed);
+                return nullptr;
+            }
+            T* item = ring->get(b);
+            if (t == b) {
+                // Last item: a thief may be taking it too
+                if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+                    item = nullptr;
+                }
+                bottom_.store(b + 1, std::memory_order_relaxed);
+            }
+            return item;
+        }
+
+        /**
+         * @brief Any thread; takes the oldest item.
+         */
+        T* steal() {
+            int64_t t = top_.load(std::memory_order_acquire);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            const int64_t b = bottom_.load(std::memory_order_acquire);
+            if (t >= b) {
+                return nullptr;
+            }
+            T* item = ring_.load(std::memory_order_acquire)->get(t);
+            if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+                return nullptr;
+            }
+            return item;
+        }
+
+        /**
+         * @brief Approximate unless called by the owner.
+         */
+        size_t size() const {
+            const int64_t b = bottom_.load(std::memory_order_relaxed);
+            const int64_t t = top_.load(std::memory_order_relaxed);
+            return b > t ? static_cast<size_t>(b - t) : 0;
+        }
+
+        bool empty() const { return size() == 0; }
+
+    private:
+        struct Ring {
+            explicit Ring(size_t size) : mask(size - 1), slots(std::make_unique<std::atomic<T*>[]>(size)) {}
+
+            T* get(int64_t index) const {
+                return slots[static_cast<size_t>(index) & mask].load(std::memory_order_relaxed);
+            }
+            void put(int64_t index, T* item) {
+                slots[static_cast<size_t>(index) & mask].store(item, std::memory_order_relaxed);
+            }
+
+            size_t mask;
+            std::unique_ptr<std::atomic<T*>[]> slots;
+        };
+
+        Ring* grow(Ring* old, int64_t top, int64_t bottom) {
+            auto ring = std::make_unique<Ring>((old->mask + 1) * 2);
+            for (int64_t i = top; i < bottom; ++i) {
+                ring->put(i, old->get(i));
+            }
+            Ring* raw = ring.get();
+            rings_.push_back(std::move(ring));
+            ring_.store(raw, std::memory_order_release);
+            return raw;
+        }
+
+        // Top and bottom on separate lines: thieves hammer one, the owner the other
+        alignas(64) std::atomic<int64_t> top_{0};
+        alignas(64) std::atomic<int64_t> bottom_{0};
+        alignas(64) std::atomic<Ring*> ring_{nullptr};
+        std::vector<std::unique_ptr<Ring>> rings_;  // Owner only
+    };
+
+}
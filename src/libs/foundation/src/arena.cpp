@@ -0,0 +1,62 @@
+#include "foundation/arena.h"
+#include <algorithm>
+
+namespace foundation {
+
+    Arena::Arena(ArenaOptions options, std::pmr::memory_resource* upstream)
+        : options_(options), upstream_(upstream) {
+        options_.block_bytes = std::max<size_t>(options_.block_bytes, 256);
+    }
+
+    Arena::~Arena() {
+        for (const Block& block : blocks_) {
+            upstream_->deallocate(block.data, block.size, alignof(std::max_align_t));
+        }
+    }
+
+    void* Arena::allocate_slow(size_t bytes, size_t alignment) {
+        if (cursor_) {
+            used_before_current_ += static_cast<size_t>(cursor_ - blocks_[current_].data);
+            current_++;
+        }
+        // The next retained block, or a new one in front of it if it is too small
+        const size_t needed = bytes + (alignment > alignof(std::max_align_t) ? alignment : 0);
+        if (current_ >= blocks_.size() || blocks_[current_].size < needed) {
+            const size_t size = std::max(options_.block_bytes, needed);
+            Block block{static_cast<char*>(upstream_->allocate(size, alignof(std::max_align_t))), size};
+            blocks_.insert(blocks_.begin() + static_cast<std::ptrdiff_t>(current_), block);
+            stats_.upstream_allocations++;
+            stats_.bytes_reserved += size;
+        }
+        cursor_ = blocks_[current_].data;
+        end_ = cursor_ + blocks_[current_].size;
+        return allocate(bytes, alignment);
+    }
+
+    void Arena::reset() {
+        size_t retained = 0;
+        size_t kept = 0;
+        for (const Block& block : blocks_) {
+            if (retained + block.size <= options_.max_retained_bytes) {
+                blocks_[kept++] = block;
+                retained += block.size;
+            } else {
+                upstream_->deallocate(block.data, block.size, alignof(std::max_align_t));
+                stats_.bytes_reserved -= block.size;
+            }
+        }
+        blocks_.resize(kept);
+        current_ = 0;
+        used_before_current_ = 0;
+        cursor_ = blocks_.empty() ? nullptr : blocks_[0].data;
+        end_ = blocks_.empty() ? nullptr : cursor_ + blocks_[0].size;
+        stats_.resets++;
+    }
+
+    ArenaStats Arena::stats() const {
+        ArenaStats stats = stats_;
+        stats.bytes_used = used_before_current_ + (cursor_ ? static_cast<size_t>(cursor_ - blocks_[current_].data) : 0);
+        return stats;
+    }
+
+}
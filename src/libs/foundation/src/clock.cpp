@@ -0,0 +1,63 @@
+#include "foundation/clock.h"
+#include <cmath>
+#include <thread>
+
+#if FOUNDATION_HAS_RDTSC && !defined(_MSC_VER)
+#include <cpuid.h>
+#endif
+
+namespace foundation {
+
+    namespace {
+        bool has_invariant_tsc() {
+#if FOUNDATION_HAS_RDTSC
+            unsigned int regs[4] = {};
+#if defined(_MSC_VER)
+            __cpuid(reinterpret_cast<int*>(regs), 0x80000000);
+            if (regs[0] < 0x80000007) {
+                return false;
+            }
+            __cpuid(reinterpret_cast<int*>(regs), 0x80000007);
+#else
+            if (__get_cpuid_max(0x80000000, nullptr) < 0x80000007) {
+                return false;
+            }
+            __get_cpuid(0x80000007, &regs[0], &regs[1], &regs[2], &regs[3]);
+#endif
+            return (regs[3] & (1u << 8)) != 0;  // EDX bit 8: TSC runs at a constant rate in all states
+#else
+            return false;
+#endif
+        }
+    }
+
+    TscCalibration calibrate_tsc(std::chrono::microseconds window) {
+        TscCalibration calibration;
+#if FOUNDATION_HAS_RDTSC
+        if (!has_invariant_tsc()) {
+            return calibration;
+        }
+        using std::chrono::steady_clock;
+        const auto start = steady_clock::now();
+        const uint64_t start_ticks = __rdtsc();
+        while (steady_clock::now() - start < window) {
+            std::this_thread::yield();
+        }
+        const uint64_t end_ticks = __rdtsc();
+        const auto end = steady_clock::now();
+
+        const double ns = std::chrono::duration<double, std::nano>(end - start).count();
+        const double ticks_per_ns = static_cast<double>(end_ticks - start_ticks) / ns;
+        if (!(ticks_per_ns >= 1.0) || !std::isfinite(ticks_per_ns)) {
+            return calibration;     // Below 1 GHz the TSC is no finer than steady_clock, and to_ns() assumes it
+        }
+        calibration.tsc = true;
+        calibration.ticks_per_ns = ticks_per_ns;
+        calibration.ns_per_tick_q32 = static_cast<uint64_t>(std::llround(4294967296.0 / ticks_per_ns));
+#else
+        (void)window;
+#endif
+        return calibration;
+    }
+
+}
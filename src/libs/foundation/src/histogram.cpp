@@ -0,0 +1,109 @@
+#include "foundation/histogram.h"
+#include <fmt/format.h>
+#include <cmath>
+
+namespace foundation {
+
+    void Histogram::merge(const Histogram& other) {
+        for (size_t i = 0; i < BUCKETS; ++i) {
+            counts_[i] += other.counts_[i];
+        }
+        total_ += other.total_;
+        sum_ += other.sum_;
+        min_ = std::min(min_, other.min_);
+        max_ = std::max(max_, other.max_);
+    }
+
+    void Histogram::reset() {
+        *this = Histogram();
+    }
+
+    uint64_t Histogram::percentile(double p) const {
+        if (total_ == 0) {
+            return 0;
+        }
+        const auto rank = std::max<uint64_t>(
+            static_cast<uint64_t>(std::ceil(p / 100.0 * static_cast<double>(total_))), 1);
+        uint64_t seen = 0;
+        for (size_t i = 0; i < BUCKETS; ++i) {
+            seen += counts_[i];
+            if (seen >= rank) {
+                return std::min(bucket_upper_bound(i), max_);
+            }
+        }
+        return max_;
+    }
+
+    uint64_t Histogram::count_at_or_below(uint64_t value) const {
+        uint64_t seen = 0;
+        for (size_t i = 0; i < BUCKETS && bucket_upper_bound(i) <= value; ++i) {
+            seen += counts_[i];
+        }
+        return seen;
+    }
+
+    LatencySummary Histogram::summary() const {
+        LatencySummary summary;
+        summary.count = count();
+        summary.min = min();
+        summary.max = max();
+        summary.mean = mean();
+        summary.p50 = percentile(50);
+        summary.p90 = percentile(90);
+        summary.p99 = percentile(99);
+        summary.p999 = percentile(99.9);
+        return summary;
+    }
+
+    uint64_t Histogram::bucket_upper_bound(size_t index) {
+        if (index < SUB_BUCKETS) {
+            return index;
+        }
+        const size_t shift = index / SUB_BUCKETS - 1;
+        const uint64_t lower = (SUB_BUCKETS + index % SUB_BUCKETS) << shift;
+        return lower + (uint64_t(1) << shift) - 1;
+    }
+
+    namespace {
+        std::string format_ns(double ns) {
+            if (ns < 1e3) {
+                return fmt::format("{:.0f}ns", ns);
+            }
+            if (ns < 1e6) {
+                return fmt::format("{:.1f}us", ns / 1e3);
+            }
+            if (ns < 1e9) {
+                return fmt::format("{:.1f}ms", ns / 1e6);
+            }
+            return fmt::format("{:.2f}s", ns / 1e9);
+        }
+    }
+
+    std::string format_latency(const LatencySummary& summary) {
+        if (summary.count == 0) {
+            return "no samples";
+        }
+        return fmt::format("n {} p50 {} p90 {} p99 {} p99.9 {} max {}", summary.count,
+                           format_ns(static_cast<double>(summary.p50)), format_ns(static_cast<double>(summary.p90)),
+                           format_ns(static_cast<double>(summary.p99)), format_ns(static_cast<double>(summary.p999)),
+                           format_ns(static_cast<double>(summary.max)));
+    }
+
+    Histogram LatencyRecorder::snapshot() const {
+        Histogram histogram;
+        shards_.for_each([&histogram](const detail::LatencyShard& shard) {
+            // The total is summed from the buckets so percentiles stay
+            // consistent while the owner keeps recording
+            for (size_t i = 0; i < Histogram::BUCKETS; ++i) {
+                const uint64_t count = shard.counts[i].load(std::memory_order_relaxed);
+                histogram.counts_[i] += count;
+                histogram.total_ += count;
+            }
+            histogram.sum_ += shard.sum.load(std::memory_order_relaxed);
+            histogram.min_ = std::min(histogram.min_, shard.min.load(std::memory_order_relaxed));
+            histogram.max_ = std::max(histogram.max_, shard.max.load(std::memory_order_relaxed));
+        });
+        return histogram;
+    }
+
+}
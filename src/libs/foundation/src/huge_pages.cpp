@@ -0,0 +1,168 @@
+#include "foundation/huge_pages.h"
+#include <spdlog/spdlog.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <mutex>
+#include <new>
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace foundation {
+
+    namespace {
+        std::atomic<std::pmr::memory_resource*> process_region{nullptr};
+
+#ifndef _WIN32
+        // A regular mapping trimmed to start on a 2 MiB boundary, so the
+        // kernel can back it with transparent huge pages
+        char* map_aligned(size_t bytes) {
+            const size_t padded = bytes + HugePageRegion::HUGE_PAGE_SIZE;
+            void* p = ::mmap(nullptr, padded, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (p == MAP_FAILED) {
+                return nullptr;
+            }
+            char* raw = static_cast<char*>(p);
+            const uintptr_t mask = HugePageRegion::HUGE_PAGE_SIZE - 1;
+            char* aligned = reinterpret_cast<char*>((reinterpret_cast<uintptr_t>(raw) + mask) & ~mask);
+            if (aligned > raw) {
+                ::munmap(raw, static_cast<size_t>(aligned - raw));
+            }
+            if (char* end = aligned + bytes; end < raw + padded) {
+                ::munmap(end, static_cast<size_t>(raw + padded - end));
+            }
+            return aligned;
+        }
+#endif
+    }
+
+    const char* to_string(PageBacking backing) {
+        switch (backing) {
+        case PageBacking::HugeTlb:
+            return "hugetlb";
+        case PageBacking::TransparentHuge:
+            return "transparent";
+        case PageBacking::Regular:
+            break;
+        }
+        return "regular";
+    }
+
+    HugePageRegion::HugePageRegion(HugePageOptions options) {
+        const size_t bytes = (std::max<size_t>(options.bytes, 1) + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+#ifndef _WIN32
+#ifdef MAP_HUGETLB
+        // Reserved from the hugetlb pool up front; fails at once if it is short
+        void* p = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | (options.prefault ? MAP_POPULATE : 0), -1, 0);
+        if (p != MAP_FAILED) {
+            base_ = static_cast<char*>(p);
+            backing_ = PageBacking::HugeTlb;
+        }
+#endif
+        if (!base_ && options.allow_fallback) {
+            base_ = map_aligned(bytes);
+#ifdef MADV_HUGEPAGE
+            if (base_ && ::madvise(base_, bytes, MADV_HUGEPAGE) == 0) {
+                backing_ = PageBacking::TransparentHuge;
+            }
+#endif
+            if (base_ && options.prefault) {
+                // One write per 4 KiB page; under THP the first write to each
+                // 2 MiB extent faults in a huge page when one is available
+                const auto page = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+                for (size_t offset = 0; offset < bytes; offset += page) {
+                    static_cast<volatile char*>(base_)[offset] = 0;
+                }
+            }
+        }
+        if (!base_) {
+            spdlog::warn("Could not map {} MiB for the huge page region: {}", bytes >> 20, std::strerror(errno));
+            return;
+        }
+        bytes_ = bytes;
+        if (options.lock) {
+            if (::mlock(base_, bytes_) == 0) {
+                locked_ = true;
+            } else {
+                spdlog::warn("Could not lock the huge page region: {} (raise RLIMIT_MEMLOCK)", std::strerror(errno));
+            }
+        }
+#else
+        if (options.allow_fallback) {
+            base_ = static_cast<char*>(::operator new(bytes, std::align_val_t(HUGE_PAGE_SIZE), std::nothrow));
+            if (base_ && options.prefault) {
+                std::memset(base_, 0, bytes);
+            }
+            bytes_ = base_ ? bytes : 0;
+        }
+#endif
+    }
+
+    HugePageRegion::~HugePageRegion() {
+        if (!base_) {
+            return;
+        }
+#ifndef _WIN32
+        ::munmap(base_, bytes_);
+#else
+        ::operator delete(base_, std::align_val_t(HUGE_PAGE_SIZE));
+#endif
+    }
+
+    HugePageStats HugePageRegion::stats() const {
+        HugePageStats stats;
+        stats.backing = backing_;
+        stats.bytes_reserved = bytes_;
+        stats.bytes_used = std::min(used_.load(std::memory_order_relaxed), bytes_);
+        stats.fallback_bytes = fallback_bytes_.load(std::memory_order_relaxed);
+        stats.locked = locked_;
+        return stats;
+    }
+
+    void* HugePageRegion::do_allocate(size_t bytes, size_t alignment) {
+        size_t used = used_.load(std::memory_order_relaxed);
+        while (base_) {
+            const uintptr_t start = reinterpret_cast<uintptr_t>(base_) + used;
+            const size_t offset = ((start + alignment - 1) & ~(alignment - 1)) - reinterpret_cast<uintptr_t>(base_);
+            if (offset + bytes > bytes_) {
+                break;
+            }
+            if (used_.compare_exchange_weak(used, offset + bytes, std::memory_order_relaxed)) {
+                return base_ + offset;
+            }
+        }
+        fallback_bytes_.fetch_add(bytes, std::memory_order_relaxed);
+        return ::operator new(bytes, std::align_val_t(alignment));
+    }
+
+    void HugePageRegion::do_deallocate(void* p, size_t bytes, size_t alignment) {
+        if (!contains(p)) {
+            ::operator delete(p, bytes, std::align_val_t(alignment));
+        }
+    }
+
+    HugePageStats enable_huge_pages(HugePageOptions options) {
+        // Never destroyed: pools keep chunks from it for the life of the process
+        static HugePageRegion* region = nullptr;
+        static std::once_flag once;
+        std::call_once(once, [&options] {
+            region = new HugePageRegion(options);
+            if (region->valid()) {
+                process_region.store(region, std::memory_order_release);
+            }
+            const HugePageStats stats = region->stats();
+            spdlog::info("Huge page region: {} MiB of {} pages, {}prefaulted, {}", stats.bytes_reserved >> 20,
+                         to_string(stats.backing), options.prefault ? "" : "not ", stats.locked ? "locked" : "unlocked");
+        });
+        return region->stats();
+    }
+
+    std::pmr::memory_resource* huge_page_resource() {
+        std::pmr::memory_resource* region = process_region.load(std::memory_order_acquire);
+        return region ? region : std::pmr::new_delete_resource();
+    }
+
+}
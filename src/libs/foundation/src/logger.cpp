@@ -1,9 +1,233 @@
 #include "foundation/logger.h"
-#include <spdlog/spdlog.h>
+#include <algorithm>
+#include <bit>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 namespace foundation {
     void init_logger() {
         spdlog::set_level(spdlog::level::info);
         spdlog::info("Logger initialized");
     }
+
+    namespace detail {
+        std::atomic<bool> async_running{false};
+        std::atomic<uint32_t> max_per_second{0};
+
+        LogBuffer::LogBuffer(size_t capacity) {
+            capacity = std::bit_ceil(std::max<size_t>(capacity, 4096));
+            data_ = new char[capacity];
+            mask_ = capacity - 1;
+        }
+
+        LogBuffer::~LogBuffer() {
+            delete[] data_;
+        }
+    }
+
+    namespace {
+        using detail::LogBuffer;
+        using detail::RecordHeader;
+
+        struct Backend {
+            std::mutex mutex;
+            std::vector<std::shared_ptr<LogBuffer>> buffers;   // Guarded by mutex
+            AsyncLoggerOptions options;
+            std::thread thread;
+            std::atomic<bool> stopping{false};
+
+            std::atomic<uint64_t> records{0};
+            std::atomic<uint64_t> suppressed{0};
+            std::atomic<uint64_t> dropped{0};    // From buffers already freed
+
+            std::mutex flush_mutex;
+            std::condition_variable flushed;
+            uint64_t passes = 0;                // Completed drain passes; guarded by flush_mutex
+            bool finished = false;              // Guarded by flush_mutex
+
+            size_t drain();
+            void run();
+        };
+
+        // Never destroyed: threads may still log while statics are torn down
+        Backend& backend = *new Backend;
+
+        // Keeps the buffer alive for the backend after the thread exits
+        struct ThreadBuffer {
+            std::shared_ptr<LogBuffer> buffer;
+            ~ThreadBuffer() {
+                if (buffer) {
+                    detail::current_buffer = nullptr;
+                    buffer->retired.store(true, std::memory_order_release);
+                }
+            }
+        };
+
+        thread_local ThreadBuffer thread_buffer_holder;
+
+        struct Pending {
+            const RecordHeader* header;
+            const char* args;
+        };
+
+        // One pass over every buffer: what is there now is formatted in
+        // timestamp order, then handed to spdlog
+        size_t Backend::drain() {
+            std::vector<std::shared_ptr<LogBuffer>> snapshot;
+            {
+                std::lock_guard lock(mutex);
+                snapshot = buffers;
+            }
+
+            static thread_local std::vector<Pending> pending;
+            static thread_local std::vector<std::pair<LogBuffer*, uint64_t>> ends;
+            pending.clear();
+            ends.clear();
+            for (const auto& buffer : snapshot) {
+                const uint64_t head = buffer->head();
+                uint64_t position = buffer->tail();
+                while (position < head) {
+                    uint32_t size;
+                    std::memcpy(&size, buffer->at(position), sizeof(size));
+                    if (size & LogBuffer::PADDING) {
+                        position += size & ~LogBuffer::PADDING;
+                        continue;
+                    }
+                    const char* record = buffer->at(position);
+                    pending.push_back({reinterpret_cast<const RecordHeader*>(record), record + sizeof(RecordHeader)});
+                    position += size;
+                }
+                ends.emplace_back(buffer.get(), head);
+            }
+            std::stable_sort(pending.begin(), pending.end(), [](const Pending& a, const Pending& b) {
+                return a.header->timestamp_ns < b.header->timestamp_ns;
+            });
+
+            spdlog::logger* logger = spdlog::default_logger_raw();
+            fmt::memory_buffer text;
+            for (const Pending& p : pending) {
+                const RecordHeader& header = *p.header;
+                text.clear();
+                header.decode(p.args, header.site->format, text);
+                if (header.suppressed) {
+                    fmt::format_to(std::back_inserter(text), " ({} similar messages suppressed)", header.suppressed);
+                    suppressed.fetch_add(header.suppressed, std::memory_order_relaxed);
+                }
+                const spdlog::log_clock::time_point time{std::chrono::duration_cast<spdlog::log_clock::duration>(
+                    std::chrono::nanoseconds(header.timestamp_ns))};
+                logger->log(time, spdlog::source_loc{header.site->file, header.site->line, ""}, header.site->level,
+                            spdlog::string_view_t(text.data(), text.size()));
+            }
+            records.fetch_add(pending.size(), std::memory_order_relaxed);
+            for (const auto& [buffer, end] : ends) {
+                buffer->release(end);
+            }
+
+            // Buffers of exited threads go once they are empty
+            std::lock_guard lock(mutex);
+            std::erase_if(buffers, [this](const std::shared_ptr<LogBuffer>& buffer) {
+                if (buffer->retired.load(std::memory_order_acquire) && buffer->tail() == buffer->head()) {
+                    dropped.fetch_add(buffer->dropped.load(std::memory_order_relaxed), std::memory_order_relaxed);
+                    return true;
+                }
+                return false;
+            });
+            return pending.size();
+        }
+
+        void Backend::run() {
+            while (true) {
+                const bool stop = stopping.load(std::memory_order_acquire);
+                const size_t written = drain();
+                {
+                    std::lock_guard lock(flush_mutex);
+                    passes++;
+                }
+                flushed.notify_all();
+                if (stop) {
+                    break;
+                }
+                if (written == 0) {
+                    std::this_thread::sleep_for(options.idle_sleep);
+                }
+            }
+            spdlog::default_logger_raw()->flush();
+            {
+                std::lock_guard lock(flush_mutex);
+                finished = true;
+            }
+            flushed.notify_all();
+        }
+    }
+
+    namespace detail {
+        LogBuffer* register_thread_buffer() {
+            auto& holder = thread_buffer_holder;
+            if (!holder.buffer) {
+                holder.buffer = std::make_shared<LogBuffer>(backend.options.buffer_bytes);
+                std::lock_guard lock(backend.mutex);
+                backend.buffers.push_back(holder.buffer);
+            }
+            current_buffer = holder.buffer.get();
+            return current_buffer;
+        }
+    }
+
+    void start_async_logger(AsyncLoggerOptions options) {
+        if (backend.thread.joinable()) {
+            return;
+        }
+        backend.options = options;
+        backend.stopping.store(false);
+        backend.finished = false;
+        detail::max_per_second.store(options.max_per_second, std::memory_order_relaxed);
+        backend.thread = std::thread([] { backend.run(); });
+        detail::async_running.store(true, std::memory_order_release);
+    }
+
+    void stop_async_logger() {
+        if (!backend.thread.joinable()) {
+            return;
+        }
+        // A call that saw the backend running may still be writing its
+        // record; wait for it, so the final pass below picks it up
+        detail::async_running.store(false, std::memory_order_seq_cst);
+        {
+            std::lock_guard lock(backend.mutex);
+            for (const auto& buffer : backend.buffers) {
+                while (buffer->writing.load(std::memory_order_acquire)) {
+                    std::this_thread::yield();
+                }
+            }
+        }
+        backend.stopping.store(true, std::memory_order_release);
+        backend.thread.join();
+    }
+
+    void flush_async_logger() {
+        if (!backend.thread.joinable()) {
+            return;
+        }
+        // A pass that starts after this call sees every record already committed
+        std::unique_lock lock(backend.flush_mutex);
+        const uint64_t target = backend.passes + 2;
+        backend.flushed.wait(lock, [&] { return backend.passes >= target || backend.finished; });
+        lock.unlock();
+        spdlog::default_logger_raw()->flush();
+    }
+
+    AsyncLoggerStats async_logger_stats() {
+        AsyncLoggerStats stats;
+        stats.records = backend.records.load(std::memory_order_relaxed);
+        stats.suppressed = backend.suppressed.load(std::memory_order_relaxed);
+        stats.dropped = backend.dropped.load(std::memory_order_relaxed);
+        std::lock_guard lock(backend.mutex);
+        for (const auto& buffer : backend.buffers) {
+            stats.dropped += buffer->dropped.load(std::memory_order_relaxed);
+        }
+        return stats;
+    }
 }
@@ -0,0 +1,183 @@
+#include "foundation/metrics.h"
+#include <fmt/format.h>
+#include <spdlog/spdlog.h>
+#include <cmath>
+
+namespace foundation {
+
+    uint64_t Counter::value() const {
+        uint64_t total = 0;
+        shards_.for_each([&total](const detail::CounterShard& shard) {
+            total += shard.value.load(std::memory_order_relaxed);
+        });
+        return total;
+    }
+
+    int64_t Gauge::value() const {
+        int64_t total = 0;
+        shards_.for_each([&total](const detail::GaugeShard& shard) {
+            total += shard.value.load(std::memory_order_relaxed);
+        });
+        return total;
+    }
+
+    namespace {
+        const char* type_name(int type) {
+            static const char* const names[] = {"counter", "gauge", "histogram"};
+            return names[type];
+        }
+
+        void escape(std::string& out, std::string_view text, bool quotes) {
+            for (char c : text) {
+                if (c == '\\') {
+                    out += "\\\\";
+                } else if (c == '\n') {
+                    out += "\\n";
+                } else if (c == '"' && quotes) {
+                    out += "\\\"";
+                } else {
+                    out += c;
+                }
+            }
+        }
+
+        std::string render_labels(const MetricLabels& labels) {
+            std::string out;
+            for (const auto& [key, value] : labels) {
+                if (!out.empty()) {
+                    out += ',';
+                }
+                out += key;
+                out += "=\"";
+                escape(out, value, true);
+                out += '"';
+            }
+            return out;
+        }
+
+        // name{labels,extra} or name{extra} or name
+        void series(std::string& out, std::string_view name, std::string_view suffix, const std::string& labels,
+                    std::string_view extra = {}) {
+            out += name;
+            out += suffix;
+            if (labels.empty() && extra.empty()) {
+                out += ' ';
+                return;
+            }
+            out += '{';
+            out += labels;
+            if (!labels.empty() && !extra.empty()) {
+                out += ',';
+            }
+            out += extra;
+            out += "} ";
+        }
+    }
+
+    MetricsRegistry::MetricsRegistry() = default;
+    MetricsRegistry::~MetricsRegistry() = default;
+
+    MetricsRegistry::Metric& MetricsRegistry::find_or_add(Type type, std::string_view name, std::string_view help,
+                                                          const MetricLabels& labels) {
+        auto metric = std::make_unique<Metric>();
+        metric->labels = render_labels(labels);
+        switch (type) {
+        case Type::Counter:
+            metric->counter = std::make_unique<Counter>();
+            break;
+        case Type::Gauge:
+            metric->gauge = std::make_unique<Gauge>();
+            break;
+        case Type::Histogram:
+            metric->histogram = std::make_unique<LatencyRecorder>(std::string(name));
+            break;
+        }
+
+        std::lock_guard lock(mutex_);
+        auto it = families_.find(name);
+        if (it == families_.end()) {
+            it = families_.emplace(std::string(name), Family{type, std::string(help), {}}).first;
+        } else if (it->second.type != type) {
+            // Still hand out a working metric so the caller need not check
+            spdlog::warn("metric {} is already registered as a {}; not exporting the {}", name,
+                         type_name(static_cast<int>(it->second.type)), type_name(static_cast<int>(type)));
+            return *unexported_.emplace_back(std::move(metric));
+        }
+        for (auto& existing : it->second.metrics) {
+            if (existing->labels == metric->labels) {
+                return *existing;
+            }
+        }
+        return *it->second.metrics.emplace_back(std::move(metric));
+    }
+
+    Counter& MetricsRegistry::counter(std::string_view name, std::string_view help, const MetricLabels& labels) {
+        return *find_or_add(Type::Counter, name, help, labels).counter;
+    }
+
+    Gauge& MetricsRegistry::gauge(std::string_view name, std::string_view help, const MetricLabels& labels) {
+        return *find_or_add(Type::Gauge, name, help, labels).gauge;
+    }
+
+    LatencyRecorder& MetricsRegistry::histogram(std::string_view name, std::string_view help,
+                                                const MetricLabels& labels) {
+        return *find_or_add(Type::Histogram, name, help, labels).histogram;
+    }
+
+    const std::vector<double>& MetricsRegistry::histogram_bounds() {
+        static const std::vector<double> bounds = {
+            1e-6, 2.5e-6, 5e-6, 1e-5, 2.5e-5, 5e-5, 1e-4, 2.5e-4, 5e-4, 1e-3, 2.5e-3,
+            5e-3, 1e-2, 2.5e-2, 5e-2, 0.1, 0.25, 0.5, 1, 2.5, 5, 10,
+        };
+        return bounds;
+    }
+
+    std::string MetricsRegistry::render_prometheus() const {
+        std::string out;
+        std::lock_guard lock(mutex_);
+        for (const auto& [name, family] : families_) {
+            out += "# HELP ";
+            out += name;
+            out += ' ';
+            escape(out, family.help, false);
+            out += "\n# TYPE ";
+            out += name;
+            out += ' ';
+            out += type_name(static_cast<int>(family.type));
+            out += '\n';
+
+            for (const auto& metric : family.metrics) {
+                if (metric->counter) {
+                    series(out, name, "", metric->labels);
+                    out += fmt::format("{}\n", metric->counter->value());
+                } else if (metric->gauge) {
+                    series(out, name, "", metric->labels);
+                    out += fmt::format("{}\n", metric->gauge->value());
+                } else {
+                    // Bucket bounds fall inside the recorder's log-linear
+                    // buckets, so counts are accurate to its ~1.6% resolution
+                    const Histogram histogram = metric->histogram->snapshot();
+                    for (double bound : histogram_bounds()) {
+                        series(out, name, "_bucket", metric->labels, fmt::format("le=\"{}\"", bound));
+                        const auto ns = static_cast<uint64_t>(std::llround(bound * 1e9));
+                        out += fmt::format("{}\n", histogram.count_at_or_below(ns));
+                    }
+                    series(out, name, "_bucket", metric->labels, "le=\"+Inf\"");
+                    out += fmt::format("{}\n", histogram.count());
+                    series(out, name, "_sum", metric->labels);
+                    out += fmt::format("{}\n", static_cast<double>(histogram.sum()) / 1e9);
+                    series(out, name, "_count", metric->labels);
+                    out += fmt::format("{}\n", histogram.count());
+                }
+            }
+        }
+        return out;
+    }
+
+    MetricsRegistry& metrics() {
+        // Leaked: worker threads may still record while statics are destroyed
+        static MetricsRegistry& registry = *new MetricsRegistry;
+        return registry;
+    }
+
+}
@@ -0,0 +1,151 @@
+#include "foundation/object_pool.h"
+#include "foundation/huge_pages.h"
+#include <array>
+#include <bit>
+
+namespace foundation {
+
+    namespace {
+        constexpr size_t CHUNK_BATCHES = 4;     // Batches carved from one upstream allocation
+    }
+
+    PoolDepot::PoolDepot(size_t block_size, size_t block_align)
+        : block_size_(block_size),
+          block_align_(block_align),
+          batch_(std::clamp<size_t>(16 * 1024 / block_size, 4, 64)) {}
+
+    void* PoolDepot::refill(Cache& cache) {
+        cache.depot = this;
+        {
+            std::lock_guard lock(mutex_);
+            if (!batches_.empty()) {
+                cache.head = batches_.back();
+                cache.count = batch_;
+                batches_.pop_back();
+            } else if (loose_) {
+                // Up to one batch of what exited threads left behind
+                FreeBlock* last = loose_;
+                size_t taken = 1;
+                while (taken < batch_ && last->next) {
+                    last = last->next;
+                    taken++;
+                }
+                cache.head = loose_;
+                cache.count = taken;
+                loose_ = last->next;
+                loose_count_ -= taken;
+                last->next = nullptr;
+            } else {
+                const size_t bytes = CHUNK_BATCHES * batch_ * block_size_;
+                char* chunk = static_cast<char*>(huge_page_resource()->allocate(bytes, block_align_));
+                stats_.chunks++;
+                stats_.bytes_reserved += bytes;
+                for (size_t b = 0; b < CHUNK_BATCHES; ++b) {
+                    char* first = chunk + b * batch_ * block_size_;
+                    for (size_t i = 0; i < batch_; ++i) {
+                        auto* block = reinterpret_cast<FreeBlock*>(first + i * block_size_);
+                        block->next = i + 1 < batch_ ? reinterpret_cast<FreeBlock*>(first + (i + 1) * block_size_)
+                                                     : nullptr;
+                    }
+                    if (b == 0) {
+                        cache.head = reinterpret_cast<FreeBlock*>(first);
+                        cache.count = batch_;
+                    } else {
+                        batches_.push_back(reinterpret_cast<FreeBlock*>(first));
+                    }
+                }
+            }
+        }
+        FreeBlock* block = cache.head;
+        cache.head = block->next;
+        cache.count--;
+        return block;
+    }
+
+    void PoolDepot::drain(Cache& cache) {
+        FreeBlock* first = cache.head;
+        FreeBlock* last = first;
+        for (size_t i = 1; i < batch_; ++i) {
+            last = last->next;
+        }
+        cache.head = last->next;
+        cache.count -= batch_;
+        last->next = nullptr;
+        std::lock_guard lock(mutex_);
+        batches_.push_back(first);
+    }
+
+    void PoolDepot::release_all(Cache& cache) {
+        if (!cache.head) {
+            return;
+        }
+        FreeBlock* last = cache.head;
+        while (last->next) {
+            last = last->next;
+        }
+        std::lock_guard lock(mutex_);
+        last->next = loose_;
+        loose_ = cache.head;
+        loose_count_ += cache.count;
+        cache.head = nullptr;
+        cache.count = 0;
+    }
+
+    PoolStats PoolDepot::stats() const {
+        std::lock_guard lock(mutex_);
+        PoolStats stats = stats_;
+        stats.blocks_in_depot = batches_.size() * batch_ + loose_count_;
+        return stats;
+    }
+
+    namespace {
+        constexpr size_t MIN_POOLED = 16;
+        constexpr size_t MAX_POOLED = 1024;
+
+        struct SizeClass {
+            void* (*allocate)();
+            void (*deallocate)(void*);
+        };
+
+        template <size_t... Shifts>
+        constexpr std::array<SizeClass, sizeof...(Shifts)> make_classes(std::index_sequence<Shifts...>) {
+            return {SizeClass{&FixedPool<MIN_POOLED << Shifts, MIN_POOLED>::allocate,
+                              &FixedPool<MIN_POOLED << Shifts, MIN_POOLED>::deallocate}...};
+        }
+
+        // 16, 32, ... 1024 bytes
+        constexpr auto size_classes = make_classes(std::make_index_sequence<7>());
+
+        size_t class_of(size_t bytes) {
+            return static_cast<size_t>(std::bit_width(std::max(bytes, MIN_POOLED) - 1)) - 4;
+        }
+
+        class PoolResource : public std::pmr::memory_resource {
+        protected:
+            void* do_allocate(size_t bytes, size_t alignment) override {
+                if (bytes > MAX_POOLED || alignment > MIN_POOLED) {
+                    return ::operator new(bytes, std::align_val_t(alignment));
+                }
+                return size_classes[class_of(bytes)].allocate();
+            }
+
+            void do_deallocate(void* p, size_t bytes, size_t alignment) override {
+                if (bytes > MAX_POOLED || alignment > MIN_POOLED) {
+                    ::operator delete(p, bytes, std::align_val_t(alignment));
+                    return;
+                }
+                size_classes[class_of(bytes)].deallocate(p);
+            }
+
+            bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+                return this == &other;
+            }
+        };
+    }
+
+    std::pmr::memory_resource* pool_resource() {
+        static PoolResource resource;
+        return &resource;
+    }
+
+}
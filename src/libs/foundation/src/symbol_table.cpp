@@ -0,0 +1,56 @@
+#include "foundation/symbol_table.h"
+#include <cstring>
+#include <mutex>
+
+namespace foundation {
+
+    SymbolTable::SymbolTable() : chunks_(std::make_unique<std::atomic<std::string_view*>[]>(MAX_SYMBOLS / CHUNK_SIZE)) {}
+
+    SymbolTable::~SymbolTable() {
+        for (size_t i = 0; i < MAX_SYMBOLS / CHUNK_SIZE; ++i) {
+            delete[] chunks_[i].load(std::memory_order_relaxed);
+        }
+    }
+
+    SymbolId SymbolTable::find(std::string_view name) const {
+        std::shared_lock lock(mutex_);
+        auto it = ids_.find(name);
+        return it == ids_.end() ? NO_SYMBOL : it->second;
+    }
+
+    SymbolId SymbolTable::intern(std::string_view name) {
+        if (SymbolId id = find(name); id != NO_SYMBOL) {
+            return id;
+        }
+        std::unique_lock lock(mutex_);
+        if (auto it = ids_.find(name); it != ids_.end()) {
+            return it->second;     // Interned by another thread meanwhile
+        }
+        const uint32_t id = size_.load(std::memory_order_relaxed);
+        if (id == MAX_SYMBOLS) {
+            return NO_SYMBOL;
+        }
+
+        char* bytes = static_cast<char*>(arena_.allocate(name.size(), 1));
+        if (!name.empty()) {
+            std::memcpy(bytes, name.data(), name.size());
+        }
+        const std::string_view stored(bytes, name.size());
+
+        std::atomic<std::string_view*>& chunk = chunks_[id >> CHUNK_BITS];
+        if (!chunk.load(std::memory_order_relaxed)) {
+            chunk.store(new std::string_view[CHUNK_SIZE], std::memory_order_release);
+        }
+        chunk.load(std::memory_order_relaxed)[id & (CHUNK_SIZE - 1)] = stored;
+        ids_.try_emplace(stored, id);
+        size_.store(id + 1, std::memory_order_release);     // Publishes the name to name()
+        return id;
+    }
+
+    SymbolTable& symbols() {
+        // Leaked, like metrics(): ids may be resolved while statics are destroyed
+        static SymbolTable& table = *new SymbolTable;
+        return table;
+    }
+
+}
@@ -0,0 +1,216 @@
+#include "foundation/thread_pool.h"
+#include "foundation/thread_runner.h"
+
+namespace foundation {
+
+    struct ThreadPool::Worker {
+        ThreadPool* pool = nullptr;
+        size_t index = 0;
+        uint64_t rng = 0;   // Victim selection
+        WorkStealingDeque<detail::Task> deque;
+        std::thread thread;
+
+        alignas(64) std::atomic<uint64_t> executed{0};
+        std::atomic<uint64_t> stolen{0};
+        std::atomic<uint64_t> parked{0};
+
+        // Owner-only counters, published with relaxed stores
+        static void bump(std::atomic<uint64_t>& counter) {
+            counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        }
+    };
+
+    thread_local ThreadPool::Worker* ThreadPool::current_worker_ = nullptr;
+
+    namespace {
+        uint64_t next_random(uint64_t& state) {
+            // xorshift64
+            state ^= state << 13;
+            state ^= state >> 7;
+            state ^= state << 17;
+            return state;
+        }
+    }
+
+    ThreadPool::ThreadPool(ThreadPoolOptions options) : options_(options) {
+        const size_t cores = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+        const size_t count = options_.threads ? options_.threads : cores;
+        for (size_t i = 0; i < count; ++i) {
+            auto worker = std::make_unique<Worker>();
+            worker->pool = this;
+            worker->index = i;
+            worker->rng = (i + 1) * 0x9e3779b97f4a7c15ull;
+            workers_.push_back(std::move(worker));
+        }
+        // Started only once every deque exists, since workers steal from all of them
+        for (auto& worker : workers_) {
+            Worker* self = worker.get();
+            self->thread = std::thread([this, self, cores] {
+                if (options_.pin_workers) {
+                    pin_current_thread({static_cast<int>((options_.first_core + self->index) % cores)});
+                }
+                worker_main(self);
+            });
+        }
+    }
+
+    ThreadPool::~ThreadPool() {
+        {
+            std::lock_guard lock(park_mutex_);
+            stopping_ = true;
+        }
+        park_cv_.notify_all();
+        for (auto& worker : workers_) {
+            worker->thread.join();
+        }
+    }
+
+    ThreadPool* ThreadPool::current() {
+        return current_worker_ ? current_worker_->pool : nullptr;
+    }
+
+    ThreadPoolStats ThreadPool::stats() const {
+        ThreadPoolStats stats;
+        for (const auto& worker : workers_) {
+            stats.executed += worker->executed.load(std::memory_order_relaxed);
+            stats.stolen += worker->stolen.load(std::memory_order_relaxed);
+            stats.parked += worker->parked.load(std::memory_order_relaxed);
+        }
+        return stats;
+    }
+
+    void ThreadPool::push(detail::Task* task) {
+        Worker* self = current_worker_;
+        if (self && self->pool == this) {
+            self->deque.push(task);
+        } else {
+            std::lock_guard lock(inject_mutex_);
+            injected_.push_back(task);
+            injected_count_.fetch_add(1, std::memory_order_relaxed);
+        }
+        // Pairs with the seq_cst increment of sleepers_ in worker_main: either
+        // the parking worker's last scan sees this task, or we see it parking
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (sleepers_.load(std::memory_order_relaxed) > 0) {
+            wake_one();
+        }
+    }
+
+    void ThreadPool::wake_one() {
+        {
+            std::lock_guard lock(park_mutex_);
+            if (wake_tokens_ < workers_.size()) {
+                wake_tokens_++;
+            }
+        }
+        park_cv_.notify_one();
+    }
+
+    detail::Task* ThreadPool::find_task(Worker* self) {
+        if (self) {
+            if (detail::Task* task = self->deque.pop()) {
+                return task;
+            }
+        }
+        if (injected_count_.load(std::memory_order_relaxed) > 0) {
+            std::lock_guard lock(inject_mutex_);
+            if (!injected_.empty()) {
+                detail::Task* task = injected_.front();
+                injected_.pop_front();
+                injected_count_.fetch_sub(1, std::memory_order_relaxed);
+                return task;
+            }
+        }
+
+        static thread_local uint64_t outsider_rng = 0x2545f4914f6cdd1dull;
+        const size_t count = workers_.size();
+        const size_t start = next_random(self ? self->rng : outsider_rng) % count;
+        for (size_t i = 0; i < count; ++i) {
+            Worker* victim = workers_[(start + i) % count].get();
+            if (victim == self) {
+                continue;
+            }
+            if (detail::Task* task = victim->deque.steal()) {
+                if (self) {
+                    Worker::bump(self->stolen);
+                }
+                return task;
+            }
+        }
+        return nullptr;
+    }
+
+    void ThreadPool::execute(detail::Task* task) {
+        task->invoke(*task);
+        TaskGroup* group = task->group;
+        delete task;
+        // Last touch of the group: its owner may return from wait() and destroy it
+        if (group) {
+            group->pending_.fetch_sub(1, std::memory_order_release);
+        }
+    }
+
+    bool ThreadPool::run_one() {
+        Worker* self = current_worker_ && current_worker_->pool == this ? current_worker_ : nullptr;
+        detail::Task* task = find_task(self);
+        if (!task) {
+            return false;
+        }
+        execute(task);
+        return true;
+    }
+
+    void ThreadPool::worker_main(Worker* self) {
+        current_worker_ = self;
+        uint32_t idle = 0;
+        while (true) {
+            if (detail::Task* task = find_task(self)) {
+                execute(task);
+                Worker::bump(self->executed);
+                idle = 0;
+                continue;
+            }
+            if (++idle < options_.spin_rounds) {
+                std::this_thread::yield();
+                continue;
+            }
+            idle = 0;
+
+            // Announce before the last scan, so a concurrent push() either
+            // is found here or sees a sleeper and hands out a wake token
+            sleepers_.fetch_add(1, std::memory_order_seq_cst);
+            if (detail::Task* task = find_task(self)) {
+                sleepers_.fetch_sub(1, std::memory_order_relaxed);
+                execute(task);
+                Worker::bump(self->executed);
+                continue;
+            }
+            {
+                std::unique_lock lock(park_mutex_);
+                if (stopping_) {
+                    // Nothing left anywhere: every queued task has run
+                    sleepers_.fetch_sub(1, std::memory_order_relaxed);
+                    break;
+                }
+                Worker::bump(self->parked);
+                park_cv_.wait(lock, [this] { return wake_tokens_ > 0 || stopping_; });
+                if (wake_tokens_ > 0) {
+                    wake_tokens_--;
+                }
+            }
+            sleepers_.fetch_sub(1, std::memory_order_relaxed);
+        }
+        current_worker_ = nullptr;
+    }
+
+    void TaskGroup::wait() {
+        while (pending_.load(std::memory_order_acquire) > 0) {
+            // Help rather than block, so a worker waiting here cannot starve
+            // the tasks it waits for
+            if (!pool_.run_one()) {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+}
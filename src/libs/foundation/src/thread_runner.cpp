@@ -0,0 +1,237 @@
+#include "foundation/thread_runner.h"
+#include "foundation/clock.h"
+#include "foundation/trace.h"
+#include <spdlog/spdlog.h>
+#include <fmt/format.h>
+#include <fmt/ranges.h>
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace foundation {
+
+    namespace {
+#ifdef __linux__
+        constexpr int MAX_CPUS = CPU_SETSIZE;
+#else
+        constexpr int MAX_CPUS = 1024;
+#endif
+
+        inline void cpu_relax() {
+#if FOUNDATION_HAS_RDTSC
+            _mm_pause();
+#elif defined(__aarch64__)
+            asm volatile("yield");
+#endif
+        }
+
+        // Prefer the node's memory for this thread's new pages
+        void prefer_node_memory(int node) {
+#if defined(__linux__) && defined(SYS_set_mempolicy)
+            constexpr int MPOL_PREFERRED = 1;
+            unsigned long mask[16] = {};
+            if (node < 0 || node >= static_cast<int>(sizeof(mask) * 8)) {
+                return;
+            }
+            mask[node / 64] |= 1ul << (node % 64);
+            if (::syscall(SYS_set_mempolicy, MPOL_PREFERRED, mask, sizeof(mask) * 8) != 0) {
+                spdlog::warn("Could not prefer memory of NUMA node {}: {}", node, std::strerror(errno));
+            }
+#else
+            (void)node;
+#endif
+        }
+
+        void set_realtime(int priority) {
+#ifdef __linux__
+            sched_param param{};
+            param.sched_priority = std::clamp(priority, sched_get_priority_min(SCHED_FIFO),
+                                              sched_get_priority_max(SCHED_FIFO));
+            if (int r = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param); r != 0) {
+                spdlog::warn("Could not switch to SCHED_FIFO priority {}: {}", param.sched_priority, std::strerror(r));
+            }
+#else
+            spdlog::warn("Realtime scheduling is not supported on this platform");
+            (void)priority;
+#endif
+        }
+    }
+
+    void place_current_thread(const ThreadRunnerOptions& options) {
+        if (!options.name.empty()) {
+#ifdef __linux__
+            pthread_setname_np(pthread_self(), options.name.substr(0, 15).c_str());
+#endif
+            set_trace_thread_name(options.name);
+        }
+        std::vector<int> cpus = options.cpus;
+        if (options.numa_node >= 0) {
+            const std::vector<int> node = numa_node_cpus(options.numa_node);
+            if (node.empty()) {
+                spdlog::warn("NUMA node {} not found; ignoring it", options.numa_node);
+            } else if (cpus.empty()) {
+                cpus = node;
+            } else {
+                std::vector<int> both;
+                std::sort(cpus.begin(), cpus.end());
+                std::set_intersection(cpus.begin(), cpus.end(), node.begin(), node.end(), std::back_inserter(both));
+                if (both.empty()) {
+                    spdlog::warn("None of CPUs {} is on NUMA node {}; using the CPUs as given",
+                                 fmt::join(cpus, ","), options.numa_node);
+                } else {
+                    cpus = std::move(both);
+                }
+            }
+            prefer_node_memory(options.numa_node);
+        }
+        if (!cpus.empty()) {
+            pin_current_thread(cpus);
+        }
+        if (options.realtime_priority > 0) {
+            set_realtime(options.realtime_priority);
+        }
+    }
+
+    ThreadRunner::ThreadRunner(ThreadRunnerOptions options) : options_(std::move(options)) {
+        options_.min_pause = std::max<uint32_t>(options_.min_pause, 1);
+        options_.max_pause = std::max(options_.max_pause, options_.min_pause);
+    }
+
+    ThreadRunner::~ThreadRunner() {
+        join();
+    }
+
+    void ThreadRunner::run(const Poll& poll) {
+        place_current_thread(options_);
+        const bool block = !options_.busy_poll;
+        uint32_t pause = options_.min_pause;
+        uint64_t idle_streak = 0;
+        uint64_t last = TscClock::ticks();
+        for (;;) {
+            const PollResult result = poll(block);
+            uint64_t now = TscClock::ticks();
+            add(polls_, 1);
+            if (result == PollResult::Worked) {
+                uint64_t waited = 0;
+                if (blocked_ns_) {
+                    const uint64_t elapsed_ns = TscClock::to_ns(now - last);
+                    waited = blocked_ns_ >= elapsed_ns
+                                 ? now - last
+                                 : static_cast<uint64_t>(static_cast<double>(now - last) *
+                                                         static_cast<double>(blocked_ns_) / static_cast<double>(elapsed_ns));
+                    blocked_ns_ = 0;
+                }
+                add(busy_ticks_, now - last - waited);
+                add(idle_ticks_, waited);
+                pause = options_.min_pause;
+                idle_streak = 0;
+            } else {
+                blocked_ns_ = 0;
+                if (result == PollResult::Done) {
+                    add(idle_ticks_, now - last);
+                    return;
+                }
+                add(idle_polls_, 1);
+                if (!block) {
+                    if (options_.yield_after && ++idle_streak >= options_.yield_after) {
+                        std::this_thread::yield();
+                    } else {
+                        for (uint32_t i = 0; i < pause; ++i) {
+                            cpu_relax();
+                        }
+                        pause = pause > options_.max_pause / 2 ? options_.max_pause : pause * 2;
+                    }
+                    now = TscClock::ticks();
+                }
+                add(idle_ticks_, now - last);
+            }
+            last = now;
+        }
+    }
+
+    void ThreadRunner::start(Poll poll) {
+        thread_ = std::thread([this, poll = std::move(poll)] { run(poll); });
+    }
+
+    void ThreadRunner::join() {
+        if (thread_.joinable()) {
+            thread_.join();
+        }
+    }
+
+    ThreadRunnerStats ThreadRunner::stats() const {
+        ThreadRunnerStats stats;
+        stats.polls = polls_.load(std::memory_order_relaxed);
+        stats.idle_polls = idle_polls_.load(std::memory_order_relaxed);
+        stats.busy_ns = TscClock::to_ns(busy_ticks_.load(std::memory_order_relaxed));
+        stats.idle_ns = TscClock::to_ns(idle_ticks_.load(std::memory_order_relaxed));
+        return stats;
+    }
+
+    bool pin_current_thread(const std::vector<int>& cpus) {
+#ifdef __linux__
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        for (int cpu : cpus) {
+            if (cpu >= 0 && cpu < CPU_SETSIZE) {
+                CPU_SET(cpu, &set);
+            }
+        }
+        if (int r = pthread_setaffinity_np(pthread_self(), sizeof(set), &set); r != 0) {
+            spdlog::warn("Could not pin thread to CPUs {}: {}", fmt::join(cpus, ","), std::strerror(r));
+            return false;
+        }
+        return true;
+#else
+        spdlog::warn("Could not pin thread to CPUs {}: not supported on this platform", fmt::join(cpus, ","));
+        return false;
+#endif
+    }
+
+    std::vector<int> numa_node_cpus(int node) {
+        std::ifstream in(fmt::format("/sys/devices/system/node/node{}/cpulist", node));
+        std::string list;
+        std::getline(in, list);
+        return parse_cpu_list(list);
+    }
+
+    std::vector<int> parse_cpu_list(std::string_view list) {
+        std::vector<int> cpus;
+        while (!list.empty()) {
+            const std::string_view item = list.substr(0, list.find(','));
+            list.remove_prefix(std::min(item.size() + 1, list.size()));
+            const size_t dash = item.find('-');
+            int first = -1;
+            int last = -1;
+            const char* end = item.data() + item.size();
+            if (std::from_chars(item.data(), end, first).ec != std::errc()) {
+                continue;
+            }
+            last = first;
+            if (dash != std::string_view::npos &&
+                std::from_chars(item.data() + dash + 1, end, last).ec != std::errc()) {
+                continue;
+            }
+            if (first < 0 || last < first || last >= MAX_CPUS) {
+                spdlog::warn("Ignoring CPU range '{}': CPUs are 0-{}", item, MAX_CPUS - 1);
+                continue;
+            }
+            for (int cpu = first; cpu <= last; ++cpu) {
+                cpus.push_back(cpu);
+            }
+        }
+        std::sort(cpus.begin(), cpus.end());
+        cpus.erase(std::unique(cpus.begin(), cpus.end()), cpus.end());
+        return cpus;
+    }
+
+}
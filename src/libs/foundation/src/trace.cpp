@@ -0,0 +1,425 @@
+#include "foundation/trace.h"
+#include "foundation/huge_pages.h"
+#include <spdlog/spdlog.h>
+#include <fmt/format.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <new>
+#include <thread>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <signal.h>
+#include <unistd.h>
+#endif
+#ifdef __linux__
+#include <sys/syscall.h>
+#endif
+
+namespace foundation {
+
+    namespace {
+        using detail::TraceEvent;
+        using detail::TraceRing;
+
+        constexpr size_t MAX_TRACE_RINGS = 1024;
+
+        // Lock-free so a crash handler can walk it; rings are never freed
+        std::atomic<TraceRing*> rings[MAX_TRACE_RINGS];
+        std::atomic<size_t> ring_count{0};
+
+        // Where threads past MAX_TRACE_RINGS record; never dumped
+        TraceRing& overflow_ring = *new TraceRing;
+
+        // Timestamps in dumps count from here; also calibrates the TSC
+        // before any signal handler needs it
+        const uint64_t trace_epoch = TscClock::ticks();
+
+        uint32_t current_tid() {
+#ifdef __linux__
+            return static_cast<uint32_t>(::syscall(SYS_gettid));
+#else
+            static std::atomic<uint32_t> next{1};
+            return next.fetch_add(1, std::memory_order_relaxed);
+#endif
+        }
+
+        // Hands the ring to the next thread that starts tracing
+        struct ThreadRing {
+            TraceRing* ring = nullptr;
+            ~ThreadRing() {
+                if (ring && ring != &overflow_ring) {
+                    detail::current_trace_ring = nullptr;
+                    ring->in_use.store(false, std::memory_order_release);
+                }
+            }
+        };
+
+        thread_local ThreadRing thread_ring_holder;
+
+        TraceRing* claim_ring() {
+            const size_t count = std::min(ring_count.load(std::memory_order_acquire), MAX_TRACE_RINGS);
+            for (size_t i = 0; i < count; ++i) {
+                TraceRing* ring = rings[i].load(std::memory_order_acquire);
+                bool free = false;
+                if (ring && ring->in_use.compare_exchange_strong(free, true, std::memory_order_acq_rel)) {
+                    // Events of the previous owner are no longer dumped under our tid
+                    ring->start.store(ring->head(), std::memory_order_release);
+                    ring->name[0].store('\0', std::memory_order_relaxed);
+                    return ring;
+                }
+            }
+            const size_t index = ring_count.fetch_add(1, std::memory_order_acq_rel);
+            if (index >= MAX_TRACE_RINGS) {
+                return &overflow_ring;
+            }
+            auto* ring = new (huge_page_resource()->allocate(sizeof(TraceRing), alignof(TraceRing))) TraceRing;
+            ring->in_use.store(true, std::memory_order_relaxed);
+            rings[index].store(ring, std::memory_order_release);
+            return ring;
+        }
+
+        /**
+         * @brief Buffered JSON output to a file descriptor or a string. Uses
+         *        no allocation or locking in fd mode.
+         */
+        class TraceWriter {
+        public:
+            explicit TraceWriter(int fd) : fd_(fd) {}
+            explicit TraceWriter(std::string* out) : out_(out) {}
+            ~TraceWriter() { flush(); }
+
+            void put(char c) {
+                if (len_ == sizeof(buffer_)) {
+                    flush();
+                }
+                buffer_[len_++] = c;
+            }
+
+            void put(const char* s) {
+                while (*s) {
+                    put(*s++);
+                }
+            }
+
+            void put_u64(uint64_t value) {
+                char digits[20];
+                int n = 0;
+                do {
+                    digits[n++] = static_cast<char>('0' + value % 10);
+                    value /= 10;
+                } while (value);
+                while (n) {
+                    put(digits[--n]);
+                }
+            }
+
+            // Nanoseconds as microseconds with three decimals, the unit of "ts" and "dur"
+            void put_us(uint64_t ns) {
+                put_u64(ns / 1000);
+                put('.');
+                const auto frac = static_cast<unsigned>(ns % 1000);
+                put(static_cast<char>('0' + frac / 100));
+                put(static_cast<char>('0' + frac / 10 % 10));
+                put(static_cast<char>('0' + frac % 10));
+            }
+
+            void put_string(const char* s) {
+                put('"');
+                for (; *s; ++s) {
+                    if (*s == '"' || *s == '\\') {
+                        put('\\');
+                    } else if (static_cast<unsigned char>(*s) < 0x20) {
+                        continue;
+                    }
+                    put(*s);
+                }
+                put('"');
+            }
+
+            void flush() {
+                if (out_) {
+                    out_->append(buffer_, len_);
+                } else {
+#ifndef _WIN32
+                    for (size_t done = 0; done < len_ && ok_;) {
+                        const ssize_t n = ::write(fd_, buffer_ + done, len_ - done);
+                        if (n > 0) {
+                            done += static_cast<size_t>(n);
+                        } else if (n < 0 && errno != EINTR) {
+                            ok_ = false;
+                        }
+                    }
+#endif
+                }
+                len_ = 0;
+            }
+
+            bool ok() const { return ok_; }
+
+        private:
+            int fd_ = -1;
+            std::string* out_ = nullptr;
+            bool ok_ = true;
+            size_t len_ = 0;
+            char buffer_[4096];
+        };
+
+        uint64_t since_epoch_ns(uint64_t ticks) {
+            return ticks > trace_epoch ? TscClock::to_ns(ticks - trace_epoch) : 0;
+        }
+
+        void write_header(TraceWriter& out, uint32_t pid, uint32_t tid, bool& first) {
+            out.put(first ? "\n" : ",\n");
+            first = false;
+            out.put("{\"pid\":");
+            out.put_u64(pid);
+            out.put(",\"tid\":");
+            out.put_u64(tid);
+        }
+
+        void write_ring(TraceWriter& out, const TraceRing& ring, uint32_t pid, bool& first) {
+            const uint32_t tid = ring.tid.load(std::memory_order_relaxed);
+            char name[sizeof(ring.name)];
+            for (size_t i = 0; i < sizeof(name); ++i) {
+                name[i] = ring.name[i].load(std::memory_order_relaxed);
+            }
+            name[sizeof(name) - 1] = '\0';
+            if (name[0]) {
+                write_header(out, pid, tid, first);
+                out.put(",\"ph\":\"M\",\"name\":\"thread_name\",\"args\":{\"name\":");
+                out.put_string(name);
+                out.put("}}");
+            }
+
+            // Copy a batch, then re-read the head: a slot the owner may have
+            // started overwriting since is dropped rather than shown torn
+            struct Copy {
+                const char* name;
+                uint64_t begin;
+                uint64_t end;
+            };
+            Copy batch[256];
+            const uint64_t head = ring.head();
+            const uint64_t start = ring.start.load(std::memory_order_acquire);
+            uint64_t index = std::max(start, head > TraceRing::CAPACITY ? head - TraceRing::CAPACITY : 0);
+            while (index < head) {
+                const size_t count = static_cast<size_t>(std::min<uint64_t>(head - index, std::size(batch)));
+                for (size_t i = 0; i < count; ++i) {
+                    const TraceEvent& event = ring.at(index + i);
+                    batch[i] = {event.name.load(std::memory_order_relaxed), event.begin.load(std::memory_order_relaxed),
+                                event.end.load(std::memory_order_relaxed)};
+                }
+                std::atomic_thread_fence(std::memory_order_acquire);
+                const uint64_t now = ring.head();
+                for (size_t i = 0; i < count; ++i) {
+                    const Copy& event = batch[i];
+                    if (index + i + TraceRing::CAPACITY <= now || !event.name || event.end < event.begin) {
+                        continue;
+                    }
+                    const uint64_t begin_ns = since_epoch_ns(event.begin);
+                    write_header(out, pid, tid, first);
+                    out.put(",\"ph\":\"X\",\"name\":");
+                    out.put_string(event.name);
+                    out.put(",\"ts\":");
+                    out.put_us(begin_ns);
+                    out.put(",\"dur\":");
+                    out.put_us(since_epoch_ns(event.end) - begin_ns);
+                    out.put('}');
+                }
+                index += count;
+            }
+        }
+
+        void write_trace_to(TraceWriter& out) {
+#ifndef _WIN32
+            const auto pid = static_cast<uint32_t>(::getpid());
+#else
+            const uint32_t pid = 1;
+#endif
+            out.put("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[");
+            bool first = true;
+            const size_t count = std::min(ring_count.load(std::memory_order_acquire), MAX_TRACE_RINGS);
+            for (size_t i = 0; i < count; ++i) {
+                if (const TraceRing* ring = rings[i].load(std::memory_order_acquire)) {
+                    write_ring(out, *ring, pid, first);
+                }
+            }
+            out.put("\n]}\n");
+        }
+
+#ifndef _WIN32
+        // Set up by install_trace_dumps() so the handlers only copy and write
+        std::string dump_directory;
+        char crash_path[4096];
+        int wake_pipe[2] = {-1, -1};
+        struct sigaction previous[NSIG];
+        std::atomic<bool> crash_dumps{false};
+
+        // The crash handler formats the whole dump on its own stack, which a
+        // stack overflow has used up; it runs on this one instead
+        constexpr size_t ALT_STACK_BYTES = 64 * 1024;
+
+        struct AltStack {
+            char* memory = nullptr;
+            ~AltStack() {
+                if (memory) {
+                    stack_t off{};
+                    off.ss_flags = SS_DISABLE;
+                    ::sigaltstack(&off, nullptr);
+                    delete[] memory;
+                }
+            }
+        };
+
+        thread_local AltStack alt_stack_holder;
+
+        // Leaves an alternate stack someone else set up in place
+        void use_alt_stack() {
+            stack_t current{};
+            if (alt_stack_holder.memory || ::sigaltstack(nullptr, &current) != 0 || !(current.ss_flags & SS_DISABLE)) {
+                return;
+            }
+            auto* memory = new char[ALT_STACK_BYTES];
+            stack_t stack{};
+            stack.ss_sp = memory;
+            stack.ss_size = ALT_STACK_BYTES;
+            if (::sigaltstack(&stack, nullptr) != 0) {
+                delete[] memory;
+                return;
+            }
+            alt_stack_holder.memory = memory;
+        }
+
+        void on_dump_signal(int) {
+            const int saved = errno;
+            const char byte = 1;
+            [[maybe_unused]] ssize_t r = ::write(wake_pipe[1], &byte, 1);
+            errno = saved;
+        }
+
+        void on_crash_signal(int sig) {
+            write_trace(crash_path);
+            // Let the original disposition (normally a core dump) take over
+            ::sigaction(sig, &previous[sig], nullptr);
+            ::raise(sig);
+        }
+
+        void run_dumper() {
+            set_trace_thread_name("trace-dumper");
+            char byte;
+            for (uint64_t n = 0;;) {
+                const ssize_t r = ::read(wake_pipe[0], &byte, 1);
+                if (r < 0 && errno == EINTR) {
+                    continue;
+                }
+                if (r <= 0) {
+                    return;
+                }
+                const std::string path = fmt::format("{}/trace-{}-{}.json", dump_directory, ::getpid(), n++);
+                if (write_trace(path.c_str())) {
+                    spdlog::info("Trace written to {}", path);
+                } else {
+                    spdlog::warn("Could not write trace to {}: {}", path, std::strerror(errno));
+                }
+            }
+        }
+#endif
+    }
+
+    namespace detail {
+        TraceRing* register_trace_ring() {
+            TraceRing* ring = claim_ring();
+            if (ring != &overflow_ring) {
+                ring->tid.store(current_tid(), std::memory_order_relaxed);
+            }
+            current_trace_ring = ring;
+            thread_ring_holder.ring = ring;
+#ifndef _WIN32
+            if (crash_dumps.load(std::memory_order_acquire)) {
+                use_alt_stack();
+            }
+#endif
+            return ring;
+        }
+    }
+
+    void set_trace_thread_name(std::string_view name) {
+        TraceRing& ring = detail::trace_ring();
+        const size_t n = std::min(name.size(), ring.name.size() - 1);
+        for (size_t i = 0; i < ring.name.size(); ++i) {
+            ring.name[i].store(i < n ? name[i] : '\0', std::memory_order_relaxed);
+        }
+    }
+
+    std::string trace_json() {
+        std::string json;
+        {
+            TraceWriter out(&json);
+            write_trace_to(out);
+        }
+        return json;
+    }
+
+    bool write_trace(const char* path) {
+#ifndef _WIN32
+        const int fd = ::open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd < 0) {
+            return false;
+        }
+        bool ok;
+        {
+            TraceWriter out(fd);
+            write_trace_to(out);
+            out.flush();
+            ok = out.ok();
+        }
+        return ::close(fd) == 0 && ok;
+#else
+        (void)path;
+        return false;
+#endif
+    }
+
+    void install_trace_dumps(TraceDumpOptions options) {
+#ifndef _WIN32
+        static std::atomic<bool> installed{false};
+        if (installed.exchange(true)) {
+            spdlog::warn("Trace dumps already installed");
+            return;
+        }
+        dump_directory = options.directory.empty() ? "." : options.directory;
+        fmt::format_to_n(crash_path, sizeof(crash_path) - 1, "{}/trace-{}-crash.json", dump_directory, ::getpid());
+
+        if (options.on_signal) {
+            if (::pipe(wake_pipe) != 0) {
+                spdlog::warn("Trace dumps on SIGUSR2 disabled: {}", std::strerror(errno));
+            } else {
+                std::thread(run_dumper).detach();
+                struct sigaction action {};
+                action.sa_handler = on_dump_signal;
+                action.sa_flags = SA_RESTART;
+                sigemptyset(&action.sa_mask);
+                ::sigaction(SIGUSR2, &action, nullptr);
+            }
+        }
+        if (options.on_crash) {
+            crash_dumps.store(true, std::memory_order_release);
+            use_alt_stack();
+            struct sigaction action {};
+            action.sa_handler = on_crash_signal;
+            action.sa_flags = SA_ONSTACK;
+            sigemptyset(&action.sa_mask);
+            for (int sig : {SIGSEGV, SIGBUS, SIGFPE, SIGILL, SIGABRT}) {
+                ::sigaction(sig, &action, &previous[sig]);
+            }
+        }
+        spdlog::info("Trace dumps go to {} (SIGUSR2: {}, on crash: {})", dump_directory, options.on_signal,
+                     options.on_crash);
+#else
+        (void)options;
+        spdlog::warn("Trace dumps on signals are not supported on this platform");
+#endif
+    }
+
+}
@@ -0,0 +1,324 @@
+#pragma once
+#include "network/task.h"
+#include "network/timer_wheel.h"
+#include <uv.h>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace network {
+
+    /**
+     * @brief A libuv TCP handle whose operations are awaited from coroutines
+     *        on the handle's loop.
+     *
+     * Completions resume the awaiting coroutine inline, from the libuv
+     * callback. Reading is continuous once the first read() is awaited:
+     * bytes collect in an internal buffer of `read_size` bytes that
+     * buffered() exposes and consume() releases, and reading pauses while
+     * it is full. Results are libuv status codes; read() reports UV_EOF at
+     * the end of the stream.
+     *
+     * connect() takes an IP literal or a name, which is looked up with
+     * uv_getaddrinfo and connected to at its first IPv4 address, or its
+     * first address if it has none.
+     *
+     * close() starts closing at once, so it may also be called without
+     * awaiting; pending reads, accepts and lookups then complete with
+     * UV_ECANCELED.
+     * The object may be destroyed once a close() has been awaited.
+     */
+    class AsyncTcp {
+    public:
+        explicit AsyncTcp(uv_loop_t* loop, size_t read_size = 64 * 1024);
+        ~AsyncTcp();
+
+        AsyncTcp(const AsyncTcp&) = delete;
+        AsyncTcp& operator=(const AsyncTcp&) = delete;
+
+        /**
+         * @return 0 on success, a negative libuv error code otherwise.
+         */
+        int listen(const std::string& host, int port, int backlog = 128);
+
+        /**
+         * @brief Accept one pending connection into `client`, a fresh
+         *        AsyncTcp on the same loop. One accept at a time.
+         */
+        auto accept(AsyncTcp& client) noexcept {
+            struct Awaiter {
+                AsyncTcp& self;
+                AsyncTcp& client;
+
+                bool await_ready() noexcept { return self.pending_accepts_ > 0 || self.closing_; }
+                void await_suspend(std::coroutine_handle<> caller) noexcept { self.accept_waiter_ = caller; }
+                int await_resume() noexcept { return self.finish_accept(client); }
+            };
+            return Awaiter{*this, client};
+        }
+
+        auto connect(const std::string& host, int port) noexcept {
+            struct Awaiter {
+                AsyncTcp& self;
+                uv_connect_t req{};
+                std::coroutine_handle<> waiter;
+                int status = 0;
+
+                bool await_ready() noexcept { return false; }
+                bool await_suspend(std::coroutine_handle<> caller) noexcept {
+                    waiter = caller;
+                    req.data = this;
+                    status = self.start_connect(&req);
+                    return status == 0;
+                }
+                int await_resume() noexcept { return status; }
+            };
+            pending_host_ = host;
+            pending_port_ = port;
+            return Awaiter{*this, {}, {}, 0};
+        }
+
+        /**
+         * @brief Wait until more bytes are buffered than when read() last
+         *        returned. 0 when they are; UV_EOF or an error when the
+         *        stream ended (buffered() may still hold data then).
+         */
+        auto read() noexcept {
+            struct Awaiter {
+                AsyncTcp& self;
+
+                bool await_ready() noexcept {
+                    self.start_reading();
+                    return self.fresh_ || self.read_status_ != 0;
+                }
+                void await_suspend(std::coroutine_handle<> caller) noexcept { self.read_waiter_ = caller; }
+                int await_resume() noexcept {
+                    const bool fresh = std::exchange(self.fresh_, false);
+                    return fresh ? 0 : self.read_status_;
+                }
+            };
+            return Awaiter{*this};
+        }
+
+        std::span<const char> buffered() const { return {buffer_.get() + head_, tail_ - head_}; }
+        void consume(size_t bytes);
+
+        /**
+         * @brief Write all of `bufs`, which must stay valid until resumed.
+         *        Tries uv_try_write first and only suspends for a remainder.
+         */
+        auto write(std::span<const uv_buf_t> bufs) noexcept {
+            struct Awaiter {
+                AsyncTcp& self;
+                std::span<const uv_buf_t> bufs;
+                uv_write_t req{};
+                std::coroutine_handle<> waiter;
+                int status = 0;
+
+                bool await_ready() noexcept { return self.try_write(bufs, status); }
+                bool await_suspend(std::coroutine_handle<> caller) noexcept {
+                    waiter = caller;
+                    req.data = this;
+                    status = self.start_write(&req, bufs);
+                    return status == 0;
+                }
+                int await_resume() noexcept { return status; }
+            };
+            return Awaiter{*this, bufs, {}, {}, 0};
+        }
+
+        auto write(std::span<const char> data) noexcept {
+            single_buf_ = uv_buf_init(const_cast<char*>(data.data()), static_cast<unsigned int>(data.size()));
+            return write(std::span<const uv_buf_t>(&single_buf_, 1));
+        }
+
+        auto close() noexcept {
+            struct Awaiter {
+                AsyncTcp& self;
+
+                bool await_ready() noexcept { return self.closed_; }
+                void await_suspend(std::coroutine_handle<> caller) noexcept { self.close_waiter_ = caller; }
+                void await_resume() noexcept {}
+            };
+            begin_close();
+            return Awaiter{*this};
+        }
+
+        bool closing() const { return closing_; }
+        int bound_port() const;
+        uv_tcp_t* handle() { return &handle_; }
+
+    private:
+        struct Resolve;
+
+        template <typename Awaiter>
+        static void complete(uv_req_t* req, int status) {
+            auto* awaiter = static_cast<Awaiter*>(req->data);
+            awaiter->status = status;
+            awaiter->waiter.resume();
+        }
+
+        static void on_resolved(uv_getaddrinfo_t* req, int status, addrinfo* result);
+
+        int finish_accept(AsyncTcp& client);
+        int start_connect(uv_connect_t* req);
+        int connect_to(uv_connect_t* req, const sockaddr* addr);
+        void start_reading();
+        bool try_write(std::span<const uv_buf_t>& bufs, int& status);
+        int start_write(uv_write_t* req, std::span<const uv_buf_t> bufs);
+        void begin_close();
+
+        uv_loop_t* loop_;
+        uv_tcp_t handle_;
+        bool closing_ = false;
+        bool closed_ = false;
+
+        size_t pending_accepts_ = 0;
+        std::coroutine_handle<> accept_waiter_;
+
+        std::string pending_host_;
+        int pending_port_ = 0;
+        Resolve* resolving_ = nullptr;          // Lookup of the pending connect's host
+        uv_connect_t* cancelled_connect_ = nullptr;    // Its connect, failed by the close
+
+        std::unique_ptr<char[]> buffer_;
+        size_t capacity_;
+        size_t head_ = 0;
+        size_t tail_ = 0;
+        bool reading_ = false;
+        bool fresh_ = false;
+        int read_status_ = 0;
+        std::coroutine_handle<> read_waiter_;
+
+        uv_buf_t single_buf_{};
+        std::vector<uv_buf_t> remainder_;   // What uv_try_write left, for uv_write
+        std::coroutine_handle<> close_waiter_;
+    };
+
+    /**
+     * @brief uv_timer_t awaited with sleep(). close() as for AsyncTcp.
+     */
+    class AsyncTimer {
+    public:
+        explicit AsyncTimer(uv_loop_t* loop);
+        ~AsyncTimer();
+
+        AsyncTimer(const AsyncTimer&) = delete;
+        AsyncTimer& operator=(const AsyncTimer&) = delete;
+
+        auto sleep(uint64_t ms) noexcept {
+            struct Awaiter {
+                AsyncTimer& self;
+                uint64_t ms;
+
+                bool await_ready() noexcept { return self.closing_; }
+                void await_suspend(std::coroutine_handle<> caller) noexcept { self.start(caller, ms); }
+                void await_resume() noexcept {}
+            };
+            return Awaiter{*this, ms};
+        }
+
+        auto close() noexcept {
+            struct Awaiter {
+                AsyncTimer& self;
+
+                bool await_ready() noexcept { return self.closed_; }
+                void await_suspend(std::coroutine_handle<> caller) noexcept { self.close_waiter_ = caller; }
+                void await_resume() noexcept {}
+            };
+            begin_close();
+            return Awaiter{*this};
+        }
+
+    private:
+        void start(std::coroutine_handle<> waiter, uint64_t ms);
+        void begin_close();
+
+        uv_timer_t handle_;
+        std::coroutine_handle<> waiter_;
+        std::coroutine_handle<> close_waiter_;
+        bool closing_ = false;
+        bool closed_ = false;
+    };
+
+    /**
+     * @brief uv_async_t awaited with wait(). notify() may be called from any
+     *        thread; notifications that arrive before the wait, or several
+     *        before the loop runs, wake it once. close() as for AsyncTcp.
+     */
+    class AsyncEvent {
+    public:
+        explicit AsyncEvent(uv_loop_t* loop);
+        ~AsyncEvent();
+
+        AsyncEvent(const AsyncEvent&) = delete;
+        AsyncEvent& operator=(const AsyncEvent&) = delete;
+
+        void notify() { uv_async_send(&handle_); }
+
+        /**
+         * @return false once the event is closing.
+         */
+        auto wait() noexcept {
+            struct Awaiter {
+                AsyncEvent& self;
+
+                bool await_ready() noexcept { return self.signaled_ || self.closing_; }
+                void await_suspend(std::coroutine_handle<> caller) noexcept { self.waiter_ = caller; }
+                bool await_resume() noexcept {
+                    self.signaled_ = false;
+                    return !self.closing_;
+                }
+            };
+            return Awaiter{*this};
+        }
+
+        auto close() noexcept {
+            struct Awaiter {
+                AsyncEvent& self;
+
+                bool await_ready() noexcept { return self.closed_; }
+                void await_suspend(std::coroutine_handle<> caller) noexcept { self.close_waiter_ = caller; }
+                void await_resume() noexcept {}
+            };
+            begin_close();
+            return Awaiter{*this};
+        }
+
+    private:
+        void begin_close();
+
+        uv_async_t handle_;
+        std::coroutine_handle<> waiter_;
+        std::coroutine_handle<> close_waiter_;
+        bool signaled_ = false;
+        bool closing_ = false;
+        bool closed_ = false;
+    };
+
+    /**
+     * @brief Suspend for `ms` on a TimerService; costs no libuv handle, at
+     *        the service's tick resolution.
+     */
+    inline auto sleep(TimerService& timers, uint64_t ms) noexcept {
+        struct Awaiter {
+            TimerService& timers;
+            uint64_t ms;
+            Timer timer;
+
+            bool await_ready() noexcept { return false; }
+            void await_suspend(std::coroutine_handle<> caller) {
+                timer.set_callback([caller] { caller.resume(); });
+                timers.schedule(timer, ms);
+            }
+            void await_resume() noexcept {}
+        };
+        return Awaiter{timers, ms, Timer()};
+    }
+
+}
@@ -0,0 +1,84 @@
+#pragma once
+#include "network/mpsc_queue.h"
+#include <uv.h>
+#include <cstddef>
+#include <functional>
+#include <memory>
+
+namespace network {
+
+    /**
+     * @brief Cross-thread mailbox for one libuv loop.
+     *
+     * Any thread may post() owned items; they are pushed onto a lock-free
+     * MpscQueue and the loop is woken through a uv_async_t. The handler runs
+     * on the loop thread and drains at most `max_batch` items per wake-up, so
+     * a flood of posts cannot starve the loop's other handles.
+     */
+    template <typename T>
+    class AsyncQueue {
+    public:
+        using Handler = std::function<void(std::unique_ptr<T>)>;
+
+        AsyncQueue(uv_loop_t* loop, Handler handler, size_t max_batch = 256)
+            : handler_(std::move(handler)), max_batch_(max_batch) {
+            uv_async_init(loop, &async_, on_async);
+            async_.data = this;
+        }
+
+        /**
+         * @brief close() must have been called and its callback processed
+         *        by the loop before the queue is destroyed.
+         */
+        ~AsyncQueue() {
+            while (T* item = queue_.pop()) {
+                delete item;
+            }
+        }
+
+        AsyncQueue(const AsyncQueue&) = delete;
+        AsyncQueue& operator=(const AsyncQueue&) = delete;
+
+        /**
+         * @brief Hand `item` to the loop thread. Safe to call from any thread.
+         */
+        void post(std::unique_ptr<T> item) {
+            queue_.push(item.release());
+            uv_async_send(&async_);
+        }
+
+        /**
+         * @brief Release the uv_async_t. Loop thread only.
+         */
+        void close() {
+            auto* handle = reinterpret_cast<uv_handle_t*>(&async_);
+            if (!uv_is_closing(handle)) {
+                uv_close(handle, nullptr);
+            }
+        }
+
+        uv_async_t* handle() { return &async_; }
+
+    private:
+        static void on_async(uv_async_t* async) {
+            auto* self = static_cast<AsyncQueue*>(async->data);
+            size_t drained = 0;
+            while (drained < self->max_batch_) {
+                T* item = self->queue_.pop();
+                if (!item) {
+                    return;
+                }
+                self->handler_(std::unique_ptr<T>(item));
+                drained++;
+            }
+            // Batch limit hit: come back on the next loop iteration
+            uv_async_send(async);
+        }
+
+        uv_async_t async_;
+        MpscQueue<T> queue_;
+        Handler handler_;
+        size_t max_batch_;
+    };
+
+}
@@ -0,0 +1,87 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+
+namespace network {
+
+    struct BufferPoolOptions {
+        size_t blocks_per_slab = 16;    // Blocks carved from one upstream allocation
+        size_t max_idle_slabs = 2;      // Fully free slabs kept per size class
+        std::pmr::memory_resource* upstream = std::pmr::new_delete_resource();     // Where slabs come from
+    };
+
+    struct BufferPoolStats {
+        uint64_t acquires = 0;
+        uint64_t releases = 0;
+        uint64_t upstream_allocations = 0;  // Slab allocations from BufferPoolOptions::upstream
+        uint64_t upstream_frees = 0;
+        size_t bytes_reserved = 0;          // Bytes currently held in slabs
+    };
+
+    /**
+     * @brief Slab-backed pool of I/O buffers with power-of-two size classes.
+     *
+     * Buffers are carved from slabs of `blocks_per_slab` blocks, so in steady
+     * state acquire/release never reach the global allocator. A slab is only
+     * returned upstream once all of its blocks are free and more than
+     * `max_idle_slabs` such slabs exist for its class.
+     *
+     * Not thread-safe: each event loop owns its own pool.
+     */
+    class BufferPool {
+    public:
+        static constexpr size_t MIN_BLOCK_SIZE = 4 * 1024;
+        static constexpr size_t MAX_BLOCK_SIZE = 256 * 1024;
+        static constexpr size_t NUM_CLASSES = 7;  // 4 KiB .. 256 KiB
+
+        explicit BufferPool(BufferPoolOptions options = {});
+        ~BufferPool();
+
+        BufferPool(const BufferPool&) = delete;
+        BufferPool& operator=(const BufferPool&) = delete;
+
+        /**
+         * @brief Get a buffer of at least `size` bytes.
+         * @param size Requested size; clamped to MAX_BLOCK_SIZE.
+         * @param capacity Receives the usable size of the returned block.
+         * @return Pointer to the start of the usable region.
+         */
+        char* acquire(size_t size, size_t* capacity = nullptr);
+
+        /**
+         * @brief Return a buffer previously obtained from acquire().
+         */
+        void release(char* data);
+
+        /**
+         * @brief Free every fully idle slab regardless of max_idle_slabs.
+         */
+        void trim();
+
+        const BufferPoolStats& stats() const { return stats_; }
+
+        static size_t class_size(size_t size_class) { return MIN_BLOCK_SIZE << size_class; }
+
+    private:
+        struct Slab;
+        struct BlockHeader;
+
+        struct SizeClass {
+            Slab* partial = nullptr;    // Slabs with at least one free block
+            size_t idle_slabs = 0;
+        };
+
+        Slab* allocate_slab(size_t size_class);
+        void free_slab(Slab* slab);
+        void link_partial(Slab* slab);
+        void unlink_partial(Slab* slab);
+
+        BufferPoolOptions options_;
+        std::array<SizeClass, NUM_CLASSES> classes_{};
+        Slab* all_slabs_ = nullptr;
+        BufferPoolStats stats_;
+    };
+
+}
@@ -0,0 +1,129 @@
+#pragma once
+#include "network/framed_reader.h"
+#include "network/outbound_queue.h"
+#include "network/shared_payload.h"
+#include "network/timer_wheel.h"
+#include <uv.h>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace network {
+
+    class TcpServer;
+    struct WriteRequest;
+
+    /**
+     * @brief One accepted TCP stream owned by a TcpServer.
+     *
+     * Connections are created and destroyed by their server; applications
+     * only ever see references inside server callbacks. All methods must be
+     * called from the thread running the server's loop.
+     */
+    class Connection {
+    public:
+        Connection(const Connection&) = delete;
+        Connection& operator=(const Connection&) = delete;
+
+        uint64_t id() const { return id_; }
+        TcpServer& server() const { return server_; }
+
+        /**
+         * @brief The libuv stream; not initialised under Backend::IoUring.
+         */
+        uv_tcp_t* handle() { return &handle_; }
+
+        /**
+         * @brief Queue `payload` for sending. The connection holds a reference
+         *        until the write completes; the bytes are never copied.
+         *
+         * With FlushMode::Immediate writes go straight to the socket with
+         * uv_try_write when nothing is queued; with FlushMode::PerTick every
+         * payload queued during a loop iteration leaves in one vectored write
+         * from the check phase. Either way a backlog waits in the outbound
+         * queue, where the server's SlowConsumerPolicy applies once the high
+         * watermark is hit.
+         * send() never closes the connection synchronously: eviction and write
+         * errors close it at the end of the current loop iteration, so callers
+         * may send while iterating over their own connection lists.
+         * @param coalesce_key See OutboundQueue::push().
+         */
+        void send(SharedPayload payload, uint64_t coalesce_key = 0);
+
+        /**
+         * @brief Copy `data` into a new payload and send it.
+         */
+        void send(std::string_view data);
+
+        /**
+         * @brief Start closing the stream. The server's close handler runs
+         *        immediately; the object is freed once libuv releases the handle.
+         */
+        void close();
+        bool is_closing() const { return closing_; }
+
+        /**
+         * @brief True between crossing the high watermark and draining to the low one.
+         */
+        bool is_congested() const { return outbound_.congested(); }
+        size_t queued_bytes() const { return outbound_.queued_bytes(); }
+        size_t queued_messages() const { return outbound_.pending_messages(); }
+        const OutboundStats& outbound_stats() const { return outbound_.stats(); }
+
+        /**
+         * @brief Loop time (uv_now) of the last read from the peer.
+         */
+        uint64_t last_read_time() const { return last_read_ms_; }
+
+        std::string peer_address() const;
+
+        void set_user_data(void* data) { user_data_ = data; }
+        void* user_data() const { return user_data_; }
+
+    private:
+        friend class TcpServer;
+        friend class UringTransport;
+
+        Connection(TcpServer& server, uint64_t id);
+        ~Connection() = default;
+
+        static void on_alloc(uv_handle_t* handle, size_t suggested_size, uv_buf_t* buf);
+        static void on_read(uv_stream_t* stream, ssize_t nread, const uv_buf_t* buf);
+        static void on_write(uv_write_t* req, int status);
+        static void on_closed(uv_handle_t* handle);
+
+        void start_reading();
+        void received(const char* data, size_t size);
+        void deliver(std::string_view frame);
+        void write_started();
+        void write_completed(WriteRequest* request, int status);
+        void flush();
+        void close_soon();
+        void start_idle_timer();
+        void on_idle_timeout();
+        void on_write_timeout();
+
+        uv_tcp_t handle_;
+        TcpServer& server_;
+        FramedReader reader_;
+        OutboundQueue outbound_;
+        bool write_inflight_ = false;
+        bool close_pending_ = false;
+        bool flush_scheduled_ = false;
+        size_t close_slot_ = 0;     // In the server's deferred closes, while close_pending_
+        size_t flush_slot_ = 0;     // In the server's pending flushes, while flush_scheduled_
+        Timer idle_timer_;
+        Timer write_timer_;
+        uint64_t last_read_ms_ = 0;
+        int fd_ = -1;               // Socket under Backend::IoUring
+        uint32_t uring_ops_ = 0;    // io_uring operations still referencing this object
+        uint64_t id_;
+        void* user_data_ = nullptr;
+        bool closing_ = false;
+
+        // Intrusive list of the server's live connections
+        Connection* prev_ = nullptr;
+        Connection* next_ = nullptr;
+    };
+
+}
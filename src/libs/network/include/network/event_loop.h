@@ -0,0 +1,86 @@
+#pragma once
+#include "network/async_queue.h"
+#include <foundation/thread_runner.h>
+#include <uv.h>
+#include <functional>
+#include <memory>
+#include <thread>
+
+namespace network {
+
+    /**
+     * @brief A private uv_loop_t, optionally driven by its own thread.
+     *
+     * Other threads talk to the loop through post(). stop() releases the
+     * loop's internal handle, so run() returns once every handle the
+     * application opened on the loop has been closed as well.
+     */
+    class EventLoop {
+    public:
+        EventLoop();
+        ~EventLoop();
+
+        EventLoop(const EventLoop&) = delete;
+        EventLoop& operator=(const EventLoop&) = delete;
+
+        uv_loop_t* get() { return &loop_; }
+
+        /**
+         * @brief Run the loop on the calling thread until it has no more work.
+         */
+        int run();
+
+        /**
+         * @brief Run the loop on a new thread.
+         */
+        void start();
+
+        /**
+         * @brief Run the loop on the calling thread through a ThreadRunner
+         *        placed and polling as `options` say. With busy_poll the
+         *        thread spins on non-blocking loop passes instead of
+         *        sleeping in the backend.
+         */
+        int run(foundation::ThreadRunnerOptions options);
+
+        /**
+         * @brief run(options) on a new thread.
+         */
+        void start(foundation::ThreadRunnerOptions options);
+
+        /**
+         * @brief Busy and idle time of the runner; zero unless the loop was
+         *        started with ThreadRunnerOptions. Safe to call from any thread.
+         */
+        foundation::ThreadRunnerStats runner_stats() const;
+
+        /**
+         * @brief Wait for the thread started by start() to finish.
+         */
+        void join();
+
+        /**
+         * @brief Execute `task` on the loop thread. Safe to call from any thread.
+         */
+        void post(std::function<void()> task);
+
+        /**
+         * @brief Let run() return once application handles are closed.
+         *        Safe to call from any thread; post() must not follow it.
+         */
+        void stop();
+
+    private:
+        struct Task : MpscNode {
+            std::function<void()> fn;
+        };
+
+        foundation::PollResult poll(bool block);
+
+        uv_loop_t loop_;
+        std::unique_ptr<AsyncQueue<Task>> tasks_;
+        std::thread thread_;
+        std::unique_ptr<foundation::ThreadRunner> runner_;
+    };
+
+}
@@ -0,0 +1,138 @@
+#pragma once
+#include "network/shared_payload.h"
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+
+namespace network {
+
+    enum class FrameMode {
+        Raw,                // No framing: every read is handed over as-is
+        LengthPrefixed,     // 4-byte big-endian length, then the payload
+        NewlineDelimited,   // Text lines; a trailing '\r' is stripped
+    };
+
+    constexpr size_t FRAME_HEADER_SIZE = 4;
+
+    /**
+     * @brief Find the first `delim` in [data, data + size) using SSE2/NEON
+     *        where available.
+     * @return Offset of the delimiter, or `size` if absent.
+     */
+    size_t find_delimiter(const char* data, size_t size, char delim);
+
+    /**
+     * @brief Allocate a payload holding one encoded frame with an
+     *        uninitialised body of `body_size` bytes.
+     * @param body Receives a pointer to the body to fill in.
+     */
+    SharedPayload allocate_frame(FrameMode mode, size_t body_size, char** body);
+
+    SharedPayload encode_frame(FrameMode mode, std::string_view body);
+
+    /**
+     * @brief Streaming frame splitter.
+     *
+     * decode() is given every byte not yet consumed, reports each complete
+     * frame as a view into that same memory and returns how many bytes it
+     * consumed; the rest is a partial frame to present again next time. In
+     * newline mode the scanned part of a partial line is remembered, so long
+     * lines arriving in pieces are scanned once.
+     */
+    class FrameDecoder {
+    public:
+        explicit FrameDecoder(FrameMode mode = FrameMode::Raw, size_t max_frame_size = 64 * 1024)
+            : mode_(mode), max_frame_size_(max_frame_size) {}
+
+        template <typename OnFrame>
+        size_t decode(std::span<const char> data, OnFrame&& on_frame);
+
+        FrameMode mode() const { return mode_; }
+        size_t max_frame_size() const { return max_frame_size_; }
+
+        /**
+         * @brief Set once a frame exceeds max_frame_size; the stream is unusable.
+         */
+        bool failed() const { return failed_; }
+
+        void reset() {
+            scanned_ = 0;
+            failed_ = false;
+        }
+
+    private:
+        static uint32_t load_be32(const char* p) {
+            auto* b = reinterpret_cast<const unsigned char*>(p);
+            return (uint32_t(b[0]) << 24) | (uint32_t(b[1]) << 16) | (uint32_t(b[2]) << 8) | uint32_t(b[3]);
+        }
+
+        FrameMode mode_;
+        size_t max_frame_size_;
+        size_t scanned_ = 0;
+        bool failed_ = false;
+    };
+
+    template <typename OnFrame>
+    size_t FrameDecoder::decode(std::span<const char> data, OnFrame&& on_frame) {
+        const char* base = data.data();
+        const size_t size = data.size();
+        size_t pos = 0;
+
+        if (failed_) {
+            return 0;
+        }
+
+        switch (mode_) {
+        case FrameMode::Raw:
+            if (size > 0) {
+                on_frame(std::string_view(base, size));
+            }
+            return size;
+
+        case FrameMode::LengthPrefixed:
+            while (size - pos >= FRAME_HEADER_SIZE) {
+                const uint32_t length = load_be32(base + pos);
+                if (length > max_frame_size_) {
+                    failed_ = true;
+                    return pos;
+                }
+                if (size - pos - FRAME_HEADER_SIZE < length) {
+                    break;
+                }
+                on_frame(std::string_view(base + pos + FRAME_HEADER_SIZE, length));
+                pos += FRAME_HEADER_SIZE + length;
+            }
+            return pos;
+
+        case FrameMode::NewlineDelimited:
+            while (pos < size) {
+                const size_t from = pos + scanned_;
+                const size_t offset = find_delimiter(base + from, size - from, '\n');
+                if (from + offset == size) {
+                    scanned_ = size - pos;
+                    if (scanned_ > max_frame_size_) {
+                        failed_ = true;
+                    }
+                    return pos;
+                }
+
+                size_t end = from + offset;
+                size_t length = end - pos;
+                if (length > max_frame_size_) {
+                    failed_ = true;
+                    return pos;
+                }
+                if (length > 0 && base[end - 1] == '\r') {
+                    length--;
+                }
+                scanned_ = 0;
+                on_frame(std::string_view(base + pos, length));
+                pos = end + 1;
+            }
+            return pos;
+        }
+        return pos;
+    }
+
+}
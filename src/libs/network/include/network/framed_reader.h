@@ -0,0 +1,134 @@
+#pragma once
+#include "network/buffer_pool.h"
+#include "network/frame_codec.h"
+#include <uv.h>
+#include <algorithm>
+#include <cstring>
+
+namespace network {
+
+    /**
+     * @brief Pooled read buffer plus FrameDecoder for one stream.
+     *
+     * prepare() hands libuv the free tail of a BufferPool block; commit()
+     * decodes what arrived and reports frames as views into that block. A
+     * partial frame stays where it is and the next read appends to it; bytes
+     * only move when the block runs out of tail room, and the block goes back
+     * to the pool as soon as nothing is pending.
+     *
+     * feed() serves transports that read into their own buffers: frames are
+     * decoded in place there and only a trailing partial frame is copied in.
+     */
+    class FramedReader {
+    public:
+        FramedReader(BufferPool& pool, FrameDecoder decoder, size_t read_size)
+            : pool_(pool), decoder_(decoder), read_size_(read_size) {}
+
+        ~FramedReader() { release(); }
+
+        FramedReader(const FramedReader&) = delete;
+        FramedReader& operator=(const FramedReader&) = delete;
+
+        /**
+         * @brief Buffer for the next read (a libuv alloc_cb result).
+         */
+        uv_buf_t prepare();
+
+        /**
+         * @brief Account for `nread` bytes written into the last prepare()
+         *        buffer and emit every complete frame.
+         * @return false if the stream violated the framing protocol.
+         */
+        template <typename OnFrame>
+        bool commit(size_t nread, OnFrame&& on_frame);
+
+        /**
+         * @brief Decode `data`, which stays owned by the caller, after any
+         *        buffered partial frame.
+         * @return false if the stream violated the framing protocol.
+         */
+        template <typename OnFrame>
+        bool feed(std::span<const char> data, OnFrame&& on_frame);
+
+        /**
+         * @brief Drop any partial frame and give the block back to the pool.
+         */
+        void release() {
+            pool_.release(buf_);
+            buf_ = nullptr;
+            capacity_ = start_ = end_ = 0;
+        }
+
+        size_t buffered() const { return end_ - start_; }
+        const FrameDecoder& decoder() const { return decoder_; }
+
+    private:
+        BufferPool& pool_;
+        FrameDecoder decoder_;
+        size_t read_size_;
+        char* buf_ = nullptr;
+        size_t capacity_ = 0;
+        size_t start_ = 0;  // First unconsumed byte
+        size_t end_ = 0;    // One past the last received byte
+    };
+
+    inline uv_buf_t FramedReader::prepare() {
+        if (!buf_) {
+            buf_ = pool_.acquire(read_size_, &capacity_);
+        } else if (capacity_ - end_ < read_size_ / 4) {
+            const size_t pending = end_ - start_;
+            if (start_ > 0 && capacity_ - pending >= read_size_ / 4) {
+                std::memmove(buf_, buf_ + start_, pending);
+            } else {
+                // A frame larger than the block: move up a size class
+                size_t capacity = 0;
+                char* bigger = pool_.acquire(capacity_ * 2, &capacity);
+                std::memcpy(bigger, buf_ + start_, pending);
+                pool_.release(buf_);
+                buf_ = bigger;
+                capacity_ = capacity;
+            }
+            start_ = 0;
+            end_ = pending;
+        }
+        return uv_buf_init(buf_ + end_, static_cast<unsigned int>(capacity_ - end_));
+    }
+
+    template <typename OnFrame>
+    bool FramedReader::commit(size_t nread, OnFrame&& on_frame) {
+        end_ += nread;
+        start_ += decoder_.decode(std::span<const char>(buf_ + start_, end_ - start_), on_frame);
+
+        if (decoder_.failed() || (end_ == capacity_ && capacity_ >= BufferPool::MAX_BLOCK_SIZE)) {
+            release();
+            return false;
+        }
+        if (start_ == end_) {
+            release();
+        }
+        return true;
+    }
+
+    template <typename OnFrame>
+    bool FramedReader::feed(std::span<const char> data, OnFrame&& on_frame) {
+        if (buffered() == 0) {
+            data = data.subspan(decoder_.decode(data, on_frame));
+            if (decoder_.failed()) {
+                return false;
+            }
+            // Scan progress referred to the caller's buffer; the copy is rescanned
+            decoder_.reset();
+        }
+        while (!data.empty()) {
+            uv_buf_t buf = prepare();
+            const size_t n = std::min<size_t>(data.size(), buf.len);
+            std::memcpy(buf.base, data.data(), n);
+            if (!commit(n, on_frame)) {
+                return false;
+            }
+            data = data.subspan(n);
+        }
+        return true;
+    }
+
+}
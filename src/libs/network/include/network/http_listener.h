@@ -0,0 +1,74 @@
+#pragma once
+#include <uv.h>
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+
+namespace network {
+
+    struct HttpResponse {
+        int status = 200;
+        std::string content_type = "text/plain; charset=utf-8";
+        std::string body;
+    };
+
+    /**
+     * @brief Minimal HTTP/1.1 endpoint for scrapes and health checks.
+     *
+     * Each connection carries one request: the listener reads up to the end
+     * of the headers (at most MAX_REQUEST_BYTES, otherwise 400), calls the
+     * handler with the method and the path without its query string, writes
+     * the response with `Connection: close` and closes. Request bodies are
+     * ignored. Runs on one libuv loop; errors are reported as libuv status
+     * codes.
+     */
+    class HttpListener {
+    public:
+        using Handler = std::function<HttpResponse(std::string_view method, std::string_view path)>;
+
+        static constexpr size_t MAX_REQUEST_BYTES = 8 * 1024;
+
+        HttpListener(uv_loop_t* loop, Handler handler);
+
+        /**
+         * @brief close() must have been called and the loop run until the
+         *        handles are released before the listener is destroyed.
+         */
+        ~HttpListener();
+
+        HttpListener(const HttpListener&) = delete;
+        HttpListener& operator=(const HttpListener&) = delete;
+
+        /**
+         * @brief Bind and start accepting.
+         * @return 0 on success, a negative libuv error code otherwise.
+         */
+        int listen(const std::string& host, int port);
+
+        /**
+         * @brief Stop accepting and drop requests still in flight.
+         */
+        void close();
+
+        /**
+         * @brief Port actually bound by listen(); useful when configured with port 0.
+         */
+        int bound_port() const;
+
+    private:
+        struct Request;
+
+        static void on_connection(uv_stream_t* listener, int status);
+        void received(Request* request);
+        void close_request(Request* request);
+
+        uv_loop_t* loop_;
+        Handler handler_;
+        uv_tcp_t listener_;
+        bool listener_open_ = false;
+        std::unordered_set<Request*> requests_;
+    };
+
+}
@@ -0,0 +1,98 @@
+#pragma once
+#include "network/frame_codec.h"
+#include "network/shared_payload.h"
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace network {
+
+    struct MessageLogOptions {
+        FrameMode framing = FrameMode::LengthPrefixed;     // Of the records; used to recover the index
+        size_t segment_bytes = 16 * 1024 * 1024;            // A new segment starts once this is full
+        uint64_t retain_bytes = 0;      // Oldest segments are deleted beyond this total; 0 keeps all
+        uint64_t retain_ms = 0;         // Segments last written longer ago are deleted; 0 keeps all
+    };
+
+    /**
+     * @brief Segmented, memory-mapped, append-only log of encoded frames.
+     *
+     * Records are stored exactly as they go on the wire, back to back, in
+     * segment files named after their first sequence number. An in-memory
+     * index keeps each record's offset, so reading from any sequence number
+     * is a lookup, and a run of records inside one segment is one contiguous
+     * range: read() returns it as a SharedPayload view of the mapped pages,
+     * ready for a vectored write, without copying per message. A view keeps
+     * its segment mapped even after retention has deleted the file.
+     *
+     * open() rebuilds the index by decoding the segments, dropping a torn
+     * record at the tail. Errors are reported as libuv status codes; POSIX
+     * only (UV_ENOSYS elsewhere). Not thread-safe.
+     */
+    class MessageLog {
+    public:
+        MessageLog(std::string directory, MessageLogOptions options = {});
+        ~MessageLog();
+
+        MessageLog(const MessageLog&) = delete;
+        MessageLog& operator=(const MessageLog&) = delete;
+
+        /**
+         * @brief Create the directory if needed and recover existing segments.
+         * @return 0 on success, a negative libuv error code otherwise.
+         */
+        int open();
+
+        /**
+         * @brief Append one encoded frame. A new segment's blocks are
+         *        allocated when it is created, so a full disk or a file size
+         *        limit fails that append rather than a later write.
+         * @param seq Receives the record's sequence number.
+         * @return 0 on success, a negative libuv error code otherwise.
+         */
+        int append(std::string_view record, uint64_t* seq = nullptr);
+
+        /**
+         * @brief Views of the records from `from_seq` to the end, at most
+         *        one per segment. If they exceed `max_bytes`, only the
+         *        newest records that fit are returned.
+         * @return Number of records covered.
+         */
+        size_t read(uint64_t from_seq, size_t max_bytes, std::vector<SharedPayload>& out) const;
+
+        /**
+         * @brief read() of the last `count` records.
+         */
+        size_t read_last(size_t count, size_t max_bytes, std::vector<SharedPayload>& out) const;
+
+        /**
+         * @brief Delete sealed segments outside the retention limits. Runs on
+         *        every rollover; call it periodically for age-based retention.
+         */
+        void enforce_retention(uint64_t now_ms);
+
+        uint64_t first_seq() const;
+        uint64_t next_seq() const;
+        size_t size() const { return static_cast<size_t>(next_seq() - first_seq()); }
+        uint64_t bytes() const;
+        size_t segment_count() const { return segments_.size(); }
+
+        static uint64_t wall_clock_ms();
+
+    private:
+        struct Segment;
+
+        int roll(size_t min_capacity);
+        int recover(const std::string& path, uint64_t base_seq);
+
+        std::string directory_;
+        MessageLogOptions options_;
+        std::deque<std::shared_ptr<Segment>> segments_;    // Oldest first; the last one is appended to
+        bool writable_ = false;                             // Whether the last segment is still open for appends
+    };
+
+}
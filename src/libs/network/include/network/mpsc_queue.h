@@ -0,0 +1,93 @@
+#pragma once
+#include <atomic>
+
+namespace network {
+
+    /**
+     * @brief Link field for types stored in an MpscQueue.
+     */
+    struct MpscNode {
+        std::atomic<MpscNode*> next{nullptr};
+    };
+
+    /**
+     * @brief Intrusive lock-free multi-producer single-consumer queue.
+     *
+     * Vyukov's design: push() is one atomic exchange and never blocks, pop()
+     * is wait-free for the single consumer. T must derive from MpscNode. The
+     * queue does not own its elements.
+     */
+    template <typename T>
+    class MpscQueue {
+    public:
+        MpscQueue() : head_(&stub_), tail_(&stub_) {}
+
+        MpscQueue(const MpscQueue&) = delete;
+        MpscQueue& operator=(const MpscQueue&) = delete;
+
+        /**
+         * @brief Append `item`. Safe to call from any thread.
+         */
+        void push(T* item) {
+            MpscNode* node = item;
+            node->next.store(nullptr, std::memory_order_relaxed);
+            MpscNode* prev = head_.exchange(node, std::memory_order_acq_rel);
+            prev->next.store(node, std::memory_order_release);
+        }
+
+        /**
+         * @brief Remove the oldest item. Consumer thread only.
+         * @return nullptr if empty, or if a producer is midway through push().
+         */
+        T* pop() {
+            MpscNode* tail = tail_;
+            MpscNode* next = tail->next.load(std::memory_order_acquire);
+
+            if (tail == &stub_) {
+                if (!next) {
+                    return nullptr;
+                }
+                tail_ = next;
+                tail = next;
+                next = next->next.load(std::memory_order_acquire);
+            }
+
+            if (next) {
+                tail_ = next;
+                return static_cast<T*>(tail);
+            }
+
+            if (tail != head_.load(std::memory_order_acquire)) {
+                return nullptr;  // Producer has swapped head but not linked yet
+            }
+
+            // Re-insert the stub so the last real node can be handed out
+            push_stub();
+            next = tail->next.load(std::memory_order_acquire);
+            if (next) {
+                tail_ = next;
+                return static_cast<T*>(tail);
+            }
+            return nullptr;
+        }
+
+        /**
+         * @brief Consumer-side emptiness check; may lag concurrent producers.
+         */
+        bool empty() const {
+            return tail_ == &stub_ && !stub_.next.load(std::memory_order_acquire);
+        }
+
+    private:
+        void push_stub() {
+            stub_.next.store(nullptr, std::memory_order_relaxed);
+            MpscNode* prev = head_.exchange(&stub_, std::memory_order_acq_rel);
+            prev->next.store(&stub_, std::memory_order_release);
+        }
+
+        alignas(64) std::atomic<MpscNode*> head_;
+        alignas(64) MpscNode* tail_;
+        MpscNode stub_;
+    };
+
+}
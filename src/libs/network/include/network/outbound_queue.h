@@ -0,0 +1,123 @@
+#pragma once
+#include "network/shared_payload.h"
+#include <uv.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace network {
+
+    /**
+     * @brief What to do with a connection whose socket drains slower than
+     *        messages are queued for it.
+     */
+    enum class SlowConsumerPolicy {
+        DropOldest,     // Evict the oldest queued messages to make room
+        Coalesce,       // Replace a queued message with the same key, drop the rest
+        Disconnect,     // Close the connection
+    };
+
+    struct OutboundOptions {
+        size_t high_watermark = 1024 * 1024;   // Queued bytes that make a connection congested
+        size_t low_watermark = 256 * 1024;     // Queued bytes at which it recovers
+        SlowConsumerPolicy policy = SlowConsumerPolicy::Disconnect;
+    };
+
+    struct OutboundStats {
+        uint64_t messages_sent = 0;         // Handed to the socket
+        uint64_t bytes_sent = 0;
+        uint64_t messages_dropped = 0;
+        uint64_t bytes_dropped = 0;
+        uint64_t messages_coalesced = 0;
+        uint64_t congestion_events = 0;     // Times the high watermark was crossed
+        uint64_t write_calls = 0;           // Try-writes plus uv_write/sendmsg submissions
+    };
+
+    /**
+     * @brief Messages accepted for one connection but not yet written.
+     *
+     * Tracks queued bytes (pending plus in flight) against the watermarks and
+     * applies the SlowConsumerPolicy while the connection is congested. The
+     * pending ring grows geometrically and is reused, so queueing does not
+     * allocate in steady state. Loop thread only.
+     */
+    class OutboundQueue {
+    public:
+        enum class Admission {
+            Queued,
+            Coalesced,  // Replaced a pending message with the same key
+            Dropped,    // Discarded by the policy
+            Evict,      // Policy says the connection must be closed
+        };
+
+        explicit OutboundQueue(OutboundOptions options = {});
+
+        /**
+         * @brief Queue `payload`, subject to the slow-consumer policy.
+         * @param coalesce_key Non-zero keys let a newer message replace an
+         *        older pending one under SlowConsumerPolicy::Coalesce.
+         */
+        Admission push(SharedPayload payload, uint64_t coalesce_key = 0);
+
+        /**
+         * @brief Describe up to `max` pending messages, oldest first.
+         * @return Number of entries filled.
+         */
+        size_t gather(uv_buf_t* bufs, size_t max) const;
+
+        /**
+         * @brief Account for `bytes` written directly from the front of the queue.
+         */
+        void consume(size_t bytes);
+
+        /**
+         * @brief Move the oldest `count` messages into `out` as in-flight.
+         * @return Bytes now in flight for them.
+         */
+        size_t take(size_t count, SharedPayload* out);
+
+        /**
+         * @brief An in-flight write of `bytes` has finished.
+         */
+        void complete(size_t bytes);
+
+        /**
+         * @brief Drop everything pending (the connection is closing).
+         */
+        void clear();
+
+        void count_write_call() { stats_.write_calls++; }
+
+        bool empty() const { return count_ == 0; }
+        size_t pending_messages() const { return count_; }
+        size_t pending_bytes() const { return pending_bytes_; }
+        size_t queued_bytes() const { return pending_bytes_ + inflight_bytes_; }
+        bool congested() const { return congested_; }
+
+        const OutboundOptions& options() const { return options_; }
+        const OutboundStats& stats() const { return stats_; }
+
+    private:
+        struct Entry {
+            SharedPayload payload;
+            uint64_t key = 0;
+            size_t offset = 0;  // Bytes already written by consume()
+        };
+
+        Entry& at(size_t i) { return ring_[(head_ + i) & (ring_.size() - 1)]; }
+        const Entry& at(size_t i) const { return ring_[(head_ + i) & (ring_.size() - 1)]; }
+        void pop_front();
+        void drop_front();
+        void update_congestion();
+
+        OutboundOptions options_;
+        std::vector<Entry> ring_;
+        size_t head_ = 0;
+        size_t count_ = 0;
+        size_t pending_bytes_ = 0;
+        size_t inflight_bytes_ = 0;
+        bool congested_ = false;
+        OutboundStats stats_;
+    };
+
+}
@@ -0,0 +1,100 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace network {
+
+    struct SearchIndexOptions {
+        size_t seal_docs = 4096;            // Documents per in-memory segment before it is sealed
+        size_t merge_fanin = 4;             // Sealed segments of one level merged into the next
+        size_t max_indexed_bytes = 1024;    // Longer documents are indexed by their prefix only
+    };
+
+    /**
+     * @brief Incremental inverted index over a stream of documents with
+     *        increasing ids (message sequence numbers).
+     *
+     * add() only tokenizes into a small in-memory segment: lowercased ASCII
+     * words (bytes >= 0x80 are kept, so UTF-8 words survive), each appended
+     * to its term's posting list. A full segment is sealed in O(1) and left
+     * for compact(), which runs off the hot path: it encodes sealed segments
+     * as sorted terms with delta + varint posting lists, and merges
+     * `merge_fanin` segments of one level into one of the next, so a search
+     * touches O(log n) segments.
+     *
+     * search() returns the newest documents containing every query term.
+     * All members are thread-safe; compact() may run on any thread while
+     * the index is searched and appended to.
+     */
+    class SearchIndex {
+    public:
+        explicit SearchIndex(SearchIndexOptions options = {});
+        ~SearchIndex();
+
+        SearchIndex(const SearchIndex&) = delete;
+        SearchIndex& operator=(const SearchIndex&) = delete;
+
+        /**
+         * @brief Index `text` as document `doc`. Ids must increase; a
+         *        smaller or repeated id is ignored.
+         */
+        void add(uint64_t doc, std::string_view text);
+
+        /**
+         * @brief Ids of up to `limit` documents containing every term of
+         *        `query`, newest first. An empty query matches nothing.
+         */
+        std::vector<uint64_t> search(std::string_view query, size_t limit) const;
+
+        /**
+         * @brief Whether compact() has work to do.
+         */
+        bool needs_compaction() const;
+
+        /**
+         * @brief Encode one sealed segment or perform one merge.
+         * @return false if there was nothing to do or another thread is
+         *         compacting.
+         */
+        bool compact();
+
+        size_t document_count() const;
+        size_t segment_count() const;    // Encoded segments
+        size_t memory_bytes() const;     // Of the encoded segments
+
+        /**
+         * @brief Call `fn` with each term of `text`, in order, truncated to
+         *        MAX_TERM bytes.
+         */
+        static void tokenize(std::string_view text, const std::function<void(std::string_view)>& fn);
+
+        static constexpr size_t MAX_TERM = 32;
+        static constexpr size_t MAX_QUERY_TERMS = 16;      // Further query terms are ignored
+
+    private:
+        struct MemSegment;
+        struct Segment;
+
+        void seal_locked();
+        bool encode_sealed(std::unique_lock<std::mutex>& lock);
+        size_t merge_run_locked() const;
+
+        SearchIndexOptions options_;
+        mutable std::mutex mutex_;
+        std::unique_ptr<MemSegment> active_;
+        std::deque<std::shared_ptr<const MemSegment>> sealed_;     // Waiting to be encoded, oldest first
+        std::vector<std::shared_ptr<const Segment>> segments_;     // Oldest first, disjoint id ranges
+        uint64_t last_doc_ = 0;
+        size_t documents_ = 0;
+        bool compacting_ = false;
+    };
+
+}
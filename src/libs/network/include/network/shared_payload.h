@@ -0,0 +1,91 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <utility>
+
+namespace network {
+
+    /**
+     * @brief Immutable, atomically refcounted byte buffer.
+     *
+     * One allocation holds the refcount and the bytes. Copies of the handle
+     * share that allocation, so a broadcast costs one payload however many
+     * connections (or loops) it is queued on; the memory is freed when the
+     * last pending write drops its reference.
+     *
+     * view_of() payloads borrow bytes that live elsewhere (e.g. a mapped log
+     * segment) and keep their owner alive instead of copying.
+     */
+    class SharedPayload {
+    public:
+        SharedPayload() = default;
+        ~SharedPayload() { reset(); }
+
+        SharedPayload(const SharedPayload& other) : block_(other.block_) {
+            if (block_) {
+                block_->refs.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+        SharedPayload(SharedPayload&& other) noexcept : block_(std::exchange(other.block_, nullptr)) {}
+
+        SharedPayload& operator=(SharedPayload other) noexcept {
+            std::swap(block_, other.block_);
+            return *this;
+        }
+
+        /**
+         * @brief Allocate `size` uninitialised bytes, to be filled through
+         *        mutable_data() before the payload is shared.
+         */
+        static SharedPayload allocate(size_t size);
+
+        static SharedPayload copy_of(std::string_view data);
+
+        /**
+         * @brief Borrow `data` without copying; `owner` keeps it valid until
+         *        the last copy of the payload is dropped.
+         */
+        static SharedPayload view_of(std::shared_ptr<const void> owner, std::string_view data);
+
+        const char* data() const { return block_ ? block_->data : nullptr; }
+        /** @brief Writable bytes of an allocate()d payload; not for views. */
+        char* mutable_data() { return block_ ? block_->data : nullptr; }
+        size_t size() const { return block_ ? block_->size : 0; }
+        bool empty() const { return size() == 0; }
+        std::string_view view() const { return {data(), size()}; }
+
+        uint32_t use_count() const {
+            return block_ ? block_->refs.load(std::memory_order_relaxed) : 0;
+        }
+
+        void reset() {
+            if (block_ && block_->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                destroy(block_);
+            }
+            block_ = nullptr;
+        }
+
+        explicit operator bool() const { return block_ != nullptr; }
+
+    private:
+        struct alignas(16) Block {
+            std::atomic<uint32_t> refs;
+            uint32_t size;
+            char* data;     // bytes() unless the payload is a view
+            char* bytes() { return reinterpret_cast<char*>(this + 1); }
+        };
+
+        struct ViewBlock : Block {
+            std::shared_ptr<const void> owner;
+        };
+
+        explicit SharedPayload(Block* block) : block_(block) {}
+        static void destroy(Block* block);
+
+        Block* block_ = nullptr;
+    };
+
+}
@@ -0,0 +1,160 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace network {
+
+    /**
+     * @brief Reference to a SlotMap element: the slot index plus the
+     *        generation the slot had when the element was inserted.
+     *
+     * A default-constructed handle is null and never resolves.
+     */
+    class SlotHandle {
+    public:
+        constexpr SlotHandle() = default;
+
+        static constexpr SlotHandle from_bits(uint64_t bits) {
+            SlotHandle handle;
+            handle.bits_ = bits;
+            return handle;
+        }
+
+        constexpr uint64_t bits() const { return bits_; }
+        constexpr uint32_t index() const { return static_cast<uint32_t>(bits_); }
+        constexpr uint32_t generation() const { return static_cast<uint32_t>(bits_ >> 32); }
+
+        constexpr explicit operator bool() const { return bits_ != 0; }
+        friend constexpr bool operator==(SlotHandle, SlotHandle) = default;
+
+    private:
+        template <typename T>
+        friend class SlotMap;
+
+        constexpr SlotHandle(uint32_t index, uint32_t generation)
+            : bits_((uint64_t(generation) << 32) | index) {}
+
+        uint64_t bits_ = 0;
+    };
+
+    /**
+     * @brief Generational slot map: O(1) insert, erase and lookup through
+     *        64-bit handles, with the values kept in one dense array.
+     *
+     * Each slot's generation changes whenever its element is erased, so a
+     * handle to an erased element stops resolving even after the slot is
+     * reused. Iteration walks the dense array; erase moves the last value
+     * into the hole, so it reorders values and invalidates pointers into
+     * the map, but never invalidates handles to other elements.
+     *
+     * Not thread-safe.
+     */
+    template <typename T>
+    class SlotMap {
+    public:
+        SlotMap() = default;
+
+        SlotMap(const SlotMap&) = delete;
+        SlotMap& operator=(const SlotMap&) = delete;
+
+        template <typename... Args>
+        SlotHandle emplace(Args&&... args) {
+            uint32_t index;
+            if (free_head_ != NONE) {
+                index = free_head_;
+                free_head_ = slots_[index].dense;
+            } else {
+                index = static_cast<uint32_t>(slots_.size());
+                slots_.push_back({0, 1});
+            }
+            Slot& slot = slots_[index];
+            slot.dense = static_cast<uint32_t>(values_.size());
+            values_.emplace_back(std::forward<Args>(args)...);
+            dense_to_slot_.push_back(index);
+            return SlotHandle(index, slot.generation);
+        }
+
+        SlotHandle insert(T value) { return emplace(std::move(value)); }
+
+        /**
+         * @return false if `handle` did not refer to a live element.
+         */
+        bool erase(SlotHandle handle) {
+            if (!contains(handle)) {
+                return false;
+            }
+            Slot& slot = slots_[handle.index()];
+            const uint32_t hole = slot.dense;
+            const uint32_t last = static_cast<uint32_t>(values_.size() - 1);
+            if (hole != last) {
+                values_[hole] = std::move(values_[last]);
+                dense_to_slot_[hole] = dense_to_slot_[last];
+                slots_[dense_to_slot_[hole]].dense = hole;
+            }
+            values_.pop_back();
+            dense_to_slot_.pop_back();
+
+            // Generation 0 is reserved so the null handle never matches
+            if (++slot.generation == 0) {
+                slot.generation = 1;
+            }
+            slot.dense = free_head_;
+            free_head_ = handle.index();
+            return true;
+        }
+
+        bool contains(SlotHandle handle) const {
+            return handle.index() < slots_.size() && slots_[handle.index()].generation == handle.generation();
+        }
+
+        /**
+         * @return nullptr if `handle` is null, stale or from another map.
+         */
+        T* get(SlotHandle handle) { return contains(handle) ? &values_[slots_[handle.index()].dense] : nullptr; }
+        const T* get(SlotHandle handle) const {
+            return contains(handle) ? &values_[slots_[handle.index()].dense] : nullptr;
+        }
+
+        /**
+         * @brief Handle of values()[dense_index].
+         */
+        SlotHandle handle_at(size_t dense_index) const {
+            const uint32_t index = dense_to_slot_[dense_index];
+            return SlotHandle(index, slots_[index].generation);
+        }
+
+        std::span<T> values() { return values_; }
+        std::span<const T> values() const { return values_; }
+        auto begin() { return values_.begin(); }
+        auto end() { return values_.end(); }
+        auto begin() const { return values_.begin(); }
+        auto end() const { return values_.end(); }
+
+        size_t size() const { return values_.size(); }
+        bool empty() const { return values_.empty(); }
+
+        void reserve(size_t capacity) {
+            values_.reserve(capacity);
+            dense_to_slot_.reserve(capacity);
+            slots_.reserve(capacity);
+        }
+
+    private:
+        static constexpr uint32_t NONE = std::numeric_limits<uint32_t>::max();
+
+        struct Slot {
+            uint32_t dense;         // Index into values_ while live, next free slot otherwise
+            uint32_t generation;
+        };
+
+        std::vector<T> values_;
+        std::vector<uint32_t> dense_to_slot_;
+        std::vector<Slot> slots_;
+        uint32_t free_head_ = NONE;
+    };
+
+}
@@ -0,0 +1,200 @@
+#pragma once
+#include <foundation/object_pool.h>
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <optional>
+#include <utility>
+
+namespace network {
+
+    template <typename T>
+    class Task;
+
+    namespace detail {
+        // Coroutine frames come from foundation's pooled resource, whose free
+        // lists are per thread; a loop runs on one thread, so a loop's
+        // coroutines recycle each other's frames without locking
+        struct PooledFrame {
+            static void* operator new(size_t size) {
+                return foundation::pool_resource()->allocate(size, alignof(std::max_align_t));
+            }
+            static void operator delete(void* frame, size_t size) {
+                foundation::pool_resource()->deallocate(frame, size, alignof(std::max_align_t));
+            }
+        };
+
+        struct PromiseBase : PooledFrame {
+            std::coroutine_handle<> continuation = std::noop_coroutine();
+            bool detached = false;      // Started by spawn(): nobody awaits it
+            bool starting = false;      // Inside its awaiter's resume(), which carries on if it completes
+
+            struct FinalAwaiter {
+                bool await_ready() noexcept { return false; }
+
+                template <typename Promise>
+                std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> self) noexcept {
+                    PromiseBase& promise = self.promise();
+                    if (promise.detached) {
+                        self.destroy();
+                        return std::noop_coroutine();
+                    }
+                    if (promise.starting) {
+                        return std::noop_coroutine();   // Finished inline: back to the awaiter's resume()
+                    }
+                    // Completed after suspending: whoever resumed it resumes the
+                    // awaiter, which at worst nests one frame per outstanding await
+                    return promise.continuation;
+                }
+
+                void await_resume() noexcept {}
+            };
+
+            std::suspend_always initial_suspend() noexcept { return {}; }
+            FinalAwaiter final_suspend() noexcept { return {}; }
+            void unhandled_exception() noexcept { std::terminate(); }
+        };
+
+        template <typename T>
+        struct Promise : PromiseBase {
+            std::optional<T> value;
+
+            Task<T> get_return_object();
+            void return_value(T result) { value.emplace(std::move(result)); }
+            T take() { return std::move(*value); }
+        };
+
+        template <>
+        struct Promise<void> : PromiseBase {
+            Task<void> get_return_object();
+            void return_void() {}
+            void take() {}
+        };
+    }
+
+    /**
+     * @brief Lazily started coroutine producing a `T`.
+     *
+     * Nothing runs until the task is co_awaited, which resumes it inline
+     * and resumes the awaiter inline when it finishes, so a chain of tasks
+     * costs no scheduling hops. A task that finishes without suspending
+     * returns to its awaiter's await_suspend() rather than transferring to
+     * it, so long runs of synchronous completions keep the stack flat even
+     * where the compiler does not turn symmetric transfer into a tail call
+     * (GCC at -O0). Frames come from a
+     * per-thread pool (see detail::PooledFrame). Top-level tasks are
+     * started with spawn(). Coroutines must not throw.
+     */
+    template <typename T = void>
+    class [[nodiscard]] Task {
+    public:
+        using promise_type = detail::Promise<T>;
+        using Handle = std::coroutine_handle<promise_type>;
+
+        Task() = default;
+        explicit Task(Handle handle) : handle_(handle) {}
+        Task(Task&& other) noexcept : handle_(std::exchange(other.handle_, {})) {}
+        Task& operator=(Task&& other) noexcept {
+            if (this != &other) {
+                if (handle_) {
+                    handle_.destroy();
+                }
+                handle_ = std::exchange(other.handle_, {});
+            }
+            return *this;
+        }
+        ~Task() {
+            if (handle_) {
+                handle_.destroy();
+            }
+        }
+
+        auto operator co_await() && noexcept {
+            struct Awaiter {
+                Handle handle;
+
+                bool await_ready() noexcept { return !handle || handle.done(); }
+                bool await_suspend(std::coroutine_handle<> caller) noexcept {
+                    auto& promise = handle.promise();
+                    promise.continuation = caller;
+                    promise.starting = true;
+                    handle.resume();
+                    if (handle.done()) {
+                        return false;   // Finished inline: the caller goes on without suspending
+                    }
+                    promise.starting = false;
+                    return true;
+                }
+                T await_resume() { return handle.promise().take(); }
+            };
+            return Awaiter{handle_};
+        }
+
+        bool done() const { return !handle_ || handle_.done(); }
+
+    private:
+        friend void spawn(Task<void> task);
+
+        Handle handle_;
+    };
+
+    namespace detail {
+        template <typename T>
+        Task<T> Promise<T>::get_return_object() {
+            return Task<T>(std::coroutine_handle<Promise<T>>::from_promise(*this));
+        }
+
+        inline Task<void> Promise<void>::get_return_object() {
+            return Task<void>(std::coroutine_handle<Promise<void>>::from_promise(*this));
+        }
+    }
+
+    /**
+     * @brief Start `task` now, on the calling thread, and let it free itself
+     *        when it finishes. Returns at its first suspension.
+     */
+    inline void spawn(Task<void> task) {
+        auto handle = std::exchange(task.handle_, {});
+        handle.promise().detached = true;
+        handle.resume();
+    }
+
+    /**
+     * @brief Auto-reset event for coroutines on one loop: wait() suspends
+     *        until set(), which resumes the waiter inline. A set() with no
+     *        waiter is remembered for the next wait(). Not thread-safe; see
+     *        AsyncEvent for waking a loop from another thread.
+     */
+    class Event {
+    public:
+        Event() = default;
+        Event(const Event&) = delete;
+        Event& operator=(const Event&) = delete;
+
+        void set() {
+            if (waiter_) {
+                std::exchange(waiter_, {}).resume();
+            } else {
+                signaled_ = true;
+            }
+        }
+
+        auto wait() noexcept {
+            struct Awaiter {
+                Event& event;
+
+                bool await_ready() noexcept { return std::exchange(event.signaled_, false); }
+                void await_suspend(std::coroutine_handle<> caller) noexcept { event.waiter_ = caller; }
+                void await_resume() noexcept {}
+            };
+            return Awaiter{*this};
+        }
+
+        bool waiting() const { return static_cast<bool>(waiter_); }
+
+    private:
+        std::coroutine_handle<> waiter_;
+        bool signaled_ = false;
+    };
+
+}
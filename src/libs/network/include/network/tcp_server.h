@@ -0,0 +1,139 @@
+#pragma once
+#include "network/buffer_pool.h"
+#include "network/connection.h"
+#include "network/timer_wheel.h"
+#include "network/uring_transport.h"
+#include "network/write_request_pool.h"
+#include <foundation/histogram.h>
+#include <uv.h>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace network {
+
+    enum class FlushMode {
+        Immediate,  // Every send() tries to write at once: lowest latency
+        PerTick,    // Sends are gathered and written once per loop iteration
+    };
+
+    struct TcpServerOptions {
+        std::string host = "0.0.0.0";
+        int port = 8888;
+        int backlog = 128;
+        size_t read_buffer_size = 64 * 1024;
+        FrameMode framing = FrameMode::Raw;  // Data handler gets one call per frame
+        size_t max_frame_size = 64 * 1024;
+        OutboundOptions outbound;           // Per-connection watermarks and slow-consumer policy
+        FlushMode flush_mode = FlushMode::Immediate;
+        uint64_t idle_timeout_ms = 0;       // Close after this long without inbound data; 0 = never
+        uint64_t write_timeout_ms = 0;      // Close when a queued write makes no progress; 0 = never
+        uint64_t timer_tick_ms = 100;       // Resolution of the server's TimerService
+        Backend backend = Backend::Libuv;
+        UringOptions uring;                 // Used with Backend::IoUring
+        bool tcp_nodelay = true;
+        bool reuse_port = false;    // SO_REUSEPORT, lets several loops share one port
+        BufferPoolOptions buffer_pool;
+        // Nanoseconds from the start of each flush until the socket took the
+        // bytes (a uv_try_write) or the write request completed; not owned
+        foundation::LatencyRecorder* write_latency = nullptr;
+    };
+
+    /**
+     * @brief Listening TCP socket plus the connections accepted on it.
+     *
+     * A server is bound to one libuv loop and owns that loop's BufferPool and
+     * WriteRequestPool, which back every read buffer and write request of
+     * its connections, and a TimerService that runs their idle and write
+     * timeouts and any application timers. Socket I/O goes through libuv or,
+     * with Backend::IoUring, through a UringTransport on the same loop. Errors are reported as libuv status codes.
+     */
+    class TcpServer {
+    public:
+        using ConnectHandler = std::function<void(Connection&)>;
+        using DataHandler = std::function<void(Connection&, std::span<const char>)>;
+        using CloseHandler = std::function<void(Connection&)>;
+
+        TcpServer(uv_loop_t* loop, TcpServerOptions options = {});
+
+        /**
+         * @brief close() must have been called and the loop run until the
+         *        handles are released before the server is destroyed.
+         */
+        ~TcpServer();
+
+        TcpServer(const TcpServer&) = delete;
+        TcpServer& operator=(const TcpServer&) = delete;
+
+        /**
+         * @brief Bind to the configured address and start accepting.
+         * @return 0 on success, a negative libuv error code otherwise.
+         */
+        int listen();
+
+        /**
+         * @brief Stop accepting and close every live connection.
+         */
+        void close();
+
+        void set_connect_handler(ConnectHandler handler) { on_connect_ = std::move(handler); }
+        void set_data_handler(DataHandler handler) { on_data_ = std::move(handler); }
+        void set_close_handler(CloseHandler handler) { on_close_ = std::move(handler); }
+
+        /**
+         * @brief Port actually bound by listen(); useful when configured with port 0.
+         */
+        int bound_port() const;
+
+        uv_loop_t* loop() const { return loop_; }
+        const TcpServerOptions& options() const { return options_; }
+        BufferPool& buffer_pool() { return buffer_pool_; }
+        WriteRequestPool& write_pool() { return write_pool_; }
+        TimerService& timers() { return timers_; }
+        size_t connection_count() const { return connection_count_; }
+
+    private:
+        friend class Connection;
+        friend class UringTransport;
+
+        static void on_connection(uv_stream_t* listener, int status);
+        static void on_check(uv_check_t* check);
+        int enable_reuse_port();
+
+        // Work queued from inside send() runs in the loop's check phase
+        void schedule_flush(Connection* conn);
+        void cancel_scheduled_flush(Connection* conn);
+        void defer_close(Connection* conn);
+        void cancel_deferred_close(Connection* conn);
+        void arm_check();
+
+        void accepted(Connection* conn);
+        void attach(Connection* conn);
+        void detach(Connection* conn);
+
+        uv_loop_t* loop_;
+        TcpServerOptions options_;
+        BufferPool buffer_pool_;
+        WriteRequestPool write_pool_;
+        TimerService timers_;
+        std::unique_ptr<UringTransport> uring_;
+        uv_tcp_t listener_;
+        bool listener_open_ = false;
+        uv_check_t check_;
+        bool check_active_ = false;
+        std::vector<Connection*> pending_flushes_;     // Each connection knows its slot
+        std::vector<Connection*> deferred_closes_;
+
+        ConnectHandler on_connect_;
+        DataHandler on_data_;
+        CloseHandler on_close_;
+
+        Connection* connections_ = nullptr;
+        size_t connection_count_ = 0;
+        uint64_t next_id_ = 0;
+    };
+
+}
@@ -0,0 +1,148 @@
+#pragma once
+#include <uv.h>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+namespace network {
+
+    class TimerWheel;
+
+    // Link of the circular lists hanging off each wheel slot
+    struct TimerNode {
+        TimerNode* prev = this;
+        TimerNode* next = this;
+    };
+
+    /**
+     * @brief One-shot timer that lives inside the object it times out.
+     *
+     * A Timer is armed through TimerWheel::schedule() and is unarmed again
+     * once it fires or is cancelled. Destroying an armed timer cancels it.
+     */
+    class Timer : private TimerNode {
+    public:
+        using Callback = std::function<void()>;
+
+        Timer() = default;
+        explicit Timer(Callback callback) : callback_(std::move(callback)) {}
+        ~Timer() { cancel(); }
+
+        Timer(const Timer&) = delete;
+        Timer& operator=(const Timer&) = delete;
+
+        void set_callback(Callback callback) { callback_ = std::move(callback); }
+
+        bool armed() const { return wheel_ != nullptr; }
+        void cancel();
+
+    private:
+        friend class TimerWheel;
+
+        TimerWheel* wheel_ = nullptr;
+        uint64_t expiry_ = 0;       // Absolute tick
+        Callback callback_;
+    };
+
+    /**
+     * @brief Hierarchical timing wheel: O(1) arm, re-arm and cancel.
+     *
+     * Four levels of 64 slots each; level 0 holds timers due within 64
+     * ticks, and every higher level covers 64 times the span of the one
+     * below. When the lower wheel wraps, the matching higher slot is
+     * cascaded down, so each timer is touched at most once per level.
+     * Delays beyond the top level are clamped to its range.
+     *
+     * Delays are rounded up to whole ticks and counted from the last tick
+     * the wheel reached, so a timer fires within one tick of its deadline.
+     * A callback may arm or cancel any timer, including its own, and may
+     * destroy the timer that is firing as its last action (a coroutine
+     * resumed by sleep() does).
+     *
+     * Not thread-safe: each event loop owns its own wheel.
+     */
+    class TimerWheel {
+    public:
+        static constexpr size_t LEVELS = 4;
+        static constexpr size_t SLOT_BITS = 6;
+        static constexpr size_t SLOTS = size_t(1) << SLOT_BITS;
+        static constexpr uint64_t MAX_TICKS = (uint64_t(1) << (LEVELS * SLOT_BITS)) - 1;
+
+        /**
+         * @param now_ms Current time; later calls to advance() use the same clock.
+         * @param tick_ms Resolution of the wheel.
+         */
+        explicit TimerWheel(uint64_t now_ms, uint64_t tick_ms = 100);
+        ~TimerWheel();
+
+        TimerWheel(const TimerWheel&) = delete;
+        TimerWheel& operator=(const TimerWheel&) = delete;
+
+        /**
+         * @brief Arm `timer` to fire `delay_ms` from the wheel's current tick,
+         *        moving it if it is already armed.
+         */
+        void schedule(Timer& timer, uint64_t delay_ms);
+        void cancel(Timer& timer);
+
+        /**
+         * @brief Move the wheel up to `now_ms`, firing every timer that came due.
+         * @return Number of timers fired.
+         */
+        size_t advance(uint64_t now_ms);
+
+        size_t size() const { return size_; }
+        bool empty() const { return size_ == 0; }
+        uint64_t tick_ms() const { return tick_ms_; }
+
+    private:
+        void place(Timer* timer);
+        void cascade(size_t level);
+
+        static void link(TimerNode* head, TimerNode* node);
+        static void unlink(TimerNode* node);
+
+        TimerNode slots_[LEVELS][SLOTS];
+        uint64_t origin_ms_;
+        uint64_t tick_ms_;
+        uint64_t current_tick_ = 0;
+        size_t size_ = 0;
+    };
+
+    /**
+     * @brief A TimerWheel driven by one uv_timer_t on a libuv loop.
+     *
+     * The uv timer only runs while at least one timer is armed, so an idle
+     * wheel costs no wakeups.
+     */
+    class TimerService {
+    public:
+        explicit TimerService(uv_loop_t* loop, uint64_t tick_ms = 100);
+
+        /**
+         * @brief close() must have been called and the loop run until the
+         *        handle is released before the service is destroyed.
+         */
+        ~TimerService() = default;
+
+        TimerService(const TimerService&) = delete;
+        TimerService& operator=(const TimerService&) = delete;
+
+        void schedule(Timer& timer, uint64_t delay_ms);
+        void cancel(Timer& timer) { wheel_.cancel(timer); }
+
+        void close();
+
+        size_t size() const { return wheel_.size(); }
+        uint64_t tick_ms() const { return wheel_.tick_ms(); }
+
+    private:
+        static void on_tick(uv_timer_t* handle);
+
+        uv_loop_t* loop_;
+        uv_timer_t handle_;
+        TimerWheel wheel_;
+        bool running_ = false;
+    };
+
+}
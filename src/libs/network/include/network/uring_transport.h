@@ -0,0 +1,134 @@
+#pragma once
+#include <uv.h>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+struct io_uring_sqe;
+
+namespace network {
+
+    class Connection;
+    class TcpServer;
+    struct WriteRequest;
+
+    enum class Backend {
+        Libuv,      // Readiness-based I/O through the loop's uv_tcp_t handles
+        IoUring,    // Completion-based I/O through an io_uring (Linux only)
+    };
+
+    struct UringOptions {
+        unsigned queue_depth = 1024;            // Submission queue entries
+        unsigned buffer_count = 1024;           // Provided receive buffers, a power of two
+        unsigned buffer_size = 16 * 1024;       // Bytes per receive buffer
+    };
+
+    /**
+     * @brief io_uring socket I/O for one TcpServer, running inside its libuv loop.
+     *
+     * The listener uses a multishot accept and every connection a multishot
+     * recv that picks buffers from a provided buffer ring, so steady-state
+     * reads need no submissions at all. Sends and re-arms are queued as SQEs
+     * and submitted together at both ends of each loop iteration, from a
+     * uv_prepare_t and a uv_check_t, so what callbacks queue goes out before
+     * the loop waits again however it is driven; completions are reaped when a uv_poll_t reports the ring readable.
+     * Other loop work (timers, async mailboxes) keeps running on libuv.
+     *
+     * Errors are reported as libuv status codes. Loop thread only.
+     */
+    class UringTransport {
+    public:
+        /**
+         * @brief Whether this build and kernel can run the backend.
+         */
+        static bool supported();
+
+        UringTransport(TcpServer& server, UringOptions options);
+
+        /**
+         * @brief close() must have been called and the loop run until the
+         *        handles are released before the transport is destroyed.
+         */
+        ~UringTransport();
+
+        UringTransport(const UringTransport&) = delete;
+        UringTransport& operator=(const UringTransport&) = delete;
+
+        /**
+         * @brief Set up the ring, bind and start accepting.
+         * @return 0 on success, a negative libuv error code otherwise.
+         */
+        int listen(const sockaddr* addr, int backlog, bool reuse_port);
+
+        /**
+         * @brief Port of the listening socket, or -1.
+         */
+        int local_port() const;
+
+        /**
+         * @brief Stop accepting and wait for every outstanding operation.
+         *        Connections must already be closed.
+         */
+        void close();
+
+        void start_reading(Connection& conn);
+
+        /**
+         * @brief Submit `request`, whose payloads `bufs` describe, as one sendmsg.
+         */
+        void send(Connection& conn, WriteRequest* request, const uv_buf_t* bufs, size_t count);
+
+        /**
+         * @brief Shut the socket down; the connection is freed once its
+         *        last operation has completed.
+         */
+        void shutdown(Connection& conn);
+
+        /**
+         * @brief getpeername() for a socket owned by the transport.
+         */
+        static int peer_name(int fd, sockaddr* addr, int* len);
+
+    private:
+        struct Ring;
+        struct SendOp;
+
+        static void on_prepare(uv_prepare_t* handle);
+        static void on_check(uv_check_t* handle);
+        static void on_poll(uv_poll_t* handle, int status, int events);
+
+        io_uring_sqe* next_sqe();
+        void arm_accept();
+        void arm_recv(Connection& conn);
+        void submit_send(SendOp* op);
+        void submit();
+        void reap();
+        void on_accept(int res, uint32_t flags);
+        void on_recv(Connection* conn, int res, uint32_t flags);
+        void on_send(SendOp* op, int res);
+        void recycle_buffer(uint16_t bid);
+        void release_if_idle(Connection* conn);
+        void bury();
+
+        SendOp* acquire_send();
+        void release_send(SendOp* op);
+
+        TcpServer& server_;
+        UringOptions options_;
+        std::unique_ptr<Ring> ring_;
+        uv_prepare_t prepare_;
+        uv_check_t check_;
+        uv_poll_t poll_;
+        bool handles_open_ = false;
+        int listen_fd_ = -1;
+        bool listening_ = false;
+        bool accept_armed_ = false;
+        size_t inflight_ = 0;       // Operations that still owe a final completion
+        std::vector<Connection*> graveyard_;    // Closed with nothing in flight; freed next iteration
+
+        std::vector<std::unique_ptr<SendOp>> send_ops_;
+        SendOp* free_sends_ = nullptr;
+    };
+
+}
@@ -0,0 +1,64 @@
+#pragma once
+#include "network/shared_payload.h"
+#include <uv.h>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace network {
+
+    /**
+     * @brief A uv_write_t together with the payloads it keeps alive.
+     */
+    struct WriteRequest {
+        static constexpr size_t MAX_BUFS = 64;
+
+        uv_write_t req;
+        std::array<SharedPayload, MAX_BUFS> payloads;
+        size_t payload_count = 0;
+        size_t bytes = 0;
+        uint64_t started_ticks = 0;     // TscClock ticks when the flush began, if timed
+        WriteRequest* next_free = nullptr;
+
+        static WriteRequest* from(uv_write_t* req) { return reinterpret_cast<WriteRequest*>(req); }
+    };
+
+    static_assert(std::is_standard_layout_v<WriteRequest>, "uv_write_t must be the first member");
+
+    /**
+     * @brief Per-loop free list of WriteRequests, grown in fixed-size chunks.
+     *
+     * Requests are never returned to the heap until the pool is destroyed,
+     * so steady-state writes cost no allocator calls. Not thread-safe.
+     */
+    class WriteRequestPool {
+    public:
+        explicit WriteRequestPool(size_t requests_per_chunk = 64);
+
+        WriteRequestPool(const WriteRequestPool&) = delete;
+        WriteRequestPool& operator=(const WriteRequestPool&) = delete;
+
+        WriteRequest* acquire();
+
+        /**
+         * @brief Drop the request's payload references and recycle it.
+         */
+        void release(WriteRequest* request);
+
+        size_t capacity() const { return chunks_.size() * requests_per_chunk_; }
+        size_t in_use() const { return in_use_; }
+        uint64_t upstream_allocations() const { return chunks_.size(); }
+
+    private:
+        void grow();
+
+        size_t requests_per_chunk_;
+        std::vector<std::unique_ptr<WriteRequest[]>> chunks_;
+        WriteRequest* free_ = nullptr;
+        size_t in_use_ = 0;
+    };
+
+}
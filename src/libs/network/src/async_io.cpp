@@ -0,0 +1,317 @@
+#include "network/async_io.h"
+#include <algorithm>
+#include <cstring>
+
+namespace network {
+
+    namespace {
+        using ConnectAwaiter = decltype(std::declval<AsyncTcp&>().connect({}, 0));
+    }
+
+    // Owned by the lookup, which may finish after the socket is gone
+    struct AsyncTcp::Resolve {
+        uv_getaddrinfo_t req;
+        AsyncTcp* self;             // Null once the socket started closing
+        uv_connect_t* connect;
+    };
+
+    AsyncTcp::AsyncTcp(uv_loop_t* loop, size_t read_size) : loop_(loop), capacity_(read_size) {
+        uv_tcp_init(loop_, &handle_);
+        handle_.data = this;
+    }
+
+    AsyncTcp::~AsyncTcp() = default;
+
+    int AsyncTcp::listen(const std::string& host, int port, int backlog) {
+        sockaddr_storage addr{};
+        int r = uv_ip4_addr(host.c_str(), port, reinterpret_cast<sockaddr_in*>(&addr));
+        if (r != 0) {
+            r = uv_ip6_addr(host.c_str(), port, reinterpret_cast<sockaddr_in6*>(&addr));
+        }
+        if (r == 0) {
+            r = uv_tcp_bind(&handle_, reinterpret_cast<const sockaddr*>(&addr), 0);
+        }
+        if (r != 0) {
+            return r;
+        }
+        return uv_listen(reinterpret_cast<uv_stream_t*>(&handle_), backlog, [](uv_stream_t* server, int status) {
+            auto* self = static_cast<AsyncTcp*>(server->data);
+            if (status < 0) {
+                return;     // Transient (e.g. EMFILE); libuv keeps listening
+            }
+            self->pending_accepts_++;
+            if (self->accept_waiter_) {
+                std::exchange(self->accept_waiter_, {}).resume();
+            }
+        });
+    }
+
+    int AsyncTcp::finish_accept(AsyncTcp& client) {
+        if (closing_) {
+            return UV_ECANCELED;
+        }
+        pending_accepts_--;
+        return uv_accept(reinterpret_cast<uv_stream_t*>(&handle_), reinterpret_cast<uv_stream_t*>(&client.handle_));
+    }
+
+    int AsyncTcp::start_connect(uv_connect_t* req) {
+        sockaddr_storage addr{};
+        int r = uv_ip4_addr(pending_host_.c_str(), pending_port_, reinterpret_cast<sockaddr_in*>(&addr));
+        if (r != 0) {
+            r = uv_ip6_addr(pending_host_.c_str(), pending_port_, reinterpret_cast<sockaddr_in6*>(&addr));
+        }
+        if (r == 0) {
+            return connect_to(req, reinterpret_cast<const sockaddr*>(&addr));
+        }
+
+        // A name: resolved on the threadpool, connected from on_resolved()
+        auto* resolve = new Resolve{{}, this, req};
+        resolve->req.data = resolve;
+        addrinfo hints{};
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+        const std::string port = std::to_string(pending_port_);
+        r = uv_getaddrinfo(loop_, &resolve->req, on_resolved, pending_host_.c_str(), port.c_str(), &hints);
+        if (r != 0) {
+            delete resolve;
+            return r;
+        }
+        resolving_ = resolve;
+        return 0;
+    }
+
+    void AsyncTcp::on_resolved(uv_getaddrinfo_t* req, int status, addrinfo* result) {
+        std::unique_ptr<Resolve> resolve(static_cast<Resolve*>(req->data));
+        AsyncTcp* self = resolve->self;
+        if (!self) {
+            uv_freeaddrinfo(result);
+            return;
+        }
+        self->resolving_ = nullptr;
+        if (status == 0) {
+            // IPv4 first, as servers here listen on 0.0.0.0 and localhost often lists ::1 first
+            const addrinfo* chosen = result;
+            for (const addrinfo* ai = result; ai; ai = ai->ai_next) {
+                if (ai->ai_family == AF_INET) {
+                    chosen = ai;
+                    break;
+                }
+            }
+            status = chosen ? self->connect_to(resolve->connect, chosen->ai_addr) : UV_EAI_NONAME;
+        }
+        uv_freeaddrinfo(result);
+        if (status != 0) {
+            complete<ConnectAwaiter>(reinterpret_cast<uv_req_t*>(resolve->connect), status);
+        }
+    }
+
+    int AsyncTcp::connect_to(uv_connect_t* req, const sockaddr* addr) {
+        return uv_tcp_connect(req, &handle_, addr, [](uv_connect_t* req, int status) {
+            complete<ConnectAwaiter>(reinterpret_cast<uv_req_t*>(req), status);
+        });
+    }
+
+    void AsyncTcp::start_reading() {
+        if (reading_ || closing_ || read_status_ != 0 || tail_ - head_ == capacity_) {
+            return;
+        }
+        if (!buffer_) {
+            buffer_ = std::make_unique<char[]>(capacity_);
+        }
+        int r = uv_read_start(
+            reinterpret_cast<uv_stream_t*>(&handle_),
+            [](uv_handle_t* handle, size_t, uv_buf_t* buf) {
+                auto* self = static_cast<AsyncTcp*>(handle->data);
+                if (self->head_ > 0 && self->tail_ == self->capacity_) {
+                    // Slide the unconsumed bytes down to make room
+                    std::memmove(self->buffer_.get(), self->buffer_.get() + self->head_, self->tail_ - self->head_);
+                    self->tail_ -= self->head_;
+                    self->head_ = 0;
+                }
+                *buf = uv_buf_init(self->buffer_.get() + self->tail_,
+                                   static_cast<unsigned int>(self->capacity_ - self->tail_));
+            },
+            [](uv_stream_t* stream, ssize_t nread, const uv_buf_t*) {
+                auto* self = static_cast<AsyncTcp*>(stream->data);
+                if (nread > 0) {
+                    self->tail_ += static_cast<size_t>(nread);
+                    self->fresh_ = true;
+                } else if (nread < 0) {
+                    self->read_status_ = nread == UV_ENOBUFS ? 0 : static_cast<int>(nread);
+                } else {
+                    return;     // EAGAIN
+                }
+                if (self->read_status_ != 0 || self->tail_ - self->head_ == self->capacity_ || nread == UV_ENOBUFS) {
+                    uv_read_stop(stream);
+                    self->reading_ = false;
+                }
+                if (self->read_waiter_) {
+                    std::exchange(self->read_waiter_, {}).resume();
+                }
+            });
+        if (r != 0) {
+            read_status_ = r;
+            return;
+        }
+        reading_ = true;
+    }
+
+    void AsyncTcp::consume(size_t bytes) {
+        head_ += std::min(bytes, tail_ - head_);
+        if (head_ == tail_) {
+            head_ = tail_ = 0;
+        }
+    }
+
+    bool AsyncTcp::try_write(std::span<const uv_buf_t>& bufs, int& status) {
+        if (closing_) {
+            status = UV_ECANCELED;
+            return true;
+        }
+        int written = uv_try_write(reinterpret_cast<uv_stream_t*>(&handle_), bufs.data(),
+                                   static_cast<unsigned int>(bufs.size()));
+        if (written == UV_EAGAIN) {
+            return false;
+        }
+        if (written < 0) {
+            status = written;
+            return true;
+        }
+        // Drop what went out; uv_write copies the uv_buf_t list it is given
+        // but not the bytes, so the remainder may live in remainder_
+        auto sent = static_cast<size_t>(written);
+        while (!bufs.empty() && sent >= bufs.front().len) {
+            sent -= bufs.front().len;
+            bufs = bufs.subspan(1);
+        }
+        if (bufs.empty()) {
+            status = 0;
+            return true;
+        }
+        if (sent > 0) {
+            remainder_.assign(bufs.begin(), bufs.end());
+            remainder_[0] = uv_buf_init(remainder_[0].base + sent, static_cast<unsigned int>(remainder_[0].len - sent));
+            bufs = remainder_;
+        }
+        return false;
+    }
+
+    int AsyncTcp::start_write(uv_write_t* req, std::span<const uv_buf_t> bufs) {
+        return uv_write(req, reinterpret_cast<uv_stream_t*>(&handle_), bufs.data(), static_cast<unsigned int>(bufs.size()),
+                        [](uv_write_t* req, int status) {
+                            using Awaiter = decltype(std::declval<AsyncTcp&>().write(std::span<const uv_buf_t>()));
+                            complete<Awaiter>(reinterpret_cast<uv_req_t*>(req), status);
+                        });
+    }
+
+    void AsyncTcp::begin_close() {
+        if (closing_) {
+            return;
+        }
+        closing_ = true;
+        if (resolving_) {
+            // The lookup may still be running; it finds no socket when it ends
+            resolving_->self = nullptr;
+            uv_cancel(reinterpret_cast<uv_req_t*>(&resolving_->req));
+            cancelled_connect_ = std::exchange(resolving_, nullptr)->connect;
+        }
+        uv_close(reinterpret_cast<uv_handle_t*>(&handle_), [](uv_handle_t* handle) {
+            auto* self = static_cast<AsyncTcp*>(handle->data);
+            self->closed_ = true;
+            if (self->read_status_ == 0) {
+                self->read_status_ = UV_ECANCELED;
+            }
+            std::coroutine_handle<> connector;
+            if (uv_connect_t* req = std::exchange(self->cancelled_connect_, nullptr)) {
+                auto* awaiter = static_cast<ConnectAwaiter*>(req->data);
+                awaiter->status = UV_ECANCELED;
+                connector = awaiter->waiter;
+            }
+            // Any of these may destroy `self`, so take them all first
+            auto reader = std::exchange(self->read_waiter_, {});
+            auto acceptor = std::exchange(self->accept_waiter_, {});
+            auto closer = std::exchange(self->close_waiter_, {});
+            for (auto waiter : {connector, reader, acceptor, closer}) {
+                if (waiter) {
+                    waiter.resume();
+                }
+            }
+        });
+    }
+
+    int AsyncTcp::bound_port() const {
+        sockaddr_storage addr{};
+        int len = sizeof(addr);
+        if (uv_tcp_getsockname(&handle_, reinterpret_cast<sockaddr*>(&addr), &len) != 0) {
+            return -1;
+        }
+        if (addr.ss_family == AF_INET6) {
+            return ntohs(reinterpret_cast<const sockaddr_in6*>(&addr)->sin6_port);
+        }
+        return ntohs(reinterpret_cast<const sockaddr_in*>(&addr)->sin_port);
+    }
+
+    AsyncTimer::AsyncTimer(uv_loop_t* loop) {
+        uv_timer_init(loop, &handle_);
+        handle_.data = this;
+    }
+
+    AsyncTimer::~AsyncTimer() = default;
+
+    void AsyncTimer::start(std::coroutine_handle<> waiter, uint64_t ms) {
+        waiter_ = waiter;
+        uv_timer_start(&handle_, [](uv_timer_t* timer) {
+            std::exchange(static_cast<AsyncTimer*>(timer->data)->waiter_, {}).resume();
+        }, ms, 0);
+    }
+
+    void AsyncTimer::begin_close() {
+        if (closing_) {
+            return;
+        }
+        closing_ = true;
+        uv_close(reinterpret_cast<uv_handle_t*>(&handle_), [](uv_handle_t* handle) {
+            auto* self = static_cast<AsyncTimer*>(handle->data);
+            self->closed_ = true;
+            auto sleeper = std::exchange(self->waiter_, {});
+            auto closer = std::exchange(self->close_waiter_, {});
+            for (auto waiter : {sleeper, closer}) {
+                if (waiter) {
+                    waiter.resume();
+                }
+            }
+        });
+    }
+
+    AsyncEvent::AsyncEvent(uv_loop_t* loop) {
+        uv_async_init(loop, &handle_, [](uv_async_t* async) {
+            auto* self = static_cast<AsyncEvent*>(async->data);
+            self->signaled_ = true;
+            if (self->waiter_) {
+                std::exchange(self->waiter_, {}).resume();
+            }
+        });
+        handle_.data = this;
+    }
+
+    AsyncEvent::~AsyncEvent() = default;
+
+    void AsyncEvent::begin_close() {
+        if (closing_) {
+            return;
+        }
+        closing_ = true;
+        uv_close(reinterpret_cast<uv_handle_t*>(&handle_), [](uv_handle_t* handle) {
+            auto* self = static_cast<AsyncEvent*>(handle->data);
+            self->closed_ = true;
+            auto waiter = std::exchange(self->waiter_, {});
+            auto closer = std::exchange(self->close_waiter_, {});
+            for (auto next : {waiter, closer}) {
+                if (next) {
+                    next.resume();
+                }
+            }
+        });
+    }
+
+}
@@ -0,0 +1,198 @@
+#include "network/buffer_pool.h"
+#include <bit>
+#include <new>
+
+namespace network {
+
+    struct alignas(16) BufferPool::BlockHeader {
+        Slab* slab;
+        BlockHeader* next_free;
+    };
+
+    struct alignas(16) BufferPool::Slab {
+        size_t size_class;
+        size_t in_use;
+        size_t block_count;
+        size_t bytes;
+        BlockHeader* free_list;
+        Slab* prev_partial;
+        Slab* next_partial;
+        Slab* prev_all;
+        Slab* next_all;
+        bool in_partial;
+    };
+
+    namespace {
+        constexpr size_t SLAB_ALIGNMENT = 64;
+
+        size_t size_class_for(size_t size) {
+            if (size <= BufferPool::MIN_BLOCK_SIZE) {
+                return 0;
+            }
+            if (size >= BufferPool::MAX_BLOCK_SIZE) {
+                return BufferPool::NUM_CLASSES - 1;
+            }
+            return std::countr_zero(std::bit_ceil(size)) -
+                   std::countr_zero(BufferPool::MIN_BLOCK_SIZE);
+        }
+    }
+
+    BufferPool::BufferPool(BufferPoolOptions options) : options_(options) {
+        if (options_.blocks_per_slab == 0) {
+            options_.blocks_per_slab = 1;
+        }
+        if (!options_.upstream) {
+            options_.upstream = std::pmr::new_delete_resource();
+        }
+    }
+
+    BufferPool::~BufferPool() {
+        while (all_slabs_) {
+            free_slab(all_slabs_);
+        }
+    }
+
+    char* BufferPool::acquire(size_t size, size_t* capacity) {
+        size_t size_class = size_class_for(size);
+        SizeClass& sc = classes_[size_class];
+
+        Slab* slab = sc.partial;
+        if (!slab) {
+            slab = allocate_slab(size_class);
+        }
+
+        BlockHeader* block = slab->free_list;
+        slab->free_list = block->next_free;
+        if (slab->in_use++ == 0) {
+            sc.idle_slabs--;
+        }
+        if (!slab->free_list) {
+            unlink_partial(slab);
+        }
+
+        stats_.acquires++;
+        if (capacity) {
+            *capacity = class_size(size_class);
+        }
+        return reinterpret_cast<char*>(block + 1);
+    }
+
+    void BufferPool::release(char* data) {
+        if (!data) {
+            return;
+        }
+        BlockHeader* block = reinterpret_cast<BlockHeader*>(data) - 1;
+        Slab* slab = block->slab;
+        SizeClass& sc = classes_[slab->size_class];
+
+        block->next_free = slab->free_list;
+        slab->free_list = block;
+        if (!slab->in_partial) {
+            link_partial(slab);
+        }
+        stats_.releases++;
+
+        if (--slab->in_use == 0) {
+            if (++sc.idle_slabs > options_.max_idle_slabs) {
+                free_slab(slab);
+            }
+        }
+    }
+
+    void BufferPool::trim() {
+        Slab* slab = all_slabs_;
+        while (slab) {
+            Slab* next = slab->next_all;
+            if (slab->in_use == 0) {
+                free_slab(slab);
+            }
+            slab = next;
+        }
+    }
+
+    BufferPool::Slab* BufferPool::allocate_slab(size_t size_class) {
+        const size_t stride = sizeof(BlockHeader) + class_size(size_class);
+        const size_t bytes = sizeof(Slab) + stride * options_.blocks_per_slab;
+
+        void* memory = options_.upstream->allocate(bytes, SLAB_ALIGNMENT);
+        Slab* slab = new (memory) Slab{};
+        slab->size_class = size_class;
+        slab->block_count = options_.blocks_per_slab;
+        slab->bytes = bytes;
+
+        // Thread blocks onto the free list in address order
+        char* base = static_cast<char*>(memory) + sizeof(Slab);
+        BlockHeader* next = nullptr;
+        for (size_t i = slab->block_count; i-- > 0;) {
+            BlockHeader* block = reinterpret_cast<BlockHeader*>(base + i * stride);
+            block->slab = slab;
+            block->next_free = next;
+            next = block;
+        }
+        slab->free_list = next;
+
+        slab->next_all = all_slabs_;
+        if (all_slabs_) {
+            all_slabs_->prev_all = slab;
+        }
+        all_slabs_ = slab;
+
+        link_partial(slab);
+        classes_[size_class].idle_slabs++;
+
+        stats_.upstream_allocations++;
+        stats_.bytes_reserved += bytes;
+        return slab;
+    }
+
+    void BufferPool::free_slab(Slab* slab) {
+        if (slab->in_partial) {
+            unlink_partial(slab);
+        }
+        if (slab->in_use == 0) {
+            classes_[slab->size_class].idle_slabs--;
+        }
+
+        if (slab->prev_all) {
+            slab->prev_all->next_all = slab->next_all;
+        } else {
+            all_slabs_ = slab->next_all;
+        }
+        if (slab->next_all) {
+            slab->next_all->prev_all = slab->prev_all;
+        }
+
+        stats_.upstream_frees++;
+        const size_t bytes = slab->bytes;
+        stats_.bytes_reserved -= bytes;
+        slab->~Slab();
+        options_.upstream->deallocate(slab, bytes, SLAB_ALIGNMENT);
+    }
+
+    void BufferPool::link_partial(Slab* slab) {
+        SizeClass& sc = classes_[slab->size_class];
+        slab->prev_partial = nullptr;
+        slab->next_partial = sc.partial;
+        if (sc.partial) {
+            sc.partial->prev_partial = slab;
+        }
+        sc.partial = slab;
+        slab->in_partial = true;
+    }
+
+    void BufferPool::unlink_partial(Slab* slab) {
+        SizeClass& sc = classes_[slab->size_class];
+        if (slab->prev_partial) {
+            slab->prev_partial->next_partial = slab->next_partial;
+        } else {
+            sc.partial = slab->next_partial;
+        }
+        if (slab->next_partial) {
+            slab->next_partial->prev_partial = slab->prev_partial;
+        }
+        slab->prev_partial = nullptr;
+        slab->next_partial = nullptr;
+        slab->in_partial = false;
+    }
+
+}
@@ -0,0 +1,283 @@
+#include "network/connection.h"
+#include "network/tcp_server.h"
+#include <foundation/clock.h>
+#include <spdlog/spdlog.h>
+
+namespace network {
+
+    Connection::Connection(TcpServer& server, uint64_t id)
+        : server_(server),
+          reader_(server.buffer_pool_,
+                  FrameDecoder(server.options_.framing, server.options_.max_frame_size),
+                  server.options_.read_buffer_size),
+          outbound_(server.options_.outbound),
+          idle_timer_([this] { on_idle_timeout(); }),
+          write_timer_([this] { on_write_timeout(); }),
+          id_(id) {
+    }
+
+    void Connection::send(SharedPayload payload, uint64_t coalesce_key) {
+        if (closing_ || close_pending_ || payload.empty()) {
+            return;
+        }
+
+        if (outbound_.push(std::move(payload), coalesce_key) == OutboundQueue::Admission::Evict) {
+            spdlog::warn("Connection {} evicted as a slow consumer ({} bytes queued)",
+                         id_, outbound_.queued_bytes());
+            close_soon();
+            return;
+        }
+
+        if (server_.options_.flush_mode == FlushMode::Immediate) {
+            flush();
+        } else if (!flush_scheduled_) {
+            flush_scheduled_ = true;
+            server_.schedule_flush(this);
+        }
+    }
+
+    void Connection::send(std::string_view data) {
+        if (!closing_ && !data.empty()) {
+            send(SharedPayload::copy_of(data));
+        }
+    }
+
+    void Connection::close() {
+        if (closing_) {
+            return;
+        }
+        closing_ = true;
+        outbound_.clear();
+        if (close_pending_) {
+            server_.cancel_deferred_close(this);
+        }
+        if (flush_scheduled_) {
+            server_.cancel_scheduled_flush(this);
+        }
+        idle_timer_.cancel();
+        write_timer_.cancel();
+
+        server_.detach(this);
+        if (server_.on_close_) {
+            server_.on_close_(*this);
+        }
+        if (server_.uring_) {
+            server_.uring_->shutdown(*this);
+        } else {
+            uv_close(reinterpret_cast<uv_handle_t*>(&handle_), on_closed);
+        }
+    }
+
+    std::string Connection::peer_address() const {
+        sockaddr_storage addr{};
+        int len = sizeof(addr);
+        int r = server_.uring_
+            ? UringTransport::peer_name(fd_, reinterpret_cast<sockaddr*>(&addr), &len)
+            : uv_tcp_getpeername(&handle_, reinterpret_cast<sockaddr*>(&addr), &len);
+        if (r != 0) {
+            return {};
+        }
+
+        char host[64] = {};
+        int port = 0;
+        if (addr.ss_family == AF_INET6) {
+            auto* in6 = reinterpret_cast<const sockaddr_in6*>(&addr);
+            uv_ip6_name(in6, host, sizeof(host));
+            port = ntohs(in6->sin6_port);
+        } else {
+            auto* in4 = reinterpret_cast<const sockaddr_in*>(&addr);
+            uv_ip4_name(in4, host, sizeof(host));
+            port = ntohs(in4->sin_port);
+        }
+        return std::string(host) + ":" + std::to_string(port);
+    }
+
+    void Connection::on_alloc(uv_handle_t* handle, size_t /*suggested_size*/, uv_buf_t* buf) {
+        auto* conn = static_cast<Connection*>(handle->data);
+        *buf = conn->reader_.prepare();
+    }
+
+    void Connection::start_reading() {
+        if (server_.uring_) {
+            server_.uring_->start_reading(*this);
+        } else {
+            uv_read_start(reinterpret_cast<uv_stream_t*>(&handle_), on_alloc, on_read);
+        }
+    }
+
+    void Connection::received(const char* data, size_t size) {
+        last_read_ms_ = uv_now(server_.loop_);
+        bool ok = reader_.feed(std::span<const char>(data, size), [this](std::string_view frame) {
+            deliver(frame);
+        });
+        if (!ok) {
+            spdlog::warn("Connection {} sent a malformed or oversized frame", id_);
+            close();
+        }
+    }
+
+    void Connection::deliver(std::string_view frame) {
+        if (!closing_ && server_.on_data_) {
+            server_.on_data_(*this, std::span<const char>(frame.data(), frame.size()));
+        }
+    }
+
+    void Connection::on_read(uv_stream_t* stream, ssize_t nread, const uv_buf_t* /*buf*/) {
+        auto* conn = static_cast<Connection*>(stream->data);
+        TcpServer& server = conn->server_;
+
+        if (nread > 0) {
+            conn->last_read_ms_ = uv_now(server.loop_);
+            bool ok = conn->reader_.commit(static_cast<size_t>(nread), [conn](std::string_view frame) {
+                conn->deliver(frame);
+            });
+            if (!ok) {
+                spdlog::warn("Connection {} sent a malformed or oversized frame", conn->id_);
+                conn->close();
+            }
+            return;
+        }
+
+        if (nread == 0) {
+            if (conn->reader_.buffered() == 0) {
+                conn->reader_.release();
+            }
+            return;
+        }
+
+        if (nread != UV_EOF) {
+            spdlog::error("Read error: {}", uv_strerror(static_cast<int>(nread)));
+        }
+        conn->close();
+    }
+
+    void Connection::flush() {
+        if (closing_ || close_pending_ || write_inflight_ || outbound_.empty()) {
+            return;
+        }
+        auto* stream = reinterpret_cast<uv_stream_t*>(&handle_);
+        uv_buf_t bufs[WriteRequest::MAX_BUFS];
+        foundation::LatencyRecorder* latency = server_.options_.write_latency;
+        const uint64_t started = latency ? foundation::TscClock::ticks() : 0;
+
+        if (server_.uring_) {
+            // Completion-based: no readiness probe, the batch goes out as one sendmsg
+            size_t count = outbound_.gather(bufs, WriteRequest::MAX_BUFS);
+            WriteRequest* request = server_.write_pool_.acquire();
+            request->bytes = outbound_.take(count, request->payloads.data());
+            request->payload_count = count;
+            request->started_ticks = started;
+            server_.uring_->send(*this, request, bufs, count);
+            outbound_.count_write_call();
+            write_started();
+            return;
+        }
+
+        // Fast path: the socket usually has room, so no request is needed
+        size_t count = outbound_.gather(bufs, WriteRequest::MAX_BUFS);
+        int written = uv_try_write(stream, bufs, static_cast<unsigned int>(count));
+        outbound_.count_write_call();
+        if (written < 0 && written != UV_EAGAIN) {
+            spdlog::debug("Connection {} write failed: {}", id_, uv_strerror(written));
+            close_soon();
+            return;
+        }
+        outbound_.consume(written > 0 ? static_cast<size_t>(written) : 0);
+        if (outbound_.empty()) {
+            if (latency) {
+                latency->record(foundation::TscClock::to_ns(foundation::TscClock::ticks() - started));
+            }
+            return;
+        }
+
+        // The rest waits for writability inside libuv, one request at a time
+        count = outbound_.gather(bufs, WriteRequest::MAX_BUFS);
+        WriteRequest* request = server_.write_pool_.acquire();
+        request->bytes = outbound_.take(count, request->payloads.data());
+        request->payload_count = count;
+        request->started_ticks = started;
+
+        int r = uv_write(&request->req, stream, bufs, static_cast<unsigned int>(count), on_write);
+        outbound_.count_write_call();
+        if (r < 0) {
+            spdlog::debug("Connection {} write failed: {}", id_, uv_strerror(r));
+            outbound_.complete(request->bytes);
+            server_.write_pool_.release(request);
+            close_soon();
+            return;
+        }
+        write_started();
+    }
+
+    void Connection::write_started() {
+        write_inflight_ = true;
+        if (server_.options_.write_timeout_ms && !write_timer_.armed()) {
+            server_.timers_.schedule(write_timer_, server_.options_.write_timeout_ms);
+        }
+    }
+
+    void Connection::close_soon() {
+        if (closing_ || close_pending_) {
+            return;
+        }
+        close_pending_ = true;
+        if (!server_.uring_) {
+            uv_read_stop(reinterpret_cast<uv_stream_t*>(&handle_));
+        }
+        server_.defer_close(this);
+    }
+
+    void Connection::start_idle_timer() {
+        last_read_ms_ = uv_now(server_.loop_);
+        if (server_.options_.idle_timeout_ms) {
+            server_.timers_.schedule(idle_timer_, server_.options_.idle_timeout_ms);
+        }
+    }
+
+    void Connection::on_idle_timeout() {
+        // Reads only stamp last_read_ms_; the timer is re-armed lazily here
+        const uint64_t timeout = server_.options_.idle_timeout_ms;
+        const uint64_t idle = uv_now(server_.loop_) - last_read_ms_;
+        if (idle < timeout) {
+            server_.timers_.schedule(idle_timer_, timeout - idle);
+            return;
+        }
+        spdlog::info("Connection {} idle for {} ms, closing", id_, idle);
+        close();
+    }
+
+    void Connection::on_write_timeout() {
+        spdlog::warn("Connection {} made no write progress for {} ms, closing",
+                     id_, server_.options_.write_timeout_ms);
+        close();
+    }
+
+    void Connection::on_write(uv_write_t* req, int status) {
+        auto* conn = static_cast<Connection*>(req->handle->data);
+        conn->write_completed(WriteRequest::from(req), status);
+    }
+
+    void Connection::write_completed(WriteRequest* request, int status) {
+        write_inflight_ = false;
+        write_timer_.cancel();
+        if (foundation::LatencyRecorder* latency = server_.options_.write_latency; latency && status >= 0) {
+            latency->record(foundation::TscClock::to_ns(foundation::TscClock::ticks() - request->started_ticks));
+        }
+        outbound_.complete(request->bytes);
+        server_.write_pool_.release(request);
+
+        if (status < 0) {
+            if (status != UV_ECANCELED) {
+                spdlog::debug("Connection {} write error: {}", id_, uv_strerror(status));
+                close();
+            }
+            return;
+        }
+        flush();
+    }
+
+    void Connection::on_closed(uv_handle_t* handle) {
+        delete static_cast<Connection*>(handle->data);
+    }
+
+}
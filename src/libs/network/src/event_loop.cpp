@@ -0,0 +1,101 @@
+#include "network/event_loop.h"
+#include <spdlog/spdlog.h>
+#ifndef _WIN32
+#include <poll.h>
+#endif
+
+namespace network {
+
+    EventLoop::EventLoop() {
+        uv_loop_init(&loop_);
+        tasks_ = std::make_unique<AsyncQueue<Task>>(&loop_, [](std::unique_ptr<Task> task) {
+            task->fn();
+        });
+    }
+
+    EventLoop::~EventLoop() {
+        join();
+        tasks_->close();
+        uv_run(&loop_, UV_RUN_NOWAIT);  // Deliver pending close callbacks
+        tasks_.reset();
+
+        int r = uv_loop_close(&loop_);
+        if (r != 0) {
+            spdlog::warn("EventLoop destroyed with open handles: {}", uv_strerror(r));
+        }
+    }
+
+    int EventLoop::run() {
+        return uv_run(&loop_, UV_RUN_DEFAULT);
+    }
+
+    void EventLoop::start() {
+        thread_ = std::thread([this] { run(); });
+    }
+
+    int EventLoop::run(foundation::ThreadRunnerOptions options) {
+        uv_loop_configure(&loop_, UV_METRICS_IDLE_TIME);    // Blocking polls report their wait
+        runner_ = std::make_unique<foundation::ThreadRunner>(std::move(options));
+        runner_->run([this](bool block) { return poll(block); });
+        return 0;
+    }
+
+    void EventLoop::start(foundation::ThreadRunnerOptions options) {
+        uv_loop_configure(&loop_, UV_METRICS_IDLE_TIME);
+        runner_ = std::make_unique<foundation::ThreadRunner>(std::move(options));
+        runner_->start([this](bool block) { return poll(block); });
+    }
+
+    foundation::ThreadRunnerStats EventLoop::runner_stats() const {
+        return runner_ ? runner_->stats() : foundation::ThreadRunnerStats{};
+    }
+
+    // One loop iteration. Every poll runs a libuv pass, so its prepare and
+    // check handles and the watchers callbacks started reach the kernel
+    // before the next wait; the pass counts as worked when the backend had
+    // events or a timer, pending callback or close was due. With nothing
+    // due, a blocking poll waits inside that pass and reports the wait.
+    foundation::PollResult EventLoop::poll(bool block) {
+#ifndef _WIN32
+        uv_update_time(&loop_);     // Timer deadlines are measured from the cached loop time
+        bool ready = uv_backend_timeout(&loop_) == 0;
+        if (!ready) {
+            pollfd backend{uv_backend_fd(&loop_), POLLIN, 0};
+            ready = ::poll(&backend, 1, 0) > 0;
+        }
+        if (!ready && block) {
+            const uint64_t idle = uv_metrics_idle_time(&loop_);
+            const int alive = uv_run(&loop_, UV_RUN_ONCE);
+            runner_->blocked(uv_metrics_idle_time(&loop_) - idle);
+            return alive ? foundation::PollResult::Worked : foundation::PollResult::Done;
+        }
+        if (!uv_run(&loop_, UV_RUN_NOWAIT)) {
+            return foundation::PollResult::Done;
+        }
+        return ready ? foundation::PollResult::Worked : foundation::PollResult::Idle;
+#else
+        const uv_run_mode mode = block ? UV_RUN_ONCE : UV_RUN_NOWAIT;
+        return uv_run(&loop_, mode) ? foundation::PollResult::Worked : foundation::PollResult::Done;
+#endif
+    }
+
+    void EventLoop::join() {
+        if (thread_.joinable()) {
+            thread_.join();
+        }
+        if (runner_) {
+            runner_->join();
+        }
+    }
+
+    void EventLoop::post(std::function<void()> task) {
+        auto item = std::make_unique<Task>();
+        item->fn = std::move(task);
+        tasks_->post(std::move(item));
+    }
+
+    void EventLoop::stop() {
+        post([this] { tasks_->close(); });
+    }
+
+}
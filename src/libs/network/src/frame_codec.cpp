@@ -0,0 +1,83 @@
+#include "network/frame_codec.h"
+#include <bit>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define NETWORK_HAVE_SSE2 1
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define NETWORK_HAVE_NEON 1
+#endif
+
+namespace network {
+
+    size_t find_delimiter(const char* data, size_t size, char delim) {
+        size_t i = 0;
+
+#if defined(NETWORK_HAVE_SSE2)
+        const __m128i needle = _mm_set1_epi8(delim);
+        for (; i + 16 <= size; i += 16) {
+            __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+            unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, needle)));
+            if (mask != 0) {
+                return i + std::countr_zero(mask);
+            }
+        }
+#elif defined(NETWORK_HAVE_NEON)
+        const uint8x16_t needle = vdupq_n_u8(static_cast<uint8_t>(delim));
+        for (; i + 16 <= size; i += 16) {
+            uint8x16_t eq = vceqq_u8(vld1q_u8(reinterpret_cast<const uint8_t*>(data + i)), needle);
+            // Narrow each byte to 4 bits so the match mask fits in 64 bits
+            uint64_t mask = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(eq), 4)), 0);
+            if (mask != 0) {
+                return i + (std::countr_zero(mask) >> 2);
+            }
+        }
+#endif
+
+        for (; i < size; ++i) {
+            if (data[i] == delim) {
+                return i;
+            }
+        }
+        return size;
+    }
+
+    SharedPayload allocate_frame(FrameMode mode, size_t body_size, char** body) {
+        SharedPayload payload;
+        switch (mode) {
+        case FrameMode::LengthPrefixed: {
+            payload = SharedPayload::allocate(FRAME_HEADER_SIZE + body_size);
+            auto* header = reinterpret_cast<unsigned char*>(payload.mutable_data());
+            const auto length = static_cast<uint32_t>(body_size);
+            header[0] = static_cast<unsigned char>(length >> 24);
+            header[1] = static_cast<unsigned char>(length >> 16);
+            header[2] = static_cast<unsigned char>(length >> 8);
+            header[3] = static_cast<unsigned char>(length);
+            *body = payload.mutable_data() + FRAME_HEADER_SIZE;
+            break;
+        }
+        case FrameMode::NewlineDelimited:
+            payload = SharedPayload::allocate(body_size + 1);
+            payload.mutable_data()[body_size] = '\n';
+            *body = payload.mutable_data();
+            break;
+        case FrameMode::Raw:
+            payload = SharedPayload::allocate(body_size);
+            *body = payload.mutable_data();
+            break;
+        }
+        return payload;
+    }
+
+    SharedPayload encode_frame(FrameMode mode, std::string_view body) {
+        char* out = nullptr;
+        SharedPayload payload = allocate_frame(mode, body.size(), &out);
+        if (!body.empty()) {
+            std::memcpy(out, body.data(), body.size());
+        }
+        return payload;
+    }
+
+}
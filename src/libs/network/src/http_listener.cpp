@@ -0,0 +1,181 @@
+#include "network/http_listener.h"
+#include <fmt/format.h>
+#include <spdlog/spdlog.h>
+
+namespace network {
+
+    struct HttpListener::Request {
+        explicit Request(HttpListener& owner) : owner(owner) {}
+
+        HttpListener& owner;
+        uv_tcp_t handle;
+        uv_write_t write;
+        char buffer[2048];
+        std::string received;
+        std::string response;
+        bool responded = false;
+        bool closing = false;
+    };
+
+    namespace {
+        const char* reason(int status) {
+            switch (status) {
+            case 200:
+                return "OK";
+            case 400:
+                return "Bad Request";
+            case 404:
+                return "Not Found";
+            case 405:
+                return "Method Not Allowed";
+            case 503:
+                return "Service Unavailable";
+            default:
+                return status < 400 ? "OK" : "Error";
+            }
+        }
+    }
+
+    HttpListener::HttpListener(uv_loop_t* loop, Handler handler) : loop_(loop), handler_(std::move(handler)) {}
+
+    HttpListener::~HttpListener() {
+        if (!requests_.empty()) {
+            spdlog::warn("HttpListener destroyed with {} open requests", requests_.size());
+        }
+    }
+
+    int HttpListener::listen(const std::string& host, int port) {
+        sockaddr_storage addr{};
+        int r = uv_ip4_addr(host.c_str(), port, reinterpret_cast<sockaddr_in*>(&addr));
+        if (r != 0) {
+            r = uv_ip6_addr(host.c_str(), port, reinterpret_cast<sockaddr_in6*>(&addr));
+        }
+        if (r != 0) {
+            return r;
+        }
+        r = uv_tcp_init(loop_, &listener_);
+        if (r != 0) {
+            return r;
+        }
+        listener_.data = this;
+        listener_open_ = true;
+        r = uv_tcp_bind(&listener_, reinterpret_cast<const sockaddr*>(&addr), 0);
+        if (r != 0) {
+            return r;
+        }
+        return uv_listen(reinterpret_cast<uv_stream_t*>(&listener_), 64, on_connection);
+    }
+
+    int HttpListener::bound_port() const {
+        sockaddr_storage addr{};
+        int len = sizeof(addr);
+        if (!listener_open_ ||
+            uv_tcp_getsockname(&listener_, reinterpret_cast<sockaddr*>(&addr), &len) != 0) {
+            return -1;
+        }
+        if (addr.ss_family == AF_INET6) {
+            return ntohs(reinterpret_cast<const sockaddr_in6*>(&addr)->sin6_port);
+        }
+        return ntohs(reinterpret_cast<const sockaddr_in*>(&addr)->sin_port);
+    }
+
+    void HttpListener::close() {
+        auto* listener = reinterpret_cast<uv_handle_t*>(&listener_);
+        if (listener_open_ && !uv_is_closing(listener)) {
+            uv_close(listener, nullptr);
+        }
+        // close_request() only erases once libuv releases the handle
+        for (Request* request : requests_) {
+            close_request(request);
+        }
+    }
+
+    void HttpListener::on_connection(uv_stream_t* listener, int status) {
+        auto* self = static_cast<HttpListener*>(listener->data);
+        if (status < 0) {
+            spdlog::error("HTTP accept error: {}", uv_strerror(status));
+            return;
+        }
+        auto* request = new Request(*self);
+        uv_tcp_init(self->loop_, &request->handle);
+        request->handle.data = request;
+        self->requests_.insert(request);
+
+        auto* stream = reinterpret_cast<uv_stream_t*>(&request->handle);
+        if (uv_accept(listener, stream) != 0) {
+            self->close_request(request);
+            return;
+        }
+        uv_read_start(
+            stream,
+            [](uv_handle_t* handle, size_t, uv_buf_t* buf) {
+                auto* request = static_cast<Request*>(handle->data);
+                *buf = uv_buf_init(request->buffer, sizeof(request->buffer));
+            },
+            [](uv_stream_t* stream, ssize_t nread, const uv_buf_t* buf) {
+                auto* request = static_cast<Request*>(stream->data);
+                if (nread < 0) {
+                    request->owner.close_request(request);
+                } else if (nread > 0 && !request->responded) {
+                    request->received.append(buf->base, static_cast<size_t>(nread));
+                    request->owner.received(request);
+                }
+            });
+    }
+
+    void HttpListener::received(Request* request) {
+        HttpResponse response;
+        const size_t end = request->received.find("\r\n\r\n");
+        if (end == std::string::npos) {
+            if (request->received.size() <= MAX_REQUEST_BYTES) {
+                return;     // Headers not complete yet
+            }
+            response = {400, "text/plain; charset=utf-8", "request too large\n"};
+        } else {
+            // "GET /path?query HTTP/1.1"
+            const std::string_view head(request->received.data(), end);
+            const std::string_view line = head.substr(0, head.find("\r\n"));
+            const size_t method_end = line.find(' ');
+            const size_t target_end = line.find(' ', method_end == std::string_view::npos ? line.size() : method_end + 1);
+            if (method_end == std::string_view::npos || target_end == std::string_view::npos) {
+                response = {400, "text/plain; charset=utf-8", "malformed request line\n"};
+            } else {
+                std::string_view path = line.substr(method_end + 1, target_end - method_end - 1);
+                path = path.substr(0, path.find('?'));
+                response = handler_(line.substr(0, method_end), path);
+            }
+        }
+
+        request->responded = true;
+        request->response = fmt::format("HTTP/1.1 {} {}\r\nContent-Type: {}\r\nContent-Length: {}\r\n"
+                                        "Connection: close\r\n\r\n",
+                                        response.status, reason(response.status), response.content_type,
+                                        response.body.size());
+        request->response += response.body;
+        uv_read_stop(reinterpret_cast<uv_stream_t*>(&request->handle));
+
+        request->write.data = request;
+        uv_buf_t buf = uv_buf_init(request->response.data(), static_cast<unsigned int>(request->response.size()));
+        int r = uv_write(&request->write, reinterpret_cast<uv_stream_t*>(&request->handle), &buf, 1,
+                         [](uv_write_t* write, int) {
+                             auto* request = static_cast<Request*>(write->data);
+                             request->owner.close_request(request);
+                         });
+        if (r != 0) {
+            close_request(request);
+        }
+    }
+
+    void HttpListener::close_request(Request* request) {
+        if (request->closing) {
+            return;
+        }
+        request->closing = true;
+        uv_close(reinterpret_cast<uv_handle_t*>(&request->handle), [](uv_handle_t* handle) {
+            auto* request = static_cast<Request*>(handle->data);
+            request->owner.requests_.erase(request);
+            delete request;
+        });
+    }
+
+}
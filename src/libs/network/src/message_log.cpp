@@ -0,0 +1,380 @@
+#include "network/message_log.h"
+#include <uv.h>
+#include <spdlog/spdlog.h>
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <system_error>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace network {
+
+    struct MessageLog::Segment {
+        uint64_t base_seq = 0;
+        std::string path;
+        char* map = nullptr;            // No descriptor is kept once mapped
+        size_t capacity = 0;            // Mapped bytes
+        size_t used = 0;
+        std::vector<uint32_t> offsets;  // Start of each record
+        uint64_t last_write_ms = 0;
+
+        size_t end_of(size_t index) const { return index < offsets.size() ? offsets[index] : used; }
+
+        ~Segment() {
+#if !defined(_WIN32)
+            if (map) {
+                munmap(map, capacity);
+            }
+#endif
+        }
+    };
+
+    MessageLog::MessageLog(std::string directory, MessageLogOptions options)
+        : directory_(std::move(directory)), options_(options) {}
+
+    MessageLog::~MessageLog() {
+#if !defined(_WIN32)
+        // Give the active segment back its real length
+        if (writable_ && !segments_.empty()) {
+            const Segment& active = *segments_.back();
+            if (::truncate(active.path.c_str(), static_cast<off_t>(active.used)) != 0) {
+                spdlog::warn("Could not trim {}: {}", active.path, std::strerror(errno));
+            }
+        }
+#endif
+    }
+
+    uint64_t MessageLog::wall_clock_ms() {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                                         std::chrono::system_clock::now().time_since_epoch())
+                                         .count());
+    }
+
+    uint64_t MessageLog::first_seq() const {
+        return segments_.empty() ? 0 : segments_.front()->base_seq;
+    }
+
+    uint64_t MessageLog::next_seq() const {
+        return segments_.empty() ? 0 : segments_.back()->base_seq + segments_.back()->offsets.size();
+    }
+
+    uint64_t MessageLog::bytes() const {
+        uint64_t total = 0;
+        for (const auto& segment : segments_) {
+            total += segment->used;
+        }
+        return total;
+    }
+
+    size_t MessageLog::read(uint64_t from_seq, size_t max_bytes, std::vector<SharedPayload>& out) const {
+        const uint64_t from = std::max(from_seq, first_seq());
+        size_t budget = max_bytes;
+        size_t records = 0;
+        size_t first_out = out.size();
+
+        // Newest segment first so the byte budget keeps the most recent records
+        for (auto it = segments_.rbegin(); it != segments_.rend() && budget > 0; ++it) {
+            const Segment& segment = **it;
+            const uint64_t end_seq = segment.base_seq + segment.offsets.size();
+            if (end_seq <= from || segment.offsets.empty()) {
+                if (segment.base_seq <= from) {
+                    break;
+                }
+                continue;
+            }
+            size_t lo = static_cast<size_t>(from > segment.base_seq ? from - segment.base_seq : 0);
+            const size_t hi = segment.offsets.size();
+            if (segment.used - segment.offsets[lo] > budget) {
+                // Smallest index whose suffix fits
+                auto fits = std::lower_bound(segment.offsets.begin() + lo, segment.offsets.end(),
+                                             segment.used - budget);
+                lo = static_cast<size_t>(fits - segment.offsets.begin());
+                budget = 0;
+                if (lo == hi) {
+                    break;
+                }
+            } else {
+                budget -= segment.used - segment.offsets[lo];
+            }
+            const size_t begin = segment.offsets[lo];
+            out.push_back(SharedPayload::view_of(
+                *it, std::string_view(segment.map + begin, segment.end_of(hi) - begin)));
+            records += hi - lo;
+            if (segment.base_seq <= from) {
+                break;
+            }
+        }
+        std::reverse(out.begin() + static_cast<std::ptrdiff_t>(first_out), out.end());
+        return records;
+    }
+
+    size_t MessageLog::read_last(size_t count, size_t max_bytes, std::vector<SharedPayload>& out) const {
+        const uint64_t next = next_seq();
+        const uint64_t available = next - first_seq();
+        return read(next - std::min<uint64_t>(count, available), max_bytes, out);
+    }
+
+#if !defined(_WIN32)
+
+    namespace {
+        int uv_error(int err) {
+            return -err;
+        }
+
+        std::string segment_path(const std::string& directory, uint64_t base_seq) {
+            char name[32];
+            std::snprintf(name, sizeof(name), "%020llu.log", static_cast<unsigned long long>(base_seq));
+            return (std::filesystem::path(directory) / name).string();
+        }
+
+        // Allocate every block of a new segment up front: a store through
+        // the mapping into a hole the filesystem cannot fill is a SIGBUS,
+        // not an error. Returns 0 or an errno value.
+        int reserve(int fd, size_t size) {
+#if !defined(__APPLE__)
+            const int err = posix_fallocate(fd, 0, static_cast<off_t>(size));
+            if (err != EOPNOTSUPP && err != ENOSYS) {
+                return err;
+            }
+#endif
+            // No fallocate for this file: write the zeros instead
+            static const char zeros[64 * 1024] = {};
+            for (size_t offset = 0; offset < size;) {
+                const ssize_t n = pwrite(fd, zeros, std::min(sizeof(zeros), size - offset), static_cast<off_t>(offset));
+                if (n < 0) {
+                    if (errno == EINTR) {
+                        continue;
+                    }
+                    return errno;
+                }
+                offset += static_cast<size_t>(n);
+            }
+            return 0;
+        }
+    }
+
+    int MessageLog::open() {
+        std::error_code ec;
+        std::filesystem::create_directories(directory_, ec);
+        if (ec) {
+            return uv_error(ec.value());
+        }
+
+        std::vector<std::pair<uint64_t, std::string>> files;
+        for (const auto& entry : std::filesystem::directory_iterator(directory_, ec)) {
+            const auto& path = entry.path();
+            if (path.extension() != ".log") {
+                continue;
+            }
+            const std::string stem = path.stem().string();
+            char* end = nullptr;
+            const uint64_t base = std::strtoull(stem.c_str(), &end, 10);
+            if (!stem.empty() && *end == '\0') {
+                files.emplace_back(base, path.string());
+            }
+        }
+        if (ec) {
+            return uv_error(ec.value());
+        }
+        std::sort(files.begin(), files.end());
+
+        for (const auto& [base, path] : files) {
+            int r = recover(path, base);
+            if (r != 0) {
+                segments_.clear();
+                return r;
+            }
+        }
+        return 0;
+    }
+
+    int MessageLog::recover(const std::string& path, uint64_t base_seq) {
+        int fd = ::open(path.c_str(), O_RDWR | O_CLOEXEC);
+        if (fd < 0) {
+            return uv_error(errno);
+        }
+        struct stat st {};
+        if (fstat(fd, &st) != 0) {
+            int err = errno;
+            ::close(fd);
+            return uv_error(err);
+        }
+        auto segment = std::make_shared<Segment>();
+        segment->base_seq = base_seq;
+        segment->path = path;
+        segment->capacity = static_cast<size_t>(st.st_size);
+        segment->last_write_ms = static_cast<uint64_t>(st.st_mtime) * 1000;
+        if (segment->capacity == 0) {
+            ::close(fd);
+            std::filesystem::remove(path);
+            return 0;
+        }
+        void* map = mmap(nullptr, segment->capacity, PROT_READ, MAP_SHARED, fd, 0);
+        if (map == MAP_FAILED) {
+            int err = errno;
+            ::close(fd);
+            return uv_error(err);
+        }
+        segment->map = static_cast<char*>(map);
+
+        // A segment that was not closed cleanly is zero-filled past its last
+        // record; empty frames are never logged, so the first one ends it.
+        // Records are walked header to header and nothing past that point is
+        // read, so recovery only touches the pages actually written
+        const char* data = segment->map;
+        const size_t capacity = segment->capacity;
+        size_t pos = 0;
+        while (pos < capacity) {
+            size_t end;
+            if (options_.framing == FrameMode::LengthPrefixed) {
+                if (capacity - pos < FRAME_HEADER_SIZE) {
+                    break;
+                }
+                const auto* b = reinterpret_cast<const unsigned char*>(data + pos);
+                const size_t length = (size_t(b[0]) << 24) | (size_t(b[1]) << 16) | (size_t(b[2]) << 8) | size_t(b[3]);
+                if (length == 0 || length > capacity - pos - FRAME_HEADER_SIZE) {
+                    break;
+                }
+                end = pos + FRAME_HEADER_SIZE + length;
+            } else if (options_.framing == FrameMode::NewlineDelimited) {
+                // The zero fill has no newline; a line never starts with NUL
+                if (data[pos] == '\0') {
+                    break;
+                }
+                const size_t newline = pos + find_delimiter(data + pos, capacity - pos, '\n');
+                if (newline == capacity || newline == pos || (newline == pos + 1 && data[pos] == '\r')) {
+                    break;
+                }
+                end = newline + 1;
+            } else {
+                end = capacity;     // Raw records have no boundaries to recover
+            }
+            segment->offsets.push_back(static_cast<uint32_t>(pos));
+            segment->used = end;
+            pos = end;
+        }
+
+        if (segment->used < segment->capacity) {
+            spdlog::warn("Recovered {} records from {}, dropping {} trailing bytes", segment->offsets.size(),
+                         path, segment->capacity - segment->used);
+            if (ftruncate(fd, static_cast<off_t>(segment->used)) != 0) {
+                spdlog::warn("Could not trim {}: {}", path, std::strerror(errno));
+            }
+        }
+        ::close(fd);
+        if (segment->offsets.empty()) {
+            std::filesystem::remove(path);
+            return 0;
+        }
+        segments_.push_back(std::move(segment));
+        writable_ = false;
+        return 0;
+    }
+
+    int MessageLog::roll(size_t min_capacity) {
+        if (writable_) {
+            const Segment& active = *segments_.back();
+            if (::truncate(active.path.c_str(), static_cast<off_t>(active.used)) != 0) {
+                spdlog::warn("Could not trim {}: {}", active.path, std::strerror(errno));
+            }
+            writable_ = false;
+        }
+
+        auto segment = std::make_shared<Segment>();
+        segment->base_seq = next_seq();
+        segment->path = segment_path(directory_, segment->base_seq);
+        segment->capacity = std::max(options_.segment_bytes, min_capacity);
+        const int fd = ::open(segment->path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd < 0) {
+            return uv_error(errno);
+        }
+        int err = reserve(fd, segment->capacity);
+        void* map = MAP_FAILED;
+        if (err == 0) {
+            map = mmap(nullptr, segment->capacity, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+            err = map == MAP_FAILED ? errno : 0;
+        }
+        // The mapping keeps the file; a log per room must not hold a descriptor each
+        ::close(fd);
+        if (err != 0) {
+            std::filesystem::remove(segment->path);
+            return uv_error(err);
+        }
+        segment->map = static_cast<char*>(map);
+        segments_.push_back(std::move(segment));
+        writable_ = true;
+
+        enforce_retention(wall_clock_ms());
+        return 0;
+    }
+
+    int MessageLog::append(std::string_view record, uint64_t* seq) {
+        if (record.empty() || record.size() > UINT32_MAX) {
+            return UV_EINVAL;
+        }
+        if (!writable_ || segments_.back()->capacity - segments_.back()->used < record.size()) {
+            int r = roll(record.size());
+            if (r != 0) {
+                return r;
+            }
+        }
+        Segment& active = *segments_.back();
+        std::memcpy(active.map + active.used, record.data(), record.size());
+        active.offsets.push_back(static_cast<uint32_t>(active.used));
+        active.used += record.size();
+        active.last_write_ms = wall_clock_ms();
+        if (seq) {
+            *seq = active.base_seq + active.offsets.size() - 1;
+        }
+        return 0;
+    }
+
+    void MessageLog::enforce_retention(uint64_t now_ms) {
+        uint64_t total = bytes();
+        // The segment being appended to is never deleted
+        while (segments_.size() > 1) {
+            const Segment& oldest = *segments_.front();
+            const bool too_big = options_.retain_bytes && total > options_.retain_bytes;
+            const bool too_old = options_.retain_ms && oldest.last_write_ms + options_.retain_ms < now_ms;
+            if (!too_big && !too_old) {
+                break;
+            }
+            std::error_code ec;
+            std::filesystem::remove(oldest.path, ec);
+            total -= oldest.used;
+            segments_.pop_front();
+        }
+    }
+
+#else
+
+    int MessageLog::open() {
+        return UV_ENOSYS;
+    }
+
+    int MessageLog::recover(const std::string&, uint64_t) {
+        return UV_ENOSYS;
+    }
+
+    int MessageLog::roll(size_t) {
+        return UV_ENOSYS;
+    }
+
+    int MessageLog::append(std::string_view, uint64_t*) {
+        return UV_ENOSYS;
+    }
+
+    void MessageLog::enforce_retention(uint64_t) {}
+
+#endif
+
+}
@@ -0,0 +1,151 @@
+#include "network/outbound_queue.h"
+#include <algorithm>
+#include <utility>
+
+namespace network {
+
+    OutboundQueue::OutboundQueue(OutboundOptions options) : options_(options) {
+        options_.low_watermark = std::min(options_.low_watermark, options_.high_watermark);
+    }
+
+    OutboundQueue::Admission OutboundQueue::push(SharedPayload payload, uint64_t coalesce_key) {
+        const size_t size = payload.size();
+
+        const bool over = queued_bytes() > 0 && queued_bytes() + size > options_.high_watermark;
+        if (congested_ || over) {
+            switch (options_.policy) {
+            case SlowConsumerPolicy::Disconnect:
+                stats_.messages_dropped++;
+                stats_.bytes_dropped += size;
+                return Admission::Evict;
+
+            case SlowConsumerPolicy::DropOldest:
+                // Only untouched messages may go; a partly written one must finish
+                while (count_ > 0 && at(0).offset == 0 &&
+                       queued_bytes() + size > options_.high_watermark) {
+                    drop_front();
+                }
+                break;
+
+            case SlowConsumerPolicy::Coalesce:
+                if (coalesce_key != 0) {
+                    for (size_t i = count_; i-- > 0;) {
+                        Entry& entry = at(i);
+                        if (entry.key == coalesce_key && entry.offset == 0) {
+                            pending_bytes_ = pending_bytes_ - entry.payload.size() + size;
+                            entry.payload = std::move(payload);
+                            stats_.messages_coalesced++;
+                            update_congestion();
+                            return Admission::Coalesced;
+                        }
+                    }
+                }
+                stats_.messages_dropped++;
+                stats_.bytes_dropped += size;
+                update_congestion();
+                return Admission::Dropped;
+            }
+        }
+
+        if (count_ == ring_.size()) {
+            // Grow to the next power of two, unrolling the ring
+            std::vector<Entry> bigger(std::max<size_t>(16, ring_.size() * 2));
+            for (size_t i = 0; i < count_; ++i) {
+                bigger[i] = std::move(at(i));
+            }
+            ring_ = std::move(bigger);
+            head_ = 0;
+        }
+
+        Entry& entry = at(count_);
+        entry.payload = std::move(payload);
+        entry.key = coalesce_key;
+        entry.offset = 0;
+        count_++;
+        pending_bytes_ += size;
+        update_congestion();
+        return Admission::Queued;
+    }
+
+    size_t OutboundQueue::gather(uv_buf_t* bufs, size_t max) const {
+        const size_t n = std::min(max, count_);
+        for (size_t i = 0; i < n; ++i) {
+            const Entry& entry = at(i);
+            bufs[i] = uv_buf_init(const_cast<char*>(entry.payload.data()) + entry.offset,
+                                  static_cast<unsigned int>(entry.payload.size() - entry.offset));
+        }
+        return n;
+    }
+
+    void OutboundQueue::consume(size_t bytes) {
+        stats_.bytes_sent += bytes;
+        pending_bytes_ -= bytes;
+        while (bytes > 0 && count_ > 0) {
+            Entry& entry = at(0);
+            const size_t remaining = entry.payload.size() - entry.offset;
+            if (bytes < remaining) {
+                entry.offset += bytes;
+                break;
+            }
+            bytes -= remaining;
+            stats_.messages_sent++;
+            pop_front();
+        }
+        update_congestion();
+    }
+
+    size_t OutboundQueue::take(size_t count, SharedPayload* out) {
+        size_t bytes = 0;
+        count = std::min(count, count_);
+        for (size_t i = 0; i < count; ++i) {
+            Entry& entry = at(0);
+            bytes += entry.payload.size() - entry.offset;
+            out[i] = std::move(entry.payload);
+            stats_.messages_sent++;
+            pop_front();
+        }
+        pending_bytes_ -= bytes;
+        inflight_bytes_ += bytes;
+        stats_.bytes_sent += bytes;
+        return bytes;
+    }
+
+    void OutboundQueue::complete(size_t bytes) {
+        inflight_bytes_ -= std::min(bytes, inflight_bytes_);
+        update_congestion();
+    }
+
+    void OutboundQueue::clear() {
+        while (count_ > 0) {
+            drop_front();
+        }
+        update_congestion();
+    }
+
+    void OutboundQueue::pop_front() {
+        Entry& entry = at(0);
+        entry.payload.reset();
+        head_ = (head_ + 1) & (ring_.size() - 1);
+        count_--;
+    }
+
+    void OutboundQueue::drop_front() {
+        const Entry& entry = at(0);
+        const size_t remaining = entry.payload.size() - entry.offset;
+        pending_bytes_ -= remaining;
+        stats_.messages_dropped++;
+        stats_.bytes_dropped += remaining;
+        pop_front();
+    }
+
+    void OutboundQueue::update_congestion() {
+        const size_t queued = queued_bytes();
+        if (!congested_ && queued >= options_.high_watermark) {
+            congested_ = true;
+            stats_.congestion_events++;
+        } else if (congested_ && queued <= options_.low_watermark) {
+            congested_ = false;
+        }
+    }
+
+}
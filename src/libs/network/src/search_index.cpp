@@ -0,0 +1,429 @@
+#include "network/search_index.h"
+#include <algorithm>
+#include <tuple>
+
+namespace network {
+
+    namespace {
+        struct TermHash {
+            using is_transparent = void;
+            size_t operator()(std::string_view term) const { return std::hash<std::string_view>{}(term); }
+        };
+
+        template <typename Fn>
+        void for_each_term(std::string_view text, Fn&& fn) {
+            char term[SearchIndex::MAX_TERM];
+            size_t size = 0;
+            for (char c : text) {
+                const auto byte = static_cast<unsigned char>(c);
+                const bool word = (byte >= 'a' && byte <= 'z') || (byte >= '0' && byte <= '9') || byte >= 0x80;
+                const bool upper = byte >= 'A' && byte <= 'Z';
+                if (word || upper) {
+                    if (size < sizeof(term)) {
+                        term[size++] = upper ? static_cast<char>(byte + ('a' - 'A')) : c;
+                    }
+                } else if (size) {
+                    fn(std::string_view(term, size));
+                    size = 0;
+                }
+            }
+            if (size) {
+                fn(std::string_view(term, size));
+            }
+        }
+
+        void put_varint(std::string& out, uint64_t value) {
+            while (value >= 0x80) {
+                out.push_back(static_cast<char>(value | 0x80));
+                value >>= 7;
+            }
+            out.push_back(static_cast<char>(value));
+        }
+
+        uint64_t get_varint(const char*& p) {
+            uint64_t value = 0;
+            for (int shift = 0;; shift += 7) {
+                const auto byte = static_cast<unsigned char>(*p++);
+                value |= uint64_t(byte & 0x7f) << shift;
+                if (byte < 0x80) {
+                    return value;
+                }
+            }
+        }
+
+        // In place; both ascending
+        void intersect(std::vector<uint64_t>& acc, const std::vector<uint64_t>& other) {
+            auto out = acc.begin();
+            auto a = acc.begin();
+            auto b = other.begin();
+            while (a != acc.end() && b != other.end()) {
+                if (*a < *b) {
+                    ++a;
+                } else if (*b < *a) {
+                    ++b;
+                } else {
+                    *out++ = *a++;
+                    ++b;
+                }
+            }
+            acc.erase(out, acc.end());
+        }
+
+        // Newest first, until `limit`
+        void take_newest(const std::vector<uint64_t>& matches, size_t limit, std::vector<uint64_t>& results) {
+            for (auto it = matches.rbegin(); it != matches.rend() && results.size() < limit; ++it) {
+                results.push_back(*it);
+            }
+        }
+    }
+
+    // Ingest only looks up a term id and appends one entry; grouping the
+    // entries by term is left to encoding
+    struct SearchIndex::MemSegment {
+        struct Entry {
+            uint32_t term;
+            uint32_t ordinal;       // Index into docs
+        };
+
+        std::unordered_map<std::string, uint32_t, TermHash, std::equal_to<>> term_ids;
+        std::vector<const std::string*> terms;      // By id; keys of term_ids
+        std::vector<uint32_t> last_ordinal;         // By id, plus one; drops repeats within a document
+        std::vector<Entry> entries;
+        std::vector<uint64_t> docs;
+
+        explicit MemSegment(size_t capacity) {
+            docs.reserve(capacity);
+            entries.reserve(capacity * 8);
+        }
+
+        void add(uint64_t doc, std::string_view text, size_t max_bytes) {
+            const auto ordinal = static_cast<uint32_t>(docs.size());
+            docs.push_back(doc);
+            for_each_term(text.substr(0, max_bytes), [&](std::string_view term) {
+                auto it = term_ids.find(term);
+                if (it == term_ids.end()) {
+                    it = term_ids.emplace(std::string(term), static_cast<uint32_t>(terms.size())).first;
+                    terms.push_back(&it->first);
+                    last_ordinal.push_back(0);
+                } else if (last_ordinal[it->second] == ordinal + 1) {
+                    return;
+                }
+                last_ordinal[it->second] = ordinal + 1;
+                entries.push_back({it->second, ordinal});
+            });
+        }
+
+        void match(const std::vector<std::string>& query, std::vector<uint64_t>& out) const {
+            out.clear();
+            std::vector<uint32_t> ids;
+            for (const auto& term : query) {
+                auto it = term_ids.find(term);
+                if (it == term_ids.end()) {
+                    return;
+                }
+                ids.push_back(it->second);
+            }
+            // Bit k of hits[ordinal] is set once the document contains query term k
+            std::vector<uint64_t> hits(docs.size());
+            const uint64_t all = (uint64_t(1) << ids.size()) - 1;
+            for (const Entry& entry : entries) {
+                for (size_t k = 0; k < ids.size(); ++k) {
+                    if (entry.term == ids[k]) {
+                        hits[entry.ordinal] |= uint64_t(1) << k;
+                    }
+                }
+            }
+            for (size_t ordinal = 0; ordinal < docs.size(); ++ordinal) {
+                if (hits[ordinal] == all) {
+                    out.push_back(docs[ordinal]);
+                }
+            }
+        }
+
+        // Ordinals per term, ascending: a counting sort of the entries
+        std::vector<uint32_t> group(std::vector<uint32_t>& starts) const {
+            starts.assign(terms.size() + 1, 0);
+            for (const Entry& entry : entries) {
+                starts[entry.term + 1]++;
+            }
+            for (size_t i = 1; i < starts.size(); ++i) {
+                starts[i] += starts[i - 1];
+            }
+            std::vector<uint32_t> next(starts.begin(), starts.end() - 1);
+            std::vector<uint32_t> ordinals(entries.size());
+            for (const Entry& entry : entries) {
+                ordinals[next[entry.term]++] = entry.ordinal;
+            }
+            return ordinals;
+        }
+    };
+
+    struct SearchIndex::Segment {
+        struct Term {
+            uint32_t text_offset;
+            uint32_t text_size;
+            uint64_t postings_offset;
+            uint32_t count;
+        };
+
+        unsigned level = 0;
+        uint64_t first_doc = 0;
+        size_t docs = 0;
+        std::string text;               // Term bytes, back to back
+        std::vector<Term> terms;        // Sorted by text
+        std::string postings;           // Per term: first id - first_doc, then gaps, as varints
+
+        std::string_view term_text(const Term& term) const { return {text.data() + term.text_offset, term.text_size}; }
+
+        const Term* find(std::string_view term) const {
+            auto it = std::lower_bound(terms.begin(), terms.end(), term,
+                                       [this](const Term& t, std::string_view key) { return term_text(t) < key; });
+            return it != terms.end() && term_text(*it) == term ? &*it : nullptr;
+        }
+
+        void decode(const Term& term, std::vector<uint64_t>& out) const {
+            out.resize(term.count);
+            const char* p = postings.data() + term.postings_offset;
+            uint64_t doc = first_doc;
+            for (uint32_t i = 0; i < term.count; ++i) {
+                doc += get_varint(p);
+                out[i] = doc;
+            }
+        }
+
+        void add_term(std::string_view term, const std::vector<uint64_t>& docs_for_term) {
+            terms.push_back({static_cast<uint32_t>(text.size()), static_cast<uint32_t>(term.size()),
+                             postings.size(), static_cast<uint32_t>(docs_for_term.size())});
+            text.append(term);
+            uint64_t prev = first_doc;
+            for (uint64_t doc : docs_for_term) {
+                put_varint(postings, doc - prev);
+                prev = doc;
+            }
+        }
+
+        void match(const std::vector<std::string>& query, std::vector<uint64_t>& out) const {
+            std::vector<const Term*> found;
+            for (const auto& term : query) {
+                const Term* t = find(term);
+                if (!t) {
+                    out.clear();
+                    return;
+                }
+                found.push_back(t);
+            }
+            std::sort(found.begin(), found.end(), [](auto* a, auto* b) { return a->count < b->count; });
+            decode(*found.front(), out);
+            std::vector<uint64_t> other;
+            for (size_t i = 1; i < found.size() && !out.empty(); ++i) {
+                decode(*found[i], other);
+                intersect(out, other);
+            }
+        }
+
+        size_t memory_bytes() const { return text.size() + terms.size() * sizeof(Term) + postings.size(); }
+    };
+
+    namespace {
+        std::vector<std::string> query_terms(std::string_view query) {
+            std::vector<std::string> terms;
+            for_each_term(query, [&](std::string_view term) {
+                if (terms.size() < SearchIndex::MAX_QUERY_TERMS &&
+                    std::find(terms.begin(), terms.end(), term) == terms.end()) {
+                    terms.emplace_back(term);
+                }
+            });
+            return terms;
+        }
+    }
+
+    SearchIndex::SearchIndex(SearchIndexOptions options)
+        : options_(options) {
+        options_.seal_docs = std::max<size_t>(options_.seal_docs, 1);
+        options_.merge_fanin = std::max<size_t>(options_.merge_fanin, 2);
+        active_ = std::make_unique<MemSegment>(options_.seal_docs);
+    }
+
+    SearchIndex::~SearchIndex() = default;
+
+    void SearchIndex::tokenize(std::string_view text, const std::function<void(std::string_view)>& fn) {
+        for_each_term(text, fn);
+    }
+
+    void SearchIndex::add(uint64_t doc, std::string_view text) {
+        std::lock_guard lock(mutex_);
+        if (documents_ > 0 && doc <= last_doc_) {
+            return;
+        }
+        active_->add(doc, text, options_.max_indexed_bytes);
+        last_doc_ = doc;
+        documents_++;
+        if (active_->docs.size() >= options_.seal_docs) {
+            seal_locked();
+        }
+    }
+
+    void SearchIndex::seal_locked() {
+        sealed_.push_back(std::move(active_));
+        active_ = std::make_unique<MemSegment>(options_.seal_docs);
+    }
+
+    size_t SearchIndex::merge_run_locked() const {
+        const size_t fanin = options_.merge_fanin;
+        if (segments_.size() < fanin) {
+            return 0;
+        }
+        // Levels never increase towards the tail, so a full run of one level sits at the end
+        const unsigned level = segments_.back()->level;
+        for (size_t i = segments_.size() - fanin; i < segments_.size(); ++i) {
+            if (segments_[i]->level != level) {
+                return 0;
+            }
+        }
+        return fanin;
+    }
+
+    bool SearchIndex::needs_compaction() const {
+        std::lock_guard lock(mutex_);
+        return !sealed_.empty() || merge_run_locked() != 0;
+    }
+
+    bool SearchIndex::encode_sealed(std::unique_lock<std::mutex>& lock) {
+        if (sealed_.empty()) {
+            return false;
+        }
+        std::shared_ptr<const MemSegment> mem = sealed_.front();
+        compacting_ = true;
+        lock.unlock();
+
+        std::vector<uint32_t> starts;
+        const std::vector<uint32_t> ordinals = mem->group(starts);
+        std::vector<uint32_t> by_text(mem->terms.size());
+        for (uint32_t id = 0; id < by_text.size(); ++id) {
+            by_text[id] = id;
+        }
+        std::sort(by_text.begin(), by_text.end(),
+                  [&](uint32_t a, uint32_t b) { return *mem->terms[a] < *mem->terms[b]; });
+
+        auto segment = std::make_shared<Segment>();
+        segment->docs = mem->docs.size();
+        segment->first_doc = mem->docs.front();
+        std::vector<uint64_t> docs;
+        for (uint32_t id : by_text) {
+            docs.clear();
+            for (uint32_t i = starts[id]; i < starts[id + 1]; ++i) {
+                docs.push_back(mem->docs[ordinals[i]]);
+            }
+            segment->add_term(*mem->terms[id], docs);
+        }
+
+        lock.lock();
+        sealed_.pop_front();
+        segments_.push_back(std::move(segment));
+        compacting_ = false;
+        return true;
+    }
+
+    bool SearchIndex::compact() {
+        std::unique_lock lock(mutex_);
+        if (compacting_) {
+            return false;
+        }
+
+        // Merging first keeps levels non-increasing towards the tail. Segments
+        // are only ever appended meanwhile, so the inputs stay where they are
+        // while the lock is released
+        const size_t run = merge_run_locked();
+        if (run == 0) {
+            return encode_sealed(lock);
+        }
+        std::vector<std::shared_ptr<const Segment>> inputs(segments_.end() - static_cast<std::ptrdiff_t>(run),
+                                                           segments_.end());
+        compacting_ = true;
+        lock.unlock();
+
+        // Inputs cover ascending id ranges, so each merged list is their concatenation
+        auto merged = std::make_shared<Segment>();
+        merged->level = inputs.front()->level + 1;
+        merged->first_doc = inputs.front()->first_doc;
+        std::vector<std::tuple<std::string_view, size_t, const Segment::Term*>> all;
+        for (size_t i = 0; i < inputs.size(); ++i) {
+            merged->docs += inputs[i]->docs;
+            for (const auto& term : inputs[i]->terms) {
+                all.emplace_back(inputs[i]->term_text(term), i, &term);
+            }
+        }
+        std::sort(all.begin(), all.end());
+        std::vector<uint64_t> docs;
+        std::vector<uint64_t> part;
+        for (size_t i = 0; i < all.size();) {
+            const std::string_view term = std::get<0>(all[i]);
+            docs.clear();
+            for (; i < all.size() && std::get<0>(all[i]) == term; ++i) {
+                inputs[std::get<1>(all[i])]->decode(*std::get<2>(all[i]), part);
+                docs.insert(docs.end(), part.begin(), part.end());
+            }
+            merged->add_term(term, docs);
+        }
+
+        lock.lock();
+        auto start = std::find(segments_.begin(), segments_.end(), inputs.front());
+        *start = std::move(merged);
+        segments_.erase(start + 1, start + static_cast<std::ptrdiff_t>(run));
+        compacting_ = false;
+        return true;
+    }
+
+    std::vector<uint64_t> SearchIndex::search(std::string_view query, size_t limit) const {
+        std::vector<uint64_t> results;
+        const std::vector<std::string> terms = query_terms(query);
+        if (terms.empty() || limit == 0) {
+            return results;
+        }
+
+        std::vector<uint64_t> matches;
+        std::deque<std::shared_ptr<const MemSegment>> sealed;
+        std::vector<std::shared_ptr<const Segment>> segments;
+        {
+            std::lock_guard lock(mutex_);
+            active_->match(terms, matches);
+            take_newest(matches, limit, results);
+            if (results.size() == limit) {
+                return results;
+            }
+            sealed = sealed_;
+            segments = segments_;
+        }
+
+        // Newest segments first, stopping once `limit` ids are found
+        for (auto it = sealed.rbegin(); it != sealed.rend() && results.size() < limit; ++it) {
+            (*it)->match(terms, matches);
+            take_newest(matches, limit, results);
+        }
+        for (auto it = segments.rbegin(); it != segments.rend() && results.size() < limit; ++it) {
+            (*it)->match(terms, matches);
+            take_newest(matches, limit, results);
+        }
+        return results;
+    }
+
+    size_t SearchIndex::document_count() const {
+        std::lock_guard lock(mutex_);
+        return documents_;
+    }
+
+    size_t SearchIndex::segment_count() const {
+        std::lock_guard lock(mutex_);
+        return segments_.size();
+    }
+
+    size_t SearchIndex::memory_bytes() const {
+        std::lock_guard lock(mutex_);
+        size_t total = 0;
+        for (const auto& segment : segments_) {
+            total += segment->memory_bytes();
+        }
+        return total;
+    }
+
+}
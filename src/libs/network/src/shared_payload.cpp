@@ -0,0 +1,46 @@
+#include "network/shared_payload.h"
+#include <foundation/object_pool.h>
+#include <cstring>
+#include <new>
+
+namespace network {
+
+    SharedPayload SharedPayload::allocate(size_t size) {
+        // Chat-sized payloads come from per-thread pools; they are often
+        // freed on another loop, which the pools allow
+        void* memory = foundation::pool_resource()->allocate(sizeof(Block) + size, alignof(Block));
+        Block* block = new (memory) Block{};
+        block->refs.store(1, std::memory_order_relaxed);
+        block->size = static_cast<uint32_t>(size);
+        block->data = block->bytes();
+        return SharedPayload(block);
+    }
+
+    SharedPayload SharedPayload::view_of(std::shared_ptr<const void> owner, std::string_view data) {
+        auto* block = new ViewBlock{};
+        block->refs.store(1, std::memory_order_relaxed);
+        block->size = static_cast<uint32_t>(data.size());
+        block->data = const_cast<char*>(data.data());
+        block->owner = std::move(owner);
+        return SharedPayload(block);
+    }
+
+    SharedPayload SharedPayload::copy_of(std::string_view data) {
+        SharedPayload payload = allocate(data.size());
+        if (!data.empty()) {
+            std::memcpy(payload.mutable_data(), data.data(), data.size());
+        }
+        return payload;
+    }
+
+    void SharedPayload::destroy(Block* block) {
+        if (block->data != block->bytes()) {
+            delete static_cast<ViewBlock*>(block);
+            return;
+        }
+        const size_t size = sizeof(Block) + block->size;
+        block->~Block();
+        foundation::pool_resource()->deallocate(block, size, alignof(Block));
+    }
+
+}
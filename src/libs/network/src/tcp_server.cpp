@@ -0,0 +1,233 @@
+#include "network/tcp_server.h"
+#include <spdlog/spdlog.h>
+#include <cerrno>
+#ifndef _WIN32
+#include <sys/socket.h>
+#endif
+
+namespace network {
+
+    TcpServer::TcpServer(uv_loop_t* loop, TcpServerOptions options)
+        : loop_(loop),
+          options_(std::move(options)),
+          buffer_pool_(options_.buffer_pool),
+          timers_(loop, options_.timer_tick_ms) {
+        uv_check_init(loop_, &check_);
+        check_.data = this;
+    }
+
+    TcpServer::~TcpServer() {
+        if (connections_) {
+            spdlog::warn("TcpServer destroyed with {} live connections", connection_count_);
+        }
+    }
+
+    int TcpServer::listen() {
+        sockaddr_storage addr{};
+        int r = uv_ip4_addr(options_.host.c_str(), options_.port,
+                            reinterpret_cast<sockaddr_in*>(&addr));
+        if (r != 0) {
+            r = uv_ip6_addr(options_.host.c_str(), options_.port,
+                            reinterpret_cast<sockaddr_in6*>(&addr));
+        }
+        if (r != 0) {
+            return r;
+        }
+
+        if (options_.backend == Backend::IoUring) {
+            if (!UringTransport::supported()) {
+                return UV_ENOSYS;
+            }
+            uring_ = std::make_unique<UringTransport>(*this, options_.uring);
+            return uring_->listen(reinterpret_cast<const sockaddr*>(&addr), options_.backlog,
+                                  options_.reuse_port);
+        }
+
+        // Create the socket up front so options can be set before bind()
+        r = uv_tcp_init_ex(loop_, &listener_, addr.ss_family);
+        if (r != 0) {
+            return r;
+        }
+        listener_.data = this;
+        listener_open_ = true;
+
+        if (options_.reuse_port) {
+            r = enable_reuse_port();
+            if (r != 0) {
+                return r;
+            }
+        }
+
+        r = uv_tcp_bind(&listener_, reinterpret_cast<const sockaddr*>(&addr), 0);
+        if (r != 0) {
+            return r;
+        }
+
+        return uv_listen(reinterpret_cast<uv_stream_t*>(&listener_), options_.backlog, on_connection);
+    }
+
+    int TcpServer::bound_port() const {
+        if (uring_) {
+            return uring_->local_port();
+        }
+        sockaddr_storage addr{};
+        int len = sizeof(addr);
+        if (!listener_open_ ||
+            uv_tcp_getsockname(&listener_, reinterpret_cast<sockaddr*>(&addr), &len) != 0) {
+            return -1;
+        }
+        if (addr.ss_family == AF_INET6) {
+            return ntohs(reinterpret_cast<const sockaddr_in6*>(&addr)->sin6_port);
+        }
+        return ntohs(reinterpret_cast<const sockaddr_in*>(&addr)->sin_port);
+    }
+
+    void TcpServer::close() {
+        auto* listener = reinterpret_cast<uv_handle_t*>(&listener_);
+        if (listener_open_ && !uv_is_closing(listener)) {
+            uv_close(listener, nullptr);
+        }
+        auto* check = reinterpret_cast<uv_handle_t*>(&check_);
+        if (!uv_is_closing(check)) {
+            uv_close(check, nullptr);
+        }
+        timers_.close();
+
+        while (connections_) {
+            connections_->close();
+        }
+        if (uring_) {
+            uring_->close();
+        }
+    }
+
+    int TcpServer::enable_reuse_port() {
+#ifdef SO_REUSEPORT
+        uv_os_fd_t fd;
+        int r = uv_fileno(reinterpret_cast<uv_handle_t*>(&listener_), &fd);
+        if (r != 0) {
+            return r;
+        }
+        int on = 1;
+        if (setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &on, sizeof(on)) != 0) {
+            return uv_translate_sys_error(errno);
+        }
+        return 0;
+#else
+        return UV_ENOTSUP;
+#endif
+    }
+
+    void TcpServer::on_connection(uv_stream_t* listener, int status) {
+        auto* server = static_cast<TcpServer*>(listener->data);
+        if (status < 0) {
+            spdlog::error("Connection error: {}", uv_strerror(status));
+            return;
+        }
+
+        auto* conn = new Connection(*server, ++server->next_id_);
+        uv_tcp_init(server->loop_, &conn->handle_);
+        conn->handle_.data = conn;
+
+        auto* stream = reinterpret_cast<uv_stream_t*>(&conn->handle_);
+        if (uv_accept(listener, stream) != 0) {
+            conn->closing_ = true;
+            uv_close(reinterpret_cast<uv_handle_t*>(&conn->handle_), Connection::on_closed);
+            return;
+        }
+        if (server->options_.tcp_nodelay) {
+            uv_tcp_nodelay(&conn->handle_, 1);
+        }
+        server->accepted(conn);
+    }
+
+    void TcpServer::accepted(Connection* conn) {
+        attach(conn);
+        if (on_connect_) {
+            on_connect_(*conn);
+        }
+        if (!conn->closing_) {
+            conn->start_reading();
+            conn->start_idle_timer();
+        }
+    }
+
+    void TcpServer::on_check(uv_check_t* check) {
+        auto* server = static_cast<TcpServer*>(check->data);
+
+        // Flushing and closing can queue more of each other, so run until
+        // both settle. Entries queued meanwhile are appended and reached by
+        // index; cancelled ones are null
+        while (!server->pending_flushes_.empty() || !server->deferred_closes_.empty()) {
+            for (size_t i = 0; i < server->pending_flushes_.size(); ++i) {
+                if (Connection* conn = server->pending_flushes_[i]) {
+                    conn->flush_scheduled_ = false;
+                    conn->flush();
+                }
+            }
+            server->pending_flushes_.clear();
+
+            for (size_t i = 0; i < server->deferred_closes_.size(); ++i) {
+                if (Connection* conn = server->deferred_closes_[i]) {
+                    conn->close();
+                }
+            }
+            server->deferred_closes_.clear();
+        }
+        uv_check_stop(check);
+        server->check_active_ = false;
+    }
+
+    void TcpServer::arm_check() {
+        if (!check_active_) {
+            uv_check_start(&check_, on_check);
+            check_active_ = true;
+        }
+    }
+
+    void TcpServer::schedule_flush(Connection* conn) {
+        conn->flush_slot_ = pending_flushes_.size();
+        pending_flushes_.push_back(conn);
+        arm_check();
+    }
+
+    // The connection may be freed before the check runs, so its entry is cleared
+    void TcpServer::cancel_scheduled_flush(Connection* conn) {
+        pending_flushes_[conn->flush_slot_] = nullptr;
+    }
+
+    void TcpServer::defer_close(Connection* conn) {
+        conn->close_slot_ = deferred_closes_.size();
+        deferred_closes_.push_back(conn);
+        arm_check();
+    }
+
+    void TcpServer::cancel_deferred_close(Connection* conn) {
+        deferred_closes_[conn->close_slot_] = nullptr;
+    }
+
+    void TcpServer::attach(Connection* conn) {
+        conn->prev_ = nullptr;
+        conn->next_ = connections_;
+        if (connections_) {
+            connections_->prev_ = conn;
+        }
+        connections_ = conn;
+        connection_count_++;
+    }
+
+    void TcpServer::detach(Connection* conn) {
+        if (conn->prev_) {
+            conn->prev_->next_ = conn->next_;
+        } else {
+            connections_ = conn->next_;
+        }
+        if (conn->next_) {
+            conn->next_->prev_ = conn->prev_;
+        }
+        conn->prev_ = nullptr;
+        conn->next_ = nullptr;
+        connection_count_--;
+    }
+
+}
@@ -0,0 +1,161 @@
+#include "network/timer_wheel.h"
+#include <algorithm>
+
+namespace network {
+
+    void Timer::cancel() {
+        if (wheel_) {
+            wheel_->cancel(*this);
+        }
+    }
+
+    TimerWheel::TimerWheel(uint64_t now_ms, uint64_t tick_ms)
+        : origin_ms_(now_ms),
+          tick_ms_(std::max<uint64_t>(tick_ms, 1)) {
+    }
+
+    TimerWheel::~TimerWheel() {
+        // Leave outstanding timers unarmed so their destructors don't touch us
+        for (auto& level : slots_) {
+            for (TimerNode& head : level) {
+                while (head.next != &head) {
+                    auto* timer = static_cast<Timer*>(head.next);
+                    unlink(timer);
+                    timer->wheel_ = nullptr;
+                }
+            }
+        }
+    }
+
+    void TimerWheel::schedule(Timer& timer, uint64_t delay_ms) {
+        if (timer.wheel_) {
+            timer.wheel_->cancel(timer);
+        }
+        uint64_t ticks = (delay_ms + tick_ms_ - 1) / tick_ms_;
+        timer.expiry_ = current_tick_ + std::clamp<uint64_t>(ticks, 1, MAX_TICKS);
+        timer.wheel_ = this;
+        place(&timer);
+        size_++;
+    }
+
+    void TimerWheel::cancel(Timer& timer) {
+        if (timer.wheel_ != this) {
+            return;
+        }
+        unlink(&timer);
+        timer.wheel_ = nullptr;
+        size_--;
+    }
+
+    size_t TimerWheel::advance(uint64_t now_ms) {
+        const uint64_t target = now_ms > origin_ms_ ? (now_ms - origin_ms_) / tick_ms_ : 0;
+        size_t fired = 0;
+
+        while (current_tick_ < target) {
+            if (size_ == 0) {
+                current_tick_ = target;
+                break;
+            }
+            current_tick_++;
+
+            // Higher levels first, so timers they hand down can cascade again
+            for (size_t level = LEVELS - 1; level > 0; --level) {
+                const uint64_t mask = (uint64_t(1) << (level * SLOT_BITS)) - 1;
+                if ((current_tick_ & mask) == 0) {
+                    cascade(level);
+                }
+            }
+
+            // Detach the slot first: callbacks may re-arm into it
+            TimerNode expiring;
+            TimerNode& head = slots_[0][current_tick_ & (SLOTS - 1)];
+            if (head.next == &head) {
+                continue;
+            }
+            expiring.next = head.next;
+            expiring.prev = head.prev;
+            expiring.next->prev = &expiring;
+            expiring.prev->next = &expiring;
+            head.next = head.prev = &head;
+
+            while (expiring.next != &expiring) {
+                auto* timer = static_cast<Timer*>(expiring.next);
+                unlink(timer);
+                timer->wheel_ = nullptr;
+                size_--;
+                fired++;
+                if (timer->callback_) {
+                    timer->callback_();
+                }
+            }
+        }
+        return fired;
+    }
+
+    void TimerWheel::place(Timer* timer) {
+        const uint64_t delta = timer->expiry_ > current_tick_ ? timer->expiry_ - current_tick_ : 0;
+        size_t level = 0;
+        while (level + 1 < LEVELS && delta >= (uint64_t(1) << ((level + 1) * SLOT_BITS))) {
+            level++;
+        }
+        const size_t slot = (timer->expiry_ >> (level * SLOT_BITS)) & (SLOTS - 1);
+        link(&slots_[level][slot], timer);
+    }
+
+    void TimerWheel::cascade(size_t level) {
+        TimerNode& head = slots_[level][(current_tick_ >> (level * SLOT_BITS)) & (SLOTS - 1)];
+        while (head.next != &head) {
+            auto* timer = static_cast<Timer*>(head.next);
+            unlink(timer);
+            place(timer);
+        }
+    }
+
+    void TimerWheel::link(TimerNode* head, TimerNode* node) {
+        node->prev = head->prev;
+        node->next = head;
+        head->prev->next = node;
+        head->prev = node;
+    }
+
+    void TimerWheel::unlink(TimerNode* node) {
+        node->prev->next = node->next;
+        node->next->prev = node->prev;
+        node->prev = node->next = node;
+    }
+
+    TimerService::TimerService(uv_loop_t* loop, uint64_t tick_ms)
+        : loop_(loop),
+          wheel_(uv_now(loop), tick_ms) {
+        uv_timer_init(loop_, &handle_);
+        handle_.data = this;
+    }
+
+    void TimerService::schedule(Timer& timer, uint64_t delay_ms) {
+        if (!running_ && !uv_is_closing(reinterpret_cast<uv_handle_t*>(&handle_))) {
+            // Catch up on time spent stopped; nothing is armed, so nothing fires
+            wheel_.advance(uv_now(loop_));
+            uv_timer_start(&handle_, on_tick, wheel_.tick_ms(), wheel_.tick_ms());
+            running_ = true;
+        }
+        wheel_.schedule(timer, delay_ms);
+    }
+
+    void TimerService::close() {
+        auto* handle = reinterpret_cast<uv_handle_t*>(&handle_);
+        if (!uv_is_closing(handle)) {
+            uv_close(handle, nullptr);
+        }
+        running_ = false;
+    }
+
+    void TimerService::on_tick(uv_timer_t* handle) {
+        auto* service = static_cast<TimerService*>(handle->data);
+        service->wheel_.advance(uv_now(service->loop_));
+        if (service->wheel_.empty() && service->running_) {
+            uv_timer_stop(handle);
+            service->running_ = false;
+        }
+    }
+
+}
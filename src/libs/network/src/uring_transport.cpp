@@ -0,0 +1,710 @@
+#include "network/uring_transport.h"
+#include "network/connection.h"
+#include "network/tcp_server.h"
+#include "network/write_request_pool.h"
+#include <spdlog/spdlog.h>
+
+#if defined(__linux__)
+#include <linux/io_uring.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#endif
+
+namespace network {
+
+#if defined(__linux__)
+
+    namespace {
+
+        // user_data carries an object pointer with the operation kind in its low bits
+        enum Tag : uint64_t {
+            TAG_ACCEPT = 0,
+            TAG_RECV = 1,
+            TAG_SEND = 2,
+            TAG_IGNORE = 3,
+        };
+        constexpr uint64_t TAG_MASK = 3;
+        constexpr uint16_t BUFFER_GROUP = 0;
+
+        int sys_setup(unsigned entries, io_uring_params* params) {
+            return static_cast<int>(syscall(__NR_io_uring_setup, entries, params));
+        }
+
+        int sys_enter(int fd, unsigned to_submit, unsigned min_complete, unsigned flags) {
+            return static_cast<int>(syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, nullptr, 0));
+        }
+
+        int sys_register(int fd, unsigned opcode, void* arg, unsigned count) {
+            return static_cast<int>(syscall(__NR_io_uring_register, fd, opcode, arg, count));
+        }
+
+        template <typename T>
+        T* at_offset(void* base, uint32_t offset) {
+            return reinterpret_cast<T*>(static_cast<char*>(base) + offset);
+        }
+
+    }
+
+    /**
+     * The mmapped submission/completion rings and the provided buffer ring.
+     * Kernels without working buffer rings get the same buffers through
+     * IORING_OP_PROVIDE_BUFFERS instead.
+     */
+    struct UringTransport::Ring {
+        int fd = -1;
+
+        void* sq_map = MAP_FAILED;
+        size_t sq_map_size = 0;
+        void* cq_map = MAP_FAILED;
+        size_t cq_map_size = 0;
+        io_uring_sqe* sqes = static_cast<io_uring_sqe*>(MAP_FAILED);
+        size_t sqes_size = 0;
+
+        unsigned* sq_head = nullptr;
+        unsigned* sq_tail = nullptr;
+        unsigned* sq_array = nullptr;
+        unsigned sq_mask = 0;
+        unsigned sq_entries = 0;
+        unsigned sq_pending = 0;    // Published but not yet handed to the kernel
+
+        unsigned* cq_head = nullptr;
+        unsigned* cq_tail = nullptr;
+        unsigned cq_mask = 0;
+        io_uring_cqe* cqes = nullptr;
+
+        io_uring_buf_ring* buf_ring = static_cast<io_uring_buf_ring*>(MAP_FAILED);
+        size_t buf_ring_size = 0;
+        char* buffers = static_cast<char*>(MAP_FAILED);
+        size_t buffers_size = 0;
+        unsigned buf_mask = 0;
+        uint16_t buf_tail = 0;
+        bool legacy_buffers = false;
+
+        ~Ring() {
+            if (buffers != MAP_FAILED) {
+                munmap(buffers, buffers_size);
+            }
+            if (buf_ring != MAP_FAILED) {
+                munmap(buf_ring, buf_ring_size);
+            }
+            if (sqes != MAP_FAILED) {
+                munmap(sqes, sqes_size);
+            }
+            if (cq_map != MAP_FAILED && cq_map != sq_map) {
+                munmap(cq_map, cq_map_size);
+            }
+            if (sq_map != MAP_FAILED) {
+                munmap(sq_map, sq_map_size);
+            }
+            if (fd >= 0) {
+                ::close(fd);
+            }
+        }
+
+        int init(unsigned entries) {
+            io_uring_params params{};
+            params.flags = IORING_SETUP_CQSIZE | IORING_SETUP_SUBMIT_ALL;
+            params.cq_entries = entries * 4;  // Multishot ops post many CQEs per SQE
+            fd = sys_setup(entries, &params);
+            if (fd < 0 && errno == EINVAL) {
+                params = {};
+                params.flags = IORING_SETUP_CQSIZE;
+                params.cq_entries = entries * 4;
+                fd = sys_setup(entries, &params);
+            }
+            if (fd < 0) {
+                return -errno;
+            }
+
+            sq_map_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+            cq_map_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+            if (params.features & IORING_FEAT_SINGLE_MMAP) {
+                sq_map_size = cq_map_size = std::max(sq_map_size, cq_map_size);
+            }
+            sq_map = mmap(nullptr, sq_map_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                          fd, IORING_OFF_SQ_RING);
+            if (sq_map == MAP_FAILED) {
+                return -errno;
+            }
+            if (params.features & IORING_FEAT_SINGLE_MMAP) {
+                cq_map = sq_map;
+            } else {
+                cq_map = mmap(nullptr, cq_map_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                              fd, IORING_OFF_CQ_RING);
+                if (cq_map == MAP_FAILED) {
+                    return -errno;
+                }
+            }
+            sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+            void* sqe_map = mmap(nullptr, sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                                 fd, IORING_OFF_SQES);
+            if (sqe_map == MAP_FAILED) {
+                return -errno;
+            }
+            sqes = static_cast<io_uring_sqe*>(sqe_map);
+
+            sq_head = at_offset<unsigned>(sq_map, params.sq_off.head);
+            sq_tail = at_offset<unsigned>(sq_map, params.sq_off.tail);
+            sq_array = at_offset<unsigned>(sq_map, params.sq_off.array);
+            sq_mask = *at_offset<unsigned>(sq_map, params.sq_off.ring_mask);
+            sq_entries = params.sq_entries;
+            cq_head = at_offset<unsigned>(cq_map, params.cq_off.head);
+            cq_tail = at_offset<unsigned>(cq_map, params.cq_off.tail);
+            cq_mask = *at_offset<unsigned>(cq_map, params.cq_off.ring_mask);
+            cqes = at_offset<io_uring_cqe>(cq_map, params.cq_off.cqes);
+            return 0;
+        }
+
+        int init_buffers(unsigned count, unsigned size) {
+            buf_ring_size = count * sizeof(io_uring_buf);
+            void* ring_map = mmap(nullptr, buf_ring_size, PROT_READ | PROT_WRITE,
+                                  MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (ring_map == MAP_FAILED) {
+                return -errno;
+            }
+            buf_ring = static_cast<io_uring_buf_ring*>(ring_map);
+
+            buffers_size = size_t(count) * size;
+            void* buffer_map = mmap(nullptr, buffers_size, PROT_READ | PROT_WRITE,
+                                    MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (buffer_map == MAP_FAILED) {
+                return -errno;
+            }
+            buffers = static_cast<char*>(buffer_map);
+
+            io_uring_buf_reg reg{};
+            reg.ring_addr = reinterpret_cast<uint64_t>(buf_ring);
+            reg.ring_entries = count;
+            reg.bgid = BUFFER_GROUP;
+            buf_mask = count - 1;
+            if (sys_register(fd, IORING_REGISTER_PBUF_RING, &reg, 1) < 0) {
+                if (errno != EINVAL) {
+                    return -errno;
+                }
+                legacy_buffers = true;  // Before 5.19
+                return 0;
+            }
+
+            for (unsigned bid = 0; bid < count; ++bid) {
+                provide(static_cast<uint16_t>(bid), size);
+            }
+            if (!probe_buffer_ring(size)) {
+                sys_register(fd, IORING_UNREGISTER_PBUF_RING, &reg, 1);
+                legacy_buffers = true;
+            }
+            return 0;
+        }
+
+        // Some kernels accept the registration yet never select from the ring
+        bool probe_buffer_ring(unsigned size) {
+            int pair[2];
+            if (socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, pair) != 0) {
+                return false;
+            }
+            bool works = false;
+            const char byte = 0;
+            io_uring_sqe* sqe = next_sqe();
+            if (sqe && ::write(pair[1], &byte, 1) == 1) {
+                sqe->opcode = IORING_OP_RECV;
+                sqe->fd = pair[0];
+                sqe->flags = IOSQE_BUFFER_SELECT;
+                sqe->buf_group = BUFFER_GROUP;
+                sqe->user_data = TAG_IGNORE;
+                const unsigned head = *cq_head;
+                if (submit(1) >= 0 && head != __atomic_load_n(cq_tail, __ATOMIC_ACQUIRE)) {
+                    const io_uring_cqe& cqe = cqes[head & cq_mask];
+                    works = cqe.res == 1 && (cqe.flags & IORING_CQE_F_BUFFER);
+                    if (works) {
+                        provide(static_cast<uint16_t>(cqe.flags >> IORING_CQE_BUFFER_SHIFT), size);
+                    }
+                    __atomic_store_n(cq_head, head + 1, __ATOMIC_RELEASE);
+                }
+            }
+            ::close(pair[0]);
+            ::close(pair[1]);
+            return works;
+        }
+
+        // Publish a fresh, zeroed SQE; the caller fills it in before the next submit
+        io_uring_sqe* next_sqe() {
+            const unsigned tail = *sq_tail;
+            if (tail - __atomic_load_n(sq_head, __ATOMIC_ACQUIRE) >= sq_entries) {
+                return nullptr;
+            }
+            const unsigned index = tail & sq_mask;
+            io_uring_sqe* sqe = &sqes[index];
+            std::memset(sqe, 0, sizeof(*sqe));
+            sq_array[index] = index;
+            __atomic_store_n(sq_tail, tail + 1, __ATOMIC_RELEASE);
+            sq_pending++;
+            return sqe;
+        }
+
+        int submit(unsigned min_complete = 0) {
+            const unsigned flags = min_complete ? IORING_ENTER_GETEVENTS : 0;
+            if (sq_pending == 0 && min_complete == 0) {
+                return 0;
+            }
+            int r = sys_enter(fd, sq_pending, min_complete, flags);
+            if (r < 0) {
+                return -errno;
+            }
+            sq_pending -= std::min<unsigned>(sq_pending, static_cast<unsigned>(r));
+            return r;
+        }
+
+        void provide(uint16_t bid, unsigned size) {
+            io_uring_buf* buf = &buf_ring->bufs[buf_tail & buf_mask];
+            buf->addr = reinterpret_cast<uint64_t>(buffers + size_t(bid) * size);
+            buf->len = size;
+            buf->bid = bid;
+            buf_tail++;
+            __atomic_store_n(&buf_ring->tail, buf_tail, __ATOMIC_RELEASE);
+        }
+    };
+
+    struct UringTransport::SendOp {
+        msghdr msg;
+        iovec iov[WriteRequest::MAX_BUFS];
+        Connection* conn;
+        WriteRequest* request;
+        SendOp* next_free;
+    };
+
+    bool UringTransport::supported() {
+        static const bool available = [] {
+            io_uring_params params{};
+            int fd = sys_setup(4, &params);
+            if (fd < 0) {
+                return false;
+            }
+            ::close(fd);
+            return (params.features & IORING_FEAT_NODROP) != 0;  // 5.5+; buffer rings are checked in listen()
+        }();
+        return available;
+    }
+
+    UringTransport::UringTransport(TcpServer& server, UringOptions options)
+        : server_(server),
+          options_(options) {
+    }
+
+    UringTransport::~UringTransport() {
+        if (listen_fd_ >= 0) {
+            ::close(listen_fd_);
+        }
+    }
+
+    int UringTransport::listen(const sockaddr* addr, int backlog, bool reuse_port) {
+        if ((options_.buffer_count & (options_.buffer_count - 1)) != 0 || options_.buffer_count > 32768) {
+            return UV_EINVAL;
+        }
+
+        ring_ = std::make_unique<Ring>();
+        int r = ring_->init(options_.queue_depth);
+        if (r == 0) {
+            r = ring_->init_buffers(options_.buffer_count, options_.buffer_size);
+        }
+        if (r != 0) {
+            ring_.reset();
+            return r;
+        }
+        if (ring_->legacy_buffers) {
+            spdlog::debug("io_uring buffer rings unavailable, using IORING_OP_PROVIDE_BUFFERS");
+            io_uring_sqe* sqe = next_sqe();
+            sqe->opcode = IORING_OP_PROVIDE_BUFFERS;
+            sqe->fd = static_cast<int>(options_.buffer_count);
+            sqe->addr = reinterpret_cast<uint64_t>(ring_->buffers);
+            sqe->len = options_.buffer_size;
+            sqe->off = 0;
+            sqe->buf_group = BUFFER_GROUP;
+            sqe->user_data = TAG_IGNORE;
+        }
+
+        listen_fd_ = ::socket(addr->sa_family, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (listen_fd_ < 0) {
+            return -errno;
+        }
+        int on = 1;
+        setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+        if (reuse_port && setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEPORT, &on, sizeof(on)) != 0) {
+            return -errno;
+        }
+        const socklen_t len = addr->sa_family == AF_INET6 ? sizeof(sockaddr_in6) : sizeof(sockaddr_in);
+        if (::bind(listen_fd_, addr, len) != 0 || ::listen(listen_fd_, backlog) != 0) {
+            return -errno;
+        }
+
+        uv_loop_t* loop = server_.loop();
+        uv_prepare_init(loop, &prepare_);
+        prepare_.data = this;
+        uv_prepare_start(&prepare_, on_prepare);
+        uv_check_init(loop, &check_);
+        check_.data = this;
+        uv_check_start(&check_, on_check);
+        uv_poll_init(loop, &poll_, ring_->fd);
+        poll_.data = this;
+        uv_poll_start(&poll_, UV_READABLE, on_poll);
+        handles_open_ = true;
+
+        // Queued only: the first submit happens on the loop thread
+        listening_ = true;
+        arm_accept();
+        return 0;
+    }
+
+    int UringTransport::local_port() const {
+        sockaddr_storage addr{};
+        socklen_t len = sizeof(addr);
+        if (listen_fd_ < 0 || getsockname(listen_fd_, reinterpret_cast<sockaddr*>(&addr), &len) != 0) {
+            return -1;
+        }
+        if (addr.ss_family == AF_INET6) {
+            return ntohs(reinterpret_cast<const sockaddr_in6*>(&addr)->sin6_port);
+        }
+        return ntohs(reinterpret_cast<const sockaddr_in*>(&addr)->sin_port);
+    }
+
+    void UringTransport::close() {
+        if (!ring_) {
+            return;
+        }
+        listening_ = false;
+        if (accept_armed_) {
+            io_uring_sqe* sqe = next_sqe();
+            sqe->opcode = IORING_OP_ASYNC_CANCEL;
+            sqe->addr = TAG_ACCEPT;
+            sqe->user_data = TAG_IGNORE;
+        }
+
+        // Every socket is shut down by now, so the remaining operations finish promptly
+        while (inflight_ > 0) {
+            int r = ring_->submit(1);
+            if (r < 0 && r != -EINTR) {
+                spdlog::error("io_uring wait failed: {}", uv_strerror(r));
+                break;
+            }
+            reap();
+        }
+        bury();
+
+        if (handles_open_) {
+            uv_close(reinterpret_cast<uv_handle_t*>(&prepare_), nullptr);
+            uv_close(reinterpret_cast<uv_handle_t*>(&check_), nullptr);
+            uv_close(reinterpret_cast<uv_handle_t*>(&poll_), nullptr);
+            handles_open_ = false;
+        }
+    }
+
+    void UringTransport::start_reading(Connection& conn) {
+        arm_recv(conn);
+    }
+
+    void UringTransport::send(Connection& conn, WriteRequest* request, const uv_buf_t* bufs, size_t count) {
+        SendOp* op = acquire_send();
+        op->conn = &conn;
+        op->request = request;
+        for (size_t i = 0; i < count; ++i) {
+            op->iov[i].iov_base = bufs[i].base;
+            op->iov[i].iov_len = bufs[i].len;
+        }
+        op->msg = {};
+        op->msg.msg_iov = op->iov;
+        op->msg.msg_iovlen = count;
+
+        conn.uring_ops_++;
+        inflight_++;
+        submit_send(op);
+    }
+
+    void UringTransport::shutdown(Connection& conn) {
+        ::shutdown(conn.fd_, SHUT_RDWR);
+        if (conn.uring_ops_ == 0) {
+            // Callers may still be inside the connection's callbacks
+            graveyard_.push_back(&conn);
+        }
+    }
+
+    int UringTransport::peer_name(int fd, sockaddr* addr, int* len) {
+        auto size = static_cast<socklen_t>(*len);
+        if (getpeername(fd, addr, &size) != 0) {
+            return -errno;
+        }
+        *len = static_cast<int>(size);
+        return 0;
+    }
+
+    void UringTransport::on_prepare(uv_prepare_t* handle) {
+        auto* transport = static_cast<UringTransport*>(handle->data);
+        transport->bury();
+        transport->submit();
+    }
+
+    // Sends queued by this iteration's I/O callbacks
+    void UringTransport::on_check(uv_check_t* handle) {
+        static_cast<UringTransport*>(handle->data)->submit();
+    }
+
+    void UringTransport::on_poll(uv_poll_t* handle, int status, int /*events*/) {
+        auto* transport = static_cast<UringTransport*>(handle->data);
+        if (status < 0) {
+            spdlog::error("io_uring poll error: {}", uv_strerror(status));
+            return;
+        }
+        transport->reap();
+    }
+
+    io_uring_sqe* UringTransport::next_sqe() {
+        io_uring_sqe* sqe = ring_->next_sqe();
+        while (!sqe) {
+            // Submission queue full: hand the batch over early
+            submit();
+            sqe = ring_->next_sqe();
+        }
+        return sqe;
+    }
+
+    void UringTransport::arm_accept() {
+        io_uring_sqe* sqe = next_sqe();
+        sqe->opcode = IORING_OP_ACCEPT;
+        sqe->fd = listen_fd_;
+        sqe->ioprio = IORING_ACCEPT_MULTISHOT;
+        sqe->accept_flags = SOCK_CLOEXEC;
+        sqe->user_data = TAG_ACCEPT;
+        accept_armed_ = true;
+        inflight_++;
+    }
+
+    void UringTransport::arm_recv(Connection& conn) {
+        io_uring_sqe* sqe = next_sqe();
+        sqe->opcode = IORING_OP_RECV;
+        sqe->fd = conn.fd_;
+        sqe->ioprio = IORING_RECV_MULTISHOT;
+        sqe->flags = IOSQE_BUFFER_SELECT;
+        sqe->buf_group = BUFFER_GROUP;
+        sqe->user_data = reinterpret_cast<uint64_t>(&conn) | TAG_RECV;
+        conn.uring_ops_++;
+        inflight_++;
+    }
+
+    void UringTransport::submit_send(SendOp* op) {
+        io_uring_sqe* sqe = next_sqe();
+        sqe->opcode = IORING_OP_SENDMSG;
+        sqe->fd = op->conn->fd_;
+        sqe->addr = reinterpret_cast<uint64_t>(&op->msg);
+        sqe->len = 1;
+        sqe->msg_flags = MSG_NOSIGNAL;
+        sqe->user_data = reinterpret_cast<uint64_t>(op) | TAG_SEND;
+    }
+
+    void UringTransport::submit() {
+        int r = ring_->submit();
+        if (r < 0 && r != -EAGAIN && r != -EBUSY && r != -EINTR) {
+            spdlog::error("io_uring submit failed: {}", uv_strerror(r));
+        }
+    }
+
+    void UringTransport::reap() {
+        unsigned head = *ring_->cq_head;
+        for (;;) {
+            const unsigned tail = __atomic_load_n(ring_->cq_tail, __ATOMIC_ACQUIRE);
+            if (head == tail) {
+                break;
+            }
+            // Copy out and release the slot first: handlers may queue more work
+            const io_uring_cqe cqe = ring_->cqes[head & ring_->cq_mask];
+            head++;
+            __atomic_store_n(ring_->cq_head, head, __ATOMIC_RELEASE);
+
+            const uint64_t tag = cqe.user_data & TAG_MASK;
+            void* target = reinterpret_cast<void*>(cqe.user_data & ~TAG_MASK);
+            switch (tag) {
+            case TAG_ACCEPT:
+                on_accept(cqe.res, cqe.flags);
+                break;
+            case TAG_RECV:
+                on_recv(static_cast<Connection*>(target), cqe.res, cqe.flags);
+                break;
+            case TAG_SEND:
+                on_send(static_cast<SendOp*>(target), cqe.res);
+                break;
+            default:
+                break;
+            }
+        }
+    }
+
+    void UringTransport::on_accept(int res, uint32_t flags) {
+        if (!(flags & IORING_CQE_F_MORE)) {
+            accept_armed_ = false;
+            inflight_--;
+        }
+
+        if (res >= 0) {
+            if (!listening_) {
+                ::close(res);
+            } else {
+                auto* conn = new Connection(server_, ++server_.next_id_);
+                conn->fd_ = res;
+                if (server_.options_.tcp_nodelay) {
+                    int on = 1;
+                    setsockopt(res, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+                }
+                server_.accepted(conn);
+            }
+        } else if (res != -ECANCELED) {
+            spdlog::error("Connection error: {}", uv_strerror(res));
+        }
+
+        if (listening_ && !accept_armed_) {
+            arm_accept();
+        }
+    }
+
+    void UringTransport::on_recv(Connection* conn, int res, uint32_t flags) {
+        if (flags & IORING_CQE_F_BUFFER) {
+            const auto bid = static_cast<uint16_t>(flags >> IORING_CQE_BUFFER_SHIFT);
+            if (res > 0 && !conn->closing_ && !conn->close_pending_) {
+                conn->received(ring_->buffers + size_t(bid) * options_.buffer_size, static_cast<size_t>(res));
+            }
+            // Frames were delivered as views; anything partial was copied out
+            recycle_buffer(bid);
+        }
+        if (flags & IORING_CQE_F_MORE) {
+            return;
+        }
+
+        conn->uring_ops_--;
+        inflight_--;
+        if (conn->closing_) {
+            release_if_idle(conn);
+            return;
+        }
+        if (!conn->close_pending_ && (res > 0 || res == -ENOBUFS)) {
+            arm_recv(*conn);  // The multishot recv ended early; keep reading
+            return;
+        }
+        if (res < 0 && res != -ECONNRESET) {
+            spdlog::error("Read error: {}", uv_strerror(res));
+        }
+        conn->close();
+    }
+
+    void UringTransport::on_send(SendOp* op, int res) {
+        Connection* conn = op->conn;
+
+        if (res > 0 && !conn->closing_) {
+            // Short send: skip what went out and resubmit the rest
+            auto done = static_cast<size_t>(res);
+            while (done > 0 && op->msg.msg_iovlen > 0) {
+                iovec& front = op->msg.msg_iov[0];
+                if (done >= front.iov_len) {
+                    done -= front.iov_len;
+                    op->msg.msg_iov++;
+                    op->msg.msg_iovlen--;
+                } else {
+                    front.iov_base = static_cast<char*>(front.iov_base) + done;
+                    front.iov_len -= done;
+                    done = 0;
+                }
+            }
+            if (op->msg.msg_iovlen > 0) {
+                submit_send(op);
+                return;
+            }
+        }
+
+        WriteRequest* request = op->request;
+        release_send(op);
+        conn->uring_ops_--;
+        inflight_--;
+
+        const bool closing = conn->closing_;
+        int status = 0;
+        if (closing) {
+            status = UV_ECANCELED;
+        } else if (res <= 0) {
+            status = res < 0 ? res : UV_EPIPE;
+        }
+        conn->write_completed(request, status);
+        if (closing) {
+            release_if_idle(conn);
+        }
+    }
+
+    void UringTransport::recycle_buffer(uint16_t bid) {
+        if (!ring_->legacy_buffers) {
+            ring_->provide(bid, options_.buffer_size);
+            return;
+        }
+        io_uring_sqe* sqe = next_sqe();
+        sqe->opcode = IORING_OP_PROVIDE_BUFFERS;
+        sqe->fd = 1;
+        sqe->addr = reinterpret_cast<uint64_t>(ring_->buffers + size_t(bid) * options_.buffer_size);
+        sqe->len = options_.buffer_size;
+        sqe->off = bid;
+        sqe->buf_group = BUFFER_GROUP;
+        sqe->user_data = TAG_IGNORE;
+    }
+
+    void UringTransport::release_if_idle(Connection* conn) {
+        if (conn->uring_ops_ == 0) {
+            ::close(conn->fd_);
+            delete conn;
+        }
+    }
+
+    void UringTransport::bury() {
+        for (Connection* conn : graveyard_) {
+            release_if_idle(conn);
+        }
+        graveyard_.clear();
+    }
+
+    UringTransport::SendOp* UringTransport::acquire_send() {
+        if (!free_sends_) {
+            send_ops_.push_back(std::make_unique<SendOp>());
+            return send_ops_.back().get();
+        }
+        SendOp* op = free_sends_;
+        free_sends_ = op->next_free;
+        return op;
+    }
+
+    void UringTransport::release_send(SendOp* op) {
+        op->next_free = free_sends_;
+        free_sends_ = op;
+    }
+
+#else
+
+    struct UringTransport::Ring {};
+    struct UringTransport::SendOp {};
+
+    bool UringTransport::supported() { return false; }
+
+    UringTransport::UringTransport(TcpServer& server, UringOptions options)
+        : server_(server),
+          options_(options) {
+    }
+
+    UringTransport::~UringTransport() = default;
+
+    int UringTransport::listen(const sockaddr*, int, bool) { return UV_ENOSYS; }
+    int UringTransport::local_port() const { return -1; }
+    void UringTransport::close() {}
+    void UringTransport::start_reading(Connection&) {}
+    void UringTransport::send(Connection&, WriteRequest*, const uv_buf_t*, size_t) {}
+    void UringTransport::shutdown(Connection&) {}
+    int UringTransport::peer_name(int, sockaddr*, int*) { return UV_ENOSYS; }
+
+#endif
+
+}
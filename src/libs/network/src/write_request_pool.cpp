@@ -0,0 +1,41 @@
+#include "network/write_request_pool.h"
+
+namespace network {
+
+    WriteRequestPool::WriteRequestPool(size_t requests_per_chunk)
+        : requests_per_chunk_(requests_per_chunk ? requests_per_chunk : 1) {
+    }
+
+    WriteRequest* WriteRequestPool::acquire() {
+        if (!free_) {
+            grow();
+        }
+        WriteRequest* request = free_;
+        free_ = request->next_free;
+        request->next_free = nullptr;
+        request->req.data = nullptr;
+        in_use_++;
+        return request;
+    }
+
+    void WriteRequestPool::release(WriteRequest* request) {
+        for (size_t i = 0; i < request->payload_count; ++i) {
+            request->payloads[i].reset();
+        }
+        request->payload_count = 0;
+        request->bytes = 0;
+        request->next_free = free_;
+        free_ = request;
+        in_use_--;
+    }
+
+    void WriteRequestPool::grow() {
+        auto chunk = std::make_unique<WriteRequest[]>(requests_per_chunk_);
+        for (size_t i = requests_per_chunk_; i-- > 0;) {
+            chunk[i].next_free = free_;
+            free_ = &chunk[i];
+        }
+        chunks_.push_back(std::move(chunk));
+    }
+
+}
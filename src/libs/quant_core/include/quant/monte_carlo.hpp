@@ -0,0 +1,19 @@
+#pragma once
+#include <foundation/thread_pool.h>
+#include <cstddef>
+#include <cstdint>
+
+namespace quant {
+    struct MonteCarloResult {
+        double price = 0;
+        double std_error = 0;
+        size_t paths = 0;
+    };
+
+    // European call under geometric Brownian motion, averaged over `paths`
+    // simulated terminal prices on `pool`. Paths are drawn in fixed blocks,
+    // each from its own generator seeded by `seed` and the block index, so
+    // the result is the same for any pool size.
+    MonteCarloResult monte_carlo_option_price(foundation::ThreadPool& pool, double s, double k, double r, double v,
+                                              double t, size_t paths, uint64_t seed = 1);
+}
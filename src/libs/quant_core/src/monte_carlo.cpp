@@ -0,0 +1,49 @@
+#include "quant/monte_carlo.hpp"
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+namespace quant {
+    namespace {
+        constexpr size_t PATHS_PER_BLOCK = 4096;
+
+        struct PayoffSums {
+            double sum = 0;
+            double sum_sq = 0;
+        };
+    }
+
+    MonteCarloResult monte_carlo_option_price(foundation::ThreadPool& pool, double s, double k, double r, double v,
+                                              double t, size_t paths, uint64_t seed) {
+        MonteCarloResult result;
+        result.paths = paths;
+        if (paths == 0) {
+            return result;
+        }
+        const double drift = (r - 0.5 * v * v) * t;
+        const double diffusion = v * std::sqrt(t);
+
+        const PayoffSums sums = foundation::parallel_reduce(
+            pool, 0, paths, PATHS_PER_BLOCK, PayoffSums{},
+            [&](size_t begin, size_t end) {
+                std::mt19937_64 rng(seed ^ ((begin / PATHS_PER_BLOCK + 1) * 0x9e3779b97f4a7c15ull));
+                std::normal_distribution<double> normal;
+                PayoffSums block;
+                for (size_t i = begin; i < end; ++i) {
+                    const double payoff = std::max(s * std::exp(drift + diffusion * normal(rng)) - k, 0.0);
+                    block.sum += payoff;
+                    block.sum_sq += payoff * payoff;
+                }
+                return block;
+            },
+            [](PayoffSums a, PayoffSums b) { return PayoffSums{a.sum + b.sum, a.sum_sq + b.sum_sq}; });
+
+        const double n = static_cast<double>(paths);
+        const double mean = sums.sum / n;
+        const double variance = std::max(sums.sum_sq / n - mean * mean, 0.0);
+        const double discount = std::exp(-r * t);
+        result.price = discount * mean;
+        result.std_error = discount * std::sqrt(variance / n);
+        return result;
+    }
+}
@@ -3,7 +3,11 @@
 
 namespace quant {
     double calculate_option_price(double s, double k, double r, double v, double t) {
-        // Placeholder Black-Scholes
-        return s * std::exp(-r * t); // Simplified
+        // Black-Scholes European call
+        const double sqrt_t = std::sqrt(t);
+        const double d1 = (std::log(s / k) + (r + 0.5 * v * v) * t) / (v * sqrt_t);
+        const double d2 = d1 - v * sqrt_t;
+        const auto cdf = [](double x) { return 0.5 * std::erfc(-x / std::sqrt(2.0)); };
+        return s * cdf(d1) - k * std::exp(-r * t) * cdf(d2);
     }
 }
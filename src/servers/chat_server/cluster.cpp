@@ -0,0 +1,335 @@
+#include "cluster.h"
+#include <foundation/object_pool.h>
+#include <spdlog/spdlog.h>
+#include <network/frame_codec.h>
+#include <fmt/core.h>
+#include <bit>
+#include <charconv>
+#include <cstring>
+
+namespace {
+    constexpr size_t MAX_FRAME = 1024 * 1024;
+    constexpr size_t MAX_PENDING = 64 * 1024 * 1024;   // A peer this far behind is dropped
+    constexpr uint64_t REDIAL_MS = 1000;
+
+    bool parse_node(std::string_view text, uint32_t& node) {
+        auto [end, ec] = std::from_chars(text.data(), text.data() + text.size(), node);
+        return ec == std::errc() && end == text.data() + text.size() && node < Cluster::MAX_NODES;
+    }
+
+    // One length-prefixed frame made of `type` and `parts`
+    template <typename... Parts>
+    void append_frame(std::string& out, char type, const Parts&... parts) {
+        const auto size = static_cast<uint32_t>(1 + (std::string_view(parts).size() + ... + 0));
+        const char header[network::FRAME_HEADER_SIZE] = {
+            static_cast<char>(size >> 24), static_cast<char>(size >> 16), static_cast<char>(size >> 8),
+            static_cast<char>(size)};
+        out.append(header, sizeof(header));
+        out.push_back(type);
+        (out.append(std::string_view(parts)), ...);
+    }
+}
+
+bool PeerConfig::parse(std::string_view spec, PeerConfig& out) {
+    const size_t at = spec.find('@');
+    const size_t colon = spec.rfind(':');
+    if (at == std::string_view::npos || colon == std::string_view::npos || colon < at) {
+        return false;
+    }
+    auto [end, ec] = std::from_chars(spec.data() + colon + 1, spec.data() + spec.size(), out.port);
+    out.host = std::string(spec.substr(at + 1, colon - at - 1));
+    return parse_node(spec.substr(0, at), out.node) && ec == std::errc() && end == spec.data() + spec.size() &&
+           !out.host.empty();
+}
+
+struct Cluster::Outgoing : network::MpscNode, foundation::PoolAllocated<Outgoing> {
+    Room* room = nullptr;
+    bool interest = false;          // Otherwise a message
+    network::SharedPayload frame;
+    std::string_view text;          // Into frame
+};
+
+struct Cluster::Link {
+    explicit Link(Cluster& cluster)
+        : cluster(cluster), socket(cluster.loop_, network::FRAME_HEADER_SIZE + MAX_FRAME),
+          decoder(network::FrameMode::LengthPrefixed, MAX_FRAME) {}
+
+    Cluster& cluster;
+    network::AsyncTcp socket;       // Buffers up to one whole frame
+    network::FrameDecoder decoder;
+    int node = -1;                  // Known once the peer's hello arrives
+    std::string pending;            // Frames for the next write
+    std::string writing;            // Frames of the write in flight
+    network::Event wake;            // Set when pending gains frames while the writer is idle
+    network::Event writer_done;
+    bool closing = false;
+};
+
+Cluster::Cluster(uv_loop_t* loop, uint32_t node, RoomDirectory& rooms, DeliverHandler deliver)
+    : loop_(loop), node_(node), loop_thread_(std::this_thread::get_id()), rooms_(rooms),
+      deliver_(std::move(deliver)), listener_(loop) {
+    mailbox_ = std::make_unique<network::AsyncQueue<Outgoing>>(
+        loop_, [this](std::unique_ptr<Outgoing> item) { on_outgoing(std::move(item)); });
+    uv_unref(reinterpret_cast<uv_handle_t*>(mailbox_->handle()));
+
+    uv_check_init(loop_, &flush_check_);
+    flush_check_.data = this;
+    uv_check_start(&flush_check_, [](uv_check_t* handle) { static_cast<Cluster*>(handle->data)->flush_all(); });
+    uv_unref(reinterpret_cast<uv_handle_t*>(&flush_check_));
+}
+
+// The cluster lives as long as its loop, which never stops while the server runs
+Cluster::~Cluster() = default;
+
+int Cluster::listen(const std::string& host, int port) {
+    int r = listener_.listen(host, port, 64);
+    if (r == 0) {
+        network::spawn(accept_links());
+    }
+    return r;
+}
+
+void Cluster::add_peer(const PeerConfig& peer) {
+    if (peer.node <= node_) {
+        return;     // The peer dials us
+    }
+    network::spawn(dial(peer));
+}
+
+network::Task<void> Cluster::accept_links() {
+    for (;;) {
+        auto* link = new Link(*this);
+        const int r = co_await listener_.accept(link->socket);
+        if (r != 0) {
+            co_await link->socket.close();
+            delete link;
+            if (r == UV_ECANCELED) {
+                co_return;
+            }
+            spdlog::error("Cluster accept error: {}", uv_strerror(r));
+            continue;
+        }
+        network::spawn(run_link(link));
+    }
+}
+
+network::Task<void> Cluster::dial(PeerConfig peer) {
+    network::AsyncTimer redial(loop_);
+    bool reported = false;      // Only the first failure in a row is logged
+    for (;;) {
+        auto* link = new Link(*this);
+        const int r = co_await link->socket.connect(peer.host, peer.port);
+        if (r == 0) {
+            reported = false;
+            co_await run_link(link);
+        } else {
+            co_await link->socket.close();
+            delete link;
+            if (r == UV_EINVAL) {
+                spdlog::error("Peer {} address {}: {}", peer.node, peer.host, uv_strerror(r));
+                co_await redial.close();
+                co_return;
+            }
+            if (!reported) {
+                // Names are looked up again on every attempt
+                spdlog::warn("Peer {} at {}:{} unreachable, redialing: {}", peer.node, peer.host, peer.port,
+                             uv_strerror(r));
+                reported = true;
+            }
+        }
+        co_await redial.sleep(REDIAL_MS);
+    }
+}
+
+network::Task<void> Cluster::run_link(Link* link) {
+    uv_tcp_nodelay(link->socket.handle(), 1);
+    append_frame(link->pending, 'H', fmt::format("{}", node_));
+    network::spawn(write_link(link));
+
+    while (!link->closing) {
+        if (co_await link->socket.read() != 0) {
+            break;
+        }
+        const size_t used = link->decoder.decode(link->socket.buffered(), [link](std::string_view frame) {
+            if (!link->closing) {
+                link->cluster.on_frame(link, frame);
+            }
+        });
+        link->socket.consume(used);
+        if (link->decoder.failed()) {
+            spdlog::warn("Peer {} sent a malformed frame", link->node);
+            break;
+        }
+    }
+
+    close_link(link);
+    co_await link->writer_done.wait();
+    co_await link->socket.close();
+    delete link;
+}
+
+network::Task<void> Cluster::write_link(Link* link) {
+    while (!link->closing) {
+        if (link->pending.empty()) {
+            co_await link->wake.wait();
+            continue;
+        }
+        link->writing.swap(link->pending);
+        link->pending.clear();
+        // Whatever queues up meanwhile goes out in the next write
+        const int r = co_await link->socket.write(std::span<const char>(link->writing));
+        link->writing.clear();
+        if (r != 0) {
+            close_link(link);
+        }
+    }
+    link->writer_done.set();
+}
+
+void Cluster::on_frame(Link* link, std::string_view frame) {
+    if (frame.empty()) {
+        return;
+    }
+    const char type = frame.front();
+    frame.remove_prefix(1);
+
+    if (type == 'H') {
+        uint32_t node;
+        if (link->node >= 0 || !parse_node(frame, node) || node == node_ || links_[node]) {
+            spdlog::warn("Rejecting peer link with hello '{}'", frame);
+            close_link(link);
+            return;
+        }
+        on_link_up(link, node);
+        return;
+    }
+    if (link->node < 0) {
+        close_link(link);
+        return;
+    }
+
+    std::string_view name = type == 'M' ? frame.substr(0, frame.find(' ')) : frame;
+    Room* room = rooms_.intern(name, loop_);
+    if (!room) {
+        return;
+    }
+    const uint64_t bit = uint64_t(1) << link->node;
+    if (type == 'S') {
+        room->node_mask.fetch_or(bit, std::memory_order_relaxed);
+    } else if (type == 'U') {
+        room->node_mask.fetch_and(~bit, std::memory_order_relaxed);
+    } else if (type == 'M' && name.size() < frame.size()) {
+        deliver_(room, frame.substr(name.size() + 1));
+    }
+}
+
+void Cluster::on_link_up(Link* link, uint32_t node) {
+    link->node = static_cast<int>(node);
+    links_[node] = link;
+    spdlog::info("Cluster link to node {} is up", node);
+
+    // Rooms we already have subscribers in; the peer sends us its own
+    rooms_.for_each([&](Room& room) {
+        if (room.id < advertised_.size() && advertised_[room.id]) {
+            append_frame(link->pending, 'S', room.name);
+        }
+    });
+}
+
+void Cluster::close_link(Link* link) {
+    if (link->closing) {
+        return;
+    }
+    link->closing = true;
+    if (link->node >= 0) {
+        spdlog::warn("Cluster link to node {} is down", link->node);
+        links_[link->node] = nullptr;
+        const uint64_t bit = uint64_t(1) << link->node;
+        rooms_.for_each([bit](Room& room) { room.node_mask.fetch_and(~bit, std::memory_order_relaxed); });
+    }
+    // Cancels the pending read and write; run_link() frees the link
+    link->socket.close();
+    if (link->wake.waiting()) {
+        link->wake.set();
+    }
+}
+
+void Cluster::flush(Link* link) {
+    if (!link->pending.empty() && link->wake.waiting()) {
+        link->wake.set();
+    }
+}
+
+void Cluster::flush_all() {
+    for (Link* link : links_) {
+        if (link) {
+            flush(link);
+        }
+    }
+}
+
+void Cluster::forward(Room* room, network::SharedPayload frame, std::string_view text) {
+    if (std::this_thread::get_id() == loop_thread_) {
+        send_message(room, text);
+        return;
+    }
+    auto item = std::make_unique<Outgoing>();
+    item->room = room;
+    item->frame = std::move(frame);
+    item->text = text;
+    mailbox_->post(std::move(item));
+}
+
+void Cluster::interest_changed(Room* room) {
+    if (std::this_thread::get_id() == loop_thread_) {
+        send_interest(room);
+        return;
+    }
+    auto item = std::make_unique<Outgoing>();
+    item->room = room;
+    item->interest = true;
+    mailbox_->post(std::move(item));
+}
+
+void Cluster::on_outgoing(std::unique_ptr<Outgoing> item) {
+    if (item->interest) {
+        send_interest(item->room);
+    } else {
+        send_message(item->room, item->text);
+    }
+}
+
+void Cluster::send_message(Room* room, std::string_view text) {
+    uint64_t mask = room->node_mask.load(std::memory_order_relaxed);
+    while (mask) {
+        Link* link = links_[std::countr_zero(mask)];
+        mask &= mask - 1;
+        if (!link) {
+            continue;
+        }
+        if (link->pending.size() > MAX_PENDING) {
+            spdlog::warn("Cluster link to node {} is {} bytes behind; dropping it", link->node, link->pending.size());
+            close_link(link);
+            continue;
+        }
+        append_frame(link->pending, 'M', room->name, " ", text);
+    }
+}
+
+// Notifications may arrive out of order from different loops, so the current
+// state is re-read rather than trusted from the caller
+void Cluster::send_interest(Room* room) {
+    const bool wanted = room->worker_mask.load(std::memory_order_relaxed) != 0;
+    if (room->id >= advertised_.size()) {
+        advertised_.resize(room->id + 1);
+    }
+    if (advertised_[room->id] == wanted) {
+        return;
+    }
+    advertised_[room->id] = wanted;
+    for (Link* link : links_) {
+        if (link) {
+            append_frame(link->pending, wanted ? 'S' : 'U', room->name);
+        }
+    }
+}
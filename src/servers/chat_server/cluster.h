@@ -0,0 +1,115 @@
+#pragma once
+#include "rooms.h"
+#include <network/async_io.h>
+#include <network/async_queue.h>
+#include <network/shared_payload.h>
+#include <network/task.h>
+#include <uv.h>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+struct PeerConfig {
+    uint32_t node;
+    std::string host;
+    int port;
+
+    /**
+     * @brief Parse "ID@HOST:PORT".
+     */
+    static bool parse(std::string_view spec, PeerConfig& out);
+};
+
+/**
+ * @brief Links this chat_server to the other nodes of a cluster.
+ *
+ * Every pair of nodes shares one TCP link, dialled by the node with the
+ * lower id and redialled a second after it drops. Over it each node
+ * advertises the rooms it has local subscribers in, so a room message is
+ * forwarded once to each node that wants it, however many of its users are
+ * in the room. Messages for one peer are appended to a single buffer and
+ * written once per loop iteration (or when the previous write completes),
+ * so a busy link carries many messages per write. Each link is served by
+ * two coroutines, one reading and dispatching frames and one writing.
+ *
+ * Link frames are length-prefixed; the first byte of the body is the type:
+ * "H<node>" hello, "S<room>" / "U<room>" (un)subscribe, "M<room> <text>"
+ * message. Runs on one loop; forward() and interest_changed() may be
+ * called from any thread.
+ */
+class Cluster {
+public:
+    static constexpr size_t MAX_NODES = 64;
+
+    // Called on the cluster loop with the body of a message from a peer
+    using DeliverHandler = std::function<void(Room* room, std::string_view text)>;
+
+    /**
+     * @brief Must be constructed on the thread that runs `loop`.
+     */
+    Cluster(uv_loop_t* loop, uint32_t node, RoomDirectory& rooms, DeliverHandler deliver);
+    ~Cluster();
+
+    Cluster(const Cluster&) = delete;
+    Cluster& operator=(const Cluster&) = delete;
+
+    /**
+     * @return 0 on success, a negative libuv error code otherwise.
+     */
+    int listen(const std::string& host, int port);
+
+    /**
+     * @brief Keep a link to `peer` if this node should dial it (lower id);
+     *        otherwise wait for the peer to connect.
+     */
+    void add_peer(const PeerConfig& peer);
+
+    /**
+     * @brief Send `text` to every peer with subscribers in `room`.
+     * @param frame Payload that `text` points into; it keeps the bytes
+     *        alive until the cluster loop has copied them.
+     */
+    void forward(Room* room, network::SharedPayload frame, std::string_view text);
+
+    /**
+     * @brief Whether this node has local subscribers in `room` may have
+     *        changed; peers are told if it did.
+     */
+    void interest_changed(Room* room);
+
+    uint32_t node() const { return node_; }
+
+private:
+    struct Link;
+    struct Outgoing;
+
+    void on_outgoing(std::unique_ptr<Outgoing> item);
+    void send_message(Room* room, std::string_view text);
+    void send_interest(Room* room);
+    network::Task<void> accept_links();
+    network::Task<void> dial(PeerConfig peer);
+    network::Task<void> run_link(Link* link);     // Owns the link; returns once it is freed
+    network::Task<void> write_link(Link* link);
+    void on_frame(Link* link, std::string_view frame);
+    void on_link_up(Link* link, uint32_t node);
+    void close_link(Link* link);
+    void flush(Link* link);
+    void flush_all();
+
+    uv_loop_t* loop_;
+    uint32_t node_;
+    std::thread::id loop_thread_;
+    RoomDirectory& rooms_;
+    DeliverHandler deliver_;
+    network::AsyncTcp listener_;
+    uv_check_t flush_check_{};
+    std::unique_ptr<network::AsyncQueue<Outgoing>> mailbox_;
+    std::array<Link*, MAX_NODES> links_{};          // By node, once the hello arrived
+    std::vector<bool> advertised_;                  // By Room::id: subscribed as far as peers know
+};
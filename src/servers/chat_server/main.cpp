@@ -1,126 +1,828 @@
+#include "cluster.h"
+#include "rooms.h"
+#include <foundation/clock.h>
+#include <foundation/histogram.h>
+#include <foundation/huge_pages.h>
+#include <foundation/logger.h>
+#include <foundation/metrics.h>
+#include <foundation/object_pool.h>
+#include <foundation/thread_runner.h>
+#include <foundation/trace.h>
+#include <network/async_queue.h>
+#include <network/event_loop.h>
+#include <network/frame_codec.h>
+#include <network/http_listener.h>
+#include <network/message_log.h>
+#include <network/search_index.h>
+#include <network/shared_payload.h>
+#include <network/slot_map.h>
+#include <network/task.h>
+#include <network/tcp_server.h>
+#include <network/timer_wheel.h>
 #include <uv.h>
 #include <spdlog/spdlog.h>
 #include <fmt/core.h>
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <csignal>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <optional>
 #include <vector>
 #include <string>
-#include <cstring>
+#include <string_view>
+
+struct ChatWorker;
 
-struct client_t {
-    uv_tcp_t handle;
+struct client_t : RoomSubscriber, foundation::PoolAllocated<client_t> {
+    network::Connection* conn = nullptr;
+    network::SlotHandle handle;     // In the worker's registry
+    int id = 0;
     std::string name;
+    ChatWorker* worker = nullptr;
+    network::Timer heartbeat;
+    Room* current = nullptr;    // Where plain messages go
+};
+
+// A room message forwarded from another worker's loop; one per message and
+// target loop, so they come from a pool
+struct RemoteMessage : network::MpscNode, foundation::PoolAllocated<RemoteMessage> {
+    Room* room = nullptr;
+    network::SharedPayload payload;
+    uint64_t coalesce_key = 0;
+    uint64_t posted_ticks = 0;  // TscClock, for the mailbox stage
+};
+
+// One event loop thread with its own listen socket and room subscribers
+struct ChatWorker {
+    explicit ChatWorker(size_t index) : index(index), rooms(index) {}
+
+    size_t index;
+    network::EventLoop loop;
+    std::unique_ptr<network::TcpServer> server;
+    std::unique_ptr<network::AsyncQueue<RemoteMessage>> mailbox;
+    network::SlotMap<std::unique_ptr<client_t>> clients;   // Owns this loop's clients
+    RoomIndex rooms;
+    foundation::ThreadRunnerStats sampled_runner;   // At the last sample_queues() pass
+};
+
+// Fixed after startup, so every worker may read it without locking
+std::vector<std::unique_ptr<ChatWorker>> workers;
+RoomDirectory room_directory;
+Room* lobby = nullptr;      // Every client starts here
+std::unique_ptr<Cluster> cluster;   // Null unless --node-id/--peer were given
+std::atomic<int> next_client_id{0};
+network::FrameMode framing = network::FrameMode::LengthPrefixed;
+uint64_t heartbeat_ms = 30 * 1000;
+network::SharedPayload heartbeat_frame;  // Empty frame; clients answer with one
+size_t history_replay = 50;     // Messages a joining client is sent by default
+size_t history_replay_bytes = 0;
+constexpr uint64_t RETENTION_INTERVAL_MS = 60 * 1000;
+constexpr size_t SEARCH_RESULTS = 20;
+
+// Per-stage latencies in nanoseconds, recorded by every loop; exported as
+// chat_stage_latency_seconds{stage=...}, reported by /stats and logged at exit
+struct StageLatencies {
+    static foundation::LatencyRecorder& stage(const char* name) {
+        return foundation::metrics().histogram("chat_stage_latency_seconds", "Time spent in each chat_server stage",
+                                               {{"stage", name}});
+    }
+
+    foundation::LatencyRecorder& publish = stage("publish");    // Chat line handled: history, index, fan-out
+    foundation::LatencyRecorder& history_append = stage("history_append");
+    foundation::LatencyRecorder& mailbox = stage("mailbox");    // Posted by one loop until delivered by another
+    foundation::LatencyRecorder& search = stage("search");
+    foundation::LatencyRecorder& compaction = stage("compaction");  // One queued index compaction, on the threadpool
+    foundation::LatencyRecorder& write = foundation::metrics().histogram(
+        "chat_write_latency_seconds", "Flush of a client's send queue until the socket took the bytes");
+
+    template <typename Fn>
+    void for_each(Fn&& fn) const {
+        fn("publish", publish);
+        fn("history_append", history_append);
+        fn("mailbox", mailbox);
+        fn("search", search);
+        fn("compaction", compaction);
+        fn("write", write);
+    }
 };
+StageLatencies latencies;
 
-std::vector<client_t*> clients;
-uv_loop_t* loop;
+// Served on --metrics-port; counters and gauges are sharded per loop thread
+struct ChatMetrics {
+    foundation::MetricsRegistry& registry = foundation::metrics();
+    foundation::Counter& connections_total = registry.counter("chat_connections_total", "Client connections accepted");
+    foundation::Gauge& connections = registry.gauge("chat_connections", "Connected clients");
+    foundation::Counter& messages_received =
+        registry.counter("chat_messages_received_total", "Frames received from clients, commands included");
+    foundation::Counter& bytes_received =
+        registry.counter("chat_bytes_received_total", "Frame payload bytes received from clients");
+    foundation::Counter& messages_delivered =
+        registry.counter("chat_messages_delivered_total", "Room messages queued to subscribed clients");
+    foundation::Counter& bytes_delivered =
+        registry.counter("chat_bytes_delivered_total", "Encoded bytes of room messages queued to clients");
+    foundation::Gauge& outbound_queued_bytes =
+        registry.gauge("chat_outbound_queued_bytes", "Bytes waiting in client send queues, sampled every second");
+    foundation::Gauge& mailbox_depth =
+        registry.gauge("chat_mailbox_depth", "Room messages posted to another loop and not yet delivered");
+
+    // Only with --cpus, --numa-node, --realtime or --busy-poll, which run the loops on a ThreadRunner
+    foundation::Gauge& loop_busy(size_t loop) {
+        return registry.gauge("chat_loop_busy_permille", "Share of the last sample a loop spent handling events",
+                              {{"loop", std::to_string(loop)}});
+    }
+};
+ChatMetrics chat_metrics;
+constexpr uint64_t METRICS_SAMPLE_MS = 1000;
+std::unique_ptr<network::HttpListener> metrics_listener;
+
+// Format straight into a framed payload: one allocation, no intermediate string
+template <typename... Args>
+network::SharedPayload make_message(fmt::format_string<Args...> format, Args&&... args) {
+    size_t size = fmt::formatted_size(format, args...);
+    char* body = nullptr;
+    network::SharedPayload payload = network::allocate_frame(framing, size, &body);
+    fmt::format_to(body, format, std::forward<Args>(args)...);
+    return payload;
+}
 
-void alloc_buffer(uv_handle_t* handle, size_t suggested_size, uv_buf_t* buf) {
-    buf->base = new char[suggested_size];
-    buf->len = suggested_size;
+// Presence updates about one user in one room may replace each other in a slow client's queue
+uint64_t presence_key(const client_t* client, const Room* room) {
+    return (static_cast<uint64_t>(room->id) << 32) | static_cast<uint32_t>(client->id);
 }
 
-void broadcast_message(client_t* sender, const char* msg, size_t len) {
-    for (auto* client : clients) {
-        if (client != sender) {
-            uv_buf_t buf = uv_buf_init(const_cast<char*>(msg), len);
-            uv_write_t* req = new uv_write_t;
-            uv_write(req, (uv_stream_t*)&client->handle, &buf, 1, 
-                [](uv_write_t* req, int status) { delete req; });
+void deliver_local(ChatWorker& worker, const client_t* sender, const Room* room,
+                   const network::SharedPayload& msg, uint64_t coalesce_key = 0) {
+    FTRACE_ZONE("deliver_local");
+    uint64_t delivered = 0;
+    for (RoomSubscriber* member : worker.rooms.members(room)) {
+        if (member != sender) {
+            static_cast<client_t*>(member)->conn->send(msg, coalesce_key);
+            delivered++;
         }
     }
+    chat_metrics.messages_delivered.inc(delivered);
+    chat_metrics.bytes_delivered.inc(delivered * msg.size());
 }
 
-void on_read(uv_stream_t* stream, ssize_t nread, const uv_buf_t* buf) {
-    client_t* client = (client_t*)stream->data;
-    
-    if (nread < 0) {
-        if (nread != UV_EOF) {
-            spdlog::error("Read error: {}", uv_strerror(nread));
-        }
-        
-        spdlog::info("Client {} disconnected", client->name);
-        std::string leave_msg = fmt::format("[Server] {} left the chat\n", client->name);
-        broadcast_message(client, leave_msg.c_str(), leave_msg.length());
-        
-        // Remove from clients list
-        clients.erase(std::remove(clients.begin(), clients.end(), client), 
-                     clients.end());
-        
-        uv_close((uv_handle_t*)stream, [](uv_handle_t* handle) {
-            delete (client_t*)handle->data;
+// Touches only the room's local subscribers, plus one mailbox post per other
+// loop that has subscribers of its own
+void fan_out(ChatWorker& worker, const client_t* sender, Room* room, const network::SharedPayload& msg,
+             uint64_t coalesce_key) {
+    FTRACE_ZONE("fan_out");
+    deliver_local(worker, sender, room, msg, coalesce_key);
+
+    uint64_t mask = room->worker_mask.load(std::memory_order_relaxed) & ~(uint64_t(1) << worker.index);
+    while (mask) {
+        const int target = std::countr_zero(mask);
+        mask &= mask - 1;
+        auto remote = std::make_unique<RemoteMessage>();
+        remote->room = room;
+        remote->payload = msg;
+        remote->coalesce_key = coalesce_key;
+        remote->posted_ticks = foundation::TscClock::ticks();
+        chat_metrics.mailbox_depth.add(1);
+        workers[target]->mailbox->post(std::move(remote));
+    }
+}
+
+// The message text inside an encoded frame
+std::string_view frame_text(const network::SharedPayload& msg) {
+    std::string_view view = msg.view();
+    if (framing == network::FrameMode::LengthPrefixed) {
+        view.remove_prefix(network::FRAME_HEADER_SIZE);
+    } else if (framing == network::FrameMode::NewlineDelimited) {
+        view.remove_suffix(1);
+    }
+    return view;
+}
+
+// Other nodes get the message once each, and only if they have subscribers
+void publish(client_t* sender, Room* room, const network::SharedPayload& msg, uint64_t coalesce_key = 0) {
+    fan_out(*sender->worker, sender, room, msg, coalesce_key);
+    if (cluster && room->node_mask.load(std::memory_order_relaxed)) {
+        cluster->forward(room, msg, frame_text(msg));
+    }
+}
+
+struct CompactionWork {
+    uv_work_t req;
+    ChatWorker* worker;
+    Room* room;
+};
+
+// Encoding and merging index segments run on the libuv threadpool, never on a loop
+void schedule_compaction(ChatWorker& worker, Room* room) {
+    if (!room->search->needs_compaction() || room->compaction_queued.exchange(true)) {
+        return;
+    }
+    auto* work = new CompactionWork{{}, &worker, room};
+    work->req.data = work;
+    uv_queue_work(
+        worker.loop.get(), &work->req,
+        [](uv_work_t* req) {
+            auto* work = static_cast<CompactionWork*>(req->data);
+            foundation::Stopwatch stopwatch;
+            while (work->room->search->compact()) {
+            }
+            latencies.compaction.record(stopwatch.elapsed_ns());
+        },
+        [](uv_work_t* req, int) {
+            auto* work = static_cast<CompactionWork*>(req->data);
+            work->room->compaction_queued = false;
+            schedule_compaction(*work->worker, work->room);     // In case a segment was sealed meanwhile
+            delete work;
         });
-        delete[] buf->base;
+}
+
+// Chat messages only; presence updates are not worth replaying
+void publish_chat(client_t* sender, Room* room, const network::SharedPayload& msg) {
+    foundation::Stopwatch stopwatch;
+    if (room->history_enabled) {
+        std::lock_guard lock(room->history_mutex);
+        uint64_t seq;
+        if (!room->history_ready.load(std::memory_order_relaxed)) {
+            room->pending_history.push_back(msg);   // Appended once the log is open
+        } else if (room->history) {
+            const int r = room->history->append(msg.view(), &seq);
+            latencies.history_append.record(stopwatch.elapsed_ns());
+            if (r != 0) {
+                FLOG_WARN("History append to #{} failed: {}", room->name, uv_strerror(r));
+            } else if (room->search && room->search_ready.load(std::memory_order_relaxed)) {
+                // Only tokenizes into the in-memory segment; see BM_SearchIndexIngest
+                room->search->add(seq, frame_text(msg));
+            }
+        }
+    }
+    if (room->search && room->search_ready.load(std::memory_order_acquire)) {
+        schedule_compaction(*sender->worker, room);
+    }
+    publish(sender, room, msg);
+    latencies.publish.record(stopwatch.elapsed_ns());
+}
+
+void search_room(client_t* client, Room* room, std::string_view query) {
+    if (!room->search) {
+        client->conn->send(make_message("[Server] Search is not enabled for #{}", room->name));
+        return;
+    }
+    if (!room->search_ready.load(std::memory_order_acquire)) {
+        bool unavailable;
+        {
+            std::lock_guard lock(room->history_mutex);
+            unavailable = room->history_ready.load(std::memory_order_relaxed) && !room->history;
+        }
+        client->conn->send(unavailable ? make_message("[Server] Search is unavailable for #{}", room->name)
+                                       : make_message("[Server] #{} is still indexing; try again shortly", room->name));
         return;
     }
-    
-    if (nread > 0) {
-        std::string msg(buf->base, nread);
-        spdlog::info("[{}]: {}", client->name, msg.substr(0, msg.length()-1));
-        
-        std::string broadcast = fmt::format("[{}]: {}", client->name, msg);
-        broadcast_message(client, broadcast.c_str(), broadcast.length());
+    foundation::Stopwatch stopwatch;
+    const std::vector<uint64_t> ids = room->search->search(query, SEARCH_RESULTS);
+    const uint64_t ns = stopwatch.elapsed_ns();
+    latencies.search.record(ns);
+    const double ms = static_cast<double>(ns) / 1e6;
+    std::string list;
+    for (uint64_t id : ids) {
+        list += fmt::format(" {}", id);
     }
-    
-    delete[] buf->base;
+    const size_t count = ids.size();
+    client->conn->send(make_message("[Server] #{}: {} matches for \"{}\" ({:.3f} ms):{}", room->name, count,
+                                    query, ms, list));
 }
 
-void on_new_connection(uv_stream_t* server, int status) {
-    if (status < 0) {
-        spdlog::error("Connection error: {}", uv_strerror(status));
+// Sends the log as views of its mapped segments: a few large writes, no per-message copies.
+// The client is subscribed before the log is read, so nothing published meanwhile is
+// missed, though a message appended from another loop in that window may arrive twice.
+// While the room's log is still being opened the replay is queued, and follows any
+// messages delivered live in the meantime.
+void replay_history(client_t* client, Room* room, std::optional<uint64_t> since) {
+    std::vector<network::SharedPayload> views;
+    size_t count;
+    uint64_t next;
+    {
+        std::lock_guard lock(room->history_mutex);
+        if (!room->history_ready.load(std::memory_order_relaxed)) {
+            room->history_waiters.push_back([worker = client->worker, handle = client->handle, room, since] {
+                worker->loop.post([worker, handle, room, since] {
+                    // Unless the client disconnected or left meanwhile
+                    if (auto* client = worker->clients.get(handle); client && (*client)->in_room(room)) {
+                        replay_history(client->get(), room, since);
+                    }
+                });
+            });
+            return;
+        }
+        if (!room->history) {
+            return;
+        }
+        count = since ? room->history->read(*since, history_replay_bytes, views)
+                      : room->history->read_last(history_replay, history_replay_bytes, views);
+        next = room->history->next_seq();
+    }
+    for (const auto& view : views) {
+        client->conn->send(view);
+    }
+    client->conn->send(make_message("[Server] Replayed {} messages of #{} (next seq {})", count,
+                                    room->name, next));
+}
+
+void join_room(client_t* client, Room* room, std::optional<uint64_t> since = std::nullopt) {
+    const bool joined = client->worker->rooms.join(client, room);
+    if (joined) {
+        publish(client, room, make_message("[Server] {} joined #{}", client->name, room->name),
+                presence_key(client, room));
+    }
+    client->current = room;
+    client->conn->send(make_message("[Server] You are now talking in #{}", room->name));
+    if (room->history_enabled && (joined || since)) {
+        replay_history(client, room, since);
+    }
+}
+
+void leave_room(client_t* client, Room* room) {
+    if (!client->worker->rooms.leave(client, room)) {
         return;
     }
-    
-    client_t* client = new client_t;
-    uv_tcp_init(loop, &client->handle);
-    client->handle.data = client;
-    
-    if (uv_accept(server, (uv_stream_t*)&client->handle) == 0) {
-        static int client_id = 0;
-        client->name = fmt::format("User{}", ++client_id);
-        
-        clients.push_back(client);
-        spdlog::info("New client connected: {}", client->name);
-        
-        std::string welcome = fmt::format("[Server] Welcome {}! Type messages to chat.\n", 
-                                         client->name);
-        uv_buf_t buf = uv_buf_init(const_cast<char*>(welcome.c_str()), 
-                                   welcome.length());
-        uv_write_t* req = new uv_write_t;
-        uv_write(req, (uv_stream_t*)&client->handle, &buf, 1, 
-            [](uv_write_t* req, int status) { delete req; });
-        
-        std::string join_msg = fmt::format("[Server] {} joined the chat\n", client->name);
-        broadcast_message(client, join_msg.c_str(), join_msg.length());
-        
-        uv_read_start((uv_stream_t*)&client->handle, alloc_buffer, on_read);
+    publish(client, room, make_message("[Server] {} left #{}", client->name, room->name),
+            presence_key(client, room));
+    if (client->current == room) {
+        client->current = client->memberships.empty() ? nullptr : client->memberships.back().room;
+    }
+}
+
+void send_stats(client_t* client) {
+    latencies.for_each([client](const char* stage, const foundation::LatencyRecorder& recorder) {
+        const std::string summary = foundation::format_latency(recorder.snapshot().summary());
+        client->conn->send(make_message("[Server] {}: {}", stage, summary));
+    });
+}
+
+// "/join <room> [since_seq]", "/leave [room]", "/rooms", "/search <terms>", "/stats"
+void handle_command(client_t* client, std::string_view line) {
+    std::string_view command = line.substr(0, line.find(' '));
+    std::string_view arg = command.size() < line.size() ? line.substr(command.size() + 1) : std::string_view{};
+    network::Connection& conn = *client->conn;
+
+    std::optional<uint64_t> since;
+    if (command == "/join" && arg.find(' ') != std::string_view::npos) {
+        std::string seq(arg.substr(arg.find(' ') + 1));
+        arg = arg.substr(0, arg.find(' '));
+        char* end = nullptr;
+        since = std::strtoull(seq.c_str(), &end, 10);
+        if (seq.empty() || *end != '\0') {
+            conn.send(make_message("[Server] Usage: /join <room> [since_seq]"));
+            return;
+        }
+    }
+
+    if (command == "/join" || (command == "/leave" && !arg.empty())) {
+        Room* room = room_directory.intern(arg, client->worker->loop.get());
+        if (!RoomDirectory::valid_name(arg)) {
+            conn.send(make_message("[Server] Room names are 1-{} characters of A-Z a-z 0-9 _ -",
+                                   RoomDirectory::MAX_NAME));
+        } else if (!room) {
+            conn.send(make_message("[Server] No more rooms can be created on this server"));
+        } else if (command == "/join") {
+            join_room(client, room, since);
+        } else {
+            leave_room(client, room);
+        }
+    } else if (command == "/leave") {
+        if (client->current) {
+            leave_room(client, client->current);
+        }
+    } else if (command == "/search" && !arg.empty()) {
+        if (client->current) {
+            search_room(client, client->current, arg);
+        } else {
+            conn.send(make_message("[Server] You are not in a room; /join <room> first"));
+        }
+    } else if (command == "/stats") {
+        send_stats(client);
+    } else if (command == "/rooms") {
+        std::string names;
+        for (const auto& m : client->memberships) {
+            names += fmt::format("{}#{}", names.empty() ? "" : " ", m.room->name);
+        }
+        std::string_view current = client->current ? std::string_view(client->current->name) : "nowhere";
+        if (names.empty()) {
+            names = "none";
+        }
+        conn.send(make_message("[Server] Rooms: {} (talking in #{})", names, current));
     } else {
-        uv_close((uv_handle_t*)&client->handle, [](uv_handle_t* handle) {
-            delete (client_t*)handle->data;
+        conn.send(make_message("[Server] Commands: /join <room> [since_seq], /leave [room], /rooms, /search <terms>, /stats"));
+    }
+}
+
+// Ping clients that have been quiet for a whole interval so idle reaping spares live ones
+void send_heartbeat(client_t* client) {
+    network::Connection& conn = *client->conn;
+    if (uv_now(conn.server().loop()) - conn.last_read_time() >= heartbeat_ms) {
+        conn.send(heartbeat_frame);
+    }
+    conn.server().timers().schedule(client->heartbeat, heartbeat_ms);
+}
+
+void on_connect(ChatWorker& worker, network::Connection& conn) {
+    int id = ++next_client_id;
+    network::SlotHandle handle = worker.clients.emplace(std::make_unique<client_t>());
+    client_t* client = worker.clients.get(handle)->get();
+    client->handle = handle;
+    client->conn = &conn;
+    client->id = id;
+    // Ids are per process, so a cluster node qualifies its users' names
+    client->name = cluster ? fmt::format("User{}@{}", id, cluster->node()) : fmt::format("User{}", id);
+    client->worker = &worker;
+    conn.set_user_data(client);
+    chat_metrics.connections_total.inc();
+    chat_metrics.connections.add(1);
+
+    if (heartbeat_ms) {
+        client->heartbeat.set_callback([client] { send_heartbeat(client); });
+        conn.server().timers().schedule(client->heartbeat, heartbeat_ms);
+    }
+    FLOG_INFO("New client connected: {} (loop {})", client->name, worker.index);
+
+    conn.send(make_message("[Server] Welcome {}! Type messages to chat, /join <room> to switch rooms.",
+                           client->name));
+    join_room(client, lobby);
+}
+
+void on_data(network::Connection& conn, std::span<const char> data) {
+    FTRACE_ZONE("on_data");
+    client_t* client = static_cast<client_t*>(conn.user_data());
+    chat_metrics.messages_received.inc();
+    chat_metrics.bytes_received.inc(data.size());
+
+    std::string_view msg(data.data(), data.size());
+    if (msg.empty()) {
+        return;  // Heartbeat reply; the read already refreshed the idle timer
+    }
+    if (msg.front() == '/') {
+        handle_command(client, msg);
+        return;
+    }
+    if (!client->current) {
+        conn.send(make_message("[Server] You are not in a room; /join <room> first"));
+        return;
+    }
+    FLOG_INFO("[#{}] [{}]: {}", client->current->name, client->name, msg);
+
+    publish_chat(client, client->current,
+                 make_message("[#{}] [{}]: {}", client->current->name, client->name, msg));
+}
+
+void on_close(ChatWorker& worker, network::Connection& conn) {
+    client_t* client = static_cast<client_t*>(conn.user_data());
+
+    const network::OutboundStats& stats = conn.outbound_stats();
+    FLOG_INFO("Client {} disconnected (sent {} msgs / {} bytes in {} writes, dropped {}, "
+              "coalesced {}, congested {} times, {} bytes still queued)",
+              client->name, stats.messages_sent, stats.bytes_sent, stats.write_calls,
+              stats.messages_dropped, stats.messages_coalesced, stats.congestion_events,
+              conn.queued_bytes());
+
+    while (!client->memberships.empty()) {
+        leave_room(client, client->memberships.back().room);
+    }
+
+    worker.clients.erase(client->handle);  // O(1); frees the client
+    chat_metrics.connections.add(-1);
+}
+
+// Each loop sets its own share of the gauge, so the sum needs no locking
+network::Task<void> sample_queues(ChatWorker& worker) {
+    for (;;) {
+        co_await network::sleep(worker.server->timers(), METRICS_SAMPLE_MS);
+        int64_t queued = 0;
+        for (const auto& client : worker.clients) {
+            queued += static_cast<int64_t>(client->conn->queued_bytes());
+        }
+        chat_metrics.outbound_queued_bytes.set(queued);
+
+        const foundation::ThreadRunnerStats now = worker.loop.runner_stats();
+        const uint64_t busy = now.busy_ns - worker.sampled_runner.busy_ns;
+        const uint64_t total = busy + now.idle_ns - worker.sampled_runner.idle_ns;
+        if (total) {
+            chat_metrics.loop_busy(worker.index).set(static_cast<int64_t>(busy * 1000 / total));
+        }
+        worker.sampled_runner = now;
+    }
+}
+
+network::Task<void> enforce_retention() {
+    for (;;) {
+        co_await network::sleep(workers[0]->server->timers(), RETENTION_INTERVAL_MS);
+        const uint64_t now = network::MessageLog::wall_clock_ms();
+        room_directory.for_each([now](Room& room) {
+            if (room.history_enabled) {
+                std::lock_guard lock(room.history_mutex);
+                if (room.history) {
+                    room.history->enforce_retention(now);
+                }
+            }
         });
     }
 }
 
-int main() {
+// False for an unknown name, which sends the flag to the usage text
+bool parse_policy(std::string_view name, network::SlowConsumerPolicy& out) {
+    if (name == "drop-oldest") {
+        out = network::SlowConsumerPolicy::DropOldest;
+    } else if (name == "coalesce") {
+        out = network::SlowConsumerPolicy::Coalesce;
+    } else if (name == "disconnect") {
+        out = network::SlowConsumerPolicy::Disconnect;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+bool parse_backend(std::string_view name, network::Backend& out) {
+    if (name == "libuv") {
+        out = network::Backend::Libuv;
+    } else if (name == "io_uring") {
+        out = network::Backend::IoUring;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+bool parse_flush(std::string_view name, network::FlushMode& out) {
+    if (name == "immediate") {
+        out = network::FlushMode::Immediate;
+    } else if (name == "per-tick") {
+        out = network::FlushMode::PerTick;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+network::HttpResponse serve_metrics(std::string_view method, std::string_view path) {
+    if (path != "/metrics" && path != "/trace") {
+        return {404, "text/plain; charset=utf-8", "try /metrics or /trace\n"};
+    }
+    if (method != "GET") {
+        return {405, "text/plain; charset=utf-8", "GET only\n"};
+    }
+    if (path == "/trace") {
+        return {200, "application/json", foundation::trace_json()};
+    }
+    return {200, "text/plain; version=0.0.4; charset=utf-8", foundation::metrics().render_prometheus()};
+}
+
+int main(int argc, char** argv) {
     spdlog::info("Starting Chat Server...");
-    
-    loop = uv_default_loop();
-    
-    uv_tcp_t server;
-    uv_tcp_init(loop, &server);
-    
-    struct sockaddr_in addr;
-    uv_ip4_addr("0.0.0.0", 8888, &addr);
-    
-    uv_tcp_bind(&server, (const struct sockaddr*)&addr, 0);
-    
-    int r = uv_listen((uv_stream_t*)&server, 128, on_new_connection);
-    if (r) {
-        spdlog::error("Listen error: {}", uv_strerror(r));
-        return 1;
-    }
-    
-    spdlog::info("Chat server listening on port 8888");
-    fmt::print("Chat Server is running on port 8888\n");
+
+#ifndef _WIN32
+    // A peer that resets mid-write must cost one connection, not the process
+    std::signal(SIGPIPE, SIG_IGN);
+#endif
+
+    int port = 8888;
+    size_t loop_count = 1;
+    network::OutboundOptions outbound;
+    network::FlushMode flush_mode = network::FlushMode::Immediate;
+    uint64_t idle_timeout_ms = 120 * 1000;
+    network::Backend backend = network::Backend::Libuv;
+    std::string history_dir;
+    int node_id = -1;
+    int cluster_port = 0;
+    int metrics_port = 0;
+    std::vector<PeerConfig> peers;
+    network::MessageLogOptions history_options;
+    bool search = false;
+    foundation::AsyncLoggerOptions log_options;
+    std::string trace_dir;
+    size_t huge_page_mb = 0;
+    bool lock_memory = false;
+    foundation::ThreadRunnerOptions runner;    // Template for every loop thread
+    bool place_loops = false;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--loops") == 0 && i + 1 < argc) {
+            loop_count = std::clamp<size_t>(std::atoi(argv[++i]), 1, Room::MAX_WORKERS);
+        } else if (std::strcmp(argv[i], "--port") == 0 && i + 1 < argc) {
+            port = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--text") == 0) {
+            framing = network::FrameMode::NewlineDelimited;  // telnet/nc compatible
+        } else if (std::strcmp(argv[i], "--high-watermark") == 0 && i + 1 < argc) {
+            outbound.high_watermark = std::strtoull(argv[++i], nullptr, 10);
+            outbound.low_watermark = outbound.high_watermark / 4;
+        } else if (std::strcmp(argv[i], "--policy") == 0 && i + 1 < argc && parse_policy(argv[i + 1], outbound.policy)) {
+            ++i;
+        } else if (std::strcmp(argv[i], "--flush") == 0 && i + 1 < argc && parse_flush(argv[i + 1], flush_mode)) {
+            ++i;
+        } else if (std::strcmp(argv[i], "--idle-timeout") == 0 && i + 1 < argc) {
+            idle_timeout_ms = std::strtoull(argv[++i], nullptr, 10) * 1000;
+        } else if (std::strcmp(argv[i], "--heartbeat") == 0 && i + 1 < argc) {
+            heartbeat_ms = std::strtoull(argv[++i], nullptr, 10) * 1000;
+        } else if (std::strcmp(argv[i], "--backend") == 0 && i + 1 < argc && parse_backend(argv[i + 1], backend)) {
+            ++i;
+        } else if (std::strcmp(argv[i], "--history-dir") == 0 && i + 1 < argc) {
+            history_dir = argv[++i];
+        } else if (std::strcmp(argv[i], "--node-id") == 0 && i + 1 < argc) {
+            node_id = std::clamp(std::atoi(argv[++i]), 0, static_cast<int>(Cluster::MAX_NODES) - 1);
+        } else if (std::strcmp(argv[i], "--cluster-port") == 0 && i + 1 < argc) {
+            cluster_port = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--peer") == 0 && i + 1 < argc && PeerConfig::parse(argv[i + 1], peers.emplace_back())) {
+            ++i;
+        } else if (std::strcmp(argv[i], "--max-rooms") == 0 && i + 1 < argc) {
+            room_directory.set_max_rooms(std::strtoull(argv[++i], nullptr, 10));
+        } else if (std::strcmp(argv[i], "--search") == 0) {
+            search = true;
+        } else if (std::strcmp(argv[i], "--history") == 0 && i + 1 < argc) {
+            history_replay = std::strtoull(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--segment-mb") == 0 && i + 1 < argc) {
+            history_options.segment_bytes = std::max<size_t>(std::strtoull(argv[++i], nullptr, 10), 1) << 20;
+        } else if (std::strcmp(argv[i], "--retain-mb") == 0 && i + 1 < argc) {
+            history_options.retain_bytes = std::strtoull(argv[++i], nullptr, 10) << 20;
+        } else if (std::strcmp(argv[i], "--retain-hours") == 0 && i + 1 < argc) {
+            history_options.retain_ms = std::strtoull(argv[++i], nullptr, 10) * 3600 * 1000;
+        } else if (std::strcmp(argv[i], "--log-rate") == 0 && i + 1 < argc) {
+            log_options.max_per_second = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (std::strcmp(argv[i], "--metrics-port") == 0 && i + 1 < argc) {
+            metrics_port = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--trace-dir") == 0 && i + 1 < argc) {
+            trace_dir = argv[++i];
+        } else if (std::strcmp(argv[i], "--hugepages") == 0 && i + 1 < argc) {
+            huge_page_mb = std::strtoull(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--mlock") == 0) {
+            lock_memory = true;
+        } else if (std::strcmp(argv[i], "--cpus") == 0 && i + 1 < argc) {
+            runner.cpus = foundation::parse_cpu_list(argv[++i]);
+            place_loops = true;
+        } else if (std::strcmp(argv[i], "--numa-node") == 0 && i + 1 < argc) {
+            runner.numa_node = std::atoi(argv[++i]);
+            place_loops = true;
+        } else if (std::strcmp(argv[i], "--realtime") == 0 && i + 1 < argc) {
+            runner.realtime_priority = std::atoi(argv[++i]);
+            place_loops = true;
+        } else if (std::strcmp(argv[i], "--busy-poll") == 0) {
+            runner.busy_poll = true;
+            place_loops = true;
+        } else {
+            fmt::print("Usage: chat_server [--port N] [--loops N] [--text] [--high-watermark BYTES]\n"
+                       "                   [--policy drop-oldest|coalesce|disconnect]\n"
+                       "                   [--flush immediate|per-tick]\n"
+                       "                   [--idle-timeout SECONDS] [--heartbeat SECONDS]  (0 disables)\n"
+                       "                   [--backend libuv|io_uring]\n"
+                       "                   [--history-dir DIR] [--history N] [--segment-mb N]\n"
+                       "                   [--retain-mb N] [--retain-hours N]  (0 keeps all)\n"
+                       "                   [--search]  (indexes the history)\n"
+                       "                   [--max-rooms N]  (default 1024)\n"
+                       "                   [--node-id N --cluster-port N [--peer ID@HOST:PORT]...]\n"
+                       "                   [--log-rate N]  (chat lines logged per second; 0 logs all)\n"
+                       "                   [--metrics-port N]  (Prometheus /metrics and /trace over HTTP)\n"
+                       "                   [--trace-dir DIR]  (trace dumps on SIGUSR2 and on crash)\n"
+                       "                   [--hugepages MB [--mlock]]  (pools and slabs on pre-faulted 2 MiB pages)\n"
+                       "                   [--cpus LIST] [--numa-node N] [--realtime PRIORITY] [--busy-poll]\n"
+                       "                   (loop i runs on the i-th CPU of LIST, e.g. 2-5; --busy-poll spins)\n");
+            return 1;
+        }
+    }
+
+    // Before anything draws from the pools, so every chunk lands in the region
+    if (huge_page_mb) {
+        foundation::HugePageOptions huge_pages;
+        huge_pages.bytes = huge_page_mb << 20;
+        huge_pages.lock = lock_memory;
+        foundation::enable_huge_pages(huge_pages);
+    }
+
+    // Per-message lines are formatted off the loops
+    foundation::start_async_logger(log_options);
+    if (!trace_dir.empty()) {
+        foundation::install_trace_dumps({trace_dir, true, true});
+    }
+
+    network::TcpServerOptions options;
+    options.host = "0.0.0.0";
+    options.port = port;
+    options.reuse_port = loop_count > 1;  // Kernel shards connections across loops
+    options.framing = framing;
+    options.outbound = outbound;
+    options.flush_mode = flush_mode;
+    options.backend = backend;
+    options.idle_timeout_ms = idle_timeout_ms;
+    options.write_timeout_ms = idle_timeout_ms;  // A peer that stops reading is just as dead
+    options.write_latency = &latencies.write;
+    if (huge_page_mb) {
+        // Region memory is never handed back, so slabs are kept rather than freed
+        options.buffer_pool.upstream = foundation::huge_page_resource();
+        options.buffer_pool.max_idle_slabs = SIZE_MAX;
+    }
+    heartbeat_frame = network::encode_frame(framing, {});
+    if (!history_dir.empty()) {
+        history_options.framing = framing;
+        room_directory.enable_history(history_dir, history_options);
+        if (search) {
+            room_directory.enable_search({});
+        }
+    } else if (search) {
+        spdlog::warn("--search needs --history-dir; search disabled");
+    }
+    // Half the queue limit, so a replay never trips the slow-consumer policy by itself
+    history_replay_bytes = outbound.high_watermark / 2;
+
+    for (size_t i = 0; i < loop_count; ++i) {
+        auto worker = std::make_unique<ChatWorker>(i);
+        ChatWorker* w = worker.get();
+
+        w->server = std::make_unique<network::TcpServer>(w->loop.get(), options);
+        w->server->set_connect_handler([w](network::Connection& conn) { on_connect(*w, conn); });
+        w->server->set_data_handler(on_data);
+        w->server->set_close_handler([w](network::Connection& conn) { on_close(*w, conn); });
+
+        w->mailbox = std::make_unique<network::AsyncQueue<RemoteMessage>>(
+            w->loop.get(), [w](std::unique_ptr<RemoteMessage> msg) {
+                FTRACE_ZONE("mailbox");
+                latencies.mailbox.record(foundation::TscClock::to_ns(foundation::TscClock::ticks() - msg->posted_ticks));
+                chat_metrics.mailbox_depth.add(-1);
+                deliver_local(*w, nullptr, msg->room, msg->payload, msg->coalesce_key);
+            });
+
+        int r = w->server->listen();
+        if (r) {
+            spdlog::error("Listen error: {}", uv_strerror(r));
+            return 1;
+        }
+        network::spawn(sample_queues(*w));
+        if (!place_loops) {
+            w->loop.post([i] { foundation::set_trace_thread_name(fmt::format("loop-{}", i)); });
+        }
+        workers.push_back(std::move(worker));
+    }
+
+    // Its history opens on the threadpool while the loops start
+    lobby = room_directory.intern("lobby", workers[0]->loop.get());
+
+    if (node_id >= 0) {
+        // Peer messages arrive on worker 0 and fan out like a local publish without a sender
+        cluster = std::make_unique<Cluster>(
+            workers[0]->loop.get(), static_cast<uint32_t>(node_id), room_directory,
+            [](Room* room, std::string_view text) {
+                fan_out(*workers[0], nullptr, room, network::encode_frame(framing, text), 0);
+            });
+        for (auto& worker : workers) {
+            worker->rooms.on_interest_change = [](Room* room) { cluster->interest_changed(room); };
+        }
+        if (cluster_port) {
+            if (int r = cluster->listen("0.0.0.0", cluster_port); r != 0) {
+                spdlog::error("Cluster listen error: {}", uv_strerror(r));
+                return 1;
+            }
+        }
+        for (const auto& peer : peers) {
+            cluster->add_peer(peer);
+        }
+        spdlog::info("Cluster node {} with {} peer(s), peer port {}", node_id, peers.size(), cluster_port);
+    }
+
+    if (metrics_port) {
+        // Scrapes are rare and rendering is quick, so loop 0 serves them
+        metrics_listener = std::make_unique<network::HttpListener>(workers[0]->loop.get(), serve_metrics);
+        if (int r = metrics_listener->listen("0.0.0.0", metrics_port); r != 0) {
+            spdlog::error("Metrics listen error: {}", uv_strerror(r));
+            return 1;
+        }
+        spdlog::info("Serving Prometheus metrics on http://0.0.0.0:{}/metrics and a trace on /trace", metrics_port);
+    }
+
+    spdlog::info("Chat server listening on port {} with {} loop(s)", port, loop_count);
+    fmt::print("Chat Server is running on port {}\n", port);
     fmt::print("Clients can connect using: ./run.sh chat_client\n");
-    
-    return uv_run(loop, UV_RUN_DEFAULT);
+
+    if (!history_dir.empty() && history_options.retain_ms) {
+        network::spawn(enforce_retention());
+    }
+
+    // Worker 0 runs on the main thread
+    auto placement = [&runner](size_t i) {
+        foundation::ThreadRunnerOptions options = runner;
+        options.name = fmt::format("loop-{}", i);
+        if (!runner.cpus.empty()) {
+            options.cpus = {runner.cpus[i % runner.cpus.size()]};   // One isolated core per loop
+        }
+        return options;
+    };
+    for (size_t i = 1; i < workers.size(); ++i) {
+        if (place_loops) {
+            workers[i]->loop.start(placement(i));
+        } else {
+            workers[i]->loop.start();
+        }
+    }
+    const int result = place_loops ? workers[0]->loop.run(placement(0)) : workers[0]->loop.run();
+    latencies.for_each([](const char* stage, const foundation::LatencyRecorder& recorder) {
+        spdlog::info("Latency {}: {}", stage, foundation::format_latency(recorder.snapshot().summary()));
+    });
+    foundation::stop_async_logger();
+    return result;
 }
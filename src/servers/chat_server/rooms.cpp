@@ -0,0 +1,248 @@
+#include "rooms.h"
+#include <foundation/clock.h>
+#include <spdlog/spdlog.h>
+#include <uv.h>
+#include <algorithm>
+#include <filesystem>
+
+void RoomDirectory::enable_history(std::string directory, network::MessageLogOptions options) {
+    std::lock_guard lock(mutex_);
+    history_directory_ = std::move(directory);
+    history_options_ = options;
+}
+
+void RoomDirectory::enable_search(network::SearchIndexOptions options) {
+    std::lock_guard lock(mutex_);
+    search_ = true;
+    search_options_ = options;
+}
+
+namespace {
+    struct OpenHistoryWork {
+        uv_work_t req;
+        Room* room;
+        std::unique_ptr<network::MessageLog> log;
+        network::FrameMode framing;
+        int status = 0;
+    };
+
+    // Index the records in `views`, the first being document `seq`
+    void index_records(const std::vector<network::SharedPayload>& views, uint64_t seq, network::SearchIndex& index,
+                       network::FrameMode framing, bool compact) {
+        for (const auto& view : views) {
+            network::FrameDecoder decoder(framing, view.size());
+            decoder.decode(std::span<const char>(view.data(), view.size()), [&](std::string_view body) {
+                index.add(seq++, body);
+                // Merge as segments seal, so a long backfill never holds them all unencoded
+                if (compact && index.needs_compaction()) {
+                    index.compact();
+                }
+            });
+        }
+    }
+
+    struct IndexHistoryWork {
+        uv_work_t req;
+        Room* room;
+        network::FrameMode framing;
+        std::vector<network::SharedPayload> views;     // Of the log as it was published
+        uint64_t first_seq;
+        uint64_t end_seq;
+    };
+
+    // The backfill runs on the threadpool; the room's search turns on once
+    // the messages appended meanwhile are indexed too, from the loop
+    void index_history(Room* room, uv_loop_t* loop, network::FrameMode framing) {
+        auto* work = new IndexHistoryWork{};
+        work->req.data = work;
+        work->room = room;
+        work->framing = framing;
+        {
+            std::lock_guard lock(room->history_mutex);
+            work->first_seq = room->history->first_seq();
+            work->end_seq = room->history->next_seq();
+            room->history->read(work->first_seq, SIZE_MAX, work->views);
+        }
+        uv_queue_work(
+            loop, &work->req,
+            [](uv_work_t* req) {
+                auto* work = static_cast<IndexHistoryWork*>(req->data);
+                foundation::Stopwatch stopwatch;
+                index_records(work->views, work->first_seq, *work->room->search, work->framing, true);
+                spdlog::info("Search index for #{}: {} messages in {:.1f} ms", work->room->name,
+                             work->end_seq - work->first_seq, static_cast<double>(stopwatch.elapsed_ns()) / 1e6);
+                work->views.clear();
+            },
+            [](uv_work_t* req, int) {
+                std::unique_ptr<IndexHistoryWork> work(static_cast<IndexHistoryWork*>(req->data));
+                Room* room = work->room;
+                std::lock_guard lock(room->history_mutex);
+                std::vector<network::SharedPayload> tail;
+                if (room->history->next_seq() > work->end_seq) {
+                    room->history->read(work->end_seq, SIZE_MAX, tail);
+                }
+                index_records(tail, work->end_seq, *room->search, work->framing, false);
+                room->search_ready.store(true, std::memory_order_release);
+            });
+    }
+}
+
+bool RoomDirectory::valid_name(std::string_view name) {
+    return !name.empty() && name.size() <= MAX_NAME &&
+           std::all_of(name.begin(), name.end(), [](char c) {
+               return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') ||
+                      c == '_' || c == '-';
+           });
+}
+
+void RoomDirectory::set_max_rooms(size_t max) {
+    std::lock_guard lock(mutex_);
+    max_rooms_ = std::max<size_t>(max, 1);
+}
+
+Room* RoomDirectory::intern(std::string_view name, uv_loop_t* loop) {
+    if (!valid_name(name)) {
+        return nullptr;
+    }
+
+    Room* created;
+    {
+        std::lock_guard lock(mutex_);
+        const std::string key(name);
+        if (auto it = rooms_.find(key); it != rooms_.end()) {
+            return it->second.get();
+        }
+        if (rooms_.size() >= max_rooms_) {
+            return nullptr;
+        }
+        auto& room = rooms_[key];
+        room = std::make_unique<Room>();
+        room->id = static_cast<uint32_t>(rooms_.size() - 1);
+        room->name = std::string(name);
+        room->history_enabled = !history_directory_.empty();
+        if (room->history_enabled && search_) {
+            room->search = std::make_unique<network::SearchIndex>(search_options_);
+        }
+        created = room.get();
+    }
+    if (created->history_enabled) {
+        open_history(created, loop);
+    }
+    return created;
+}
+
+// Recovering a log reads all of it, so it never runs on a loop or under the directory mutex
+void RoomDirectory::open_history(Room* room, uv_loop_t* loop) {
+    auto* work = new OpenHistoryWork{};
+    work->req.data = work;
+    work->room = room;
+    work->log = std::make_unique<network::MessageLog>(
+        (std::filesystem::path(history_directory_) / room->name).string(), history_options_);
+    work->framing = history_options_.framing;
+    uv_queue_work(
+        loop, &work->req,
+        [](uv_work_t* req) {
+            auto* work = static_cast<OpenHistoryWork*>(req->data);
+            Room* room = work->room;
+            work->status = work->log->open();
+            if (work->status != 0) {
+                spdlog::error("History for #{} unavailable: {}", room->name, uv_strerror(work->status));
+                return;
+            }
+            spdlog::info("History for #{}: {} messages recovered", room->name, work->log->size());
+        },
+        [](uv_work_t* req, int) {
+            std::unique_ptr<OpenHistoryWork> work(static_cast<OpenHistoryWork*>(req->data));
+            Room* room = work->room;
+            std::vector<std::function<void()>> waiters;
+            {
+                std::lock_guard lock(room->history_mutex);
+                if (work->status == 0) {
+                    room->history = std::move(work->log);
+                    for (const auto& msg : room->pending_history) {
+                        room->history->append(msg.view());
+                    }
+                }
+                room->pending_history.clear();
+                room->history_ready.store(true, std::memory_order_release);
+                waiters.swap(room->history_waiters);
+            }
+            for (const auto& waiter : waiters) {
+                waiter();
+            }
+            if (room->history && room->search) {
+                index_history(room, req->loop, work->framing);
+            }
+        });
+}
+
+void RoomDirectory::for_each(const std::function<void(Room&)>& fn) {
+    std::lock_guard lock(mutex_);
+    for (auto& [name, room] : rooms_) {
+        fn(*room);
+    }
+}
+
+size_t RoomDirectory::size() const {
+    std::lock_guard lock(mutex_);
+    return rooms_.size();
+}
+
+bool RoomSubscriber::in_room(const Room* room) const {
+    return std::any_of(memberships.begin(), memberships.end(),
+                       [room](const Membership& m) { return m.room == room; });
+}
+
+bool RoomIndex::join(RoomSubscriber* subscriber, Room* room) {
+    if (subscriber->in_room(room)) {
+        return false;
+    }
+    if (room->id >= members_.size()) {
+        members_.resize(room->id + 1);
+    }
+    auto& members = members_[room->id];
+    if (members.empty() && room->worker_mask.fetch_or(worker_bit_, std::memory_order_relaxed) == 0 &&
+        on_interest_change) {
+        on_interest_change(room);
+    }
+    subscriber->memberships.push_back({room, static_cast<uint32_t>(members.size())});
+    members.push_back(subscriber);
+    return true;
+}
+
+bool RoomIndex::leave(RoomSubscriber* subscriber, Room* room) {
+    auto& memberships = subscriber->memberships;
+    auto it = std::find_if(memberships.begin(), memberships.end(),
+                           [room](const RoomSubscriber::Membership& m) { return m.room == room; });
+    if (it == memberships.end()) {
+        return false;
+    }
+    const uint32_t slot = it->slot;
+    *it = memberships.back();
+    memberships.pop_back();
+
+    auto& members = members_[room->id];
+    RoomSubscriber* moved = members.back();
+    members[slot] = moved;
+    members.pop_back();
+    if (moved != subscriber) {
+        for (auto& m : moved->memberships) {
+            if (m.room == room) {
+                m.slot = slot;
+                break;
+            }
+        }
+    }
+    if (members.empty() && room->worker_mask.fetch_and(~worker_bit_, std::memory_order_relaxed) == worker_bit_ &&
+        on_interest_change) {
+        on_interest_change(room);
+    }
+    return true;
+}
+
+std::span<RoomSubscriber* const> RoomIndex::members(const Room* room) const {
+    if (room->id >= members_.size()) {
+        return {};
+    }
+    return members_[room->id];
+}
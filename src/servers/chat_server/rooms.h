@@ -0,0 +1,164 @@
+#pragma once
+#include <network/message_log.h>
+#include <network/search_index.h>
+#include <network/shared_payload.h>
+#include <uv.h>
+#include <atomic>
+#include <functional>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief A named room, shared by every worker loop.
+ *
+ * Rooms are interned once and never freed, so a Room* stays valid for the
+ * life of the server and may be handed between loops.
+ */
+struct Room {
+    static constexpr size_t MAX_WORKERS = 64;
+
+    uint32_t id;
+    std::string name;
+
+    // Bit i is set while worker i has at least one local subscriber, so a
+    // publish is forwarded only to loops that will deliver it
+    std::atomic<uint64_t> worker_mask{0};
+
+    // Bit n is set while cluster node n has subscribers; see Cluster
+    std::atomic<uint64_t> node_mask{0};
+
+    // Fixed at creation; the log itself is opened off-loop, see RoomDirectory::intern()
+    bool history_enabled = false;
+
+    // Every loop appends and replays under the mutex. Until `history_ready`,
+    // messages wait in `pending_history` and replays in `history_waiters`;
+    // `history` stays null if the log could not be opened
+    std::mutex history_mutex;
+    std::atomic<bool> history_ready{false};
+    std::unique_ptr<network::MessageLog> history;
+    std::vector<network::SharedPayload> pending_history;
+    std::vector<std::function<void()>> history_waiters;
+
+    // Over the history, by sequence number; null unless search is enabled
+    // too. Built on the threadpool once the log is open; appended to and
+    // searched only once `search_ready`
+    std::unique_ptr<network::SearchIndex> search;
+    std::atomic<bool> search_ready{false};
+    std::atomic<bool> compaction_queued{false};
+};
+
+/**
+ * @brief Thread-safe name -> Room interning.
+ */
+class RoomDirectory {
+public:
+    static constexpr size_t MAX_NAME = 32;
+    static constexpr size_t DEFAULT_MAX_ROOMS = 1024;
+
+    /**
+     * @brief Whether `name` is 1-MAX_NAME characters of [A-Za-z0-9_-].
+     */
+    static bool valid_name(std::string_view name);
+
+    /**
+     * @brief Rooms are never freed, and each may hold a mapped log, so
+     *        creation stops at `max` rooms (at least 1).
+     */
+    void set_max_rooms(size_t max);
+
+    /**
+     * @brief Give every room created from now on a MessageLog in
+     *        `directory`/<room name>. Call before the first intern().
+     */
+    void enable_history(std::string directory, network::MessageLogOptions options);
+
+    /**
+     * @brief Also index each room's history for search; existing history
+     *        is indexed on the threadpool once the room's log is open. Call
+     *        before the first intern().
+     */
+    void enable_search(network::SearchIndexOptions options);
+
+    /**
+     * @brief Room called `name`, created on first use.
+     *
+     * A new room with history is returned at once: its log is opened and
+     * recovered on the libuv threadpool, queued from `loop`, which must be
+     * the calling thread's loop. The room is published to history users
+     * (Room::history_ready) from that loop once the log is open, and to
+     * search (Room::search_ready) once the history is indexed.
+     * @return nullptr if `name` is not valid_name() or the room would be
+     *         one more than the limit.
+     */
+    Room* intern(std::string_view name, uv_loop_t* loop);
+
+    void for_each(const std::function<void(Room&)>& fn);
+
+    size_t size() const;
+
+private:
+    void open_history(Room* room, uv_loop_t* loop);
+
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, std::unique_ptr<Room>> rooms_;
+    size_t max_rooms_ = DEFAULT_MAX_ROOMS;
+    std::string history_directory_;
+    network::MessageLogOptions history_options_;
+    bool search_ = false;
+    network::SearchIndexOptions search_options_;
+};
+
+/**
+ * @brief Base for anything that subscribes to rooms through a RoomIndex.
+ */
+struct RoomSubscriber {
+    struct Membership {
+        Room* room;
+        uint32_t slot;      // Position in the room's member vector
+    };
+    std::vector<Membership> memberships;
+
+    bool in_room(const Room* room) const;
+};
+
+/**
+ * @brief One worker's subscribers per room.
+ *
+ * Each room keeps its local members in a dense vector, so a publish walks
+ * exactly that room's subscribers. Every subscriber records its slot in
+ * each room it joined, which makes join and leave O(1) in the room size
+ * (leave moves the last member into the freed slot). Loop thread only.
+ */
+class RoomIndex {
+public:
+    explicit RoomIndex(size_t worker_index) : worker_bit_(uint64_t(1) << worker_index) {}
+
+    /**
+     * @return false if `subscriber` was already in `room`.
+     */
+    bool join(RoomSubscriber* subscriber, Room* room);
+
+    /**
+     * @return false if `subscriber` was not in `room`.
+     */
+    bool leave(RoomSubscriber* subscriber, Room* room);
+
+    std::span<RoomSubscriber* const> members(const Room* room) const;
+
+    /**
+     * @brief Called when a room gains its first subscriber on any loop or
+     *        loses its last one, from the loop where that happened.
+     */
+    std::function<void(Room*)> on_interest_change;
+
+private:
+    uint64_t worker_bit_;
+    std::vector<std::vector<RoomSubscriber*>> members_;     // Indexed by Room::id
+};
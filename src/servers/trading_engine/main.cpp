@@ -1,8 +1,47 @@
+#include <foundation/huge_pages.h>
+#include <foundation/thread_runner.h>
 #include <spdlog/spdlog.h>
 #include <fmt/core.h>
+#include <cstdlib>
+#include <cstring>
 
-int main() {
+int main(int argc, char** argv) {
     spdlog::info("Starting Trading Engine...");
+
+    size_t huge_page_mb = 0;
+    bool lock_memory = false;
+    foundation::ThreadRunnerOptions engine_thread;
+    engine_thread.name = "engine";
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--hugepages") == 0 && i + 1 < argc) {
+            huge_page_mb = std::strtoull(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--mlock") == 0) {
+            lock_memory = true;
+        } else if (std::strcmp(argv[i], "--cpus") == 0 && i + 1 < argc) {
+            engine_thread.cpus = foundation::parse_cpu_list(argv[++i]);
+        } else if (std::strcmp(argv[i], "--numa-node") == 0 && i + 1 < argc) {
+            engine_thread.numa_node = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--realtime") == 0 && i + 1 < argc) {
+            engine_thread.realtime_priority = std::atoi(argv[++i]);
+        } else {
+            fmt::print("Usage: trading_engine [--hugepages MB [--mlock]]  (pools on pre-faulted 2 MiB pages)\n"
+                       "                      [--cpus LIST] [--numa-node N] [--realtime PRIORITY]\n"
+                       "                      (engine thread placement, e.g. --cpus 3 --realtime 80)\n");
+            return 1;
+        }
+    }
+
+    // Before anything is allocated, so --numa-node also steers the region's pages
+    foundation::place_current_thread(engine_thread);
+
+    // Before any pool is used, so every pool chunk comes from the region
+    if (huge_page_mb) {
+        foundation::HugePageOptions huge_pages;
+        huge_pages.bytes = huge_page_mb << 20;
+        huge_pages.lock = lock_memory;
+        foundation::enable_huge_pages(huge_pages);
+    }
+
     fmt::print("Trading Engine initialized.\n");
     return 0;
 }
@@ -0,0 +1,156 @@
+#include <benchmark/benchmark.h>
+#include <foundation/arena.h>
+#include <foundation/huge_pages.h>
+#include <foundation/object_pool.h>
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+    // The size of a small per-event object: a mailbox node, a queued message
+    struct Event {
+        void* next = nullptr;
+        uint64_t key = 0;
+        char payload[48] = {};
+    };
+
+    struct PooledEvent : Event, foundation::PoolAllocated<PooledEvent> {};
+
+    constexpr int BATCH = 64;
+}
+
+// A frame's worth of scratch: 64 small allocations, then all freed at once
+static void BM_ScratchNewDelete(benchmark::State& state) {
+    std::vector<Event*> events(BATCH);
+    for (auto _ : state) {
+        for (auto& e : events) {
+            e = new Event;
+            benchmark::DoNotOptimize(e);
+        }
+        for (auto* e : events) {
+            delete e;
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * BATCH);
+}
+BENCHMARK(BM_ScratchNewDelete);
+
+static void BM_ScratchArena(benchmark::State& state) {
+    foundation::Arena arena;
+    for (auto _ : state) {
+        for (int i = 0; i < BATCH; ++i) {
+            benchmark::DoNotOptimize(arena.create<Event>());
+        }
+        arena.reset();
+    }
+    state.SetItemsProcessed(state.iterations() * BATCH);
+}
+BENCHMARK(BM_ScratchArena);
+
+// Objects with independent lifetimes, freed in a different order
+static void BM_ObjectsMakeUnique(benchmark::State& state) {
+    std::vector<std::unique_ptr<Event>> events(BATCH);
+    for (auto _ : state) {
+        for (auto& e : events) {
+            e = std::make_unique<Event>();
+        }
+        for (int i = 0; i < BATCH; i += 2) {
+            events[i].reset();
+        }
+        for (int i = 1; i < BATCH; i += 2) {
+            events[i].reset();
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * BATCH);
+}
+BENCHMARK(BM_ObjectsMakeUnique);
+
+static void BM_ObjectsPooled(benchmark::State& state) {
+    std::vector<std::unique_ptr<PooledEvent>> events(BATCH);
+    for (auto _ : state) {
+        for (auto& e : events) {
+            e = std::make_unique<PooledEvent>();
+        }
+        for (int i = 0; i < BATCH; i += 2) {
+            events[i].reset();
+        }
+        for (int i = 1; i < BATCH; i += 2) {
+            events[i].reset();
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * BATCH);
+}
+BENCHMARK(BM_ObjectsPooled);
+
+// Allocated on one thread, freed on another, as chat_server's cross-loop
+// mailbox messages are
+static void BM_CrossThreadFree(benchmark::State& state) {
+    const bool pooled = state.range(0);
+    constexpr int COUNT = 4096;
+    std::vector<Event*> events(COUNT);
+    for (auto _ : state) {
+        for (auto& e : events) {
+            e = pooled ? new PooledEvent : new Event;
+        }
+        std::thread([&] {
+            for (auto* e : events) {
+                if (pooled) {
+                    delete static_cast<PooledEvent*>(e);
+                } else {
+                    delete e;
+                }
+            }
+        }).join();
+    }
+    state.SetItemsProcessed(state.iterations() * COUNT);
+}
+BENCHMARK(BM_CrossThreadFree)->Arg(0)->Arg(1);
+
+// Building a container of short strings, as Portfolio's history does
+static void BM_PmrStrings(benchmark::State& state) {
+    const int source = static_cast<int>(state.range(0));
+    for (auto _ : state) {
+        foundation::Arena arena;
+        std::pmr::memory_resource* resource = source == 0   ? std::pmr::new_delete_resource()
+                                              : source == 1 ? foundation::pool_resource()
+                                                            : &arena;
+        std::pmr::vector<std::pmr::string> lines(resource);
+        for (int i = 0; i < 256; ++i) {
+            lines.emplace_back("BUY AAPL x100 @ $123.45 and some more text");
+        }
+        benchmark::DoNotOptimize(lines.data());
+    }
+    state.SetItemsProcessed(state.iterations() * 256);
+    state.SetLabel(source == 0 ? "new_delete" : source == 1 ? "pool_resource" : "arena");
+}
+BENCHMARK(BM_PmrStrings)->Arg(0)->Arg(1)->Arg(2);
+
+// A 2 MiB slab written for the first time. A fresh mapping pays the page
+// faults (and zeroing) on first touch (arg 0); slabs of a pre-faulted
+// region paid them at startup (arg 1)
+static void BM_FirstTouchSlab(benchmark::State& state) {
+    constexpr size_t SLAB = foundation::HugePageRegion::HUGE_PAGE_SIZE;
+    foundation::HugePageRegion prefaulted({.bytes = 64 * SLAB});
+    char* slabs = static_cast<char*>(prefaulted.allocate(64 * SLAB, 64));
+    size_t next = 0;
+    for (auto _ : state) {
+        if (state.range(0) == 0) {
+            foundation::HugePageRegion fresh({.bytes = SLAB, .prefault = false});
+            char* slab = static_cast<char*>(fresh.allocate(SLAB, 64));
+            for (size_t i = 0; i < SLAB; i += 4096) {
+                slab[i] = 1;
+            }
+            benchmark::ClobberMemory();
+        } else {
+            char* slab = slabs + (next++ % 64) * SLAB;
+            for (size_t i = 0; i < SLAB; i += 4096) {
+                slab[i] = 1;
+            }
+            benchmark::ClobberMemory();
+        }
+    }
+    state.SetBytesProcessed(state.iterations() * SLAB);
+}
+BENCHMARK(BM_FirstTouchSlab)->Arg(0)->Arg(1);
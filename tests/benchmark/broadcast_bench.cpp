@@ -0,0 +1,45 @@
+#include <benchmark/benchmark.h>
+#include <network/shared_payload.h>
+#include <network/write_request_pool.h>
+#include <string>
+#include <vector>
+
+static const std::string MESSAGE(120, 'm');
+
+// Old fan-out: every recipient's write owns a private copy of the message
+static void BM_BroadcastCopyPerRecipient(benchmark::State& state) {
+    const auto recipients = static_cast<size_t>(state.range(0));
+    std::vector<std::string> pending(recipients);
+    for (auto _ : state) {
+        for (auto& slot : pending) {
+            slot = MESSAGE;
+        }
+        benchmark::DoNotOptimize(pending.data());
+        for (auto& slot : pending) {
+            std::string().swap(slot);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * recipients);
+}
+BENCHMARK(BM_BroadcastCopyPerRecipient)->Arg(10000);
+
+// New fan-out: one shared payload, one pooled request per recipient
+static void BM_BroadcastSharedPayload(benchmark::State& state) {
+    const auto recipients = static_cast<size_t>(state.range(0));
+    network::WriteRequestPool pool;
+    std::vector<network::WriteRequest*> pending(recipients);
+    for (auto _ : state) {
+        network::SharedPayload payload = network::SharedPayload::copy_of(MESSAGE);
+        for (auto& slot : pending) {
+            slot = pool.acquire();
+            slot->payloads[0] = payload;
+            slot->payload_count = 1;
+        }
+        benchmark::DoNotOptimize(pending.data());
+        for (auto* slot : pending) {
+            pool.release(slot);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * recipients);
+}
+BENCHMARK(BM_BroadcastSharedPayload)->Arg(10000);
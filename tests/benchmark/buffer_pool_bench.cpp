@@ -0,0 +1,31 @@
+#include <benchmark/benchmark.h>
+#include <network/buffer_pool.h>
+
+// One read buffer per message, as the chat server did before BufferPool
+static void BM_ReadBufferNewDelete(benchmark::State& state) {
+    const size_t size = static_cast<size_t>(state.range(0));
+    for (auto _ : state) {
+        char* buf = new char[size];
+        benchmark::DoNotOptimize(buf);
+        delete[] buf;
+    }
+    state.counters["allocs_per_msg"] = 1;
+}
+BENCHMARK(BM_ReadBufferNewDelete)->Arg(64 * 1024);
+
+static void BM_ReadBufferPooled(benchmark::State& state) {
+    const size_t size = static_cast<size_t>(state.range(0));
+    network::BufferPool pool;
+    pool.release(pool.acquire(size));  // Warm up one slab
+
+    const uint64_t before = pool.stats().upstream_allocations;
+    for (auto _ : state) {
+        char* buf = pool.acquire(size);
+        benchmark::DoNotOptimize(buf);
+        pool.release(buf);
+    }
+    const uint64_t allocs = pool.stats().upstream_allocations - before;
+    state.counters["allocs_per_msg"] =
+        static_cast<double>(allocs) / static_cast<double>(state.iterations());
+}
+BENCHMARK(BM_ReadBufferPooled)->Arg(64 * 1024);
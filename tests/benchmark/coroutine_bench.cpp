@@ -0,0 +1,251 @@
+#include <benchmark/benchmark.h>
+#include <network/async_io.h>
+#include <network/task.h>
+#include <uv.h>
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+    // Raw libuv clients on the same loop as the echo server under test
+    class EchoClients {
+    public:
+        EchoClients(uv_loop_t* loop, int port, int clients) : loop_(loop) {
+            sockaddr_in addr{};
+            uv_ip4_addr("127.0.0.1", port, &addr);
+            clients_.resize(clients);
+            for (auto& client : clients_) {
+                client = std::make_unique<Client>();
+                client->owner = this;
+                uv_tcp_init(loop_, &client->handle);
+                client->handle.data = client.get();
+                uv_tcp_connect(&client->connect, &client->handle, reinterpret_cast<const sockaddr*>(&addr),
+                               [](uv_connect_t* req, int status) {
+                                   auto* client = static_cast<Client*>(req->handle->data);
+                                   if (status == 0) {
+                                       client->owner->connected_++;
+                                       uv_read_start(req->handle, on_alloc, on_read);
+                                   }
+                               });
+            }
+            while (connected_ < clients_.size()) {
+                uv_run(loop_, UV_RUN_NOWAIT);
+            }
+        }
+
+        void close() {
+            for (auto& client : clients_) {
+                uv_close(reinterpret_cast<uv_handle_t*>(&client->handle), nullptr);
+            }
+        }
+
+        // Every client sends `burst` copies of `message`; spin until all echoes are back
+        void round(const std::string& message, int burst) {
+            uv_buf_t bufs[64];
+            const int count = std::min<int>(burst, 64);
+            for (int i = 0; i < count; ++i) {
+                bufs[i] = uv_buf_init(const_cast<char*>(message.data()), static_cast<unsigned int>(message.size()));
+            }
+            for (auto& client : clients_) {
+                uv_try_write(reinterpret_cast<uv_stream_t*>(&client->handle), bufs, count);
+            }
+            const size_t expected = clients_.size() * count * message.size();
+            while (received_ < expected) {
+                uv_run(loop_, UV_RUN_ONCE);
+            }
+            received_ = 0;
+        }
+
+    private:
+        struct Client {
+            EchoClients* owner;
+            uv_tcp_t handle;
+            uv_connect_t connect;
+        };
+
+        static void on_alloc(uv_handle_t*, size_t, uv_buf_t* buf) {
+            static char scratch[64 * 1024];
+            *buf = uv_buf_init(scratch, sizeof(scratch));
+        }
+
+        static void on_read(uv_stream_t* stream, ssize_t nread, const uv_buf_t*) {
+            if (nread > 0) {
+                static_cast<Client*>(stream->data)->owner->received_ += static_cast<size_t>(nread);
+            }
+        }
+
+        uv_loop_t* loop_;
+        std::vector<std::unique_ptr<Client>> clients_;
+        size_t connected_ = 0;
+        size_t received_ = 0;
+    };
+
+    // The callback baseline: echo what arrives, pausing reads while a write
+    // the socket could not take at once is in flight
+    class CallbackEchoServer {
+    public:
+        explicit CallbackEchoServer(uv_loop_t* loop) : loop_(loop) {
+            uv_tcp_init(loop_, &listener_);
+            listener_.data = this;
+            sockaddr_in addr{};
+            uv_ip4_addr("127.0.0.1", 0, &addr);
+            uv_tcp_bind(&listener_, reinterpret_cast<const sockaddr*>(&addr), 0);
+            uv_listen(reinterpret_cast<uv_stream_t*>(&listener_), 128, [](uv_stream_t* server, int) {
+                auto* self = static_cast<CallbackEchoServer*>(server->data);
+                auto& conn = self->conns_.emplace_back(std::make_unique<Conn>());
+                uv_tcp_init(self->loop_, &conn->handle);
+                conn->handle.data = conn.get();
+                uv_accept(server, reinterpret_cast<uv_stream_t*>(&conn->handle));
+                start(conn.get());
+            });
+        }
+
+        int port() const {
+            sockaddr_in addr{};
+            int len = sizeof(addr);
+            uv_tcp_getsockname(&listener_, reinterpret_cast<sockaddr*>(&addr), &len);
+            return ntohs(addr.sin_port);
+        }
+
+        void close() {
+            uv_close(reinterpret_cast<uv_handle_t*>(&listener_), nullptr);
+            for (auto& conn : conns_) {
+                uv_close(reinterpret_cast<uv_handle_t*>(&conn->handle), nullptr);
+            }
+        }
+
+    private:
+        struct Conn {
+            uv_tcp_t handle;
+            uv_write_t write;
+            char buffer[64 * 1024];
+        };
+
+        static void start(Conn* conn) {
+            uv_read_start(
+                reinterpret_cast<uv_stream_t*>(&conn->handle),
+                [](uv_handle_t* handle, size_t, uv_buf_t* buf) {
+                    auto* conn = static_cast<Conn*>(handle->data);
+                    *buf = uv_buf_init(conn->buffer, sizeof(conn->buffer));
+                },
+                [](uv_stream_t* stream, ssize_t nread, const uv_buf_t* buf) {
+                    if (nread <= 0) {
+                        return;
+                    }
+                    uv_buf_t out = uv_buf_init(buf->base, static_cast<unsigned int>(nread));
+                    const int written = uv_try_write(stream, &out, 1);
+                    if (written == nread) {
+                        return;
+                    }
+                    const size_t sent = written > 0 ? static_cast<size_t>(written) : 0;
+                    out = uv_buf_init(buf->base + sent, static_cast<unsigned int>(nread - sent));
+                    uv_read_stop(stream);
+                    uv_write(&static_cast<Conn*>(stream->data)->write, stream, &out, 1, [](uv_write_t* req, int) {
+                        start(static_cast<Conn*>(req->handle->data));
+                    });
+                });
+        }
+
+        uv_loop_t* loop_;
+        uv_tcp_t listener_;
+        std::vector<std::unique_ptr<Conn>> conns_;
+    };
+
+    // The same echo as straight-line coroutines
+    class CoroutineEchoServer {
+    public:
+        explicit CoroutineEchoServer(uv_loop_t* loop) : loop_(loop), listener_(loop) {
+            listener_.listen("127.0.0.1", 0);
+            network::spawn(accept_all());
+        }
+
+        int port() const { return listener_.bound_port(); }
+
+        void close() {
+            listener_.close();
+            for (auto& conn : conns_) {
+                conn->close();
+            }
+        }
+
+    private:
+        network::Task<void> accept_all() {
+            for (;;) {
+                auto& conn = conns_.emplace_back(std::make_unique<network::AsyncTcp>(loop_));
+                if (co_await listener_.accept(*conn) != 0) {
+                    co_return;
+                }
+                network::spawn(echo(*conn));
+            }
+        }
+
+        static network::Task<void> echo(network::AsyncTcp& conn) {
+            for (;;) {
+                if (co_await conn.read() != 0) {
+                    co_return;
+                }
+                std::span<const char> data = conn.buffered();
+                if (co_await conn.write(data) != 0) {
+                    co_return;
+                }
+                conn.consume(data.size());
+            }
+        }
+
+        uv_loop_t* loop_;
+        network::AsyncTcp listener_;
+        std::vector<std::unique_ptr<network::AsyncTcp>> conns_;
+    };
+
+    template <typename Server>
+    void run_echo(benchmark::State& state) {
+        const int clients = static_cast<int>(state.range(0));
+        const int burst = static_cast<int>(state.range(1));
+        uv_loop_t loop;
+        uv_loop_init(&loop);
+        {
+            Server server(&loop);
+            EchoClients echo_clients(&loop, server.port(), clients);
+            const std::string message(64, 'e');
+            for (auto _ : state) {
+                echo_clients.round(message, burst);
+            }
+            state.SetItemsProcessed(state.iterations() * clients * burst);
+            echo_clients.close();
+            server.close();
+            uv_run(&loop, UV_RUN_DEFAULT);
+        }
+        uv_loop_close(&loop);
+    }
+
+    network::Task<int> identity(int value) {
+        co_return value;
+    }
+
+}
+
+static void BM_EchoCallbacks(benchmark::State& state) {
+    run_echo<CallbackEchoServer>(state);
+}
+BENCHMARK(BM_EchoCallbacks)->Args({64, 8})->UseRealTime();
+
+static void BM_EchoCoroutines(benchmark::State& state) {
+    run_echo<CoroutineEchoServer>(state);
+}
+BENCHMARK(BM_EchoCoroutines)->Args({64, 8})->UseRealTime();
+
+// Create, start and finish one Task: a pooled frame allocation and two
+// symmetric transfers
+static void BM_TaskAwait(benchmark::State& state) {
+    int64_t total = 0;
+    auto loop = [&]() -> network::Task<void> {
+        for (auto _ : state) {
+            total += co_await identity(1);
+        }
+    };
+    network::spawn(loop());
+    benchmark::DoNotOptimize(total);
+}
+BENCHMARK(BM_TaskAwait);
@@ -0,0 +1,115 @@
+#include <benchmark/benchmark.h>
+#include <foundation/flat_hash_map.h>
+#include <foundation/symbol_table.h>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+    struct Quote {
+        double bid;
+        double ask;
+    };
+
+    std::vector<std::string> tickers(size_t count) {
+        std::vector<std::string> names;
+        std::mt19937 rng(7);
+        for (size_t i = 0; i < count; ++i) {
+            std::string name;
+            for (int c = 0; c < 4; ++c) {
+                name.push_back(static_cast<char>('A' + rng() % 26));
+            }
+            names.push_back(name + std::to_string(i));
+        }
+        return names;
+    }
+
+    // The order lookups arrive in: random, so the table does not stay in cache
+    std::vector<uint32_t> lookup_order(size_t count) {
+        std::vector<uint32_t> order(1 << 16);
+        std::mt19937 rng(11);
+        for (auto& index : order) {
+            index = static_cast<uint32_t>(rng() % count);
+        }
+        return order;
+    }
+
+}
+
+// What stock_trader did: hash the ticker string, walk the node list
+static void BM_QuoteByStringUnorderedMap(benchmark::State& state) {
+    const auto names = tickers(state.range(0));
+    const auto order = lookup_order(names.size());
+    std::unordered_map<std::string, Quote> quotes;
+    for (const auto& name : names) {
+        quotes[name] = {1.0, 1.01};
+    }
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(quotes.find(names[order[i++ & 0xFFFF]])->second.bid);
+    }
+}
+BENCHMARK(BM_QuoteByStringUnorderedMap)->Arg(64)->Arg(100000);
+
+static void BM_QuoteByStringFlatMap(benchmark::State& state) {
+    const auto names = tickers(state.range(0));
+    const auto order = lookup_order(names.size());
+    foundation::FlatHashMap<std::string, Quote> quotes;
+    for (const auto& name : names) {
+        quotes[name] = {1.0, 1.01};
+    }
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(quotes.find(names[order[i++ & 0xFFFF]])->second.bid);
+    }
+}
+BENCHMARK(BM_QuoteByStringFlatMap)->Arg(64)->Arg(100000);
+
+static void BM_QuoteBySymbolUnorderedMap(benchmark::State& state) {
+    const auto order = lookup_order(state.range(0));
+    std::unordered_map<uint32_t, Quote> quotes;
+    for (uint32_t id = 0; id < state.range(0); ++id) {
+        quotes[id] = {1.0, 1.01};
+    }
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(quotes.find(order[i++ & 0xFFFF])->second.bid);
+    }
+}
+BENCHMARK(BM_QuoteBySymbolUnorderedMap)->Arg(64)->Arg(100000);
+
+// Interned once up front; the hot path hashes a 32-bit id
+static void BM_QuoteBySymbolFlatMap(benchmark::State& state) {
+    foundation::SymbolTable symbols;
+    std::vector<foundation::SymbolId> ids;
+    for (const auto& name : tickers(state.range(0))) {
+        ids.push_back(symbols.intern(name));
+    }
+    const auto order = lookup_order(ids.size());
+    foundation::FlatHashMap<foundation::SymbolId, Quote> quotes;
+    for (foundation::SymbolId id : ids) {
+        quotes[id] = {1.0, 1.01};
+    }
+    size_t i = 0;
+    for (auto _ : state) {
+        // Ids are dense from 0, so the lookup order doubles as ids
+        benchmark::DoNotOptimize(quotes.find(order[i++ & 0xFFFF])->second.bid);
+    }
+}
+BENCHMARK(BM_QuoteBySymbolFlatMap)->Arg(64)->Arg(100000);
+
+static void BM_SymbolIntern(benchmark::State& state) {
+    foundation::SymbolTable symbols;
+    const auto names = tickers(1024);
+    for (const auto& name : names) {
+        symbols.intern(name);
+    }
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(symbols.intern(names[i++ & 1023]));
+    }
+}
+BENCHMARK(BM_SymbolIntern)->Threads(1)->Threads(4);
@@ -0,0 +1,53 @@
+#include <benchmark/benchmark.h>
+#include <foundation/clock.h>
+#include <foundation/histogram.h>
+#include <chrono>
+#include <cstdint>
+
+// What timing one stage costs: two clock reads and a record
+static void BM_SteadyClockNow(benchmark::State& state) {
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(std::chrono::steady_clock::now());
+    }
+}
+BENCHMARK(BM_SteadyClockNow);
+
+static void BM_TscClockTicks(benchmark::State& state) {
+    state.SetLabel(foundation::TscClock::calibration().tsc ? "rdtsc" : "steady_clock fallback");
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(foundation::TscClock::ticks());
+    }
+}
+BENCHMARK(BM_TscClockTicks);
+
+static void BM_LatencyRecorderRecord(benchmark::State& state) {
+    static foundation::LatencyRecorder recorder("bench");
+    uint64_t value = 1;
+    for (auto _ : state) {
+        recorder.record(value);
+        value = value * 6364136223846793005ull + 1442695040888963407ull;
+        value >>= 40;   // Spread over the low buckets, like real latencies
+    }
+}
+BENCHMARK(BM_LatencyRecorderRecord)->Threads(1)->Threads(4);
+
+static void BM_TimedStage(benchmark::State& state) {
+    static foundation::LatencyRecorder recorder("stage");
+    for (auto _ : state) {
+        foundation::Stopwatch stopwatch;
+        benchmark::ClobberMemory();
+        recorder.record(stopwatch.elapsed_ns());
+    }
+}
+BENCHMARK(BM_TimedStage);
+
+static void BM_LatencyRecorderSnapshot(benchmark::State& state) {
+    static foundation::LatencyRecorder recorder("snapshot");
+    for (uint64_t v = 0; v < 100000; ++v) {
+        recorder.record(v);
+    }
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(recorder.snapshot().summary());
+    }
+}
+BENCHMARK(BM_LatencyRecorderSnapshot);
@@ -0,0 +1,66 @@
+#include <benchmark/benchmark.h>
+#include <foundation/logger.h>
+#include <spdlog/sinks/null_sink.h>
+#include <memory>
+#include <string>
+
+namespace {
+    // Both loggers write to a null sink, so only the calling thread's cost differs
+    struct NullLogger {
+        NullLogger() {
+            previous = spdlog::default_logger();
+            auto logger = std::make_shared<spdlog::logger>("bench", std::make_shared<spdlog::sinks::null_sink_mt>());
+            logger->set_level(spdlog::level::info);
+            spdlog::set_default_logger(logger);
+        }
+        ~NullLogger() { spdlog::set_default_logger(previous); }
+
+        std::shared_ptr<spdlog::logger> previous;
+    };
+
+    const std::string user = "User42";
+    const std::string room = "lobby";
+}
+
+// The chat_server per-message line, formatted on the calling thread
+static void BM_LogSpdlogSync(benchmark::State& state) {
+    NullLogger null_logger;
+    int64_t seq = 0;
+    for (auto _ : state) {
+        spdlog::info("[#{}] [{}]: {} bytes seq {}", room, user, 128, seq++);
+    }
+}
+BENCHMARK(BM_LogSpdlogSync);
+
+// The same line through FLOG_INFO: arguments copied into the thread's
+// buffer, formatted on the backend thread
+static void BM_LogAsync(benchmark::State& state) {
+    NullLogger null_logger;
+    foundation::start_async_logger();
+    int64_t seq = 0;
+    for (auto _ : state) {
+        FLOG_INFO("[#{}] [{}]: {} bytes seq {}", room, user, 128, seq++);
+        if ((seq & 4095) == 0) {
+            // Keep the buffer from filling while the backend shares this CPU
+            state.PauseTiming();
+            foundation::flush_async_logger();
+            state.ResumeTiming();
+        }
+    }
+    foundation::stop_async_logger();
+    state.counters["dropped"] = static_cast<double>(foundation::async_logger_stats().dropped);
+}
+BENCHMARK(BM_LogAsync);
+
+// A level compiled in but disabled at run time costs one branch
+static void BM_LogAsyncFiltered(benchmark::State& state) {
+    NullLogger null_logger;
+    foundation::start_async_logger();
+    int64_t seq = 0;
+    for (auto _ : state) {
+        FLOG_DEBUG("[#{}] [{}]: {} bytes seq {}", room, user, 128, seq++);
+    }
+    foundation::stop_async_logger();
+    benchmark::DoNotOptimize(seq);
+}
+BENCHMARK(BM_LogAsyncFiltered);
@@ -0,0 +1,120 @@
+#pragma once
+#include <network/tcp_server.h>
+#include <network/write_request_pool.h>
+#include <uv.h>
+#include <memory>
+#include <vector>
+
+// A loopback TcpServer with `clients` libuv sockets connected to it on the same loop
+class LoopbackHarness {
+public:
+    LoopbackHarness(network::TcpServerOptions options, int clients) {
+        uv_loop_init(&loop_);
+
+        options.host = "127.0.0.1";
+        options.port = 0;
+        server_ = std::make_unique<network::TcpServer>(&loop_, options);
+        server_->set_connect_handler([this](network::Connection& conn) { accepted_.push_back(&conn); });
+        listen_status_ = server_->listen();
+        if (listen_status_ != 0) {
+            return;
+        }
+
+        sockaddr_in addr{};
+        uv_ip4_addr("127.0.0.1", server_->bound_port(), &addr);
+        clients_.resize(clients);
+        for (auto& client : clients_) {
+            client = std::make_unique<Client>();
+            client->owner = this;
+            uv_tcp_init(&loop_, &client->handle);
+            client->handle.data = client.get();
+            uv_tcp_connect(&client->connect, &client->handle,
+                           reinterpret_cast<const sockaddr*>(&addr), on_connect);
+        }
+        while (accepted_.size() < clients_.size()) {
+            uv_run(&loop_, UV_RUN_NOWAIT);
+        }
+    }
+
+    ~LoopbackHarness() {
+        server_->close();
+        for (auto& client : clients_) {
+            uv_close(reinterpret_cast<uv_handle_t*>(&client->handle), nullptr);
+        }
+        uv_run(&loop_, UV_RUN_DEFAULT);
+        server_.reset();
+        uv_loop_close(&loop_);
+    }
+
+    LoopbackHarness(const LoopbackHarness&) = delete;
+    LoopbackHarness& operator=(const LoopbackHarness&) = delete;
+
+    // 0, or the libuv error listen() failed with (e.g. no io_uring here)
+    int listen_status() const { return listen_status_; }
+
+    network::TcpServer& server() { return *server_; }
+    const std::vector<network::Connection*>& connections() const { return accepted_; }
+
+    // Write `payload` from client `index` towards the server
+    void send_from_client(size_t index, const network::SharedPayload& payload) {
+        auto* request = pool_.acquire();
+        request->payloads[0] = payload;
+        request->payload_count = 1;
+        uv_buf_t buf = uv_buf_init(const_cast<char*>(payload.data()), static_cast<unsigned int>(payload.size()));
+        uv_write(&request->req, reinterpret_cast<uv_stream_t*>(&clients_[index]->handle), &buf, 1,
+                 [](uv_write_t* req, int) {
+                     auto* client = static_cast<Client*>(req->handle->data);
+                     client->owner->pool_.release(network::WriteRequest::from(req));
+                 });
+    }
+
+    // Spin the loop until the clients have received `expected_bytes` in total.
+    // Sends may happen outside any callback, so NOWAIT keeps poll from
+    // blocking before the check phase gets to flush a PerTick batch.
+    void drain(size_t expected_bytes) {
+        while (received_ < expected_bytes) {
+            uv_run(&loop_, UV_RUN_NOWAIT);
+        }
+        received_ = 0;
+    }
+
+    uint64_t write_calls() const {
+        uint64_t total = 0;
+        for (auto* conn : accepted_) {
+            total += conn->outbound_stats().write_calls;
+        }
+        return total;
+    }
+
+private:
+    struct Client {
+        LoopbackHarness* owner;
+        uv_tcp_t handle;
+        uv_connect_t connect;
+    };
+
+    static void on_connect(uv_connect_t* req, int status) {
+        if (status == 0) {
+            uv_read_start(req->handle, on_alloc, on_read);
+        }
+    }
+
+    static void on_alloc(uv_handle_t*, size_t, uv_buf_t* buf) {
+        static char scratch[256 * 1024];
+        *buf = uv_buf_init(scratch, sizeof(scratch));
+    }
+
+    static void on_read(uv_stream_t* stream, ssize_t nread, const uv_buf_t*) {
+        if (nread > 0) {
+            static_cast<Client*>(stream->data)->owner->received_ += static_cast<size_t>(nread);
+        }
+    }
+
+    uv_loop_t loop_;
+    std::unique_ptr<network::TcpServer> server_;
+    int listen_status_ = 0;
+    std::vector<network::Connection*> accepted_;
+    std::vector<std::unique_ptr<Client>> clients_;
+    network::WriteRequestPool pool_;
+    size_t received_ = 0;
+};
@@ -0,0 +1,53 @@
+#include <benchmark/benchmark.h>
+#include <network/frame_codec.h>
+#include <network/message_log.h>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace {
+    std::filesystem::path bench_dir(const char* name) {
+        auto dir = std::filesystem::temp_directory_path() / name;
+        std::filesystem::remove_all(dir);
+        return dir;
+    }
+}
+
+static void BM_MessageLogAppend(benchmark::State& state) {
+    const auto dir = bench_dir("message_log_bench_append");
+    {
+        network::MessageLogOptions options;
+        options.segment_bytes = 4 * 1024 * 1024;
+        options.retain_bytes = 16 * 1024 * 1024;
+        network::MessageLog log(dir.string(), options);
+        log.open();
+        const auto frame = network::encode_frame(network::FrameMode::LengthPrefixed,
+                                                 std::string(static_cast<size_t>(state.range(0)), 'x'));
+        for (auto _ : state) {
+            benchmark::DoNotOptimize(log.append(frame.view()));
+        }
+        state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * frame.size()));
+    }
+    std::filesystem::remove_all(dir);
+}
+BENCHMARK(BM_MessageLogAppend)->Arg(64)->Arg(512);
+
+// Replaying the last N messages to a joining client: views, not copies
+static void BM_MessageLogReplay(benchmark::State& state) {
+    const auto dir = bench_dir("message_log_bench_replay");
+    {
+        network::MessageLog log(dir.string());
+        log.open();
+        const auto frame = network::encode_frame(network::FrameMode::LengthPrefixed, std::string(100, 'x'));
+        for (int i = 0; i < 100000; ++i) {
+            log.append(frame.view());
+        }
+        std::vector<network::SharedPayload> views;
+        for (auto _ : state) {
+            views.clear();
+            benchmark::DoNotOptimize(log.read_last(static_cast<size_t>(state.range(0)), SIZE_MAX, views));
+        }
+    }
+    std::filesystem::remove_all(dir);
+}
+BENCHMARK(BM_MessageLogReplay)->Arg(50)->Arg(10000);
@@ -0,0 +1,49 @@
+#include <benchmark/benchmark.h>
+#include <foundation/metrics.h>
+#include <atomic>
+#include <cstdint>
+
+// A counter bumped by every loop: one shared atomic bounces its cache line
+// between cores, the sharded Counter writes only its own
+static void BM_SharedAtomicIncrement(benchmark::State& state) {
+    static std::atomic<uint64_t> counter{0};
+    for (auto _ : state) {
+        counter.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+BENCHMARK(BM_SharedAtomicIncrement)->Threads(1)->Threads(4);
+
+static void BM_CounterInc(benchmark::State& state) {
+    static foundation::Counter& counter = foundation::metrics().counter("bench_counter_total", "Benchmark");
+    for (auto _ : state) {
+        counter.inc();
+    }
+}
+BENCHMARK(BM_CounterInc)->Threads(1)->Threads(4);
+
+static void BM_GaugeAdd(benchmark::State& state) {
+    static foundation::Gauge& gauge = foundation::metrics().gauge("bench_gauge", "Benchmark");
+    for (auto _ : state) {
+        gauge.add(1);
+    }
+}
+BENCHMARK(BM_GaugeAdd)->Threads(1)->Threads(4);
+
+// What a scrape costs with a server's worth of metrics
+static void BM_RenderPrometheus(benchmark::State& state) {
+    foundation::MetricsRegistry registry;
+    for (int i = 0; i < 20; ++i) {
+        registry.counter("bench_total", "Benchmark", {{"index", std::to_string(i)}}).inc(i);
+    }
+    for (int i = 0; i < 6; ++i) {
+        foundation::LatencyRecorder& recorder =
+            registry.histogram("bench_seconds", "Benchmark", {{"stage", std::to_string(i)}});
+        for (uint64_t v = 0; v < 10000; ++v) {
+            recorder.record(v * 997);
+        }
+    }
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(registry.render_prometheus());
+    }
+}
+BENCHMARK(BM_RenderPrometheus);
@@ -0,0 +1,90 @@
+#include <benchmark/benchmark.h>
+#include <network/search_index.h>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+    // Chat-like lines over a Zipf-ish vocabulary, formatted as chat_server stores them
+    std::vector<std::string> make_messages(size_t count) {
+        std::mt19937 rng(7);
+        std::vector<std::string> vocabulary;
+        for (int i = 0; i < 20000; ++i) {
+            vocabulary.push_back("w" + std::to_string(i));
+        }
+        std::vector<std::string> messages;
+        for (size_t i = 0; i < count; ++i) {
+            std::string text = "[#lobby] [User" + std::to_string(rng() % 1000) + "]:";
+            for (int w = 0; w < 10; ++w) {
+                const double u = std::uniform_real_distribution<double>(0, 1)(rng);
+                text += ' ';
+                text += vocabulary[static_cast<size_t>(u * u * u * vocabulary.size())];
+            }
+            messages.push_back(std::move(text));
+        }
+        return messages;
+    }
+}
+
+// The cost chat_server adds to publishing a message; sealing is O(1) here and
+// encoding and merging happen in compact(), off the loop
+static void BM_SearchIndexIngest(benchmark::State& state) {
+    const auto messages = make_messages(4096);
+    network::SearchIndex index;
+    uint64_t doc = 0;
+    for (auto _ : state) {
+        index.add(doc, messages[doc % messages.size()]);
+        doc++;
+        if (doc % 4096 == 0) {
+            state.PauseTiming();
+            while (index.compact()) {
+            }
+            state.ResumeTiming();
+        }
+    }
+}
+BENCHMARK(BM_SearchIndexIngest);
+
+static void BM_SearchIndexCompact(benchmark::State& state) {
+    const auto messages = make_messages(4096);
+    uint64_t docs = 0;
+    for (auto _ : state) {
+        state.PauseTiming();
+        network::SearchIndex index;
+        for (size_t i = 0; i < 16 * 4096; ++i) {
+            index.add(i, messages[i % messages.size()]);
+        }
+        state.ResumeTiming();
+        while (index.compact()) {
+        }
+        docs += 16 * 4096;
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(docs));
+}
+BENCHMARK(BM_SearchIndexCompact)->Unit(benchmark::kMillisecond);
+
+// Top 20 over a million messages: one common and one rare term, and a conjunction
+static void BM_SearchIndexQuery(benchmark::State& state) {
+    static const auto index = [] {
+        const auto messages = make_messages(65536);
+        auto built = std::make_unique<network::SearchIndex>();
+        for (uint64_t doc = 0; doc < (1u << 20); ++doc) {
+            built->add(doc, messages[doc % messages.size()]);
+            if (doc % 4096 == 0) {
+                while (built->compact()) {
+                }
+            }
+        }
+        while (built->compact()) {
+        }
+        return built;
+    }();
+    static const char* queries[] = {"w3", "w19000", "w3 w7 user12"};
+    const char* query = queries[state.range(0)];
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(index->search(query, 20));
+    }
+    state.SetLabel(query);
+}
+BENCHMARK(BM_SearchIndexQuery)->DenseRange(0, 2)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,105 @@
+#include <benchmark/benchmark.h>
+#include <network/slot_map.h>
+#include <algorithm>
+#include <random>
+#include <vector>
+
+namespace {
+    struct Client {
+        uint64_t id;
+        uint64_t bytes_sent = 0;
+    };
+
+    // A connect plus a disconnect of a random existing client
+    std::vector<size_t> churn_picks(size_t clients, size_t count) {
+        std::mt19937 rng(42);
+        std::vector<size_t> picks(count);
+        for (auto& pick : picks) {
+            pick = rng() % clients;
+        }
+        return picks;
+    }
+}
+
+// The registry chat_server had: pointers in a vector, erase(remove(...)) on disconnect
+static void BM_ChurnVectorErase(benchmark::State& state) {
+    const size_t clients = static_cast<size_t>(state.range(0));
+    std::vector<Client*> registry;
+    for (size_t i = 0; i < clients; ++i) {
+        registry.push_back(new Client{i});
+    }
+    const auto picks = churn_picks(clients, 4096);
+    size_t next = 0;
+    uint64_t next_id = clients;
+
+    for (auto _ : state) {
+        Client* gone = registry[picks[next++ % picks.size()]];
+        registry.erase(std::remove(registry.begin(), registry.end(), gone), registry.end());
+        delete gone;
+        registry.push_back(new Client{next_id++});
+    }
+    for (Client* client : registry) {
+        delete client;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ChurnVectorErase)->Arg(1000)->Arg(50000);
+
+static void BM_ChurnSlotMap(benchmark::State& state) {
+    const size_t clients = static_cast<size_t>(state.range(0));
+    network::SlotMap<Client> registry;
+    std::vector<network::SlotHandle> handles;
+    for (size_t i = 0; i < clients; ++i) {
+        handles.push_back(registry.insert(Client{i}));
+    }
+    const auto picks = churn_picks(clients, 4096);
+    size_t next = 0;
+    uint64_t next_id = clients;
+
+    for (auto _ : state) {
+        network::SlotHandle& handle = handles[picks[next++ % picks.size()]];
+        registry.erase(handle);
+        handle = registry.insert(Client{next_id++});
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ChurnSlotMap)->Arg(1000)->Arg(50000);
+
+// Fan-out over every client: pointer chasing vs the slot map's dense array
+static void BM_FanOutPointerVector(benchmark::State& state) {
+    const size_t clients = static_cast<size_t>(state.range(0));
+    std::vector<Client*> registry;
+    for (size_t i = 0; i < clients; ++i) {
+        registry.push_back(new Client{i});
+    }
+    std::shuffle(registry.begin(), registry.end(), std::mt19937(1));
+
+    for (auto _ : state) {
+        for (Client* client : registry) {
+            client->bytes_sent += 64;
+        }
+        benchmark::ClobberMemory();
+    }
+    for (Client* client : registry) {
+        delete client;
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(clients));
+}
+BENCHMARK(BM_FanOutPointerVector)->Arg(50000);
+
+static void BM_FanOutSlotMap(benchmark::State& state) {
+    const size_t clients = static_cast<size_t>(state.range(0));
+    network::SlotMap<Client> registry;
+    for (size_t i = 0; i < clients; ++i) {
+        registry.insert(Client{i});
+    }
+
+    for (auto _ : state) {
+        for (Client& client : registry) {
+            client.bytes_sent += 64;
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(clients));
+}
+BENCHMARK(BM_FanOutSlotMap)->Arg(50000);
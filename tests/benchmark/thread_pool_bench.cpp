@@ -0,0 +1,80 @@
+#include <benchmark/benchmark.h>
+#include <foundation/thread_pool.h>
+#include <quant/monte_carlo.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+// Scaling runs: the argument is the pool size, from 1 up to every core.
+// Wall-clock time is what shrinks, so these use real time.
+static void PoolSizes(benchmark::internal::Benchmark* bench) {
+    const int cores = static_cast<int>(std::max(std::thread::hardware_concurrency(), 1u));
+    for (int threads = 1; threads < cores; threads *= 2) {
+        bench->Arg(threads);
+    }
+    bench->Arg(cores);
+    bench->UseRealTime()->Unit(benchmark::kMillisecond);
+}
+
+static void BM_MonteCarloPricing(benchmark::State& state) {
+    foundation::ThreadPool pool(foundation::ThreadPoolOptions{.threads = static_cast<size_t>(state.range(0))});
+    constexpr size_t PATHS = 1 << 20;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(quant::monte_carlo_option_price(pool, 100, 105, 0.03, 0.2, 0.75, PATHS));
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * PATHS));
+}
+BENCHMARK(BM_MonteCarloPricing)->Apply(PoolSizes);
+
+static void BM_ParallelReduceSum(benchmark::State& state) {
+    foundation::ThreadPool pool(foundation::ThreadPoolOptions{.threads = static_cast<size_t>(state.range(0))});
+    std::vector<double> values(1 << 24);
+    for (size_t i = 0; i < values.size(); ++i) {
+        values[i] = std::sqrt(static_cast<double>(i));
+    }
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(foundation::parallel_reduce(
+            pool, 0, values.size(), 0, 0.0,
+            [&](size_t begin, size_t end) {
+                double sum = 0;
+                for (size_t i = begin; i < end; ++i) {
+                    sum += values[i];
+                }
+                return sum;
+            },
+            [](double a, double b) { return a + b; }));
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * values.size() * sizeof(double)));
+}
+BENCHMARK(BM_ParallelReduceSum)->Apply(PoolSizes);
+
+// Scheduling overhead: spawn and join tiny tasks
+static void BM_TaskGroupSpawnJoin(benchmark::State& state) {
+    foundation::ThreadPool pool(foundation::ThreadPoolOptions{.threads = static_cast<size_t>(state.range(0))});
+    constexpr int TASKS = 1000;
+    for (auto _ : state) {
+        foundation::TaskGroup group(pool);
+        for (int i = 0; i < TASKS; ++i) {
+            group.run([] { benchmark::ClobberMemory(); });
+        }
+        group.wait();
+    }
+    state.SetItemsProcessed(state.iterations() * TASKS);
+}
+BENCHMARK(BM_TaskGroupSpawnJoin)->Arg(1)->Arg(4)->UseRealTime();
+
+static void BM_ParallelForFineGrained(benchmark::State& state) {
+    foundation::ThreadPool pool(foundation::ThreadPoolOptions{.threads = static_cast<size_t>(state.range(0))});
+    std::vector<uint32_t> data(1 << 16);
+    for (auto _ : state) {
+        foundation::parallel_for(pool, 0, data.size(), 256, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                data[i] = data[i] * 1664525u + 1013904223u;
+            }
+        });
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * data.size()));
+}
+BENCHMARK(BM_ParallelForFineGrained)->Arg(1)->Arg(4)->UseRealTime();
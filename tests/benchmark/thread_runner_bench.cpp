@@ -0,0 +1,41 @@
+#include <benchmark/benchmark.h>
+#include <foundation/thread_runner.h>
+#include <network/event_loop.h>
+#include <atomic>
+#include <thread>
+
+// Round trip of a task posted to another loop thread: the argument picks a
+// loop that sleeps in the backend (0) or busy-polls it (1). Busy polling
+// trades a core for skipping the wakeup; on a single core it mostly shows
+// the cost of sharing that core, so compare on pinned, isolated cores.
+static void BM_PostToLoopRoundTrip(benchmark::State& state) {
+    network::EventLoop loop;
+    foundation::ThreadRunnerOptions options;
+    options.busy_poll = state.range(0) != 0;
+    options.yield_after = std::thread::hardware_concurrency() > 1 ? 0 : 64;
+    loop.start(options);
+
+    std::atomic<uint64_t> done{0};
+    uint64_t sent = 0;
+    for (auto _ : state) {
+        loop.post([&done] { done.fetch_add(1, std::memory_order_release); });
+        ++sent;
+        while (done.load(std::memory_order_acquire) != sent) {
+            std::this_thread::yield();
+        }
+    }
+    loop.stop();
+    loop.join();
+    state.counters["busy_ratio"] = loop.runner_stats().busy_ratio();
+}
+BENCHMARK(BM_PostToLoopRoundTrip)->Arg(0)->Arg(1)->UseRealTime();
+
+// What the runner itself adds per idle poll
+static void BM_RunnerIdlePoll(benchmark::State& state) {
+    foundation::ThreadRunnerOptions options;
+    options.busy_poll = true;
+    options.max_pause = 1;
+    foundation::ThreadRunner runner(options);
+    runner.run([&state](bool) { return state.KeepRunning() ? foundation::PollResult::Idle : foundation::PollResult::Done; });
+}
+BENCHMARK(BM_RunnerIdlePoll);
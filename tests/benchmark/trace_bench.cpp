@@ -0,0 +1,32 @@
+#include <benchmark/benchmark.h>
+#include <foundation/clock.h>
+#include <foundation/trace.h>
+
+// One zone: two rdtsc reads and a store into the thread's ring
+static void BM_TraceZone(benchmark::State& state) {
+    for (auto _ : state) {
+        FTRACE_ZONE("bench_zone");
+        benchmark::ClobberMemory();
+    }
+}
+BENCHMARK(BM_TraceZone)->Threads(1)->Threads(4);
+
+// The floor: the clock reads alone
+static void BM_TraceClockOnly(benchmark::State& state) {
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(foundation::TscClock::ticks());
+        benchmark::DoNotOptimize(foundation::TscClock::ticks());
+    }
+}
+BENCHMARK(BM_TraceClockOnly);
+
+// A dump of full rings, as a signal or /trace would produce
+static void BM_TraceDump(benchmark::State& state) {
+    for (size_t i = 0; i < foundation::detail::TraceRing::CAPACITY; ++i) {
+        FTRACE_ZONE("bench_dump");
+    }
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(foundation::trace_json());
+    }
+}
+BENCHMARK(BM_TraceDump)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,85 @@
+#include "loopback_harness.h"
+#include <benchmark/benchmark.h>
+#include <network/frame_codec.h>
+#include <network/tcp_server.h>
+#include <string>
+
+namespace {
+
+    network::TcpServerOptions echo_options(network::Backend backend) {
+        network::TcpServerOptions options;
+        options.backend = backend;
+        options.framing = network::FrameMode::LengthPrefixed;
+        options.flush_mode = network::FlushMode::PerTick;
+        options.outbound.high_watermark = 64 * 1024 * 1024;
+        return options;
+    }
+
+    // Every client sends `burst` frames per iteration and waits for all echoes
+    void run_echo(benchmark::State& state, network::Backend backend) {
+        const int clients = static_cast<int>(state.range(0));
+        const int burst = static_cast<int>(state.range(1));
+        LoopbackHarness harness(echo_options(backend), clients);
+        if (harness.listen_status() != 0) {
+            state.SkipWithError(uv_strerror(harness.listen_status()));
+            return;
+        }
+        harness.server().set_data_handler([](network::Connection& conn, std::span<const char> frame) {
+            conn.send(network::encode_frame(network::FrameMode::LengthPrefixed,
+                                            std::string_view(frame.data(), frame.size())));
+        });
+
+        network::SharedPayload frame = network::encode_frame(network::FrameMode::LengthPrefixed,
+                                                             std::string(64, 'e'));
+        for (auto _ : state) {
+            for (int c = 0; c < clients; ++c) {
+                for (int i = 0; i < burst; ++i) {
+                    harness.send_from_client(c, frame);
+                }
+            }
+            harness.drain(static_cast<size_t>(clients) * burst * frame.size());
+        }
+        state.SetItemsProcessed(state.iterations() * clients * burst);
+    }
+
+    // Server-to-client only: one payload fanned out to every client
+    void run_fan_out(benchmark::State& state, network::Backend backend) {
+        const int clients = static_cast<int>(state.range(0));
+        LoopbackHarness harness(echo_options(backend), clients);
+        if (harness.listen_status() != 0) {
+            state.SkipWithError(uv_strerror(harness.listen_status()));
+            return;
+        }
+
+        network::SharedPayload frame = network::encode_frame(network::FrameMode::LengthPrefixed,
+                                                             std::string(256, 'f'));
+        for (auto _ : state) {
+            for (auto* conn : harness.connections()) {
+                conn->send(frame);
+            }
+            harness.drain(static_cast<size_t>(clients) * frame.size());
+        }
+        state.SetItemsProcessed(state.iterations() * clients);
+    }
+
+}
+
+static void BM_EchoLibuv(benchmark::State& state) {
+    run_echo(state, network::Backend::Libuv);
+}
+BENCHMARK(BM_EchoLibuv)->Args({64, 8})->UseRealTime();
+
+static void BM_EchoIoUring(benchmark::State& state) {
+    run_echo(state, network::Backend::IoUring);
+}
+BENCHMARK(BM_EchoIoUring)->Args({64, 8})->UseRealTime();
+
+static void BM_FanOutLibuv(benchmark::State& state) {
+    run_fan_out(state, network::Backend::Libuv);
+}
+BENCHMARK(BM_FanOutLibuv)->Arg(256)->UseRealTime();
+
+static void BM_FanOutIoUring(benchmark::State& state) {
+    run_fan_out(state, network::Backend::IoUring);
+}
+BENCHMARK(BM_FanOutIoUring)->Arg(256)->UseRealTime();
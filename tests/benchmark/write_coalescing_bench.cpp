@@ -0,0 +1,43 @@
+#include "loopback_harness.h"
+#include <benchmark/benchmark.h>
+#include <network/tcp_server.h>
+#include <string>
+
+namespace {
+
+    // Each iteration is one loop tick in which every client receives `burst` messages
+    void run_fan_in(benchmark::State& state, network::FlushMode mode) {
+        const int clients = static_cast<int>(state.range(0));
+        const int burst = static_cast<int>(state.range(1));
+        network::TcpServerOptions options;
+        options.flush_mode = mode;
+        options.outbound.high_watermark = 64 * 1024 * 1024;
+        LoopbackHarness harness(options, clients);
+        network::SharedPayload message = network::SharedPayload::copy_of(std::string(64, 'm'));
+
+        const uint64_t calls_before = harness.write_calls();
+        for (auto _ : state) {
+            for (auto* conn : harness.connections()) {
+                for (int i = 0; i < burst; ++i) {
+                    conn->send(message);
+                }
+            }
+            harness.drain(static_cast<size_t>(clients) * burst * message.size());
+        }
+
+        const double messages = static_cast<double>(state.iterations()) * clients * burst;
+        state.counters["writes_per_msg"] = static_cast<double>(harness.write_calls() - calls_before) / messages;
+        state.SetItemsProcessed(static_cast<int64_t>(messages));
+    }
+
+}
+
+static void BM_FanInImmediate(benchmark::State& state) {
+    run_fan_in(state, network::FlushMode::Immediate);
+}
+BENCHMARK(BM_FanInImmediate)->Args({64, 32})->UseRealTime();
+
+static void BM_FanInPerTick(benchmark::State& state) {
+    run_fan_in(state, network::FlushMode::PerTick);
+}
+BENCHMARK(BM_FanInPerTick)->Args({64, 32})->UseRealTime();
@@ -0,0 +1,201 @@
+#include <gtest/gtest.h>
+#include <foundation/arena.h>
+#include <foundation/huge_pages.h>
+#include <foundation/object_pool.h>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <memory_resource>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+using foundation::Arena;
+using foundation::ArenaOptions;
+
+TEST(ArenaTest, AlignsAndReusesBlocksAfterReset) {
+    ArenaOptions options;
+    options.block_bytes = 1024;
+    Arena arena(options);
+
+    for (size_t alignment : {1, 2, 8, 16, 64}) {
+        arena.allocate(1, 1);
+        void* p = arena.allocate(24, alignment);
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(p) % alignment, 0u);
+    }
+    for (int i = 0; i < 100; ++i) {
+        arena.allocate(100);
+    }
+    const auto before = arena.stats();
+    EXPECT_GT(before.upstream_allocations, 1u);
+    EXPECT_GE(before.bytes_used, 100u * 100u);
+
+    arena.reset();
+    for (int i = 0; i < 100; ++i) {
+        arena.allocate(100);
+    }
+    const auto after = arena.stats();
+    EXPECT_EQ(after.upstream_allocations, before.upstream_allocations);
+    EXPECT_EQ(after.resets, 1u);
+}
+
+TEST(ArenaTest, OversizedAllocationsAndRetentionLimit) {
+    ArenaOptions options;
+    options.block_bytes = 1024;
+    options.max_retained_bytes = 4096;
+    Arena arena(options);
+
+    char* big = static_cast<char*>(arena.allocate(100000));
+    big[99999] = 1;
+    int* small = arena.create<int>(7);
+    EXPECT_EQ(*small, 7);
+    EXPECT_GE(arena.stats().bytes_reserved, 100000u);
+
+    arena.reset();
+    EXPECT_LE(arena.stats().bytes_reserved, 4096u);
+}
+
+TEST(ArenaTest, BacksPmrContainers) {
+    Arena arena;
+    std::pmr::vector<std::pmr::string> lines(&arena);
+    for (int i = 0; i < 1000; ++i) {
+        lines.emplace_back("a line long enough to defeat the small string buffer " + std::to_string(i));
+    }
+    EXPECT_EQ(lines[999].get_allocator().resource(), &arena);
+    EXPECT_EQ(lines[999].back(), '9');
+}
+
+namespace {
+    struct Pooled : foundation::PoolAllocated<Pooled> {
+        uint64_t value[3] = {};
+    };
+}
+
+TEST(ObjectPoolTest, ReusesFreedBlocks) {
+    using Pool = foundation::ObjectPool<std::string>;
+    std::string* a = Pool::create("first");
+    Pool::destroy(a);
+    std::string* b = Pool::create("second");
+    EXPECT_EQ(a, b);    // LIFO per thread
+    EXPECT_EQ(*b, "second");
+
+    auto owned = Pool::make(3, 'x');
+    EXPECT_EQ(*owned, "xxx");
+    Pool::destroy(b);
+
+    auto pooled = std::make_unique<Pooled>();
+    pooled->value[2] = 5;
+    Pooled* raw = pooled.get();
+    pooled.reset();
+    EXPECT_EQ(std::make_unique<Pooled>().get(), raw);
+}
+
+TEST(ObjectPoolTest, FreesOnAnotherThread) {
+    using Pool = foundation::FixedPool<48>;
+    constexpr int COUNT = 10000;
+    std::vector<void*> blocks;
+    for (int i = 0; i < COUNT; ++i) {
+        blocks.push_back(Pool::allocate());
+        std::memset(blocks.back(), 0xab, 48);
+    }
+    EXPECT_EQ(std::set<void*>(blocks.begin(), blocks.end()).size(), static_cast<size_t>(COUNT));
+
+    std::thread([&] {
+        for (void* block : blocks) {
+            Pool::deallocate(block);
+        }
+    }).join();
+    // The exited thread handed everything back, so this thread reuses it
+    const uint64_t chunks = Pool::stats().chunks;
+    EXPECT_GE(Pool::stats().blocks_in_depot, static_cast<size_t>(COUNT));
+    for (int i = 0; i < COUNT; ++i) {
+        blocks[i] = Pool::allocate();
+    }
+    EXPECT_EQ(Pool::stats().chunks, chunks);
+    for (void* block : blocks) {
+        Pool::deallocate(block);
+    }
+}
+
+TEST(ObjectPoolTest, PoolResourceServesPmrContainers) {
+    std::pmr::memory_resource* resource = foundation::pool_resource();
+    std::pmr::vector<std::pmr::string> strings(resource);
+    for (int i = 0; i < 100; ++i) {
+        strings.emplace_back(std::string(i * 20, 'z'));
+    }
+    EXPECT_EQ(strings[99].size(), 1980u);
+
+    void* aligned = resource->allocate(64, 64);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(aligned) % 64, 0u);
+    resource->deallocate(aligned, 64, 64);
+}
+
+TEST(HugePageRegionTest, CarvesAlignedAllocationsAndFallsBackWhenFull) {
+    foundation::HugePageRegion region({.bytes = 1, .prefault = true, .lock = false, .allow_fallback = true});
+    ASSERT_TRUE(region.valid());
+    foundation::HugePageStats stats = region.stats();
+    EXPECT_EQ(stats.bytes_reserved, foundation::HugePageRegion::HUGE_PAGE_SIZE);     // Whole pages
+
+    void* small = region.allocate(24, 8);
+    void* aligned = region.allocate(100, 4096);
+    EXPECT_TRUE(region.contains(small));
+    EXPECT_TRUE(region.contains(aligned));
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(aligned) % 4096, 0u);
+    EXPECT_GE(static_cast<char*>(aligned), static_cast<char*>(small) + 24);
+    std::memset(aligned, 0x5a, 100);
+
+    // Does not fit in what is left: served by the heap, and freed there
+    void* big = region.allocate(foundation::HugePageRegion::HUGE_PAGE_SIZE, 64);
+    EXPECT_FALSE(region.contains(big));
+    stats = region.stats();
+    EXPECT_EQ(stats.fallback_bytes, foundation::HugePageRegion::HUGE_PAGE_SIZE);
+    EXPECT_GE(stats.bytes_used, 4096u + 100u);
+    region.deallocate(big, foundation::HugePageRegion::HUGE_PAGE_SIZE, 64);
+    region.deallocate(small, 24, 8);    // A no-op inside the region
+    EXPECT_EQ(region.stats().bytes_used, stats.bytes_used);
+}
+
+TEST(HugePageRegionTest, ConcurrentAllocationsDoNotOverlap) {
+    foundation::HugePageRegion region({.bytes = 4 << 20, .prefault = false, .lock = false, .allow_fallback = true});
+    constexpr int THREADS = 4;
+    constexpr int EACH = 2000;
+    std::vector<std::vector<char*>> blocks(THREADS);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < THREADS; ++t) {
+        threads.emplace_back([&region, &blocks, t] {
+            for (int i = 0; i < EACH; ++i) {
+                blocks[t].push_back(static_cast<char*>(region.allocate(48, 16)));
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    std::vector<char*> all;
+    for (const auto& list : blocks) {
+        all.insert(all.end(), list.begin(), list.end());
+    }
+    std::sort(all.begin(), all.end());
+    for (size_t i = 0; i < all.size(); ++i) {
+        EXPECT_TRUE(region.contains(all[i]));
+        if (i > 0) {
+            EXPECT_GE(all[i] - all[i - 1], 48);
+        }
+    }
+}
+
+TEST(HugePageRegionTest, ProcessRegionFeedsObjectPools) {
+    struct Unpooled {
+        char bytes[777];    // A block size no other test pools, so its first chunk comes after enabling
+    };
+    const foundation::HugePageStats stats = foundation::enable_huge_pages({.bytes = 8 << 20});
+    ASSERT_GT(stats.bytes_reserved, 0u);
+    std::pmr::memory_resource* resource = foundation::huge_page_resource();
+    ASSERT_NE(resource, std::pmr::new_delete_resource());
+
+    Unpooled* object = foundation::ObjectPool<Unpooled>::create();
+    EXPECT_TRUE(static_cast<foundation::HugePageRegion*>(resource)->contains(object));
+    foundation::ObjectPool<Unpooled>::destroy(object);
+}
@@ -0,0 +1,102 @@
+#include <gtest/gtest.h>
+#include <network/buffer_pool.h>
+#include <cstring>
+#include <memory_resource>
+#include <vector>
+
+using network::BufferPool;
+
+TEST(BufferPoolTest, RoundsUpToSizeClass) {
+    BufferPool pool;
+    size_t capacity = 0;
+
+    char* small = pool.acquire(100, &capacity);
+    EXPECT_EQ(capacity, BufferPool::MIN_BLOCK_SIZE);
+    pool.release(small);
+
+    char* medium = pool.acquire(5000, &capacity);
+    EXPECT_EQ(capacity, 8 * 1024u);
+    pool.release(medium);
+
+    char* huge = pool.acquire(10 * 1024 * 1024, &capacity);
+    EXPECT_EQ(capacity, BufferPool::MAX_BLOCK_SIZE);
+    std::memset(huge, 0xab, capacity);
+    pool.release(huge);
+}
+
+TEST(BufferPoolTest, SteadyStateDoesNotAllocate) {
+    BufferPool pool({.blocks_per_slab = 8, .max_idle_slabs = 1});
+
+    for (int i = 0; i < 4; ++i) {
+        pool.release(pool.acquire(64 * 1024));
+    }
+    const uint64_t warm = pool.stats().upstream_allocations;
+
+    for (int i = 0; i < 10000; ++i) {
+        pool.release(pool.acquire(64 * 1024));
+    }
+    EXPECT_EQ(pool.stats().upstream_allocations, warm);
+    EXPECT_EQ(pool.stats().acquires, pool.stats().releases);
+}
+
+TEST(BufferPoolTest, CarvesManyBlocksFromOneSlab) {
+    BufferPool pool({.blocks_per_slab = 16, .max_idle_slabs = 1});
+    std::vector<char*> blocks;
+    for (int i = 0; i < 16; ++i) {
+        blocks.push_back(pool.acquire(4096));
+    }
+    EXPECT_EQ(pool.stats().upstream_allocations, 1u);
+
+    blocks.push_back(pool.acquire(4096));
+    EXPECT_EQ(pool.stats().upstream_allocations, 2u);
+
+    for (char* block : blocks) {
+        pool.release(block);
+    }
+}
+
+TEST(BufferPoolTest, IdleSlabsAreBounded) {
+    BufferPool pool({.blocks_per_slab = 2, .max_idle_slabs = 1});
+    std::vector<char*> blocks;
+    for (int i = 0; i < 8; ++i) {
+        blocks.push_back(pool.acquire(4096));
+    }
+    EXPECT_EQ(pool.stats().upstream_allocations, 4u);
+
+    for (char* block : blocks) {
+        pool.release(block);
+    }
+    // Three of the four slabs went back to the heap, one stays warm
+    EXPECT_EQ(pool.stats().upstream_frees, 3u);
+
+    pool.trim();
+    EXPECT_EQ(pool.stats().upstream_frees, 4u);
+    EXPECT_EQ(pool.stats().bytes_reserved, 0u);
+}
+
+TEST(BufferPoolTest, SlabsComeFromUpstream) {
+    // Counts what passes through to the heap
+    struct CountingResource : std::pmr::memory_resource {
+        size_t outstanding = 0;
+        void* do_allocate(size_t bytes, size_t alignment) override {
+            outstanding += bytes;
+            return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+        }
+        void do_deallocate(void* p, size_t bytes, size_t alignment) override {
+            outstanding -= bytes;
+            std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+        }
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+    };
+
+    CountingResource upstream;
+    {
+        BufferPool pool({.blocks_per_slab = 4, .max_idle_slabs = 0, .upstream = &upstream});
+        char* block = pool.acquire(100);
+        EXPECT_EQ(upstream.outstanding, pool.stats().bytes_reserved);
+        pool.release(block);    // Over max_idle_slabs: handed straight back
+        EXPECT_EQ(upstream.outstanding, 0u);
+        pool.acquire(100);
+    }
+    EXPECT_EQ(upstream.outstanding, 0u);
+}
@@ -0,0 +1,293 @@
+#include <gtest/gtest.h>
+#include <network/async_io.h>
+#include <network/task.h>
+#include <network/timer_wheel.h>
+#include <uv.h>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+using network::AsyncTcp;
+using network::Task;
+
+namespace {
+    Task<int> add(int a, int b) {
+        co_return a + b;
+    }
+
+    Task<int> sum_to(int n) {
+        int total = 0;
+        for (int i = 1; i <= n; ++i) {
+            total = co_await add(total, i);
+        }
+        co_return total;
+    }
+}
+
+TEST(TaskTest, StartsLazilyAndChainsValues) {
+    bool started = false;
+    int result = 0;
+    auto outer = [&]() -> Task<void> {
+        started = true;
+        result = co_await sum_to(100);
+    };
+    Task<void> task = outer();
+    EXPECT_FALSE(started);
+    network::spawn(std::move(task));
+    EXPECT_TRUE(started);
+    EXPECT_EQ(result, 5050);
+}
+
+TEST(TaskTest, DeepChainsDoNotGrowTheStack) {
+    // Symmetric transfer: a million synchronous completions in a row
+    int result = 0;
+    auto outer = [&]() -> Task<void> {
+        for (int i = 0; i < 1000000; ++i) {
+            result = co_await add(result, 1);
+        }
+    };
+    network::spawn(outer());
+    EXPECT_EQ(result, 1000000);
+}
+
+TEST(TaskTest, EventResumesWaiterAndRemembersEarlySet) {
+    network::Event event;
+    std::vector<int> steps;
+    auto waiter = [&]() -> Task<void> {
+        steps.push_back(1);
+        co_await event.wait();
+        steps.push_back(3);
+        co_await event.wait();      // Already set below: does not suspend
+        steps.push_back(4);
+    };
+
+    network::spawn(waiter());
+    EXPECT_TRUE(event.waiting());
+    steps.push_back(2);
+    event.set();    // Resumes the waiter inline, up to its second wait
+    EXPECT_EQ(steps, (std::vector<int>{1, 2, 3}));
+    event.set();
+    EXPECT_FALSE(event.waiting());
+    EXPECT_EQ(steps, (std::vector<int>{1, 2, 3, 4}));
+
+    network::Event early;
+    early.set();
+    bool passed = false;
+    auto eager = [&]() -> Task<void> {
+        co_await early.wait();
+        passed = true;
+    };
+    network::spawn(eager());
+    EXPECT_TRUE(passed);
+}
+
+TEST(AsyncIoTest, EchoesOverLoopback) {
+    uv_loop_t loop;
+    uv_loop_init(&loop);
+    AsyncTcp listener(&loop);
+    ASSERT_EQ(listener.listen("127.0.0.1", 0), 0);
+
+    auto serve = [&]() -> Task<void> {
+        AsyncTcp client(&loop);
+        EXPECT_EQ(co_await listener.accept(client), 0);
+        while (co_await client.read() == 0) {
+            std::span<const char> data = client.buffered();
+            EXPECT_EQ(co_await client.write(data), 0);
+            client.consume(data.size());
+        }
+        co_await client.close();
+        co_await listener.close();
+    };
+
+    std::string echoed;
+    auto talk = [&]() -> Task<void> {
+        AsyncTcp socket(&loop);
+        EXPECT_EQ(co_await socket.connect("127.0.0.1", listener.bound_port()), 0);
+        for (int i = 0; i < 3; ++i) {
+            std::string line = "hello " + std::to_string(i) + "\n";
+            EXPECT_EQ(co_await socket.write(std::span<const char>(line)), 0);
+            while (socket.buffered().size() < line.size()) {
+                if (co_await socket.read() != 0) {
+                    break;
+                }
+            }
+            echoed.append(socket.buffered().data(), socket.buffered().size());
+            socket.consume(socket.buffered().size());
+        }
+        co_await socket.close();
+    };
+
+    network::spawn(serve());
+    network::spawn(talk());
+    uv_run(&loop, UV_RUN_DEFAULT);
+    EXPECT_EQ(echoed, "hello 0\nhello 1\nhello 2\n");
+    EXPECT_EQ(uv_loop_close(&loop), 0);
+}
+
+TEST(AsyncIoTest, ConnectsByNameAndFailsUnknownNames) {
+    uv_loop_t loop;
+    uv_loop_init(&loop);
+    AsyncTcp listener(&loop);
+    ASSERT_EQ(listener.listen("127.0.0.1", 0), 0);
+
+    auto serve = [&]() -> Task<void> {
+        AsyncTcp client(&loop);
+        EXPECT_EQ(co_await listener.accept(client), 0);
+        co_await client.close();
+        co_await listener.close();
+    };
+
+    int by_name = 1;
+    int unknown = 0;
+    int cancelled = 0;
+    auto talk = [&]() -> Task<void> {
+        AsyncTcp socket(&loop);
+        by_name = co_await socket.connect("localhost", listener.bound_port());
+        co_await socket.close();
+
+        AsyncTcp nowhere(&loop);
+        unknown = co_await nowhere.connect("no-such-host.invalid", 1);
+        co_await nowhere.close();
+    };
+    // Closed while its lookup is outstanding
+    AsyncTcp abandoned(&loop);
+    auto abandon = [&]() -> Task<void> {
+        cancelled = co_await abandoned.connect("no-such-host.invalid", 1);
+    };
+
+    network::spawn(serve());
+    network::spawn(talk());
+    network::spawn(abandon());
+    network::spawn([&]() -> Task<void> { co_await abandoned.close(); }());
+    uv_run(&loop, UV_RUN_DEFAULT);
+    EXPECT_EQ(by_name, 0);
+    EXPECT_LT(unknown, 0);
+    EXPECT_EQ(cancelled, UV_ECANCELED);
+    EXPECT_EQ(uv_loop_close(&loop), 0);
+}
+
+TEST(AsyncIoTest, LargeWritesCompleteAfterPartialTryWrite) {
+    uv_loop_t loop;
+    uv_loop_init(&loop);
+    AsyncTcp listener(&loop);
+    ASSERT_EQ(listener.listen("127.0.0.1", 0), 0);
+    const std::string payload(8 * 1024 * 1024, 'x');
+
+    size_t received = 0;
+    auto drain = [&]() -> Task<void> {
+        AsyncTcp client(&loop, 16 * 1024);
+        EXPECT_EQ(co_await listener.accept(client), 0);
+        while (co_await client.read() == 0) {
+            received += client.buffered().size();
+            client.consume(client.buffered().size());
+        }
+        co_await client.close();
+        co_await listener.close();
+    };
+    auto send = [&]() -> Task<void> {
+        AsyncTcp socket(&loop);
+        EXPECT_EQ(co_await socket.connect("127.0.0.1", listener.bound_port()), 0);
+        uv_buf_t bufs[2] = {uv_buf_init(const_cast<char*>(payload.data()), 1000),
+                            uv_buf_init(const_cast<char*>(payload.data()) + 1000,
+                                        static_cast<unsigned int>(payload.size() - 1000))};
+        EXPECT_EQ(co_await socket.write(std::span<const uv_buf_t>(bufs)), 0);
+        co_await socket.close();
+    };
+
+    network::spawn(drain());
+    network::spawn(send());
+    uv_run(&loop, UV_RUN_DEFAULT);
+    EXPECT_EQ(received, payload.size());
+    EXPECT_EQ(uv_loop_close(&loop), 0);
+}
+
+TEST(AsyncIoTest, CloseCancelsPendingReadAndAccept) {
+    uv_loop_t loop;
+    uv_loop_init(&loop);
+    AsyncTcp listener(&loop);
+    ASSERT_EQ(listener.listen("127.0.0.1", 0), 0);
+    AsyncTcp peer(&loop);
+    AsyncTcp accepted(&loop);
+    AsyncTcp never(&loop);
+
+    int accept_status = 1;
+    int read_status = 1;
+    auto accept_into = [&](AsyncTcp& client, int& status) -> Task<void> {
+        status = co_await listener.accept(client);
+    };
+    auto read_one = [&]() -> Task<void> {
+        EXPECT_EQ(co_await peer.connect("127.0.0.1", listener.bound_port()), 0);
+        read_status = co_await peer.read();
+    };
+    auto closer = [&]() -> Task<void> {
+        network::AsyncTimer timer(&loop);
+        co_await timer.sleep(20);
+        co_await timer.close();
+        peer.close();           // Not awaited: the reader is resumed first
+        accepted.close();
+        never.close();
+        co_await listener.close();
+    };
+
+    int first_status = 1;
+    network::spawn(accept_into(accepted, first_status));   // Takes the connection
+    network::spawn(read_one());
+    network::spawn(closer());
+    uv_run(&loop, UV_RUN_NOWAIT);
+    network::spawn(accept_into(never, accept_status));     // Nothing left to accept
+    uv_run(&loop, UV_RUN_DEFAULT);
+    EXPECT_EQ(first_status, 0);
+    EXPECT_EQ(read_status, UV_ECANCELED);
+    EXPECT_EQ(accept_status, UV_ECANCELED);
+    EXPECT_EQ(uv_loop_close(&loop), 0);
+}
+
+TEST(AsyncIoTest, EventWakesLoopFromAnotherThread) {
+    uv_loop_t loop;
+    uv_loop_init(&loop);
+    network::AsyncEvent event(&loop);
+    std::atomic<int> sent{0};
+    int woken = 0;
+    auto waiter = [&]() -> Task<void> {
+        while (co_await event.wait()) {
+            woken++;
+            if (sent.load() == 3) {
+                co_await event.close();
+            }
+        }
+    };
+    network::spawn(waiter());
+    std::thread notifier([&] {
+        for (int i = 0; i < 3; ++i) {
+            sent.fetch_add(1);
+            event.notify();
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+    });
+    uv_run(&loop, UV_RUN_DEFAULT);
+    notifier.join();
+    EXPECT_GE(woken, 1);
+    EXPECT_LE(woken, 3);
+    EXPECT_EQ(uv_loop_close(&loop), 0);
+}
+
+TEST(AsyncIoTest, SleepsOnTimerService) {
+    uv_loop_t loop;
+    uv_loop_init(&loop);
+    network::TimerService timers(&loop, 5);
+    std::vector<int> order;
+    auto sleeper = [&](int id, uint64_t ms) -> Task<void> {
+        co_await network::sleep(timers, ms);
+        order.push_back(id);
+        if (order.size() == 2) {
+            timers.close();
+        }
+    };
+    network::spawn(sleeper(2, 40));
+    network::spawn(sleeper(1, 10));
+    uv_run(&loop, UV_RUN_DEFAULT);
+    EXPECT_EQ(order, (std::vector<int>{1, 2}));
+    EXPECT_EQ(uv_loop_close(&loop), 0);
+}
@@ -0,0 +1,163 @@
+#include <gtest/gtest.h>
+#include <foundation/flat_hash_map.h>
+#include <foundation/symbol_table.h>
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+using foundation::FlatHashMap;
+
+TEST(FlatHashMapTest, InsertFindErase) {
+    FlatHashMap<uint32_t, int> map;
+    EXPECT_TRUE(map.empty());
+    EXPECT_EQ(map.find(7u), map.end());
+
+    auto [it, inserted] = map.try_emplace(7u, 70);
+    EXPECT_TRUE(inserted);
+    EXPECT_EQ(it->second, 70);
+    EXPECT_FALSE(map.try_emplace(7u, 71).second);
+    EXPECT_EQ(map[7u], 70);
+    map[8u] = 80;
+    EXPECT_EQ(map.size(), 2u);
+    EXPECT_TRUE(map.contains(8u));
+
+    EXPECT_EQ(map.erase(7u), 1u);
+    EXPECT_EQ(map.erase(7u), 0u);
+    EXPECT_FALSE(map.contains(7u));
+    EXPECT_EQ(map.size(), 1u);
+}
+
+TEST(FlatHashMapTest, MatchesUnorderedMapUnderRandomOperations) {
+    FlatHashMap<uint64_t, uint64_t> map;
+    std::unordered_map<uint64_t, uint64_t> reference;
+    std::mt19937_64 rng(42);
+    for (int i = 0; i < 200000; ++i) {
+        // A small key range forces collisions, tombstones and in-place rehashes
+        const uint64_t key = rng() % 5000;
+        switch (rng() % 3) {
+        case 0:
+            map[key] = i;
+            reference[key] = i;
+            break;
+        case 1:
+            EXPECT_EQ(map.erase(key), reference.erase(key));
+            break;
+        default: {
+            auto it = map.find(key);
+            auto ref = reference.find(key);
+            ASSERT_EQ(it == map.end(), ref == reference.end());
+            if (ref != reference.end()) {
+                EXPECT_EQ(it->second, ref->second);
+            }
+        }
+        }
+    }
+    ASSERT_EQ(map.size(), reference.size());
+    size_t visited = 0;
+    for (const auto& [key, value] : map) {
+        EXPECT_EQ(reference.at(key), value);
+        visited++;
+    }
+    EXPECT_EQ(visited, reference.size());
+}
+
+TEST(FlatHashMapTest, StringKeysLookUpByStringView) {
+    FlatHashMap<std::string, int> map;
+    map["AAPL"] = 1;
+    map.try_emplace(std::string_view("MSFT"), 2);
+    std::string_view key = "AAPL";
+    EXPECT_EQ(map.find(key)->second, 1);
+    EXPECT_EQ(map.find("MSFT")->second, 2);
+    EXPECT_FALSE(map.contains("GOOGL"));
+}
+
+TEST(FlatHashMapTest, MovesValuesAndDestroysThemOnce) {
+    auto counter = std::make_shared<int>(0);
+    {
+        FlatHashMap<int, std::shared_ptr<int>> map;
+        for (int i = 0; i < 1000; ++i) {
+            map[i] = counter;   // Grows several times
+        }
+        EXPECT_EQ(counter.use_count(), 1001);
+        for (int i = 0; i < 500; ++i) {
+            map.erase(i);
+        }
+        EXPECT_EQ(counter.use_count(), 501);
+
+        FlatHashMap<int, std::shared_ptr<int>> copy = map;
+        EXPECT_EQ(counter.use_count(), 1001);
+        FlatHashMap<int, std::shared_ptr<int>> moved = std::move(copy);
+        EXPECT_EQ(moved.size(), 500u);
+        map.clear();
+        EXPECT_EQ(counter.use_count(), 501);
+    }
+    EXPECT_EQ(counter.use_count(), 1);
+}
+
+TEST(FlatHashMapTest, ReserveAvoidsRehash) {
+    FlatHashMap<int, int> map;
+    map.reserve(1000);
+    const size_t capacity = map.capacity();
+    EXPECT_GE(capacity * 7 / 8, 1000u);
+    for (int i = 0; i < 1000; ++i) {
+        map[i] = i;
+    }
+    EXPECT_EQ(map.capacity(), capacity);
+}
+
+TEST(SymbolTableTest, InternsDenseStableIds) {
+    foundation::SymbolTable table;
+    EXPECT_EQ(table.find("AAPL"), foundation::NO_SYMBOL);
+    const foundation::SymbolId aapl = table.intern("AAPL");
+    const foundation::SymbolId msft = table.intern(std::string("MSFT"));
+    EXPECT_EQ(aapl, 0u);
+    EXPECT_EQ(msft, 1u);
+    EXPECT_EQ(table.intern("AAPL"), aapl);
+    EXPECT_EQ(table.find("MSFT"), msft);
+    EXPECT_EQ(table.name(aapl), "AAPL");
+    EXPECT_EQ(table.name(99), "");
+
+    // Views stay valid however many names follow
+    const std::string_view name = table.name(msft);
+    for (int i = 0; i < 20000; ++i) {
+        table.intern("SYM" + std::to_string(i));
+    }
+    EXPECT_EQ(name.data(), table.name(msft).data());
+    EXPECT_EQ(table.size(), 20002u);
+    EXPECT_EQ(table.name(table.find("SYM12345")), "SYM12345");
+}
+
+TEST(SymbolTableTest, ConcurrentInternAgreesOnIds) {
+    foundation::SymbolTable table;
+    constexpr int THREADS = 4;
+    constexpr int NAMES = 5000;
+    std::vector<std::vector<foundation::SymbolId>> ids(THREADS, std::vector<foundation::SymbolId>(NAMES));
+    std::vector<std::thread> threads;
+    for (int t = 0; t < THREADS; ++t) {
+        threads.emplace_back([&table, &ids, t] {
+            // Each thread walks the names in a different order
+            std::vector<int> order(NAMES);
+            std::iota(order.begin(), order.end(), 0);
+            std::shuffle(order.begin(), order.end(), std::mt19937(t));
+            for (int n : order) {
+                ids[t][n] = table.intern("N" + std::to_string(n));
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(table.size(), static_cast<size_t>(NAMES));
+    for (int n = 0; n < NAMES; ++n) {
+        for (int t = 1; t < THREADS; ++t) {
+            EXPECT_EQ(ids[t][n], ids[0][n]);
+        }
+        EXPECT_EQ(table.name(ids[0][n]), "N" + std::to_string(n));
+    }
+}
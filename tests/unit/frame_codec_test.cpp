@@ -0,0 +1,110 @@
+#include <gtest/gtest.h>
+#include <network/frame_codec.h>
+#include <network/framed_reader.h>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using network::FrameDecoder;
+using network::FrameMode;
+
+namespace {
+    std::string encoded(FrameMode mode, std::string_view body) {
+        return std::string(network::encode_frame(mode, body).view());
+    }
+
+    // Push `wire` through a FramedReader in `chunk`-byte reads
+    std::vector<std::string> read_in_chunks(FrameMode mode, const std::string& wire, size_t chunk,
+                                            bool* ok = nullptr) {
+        network::BufferPool pool;
+        network::FramedReader reader(pool, FrameDecoder(mode), 4096);
+        std::vector<std::string> frames;
+        bool good = true;
+        for (size_t pos = 0; pos < wire.size() && good; pos += chunk) {
+            uv_buf_t buf = reader.prepare();
+            size_t n = std::min({chunk, wire.size() - pos, static_cast<size_t>(buf.len)});
+            std::memcpy(buf.base, wire.data() + pos, n);
+            good = reader.commit(n, [&](std::string_view frame) { frames.emplace_back(frame); });
+            pos -= chunk - n;
+        }
+        if (ok) {
+            *ok = good;
+        }
+        return frames;
+    }
+}
+
+TEST(FrameCodecTest, FindDelimiterMatchesScalarScan) {
+    std::string text(100, 'a');
+    for (size_t at = 0; at < text.size(); ++at) {
+        std::string probe = text;
+        probe[at] = '\n';
+        EXPECT_EQ(network::find_delimiter(probe.data(), probe.size(), '\n'), at);
+    }
+    EXPECT_EQ(network::find_delimiter(text.data(), text.size(), '\n'), text.size());
+}
+
+TEST(FrameCodecTest, LengthPrefixedSplitsMergedFrames) {
+    std::string wire = encoded(FrameMode::LengthPrefixed, "hello") +
+                       encoded(FrameMode::LengthPrefixed, "") +
+                       encoded(FrameMode::LengthPrefixed, "world");
+    FrameDecoder decoder(FrameMode::LengthPrefixed);
+    std::vector<std::string> frames;
+    size_t consumed = decoder.decode(wire, [&](std::string_view f) { frames.emplace_back(f); });
+    EXPECT_EQ(consumed, wire.size());
+    EXPECT_EQ(frames, (std::vector<std::string>{"hello", "", "world"}));
+}
+
+TEST(FrameCodecTest, LengthPrefixedReassemblesAcrossReads) {
+    std::string big(3000, 'x');
+    std::string wire = encoded(FrameMode::LengthPrefixed, "one") +
+                       encoded(FrameMode::LengthPrefixed, big) +
+                       encoded(FrameMode::LengthPrefixed, "three");
+    for (size_t chunk : {1u, 3u, 7u, 1000u}) {
+        auto frames = read_in_chunks(FrameMode::LengthPrefixed, wire, chunk);
+        EXPECT_EQ(frames, (std::vector<std::string>{"one", big, "three"})) << "chunk " << chunk;
+    }
+}
+
+TEST(FrameCodecTest, FramesLargerThanReadSizeGrowTheBuffer) {
+    std::string big(20000, 'y');
+    auto frames = read_in_chunks(FrameMode::LengthPrefixed, encoded(FrameMode::LengthPrefixed, big), 1500);
+    ASSERT_EQ(frames.size(), 1u);
+    EXPECT_EQ(frames[0], big);
+}
+
+TEST(FrameCodecTest, NewlineModeStripsCarriageReturn) {
+    auto frames = read_in_chunks(FrameMode::NewlineDelimited, "hi\r\nthere\nparti", 4);
+    EXPECT_EQ(frames, (std::vector<std::string>{"hi", "there"}));
+}
+
+TEST(FrameCodecTest, OversizedFrameFailsTheStream) {
+    FrameDecoder decoder(FrameMode::LengthPrefixed, 16);
+    std::string wire = encoded(FrameMode::LengthPrefixed, std::string(17, 'z'));
+    int frames = 0;
+    decoder.decode(wire, [&](std::string_view) { frames++; });
+    EXPECT_TRUE(decoder.failed());
+    EXPECT_EQ(frames, 0);
+
+    FrameDecoder lines(FrameMode::NewlineDelimited, 8);
+    lines.decode(std::string_view("0123456789"), [&](std::string_view) { frames++; });
+    EXPECT_TRUE(lines.failed());
+}
+
+TEST(FrameCodecTest, FeedDecodesInPlaceAndKeepsPartialFrames) {
+    for (FrameMode mode : {FrameMode::LengthPrefixed, FrameMode::NewlineDelimited}) {
+        std::string big(6000, 'b');
+        std::string wire = encoded(mode, "one") + encoded(mode, big) + encoded(mode, "three");
+        for (size_t chunk : {1u, 5u, 4096u}) {
+            network::BufferPool pool;
+            network::FramedReader reader(pool, FrameDecoder(mode), 4096);
+            std::vector<std::string> frames;
+            for (size_t pos = 0; pos < wire.size(); pos += chunk) {
+                std::string piece = wire.substr(pos, chunk);  // Caller-owned, gone after feed()
+                ASSERT_TRUE(reader.feed(piece, [&](std::string_view f) { frames.emplace_back(f); }));
+            }
+            EXPECT_EQ(frames, (std::vector<std::string>{"one", big, "three"})) << "chunk " << chunk;
+            EXPECT_EQ(reader.buffered(), 0u);
+        }
+    }
+}
@@ -0,0 +1,90 @@
+#include <gtest/gtest.h>
+#include <foundation/clock.h>
+#include <foundation/histogram.h>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+using foundation::Histogram;
+
+TEST(HistogramTest, PercentilesWithinBucketPrecision) {
+    Histogram histogram;
+    for (uint64_t v = 1; v <= 100000; ++v) {
+        histogram.record(v);
+    }
+    EXPECT_EQ(histogram.count(), 100000u);
+    EXPECT_EQ(histogram.min(), 1u);
+    EXPECT_EQ(histogram.max(), 100000u);
+    EXPECT_DOUBLE_EQ(histogram.mean(), 50000.5);
+    for (double p : {50.0, 90.0, 99.0, 99.9}) {
+        const double exact = p * 1000;
+        EXPECT_GE(static_cast<double>(histogram.percentile(p)), exact);
+        EXPECT_LE(static_cast<double>(histogram.percentile(p)), exact * 1.016);
+    }
+    EXPECT_EQ(histogram.percentile(100), 100000u);
+
+    // Small values are exact, and the top of the range does not overflow
+    Histogram edges;
+    edges.record(0);
+    edges.record(63);
+    edges.record(UINT64_MAX);
+    EXPECT_EQ(edges.percentile(1), 0u);
+    EXPECT_EQ(edges.percentile(60), 63u);
+    EXPECT_EQ(edges.percentile(100), UINT64_MAX);
+}
+
+TEST(HistogramTest, MergeMatchesSingleHistogram) {
+    Histogram a, b, all;
+    for (uint64_t v = 0; v < 5000; ++v) {
+        (v % 3 ? a : b).record(v * 37);
+        all.record(v * 37);
+    }
+    a.merge(b);
+    EXPECT_EQ(a.count(), all.count());
+    EXPECT_EQ(a.summary().p99, all.summary().p99);
+    EXPECT_EQ(a.min(), all.min());
+
+    a.reset();
+    EXPECT_EQ(a.count(), 0u);
+    EXPECT_EQ(a.percentile(50), 0u);
+}
+
+TEST(LatencyRecorderTest, MergesThreadShards) {
+    foundation::LatencyRecorder recorder("test");
+    constexpr int THREADS = 4;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < THREADS; ++t) {
+        threads.emplace_back([&recorder, t] {
+            for (uint64_t v = 0; v < 10000; ++v) {
+                recorder.record(v + t * 10000);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    recorder.record(7);     // This thread's shard
+
+    const Histogram snapshot = recorder.snapshot();
+    EXPECT_EQ(snapshot.count(), THREADS * 10000u + 1);
+    EXPECT_EQ(snapshot.min(), 0u);
+    EXPECT_EQ(snapshot.max(), THREADS * 10000u - 1);
+    EXPECT_NEAR(static_cast<double>(snapshot.percentile(50)), 20000, 20000 * 0.016);
+}
+
+TEST(TscClockTest, TracksSteadyClock) {
+    const auto& calibration = foundation::TscClock::calibration();
+    EXPECT_GT(calibration.ticks_per_ns, 0);
+
+    const uint64_t start = foundation::TscClock::now_ns();
+    const auto steady_start = std::chrono::steady_clock::now();
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    const uint64_t elapsed = foundation::TscClock::now_ns() - start;
+    const auto steady_elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - steady_start).count();
+    EXPECT_NEAR(static_cast<double>(elapsed), static_cast<double>(steady_elapsed), steady_elapsed * 0.02);
+
+    foundation::Stopwatch stopwatch;
+    EXPECT_LT(stopwatch.elapsed_ns(), 1000000000u);
+}
@@ -0,0 +1,188 @@
+#include <gtest/gtest.h>
+#include <foundation/logger.h>
+#include <fmt/chrono.h>
+#include <fmt/ranges.h>
+#include <spdlog/sinks/ostream_sink.h>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <span>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct GridPoint {
+    int x;
+    int y;
+};
+
+template <>
+struct foundation::LogByValue<GridPoint> : std::true_type {};
+
+template <>
+struct fmt::formatter<GridPoint> : fmt::formatter<int> {
+    auto format(const GridPoint& p, fmt::format_context& ctx) const { return fmt::format_to(ctx.out(), "({}, {})", p.x, p.y); }
+};
+
+namespace {
+    // Routes spdlog's default logger into a string for the duration of a test
+    class LoggerTest : public ::testing::Test {
+    protected:
+        void SetUp() override {
+            previous_ = spdlog::default_logger();
+            auto sink = std::make_shared<spdlog::sinks::ostream_sink_mt>(out_);
+            sink->set_pattern("%l %v");
+            auto logger = std::make_shared<spdlog::logger>("logger_test", sink);
+            logger->set_level(spdlog::level::trace);
+            spdlog::set_default_logger(logger);
+        }
+
+        void TearDown() override {
+            foundation::stop_async_logger();
+            spdlog::set_default_logger(previous_);
+        }
+
+        std::vector<std::string> lines() const {
+            std::vector<std::string> result;
+            std::istringstream in(out_.str());
+            for (std::string line; std::getline(in, line);) {
+                result.push_back(line);
+            }
+            return result;
+        }
+
+        std::ostringstream out_;
+        std::shared_ptr<spdlog::logger> previous_;
+    };
+}
+
+TEST_F(LoggerTest, FormatsOnTheBackend) {
+    foundation::start_async_logger();
+    std::string temporary = "temp";
+    const char* missing = nullptr;
+    FLOG_INFO("int={} double={:.2f} str={} cstr={} null={}", 42, 1.5, temporary + "orary", "lit", missing);
+    temporary = "changed";
+    FLOG_WARN("char={} bool={} neg={}", 'x', true, -7);
+    foundation::flush_async_logger();
+
+    EXPECT_EQ(lines(), (std::vector<std::string>{
+                           "info int=42 double=1.50 str=temporary cstr=lit null=(null)",
+                           "warning char=x bool=true neg=-7",
+                       }));
+    EXPECT_EQ(foundation::async_logger_stats().dropped, 0u);
+}
+
+TEST_F(LoggerTest, CopiesOnlySelfContainedValues) {
+    foundation::start_async_logger();
+    std::vector<int> values{1, 2, 3};
+    FLOG_INFO("join={} span={} point={}", fmt::join(values, "+"), std::span<const int>(values), GridPoint{4, 5});
+    // Both views are trivially copyable; only their formatted text may reach the backend
+    values.assign({7, 8, 9});
+    foundation::flush_async_logger();
+
+    EXPECT_EQ(lines(), (std::vector<std::string>{"info join=1+2+3 span=[1, 2, 3] point=(4, 5)"}));
+}
+
+TEST_F(LoggerTest, FormatsOtherTypesWithTheirOwnSpec) {
+    foundation::start_async_logger();
+    std::vector<double> prices{1.25, 2.5};
+    FLOG_INFO("{{literal}} {1:%Q}s {0::.1f} {2:>6}", prices, std::chrono::seconds(90), std::string("right"));
+    // A dynamic width is not applied, but the arguments after it stay in place
+    FLOG_INFO("[{:>{}}] {}", std::chrono::seconds(3), 5, 7);
+    foundation::flush_async_logger();
+
+    EXPECT_EQ(lines(), (std::vector<std::string>{"info {literal} 90s [1.2, 2.5]  right", "info [3s] 7"}));
+}
+
+TEST_F(LoggerTest, LogsSynchronouslyWhenNotStarted) {
+    FLOG_ERROR("sync {}", 1);
+    EXPECT_EQ(lines(), std::vector<std::string>{"error sync 1"});
+}
+
+TEST_F(LoggerTest, RespectsRuntimeLevel) {
+    foundation::start_async_logger();
+    spdlog::default_logger()->set_level(spdlog::level::warn);
+    FLOG_INFO("hidden {}", 1);
+    FLOG_WARN("shown {}", 2);
+    foundation::flush_async_logger();
+    EXPECT_EQ(lines(), std::vector<std::string>{"warning shown 2"});
+}
+
+TEST_F(LoggerTest, RateLimitsEachCallSite) {
+    foundation::AsyncLoggerOptions options;
+    options.max_per_second = 3;
+    foundation::start_async_logger(options);
+    // Start at the beginning of a second so the burst falls in one window
+    std::this_thread::sleep_for(std::chrono::nanoseconds(1000000000 - foundation::detail::now_ns() % 1000000000));
+    for (int i = 0; i < 11; ++i) {
+        if (i == 10) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1100));
+        }
+        FLOG_INFO("repeated {}", i);
+    }
+    FLOG_INFO("other site");
+    foundation::flush_async_logger();
+
+    EXPECT_EQ(lines(), (std::vector<std::string>{
+                           "info repeated 0",
+                           "info repeated 1",
+                           "info repeated 2",
+                           "info repeated 10 (7 similar messages suppressed)",
+                           "info other site",
+                       }));
+}
+
+TEST_F(LoggerTest, MergesThreadsInTimestampOrder) {
+    foundation::start_async_logger();
+    constexpr int THREADS = 4;
+    constexpr int PER_THREAD = 1000;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < THREADS; ++t) {
+        threads.emplace_back([t] {
+            for (int i = 0; i < PER_THREAD; ++i) {
+                FLOG_DEBUG("thread {} line {}", t, i);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    foundation::flush_async_logger();
+
+    const auto output = lines();
+    ASSERT_EQ(output.size(), static_cast<size_t>(THREADS * PER_THREAD));
+    std::vector<int> next(THREADS, 0);
+    for (const auto& line : output) {
+        int t, i;
+        ASSERT_EQ(std::sscanf(line.c_str(), "debug thread %d line %d", &t, &i), 2);
+        EXPECT_EQ(i, next[t]++);
+    }
+}
+
+TEST_F(LoggerTest, KeepsRecordsLoggedWhileStopping) {
+    foundation::start_async_logger();
+    constexpr int THREADS = 4;
+    constexpr int PER_THREAD = 2000;
+    std::atomic<int> started{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < THREADS; ++t) {
+        threads.emplace_back([t, &started] {
+            started.fetch_add(1);
+            for (int i = 0; i < PER_THREAD; ++i) {
+                FLOG_DEBUG("thread {} line {}", t, i);
+            }
+        });
+    }
+    while (started.load() < THREADS) {
+        std::this_thread::yield();
+    }
+    // Each record is either drained by the last pass or logged synchronously
+    foundation::stop_async_logger();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_EQ(lines().size() + foundation::async_logger_stats().dropped, static_cast<size_t>(THREADS * PER_THREAD));
+}
@@ -0,0 +1,190 @@
+#include <gtest/gtest.h>
+#include <network/frame_codec.h>
+#include <network/message_log.h>
+#include <uv.h>
+#include <csignal>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+
+using network::FrameMode;
+using network::MessageLog;
+using network::MessageLogOptions;
+using network::SharedPayload;
+
+namespace {
+    class MessageLogTest : public ::testing::Test {
+    protected:
+        void SetUp() override {
+            dir_ = std::filesystem::temp_directory_path() /
+                   ("message_log_test_" + std::to_string(::testing::UnitTest::GetInstance()->random_seed()) + "_" +
+                    ::testing::UnitTest::GetInstance()->current_test_info()->name());
+            std::filesystem::remove_all(dir_);
+        }
+        void TearDown() override { std::filesystem::remove_all(dir_); }
+
+        static std::string frame(const std::string& body) {
+            return std::string(network::encode_frame(FrameMode::LengthPrefixed, body).view());
+        }
+
+        // Decode every frame in `payloads` back into bodies
+        static std::vector<std::string> bodies(const std::vector<SharedPayload>& payloads) {
+            std::vector<std::string> out;
+            for (const auto& payload : payloads) {
+                network::FrameDecoder decoder(FrameMode::LengthPrefixed);
+                size_t used = decoder.decode(std::span<const char>(payload.data(), payload.size()),
+                                             [&](std::string_view body) { out.emplace_back(body); });
+                EXPECT_EQ(used, payload.size());
+            }
+            return out;
+        }
+
+        std::filesystem::path dir_;
+    };
+}
+
+TEST_F(MessageLogTest, AppendAndReadBack) {
+    MessageLog log(dir_.string());
+    ASSERT_EQ(log.open(), 0);
+    EXPECT_EQ(log.size(), 0u);
+
+    for (int i = 0; i < 5; ++i) {
+        uint64_t seq = 99;
+        ASSERT_EQ(log.append(frame("m" + std::to_string(i)), &seq), 0);
+        EXPECT_EQ(seq, static_cast<uint64_t>(i));
+    }
+
+    std::vector<SharedPayload> out;
+    EXPECT_EQ(log.read(2, 1 << 20, out), 3u);
+    ASSERT_EQ(out.size(), 1u);  // One contiguous view for one segment
+    EXPECT_EQ(bodies(out), (std::vector<std::string>{"m2", "m3", "m4"}));
+
+    out.clear();
+    EXPECT_EQ(log.read_last(2, 1 << 20, out), 2u);
+    EXPECT_EQ(bodies(out), (std::vector<std::string>{"m3", "m4"}));
+}
+
+TEST_F(MessageLogTest, ReadSpansSegmentsAndHonoursByteBudget) {
+    MessageLogOptions options;
+    options.segment_bytes = 64;
+    MessageLog log(dir_.string(), options);
+    ASSERT_EQ(log.open(), 0);
+
+    std::vector<std::string> expected;
+    for (int i = 0; i < 20; ++i) {
+        expected.push_back("message-" + std::to_string(i));
+        ASSERT_EQ(log.append(frame(expected.back())), 0);
+    }
+    EXPECT_GT(log.segment_count(), 1u);
+
+    std::vector<SharedPayload> out;
+    EXPECT_EQ(log.read(0, 1 << 20, out), 20u);
+    EXPECT_EQ(out.size(), log.segment_count());
+    EXPECT_EQ(bodies(out), expected);
+
+    // 14-byte frames: a 50-byte budget keeps the newest three
+    out.clear();
+    EXPECT_EQ(log.read(0, 50, out), 3u);
+    EXPECT_EQ(bodies(out), std::vector<std::string>(expected.end() - 3, expected.end()));
+}
+
+TEST_F(MessageLogTest, ReopenRecoversIndexAndDropsTornTail) {
+    {
+        MessageLog log(dir_.string());
+        ASSERT_EQ(log.open(), 0);
+        for (int i = 0; i < 3; ++i) {
+            ASSERT_EQ(log.append(frame("kept" + std::to_string(i))), 0);
+        }
+    }
+    // Simulate a crash midway through a record
+    auto segment = std::filesystem::directory_iterator(dir_)->path();
+    {
+        std::ofstream tail(segment, std::ios::binary | std::ios::app);
+        tail << frame("torn").substr(0, 6);
+    }
+
+    MessageLog log(dir_.string());
+    ASSERT_EQ(log.open(), 0);
+    EXPECT_EQ(log.next_seq(), 3u);
+    uint64_t seq = 0;
+    ASSERT_EQ(log.append(frame("after"), &seq), 0);
+    EXPECT_EQ(seq, 3u);
+
+    std::vector<SharedPayload> out;
+    log.read(0, 1 << 20, out);
+    EXPECT_EQ(bodies(out), (std::vector<std::string>{"kept0", "kept1", "kept2", "after"}));
+}
+
+TEST_F(MessageLogTest, ReopenStopsAtZeroFilledTail) {
+    for (FrameMode mode : {FrameMode::LengthPrefixed, FrameMode::NewlineDelimited}) {
+        std::filesystem::remove_all(dir_);
+        MessageLogOptions options;
+        options.framing = mode;
+        {
+            MessageLog log(dir_.string(), options);
+            ASSERT_EQ(log.open(), 0);
+            for (int i = 0; i < 3; ++i) {
+                ASSERT_EQ(log.append(network::encode_frame(mode, "kept" + std::to_string(i)).view()), 0);
+            }
+        }
+        // A crash leaves the rest of the sparse segment as zeros
+        auto segment = std::filesystem::directory_iterator(dir_)->path();
+        const auto used = std::filesystem::file_size(segment);
+        std::filesystem::resize_file(segment, 1 << 20);
+
+        MessageLog log(dir_.string(), options);
+        ASSERT_EQ(log.open(), 0);
+        EXPECT_EQ(log.next_seq(), 3u);
+        EXPECT_EQ(log.bytes(), used);
+        EXPECT_EQ(std::filesystem::file_size(segment), used);
+    }
+}
+
+#ifndef _WIN32
+TEST_F(MessageLogTest, RollFailsWhenTheSegmentCannotBeAllocated) {
+    MessageLogOptions options;
+    options.segment_bytes = 1 << 20;
+    MessageLog log(dir_.string(), options);
+    ASSERT_EQ(log.open(), 0);
+
+    // A file size limit below the segment size stands in for a full disk
+    rlimit previous{};
+    ASSERT_EQ(getrlimit(RLIMIT_FSIZE, &previous), 0);
+    rlimit limited = previous;
+    limited.rlim_cur = 64 * 1024;
+    const auto handler = std::signal(SIGXFSZ, SIG_IGN);
+    ASSERT_EQ(setrlimit(RLIMIT_FSIZE, &limited), 0);
+    const int r = log.append(frame("no room"));
+    setrlimit(RLIMIT_FSIZE, &previous);
+    std::signal(SIGXFSZ, handler);
+
+    EXPECT_EQ(r, UV_EFBIG);
+    EXPECT_EQ(log.size(), 0u);
+    uint64_t seq = 99;
+    ASSERT_EQ(log.append(frame("room again"), &seq), 0);
+    EXPECT_EQ(seq, 0u);
+}
+#endif
+
+TEST_F(MessageLogTest, RetentionDropsOldestSegmentsButViewsStayValid) {
+    MessageLogOptions options;
+    options.segment_bytes = 32;
+    options.retain_bytes = 64;
+    MessageLog log(dir_.string(), options);
+    ASSERT_EQ(log.open(), 0);
+
+    ASSERT_EQ(log.append(frame("first-segment-record")), 0);
+    std::vector<SharedPayload> held;
+    log.read(0, 1 << 20, held);
+
+    for (int i = 0; i < 20; ++i) {
+        ASSERT_EQ(log.append(frame("filler-" + std::to_string(i))), 0);
+    }
+    EXPECT_GT(log.first_seq(), 0u);
+    EXPECT_LE(log.bytes(), 64u + 32u);
+    EXPECT_EQ(bodies(held), std::vector<std::string>{"first-segment-record"});
+}
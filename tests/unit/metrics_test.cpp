@@ -0,0 +1,135 @@
+#include <gtest/gtest.h>
+#include <foundation/metrics.h>
+#include <network/http_listener.h>
+#include <uv.h>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+using foundation::MetricsRegistry;
+
+TEST(MetricsTest, CountersAndGaugesSumThreadShards) {
+    MetricsRegistry registry;
+    foundation::Counter& counter = registry.counter("events_total", "Events");
+    foundation::Gauge& gauge = registry.gauge("depth", "Depth");
+    constexpr int THREADS = 4;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < THREADS; ++t) {
+        threads.emplace_back([&counter, &gauge, t] {
+            for (int i = 0; i < 10000; ++i) {
+                counter.inc();
+            }
+            gauge.add(t + 5);
+            gauge.add(-5);
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    counter.inc(7);
+    gauge.set(100);     // Replaces only this thread's share
+
+    EXPECT_EQ(counter.value(), THREADS * 10000u + 7);
+    EXPECT_EQ(gauge.value(), 0 + 1 + 2 + 3 + 100);
+}
+
+TEST(MetricsTest, RegistrationIsIdempotent) {
+    MetricsRegistry registry;
+    foundation::Counter& a = registry.counter("requests_total", "Requests", {{"code", "200"}});
+    foundation::Counter& b = registry.counter("requests_total", "Requests", {{"code", "200"}});
+    foundation::Counter& c = registry.counter("requests_total", "Requests", {{"code", "500"}});
+    EXPECT_EQ(&a, &b);
+    EXPECT_NE(&a, &c);
+
+    // A clashing type still works but is not exported
+    foundation::Gauge& clash = registry.gauge("requests_total", "Oops");
+    clash.add(3);
+    EXPECT_EQ(clash.value(), 3);
+    EXPECT_EQ(registry.render_prometheus().find("gauge"), std::string::npos);
+}
+
+TEST(MetricsTest, RendersPrometheusText) {
+    MetricsRegistry registry;
+    registry.counter("requests_total", "Requests\nserved", {{"path", "/a\"b"}}).inc(3);
+    registry.gauge("queue_depth", "Depth").add(-2);
+    foundation::LatencyRecorder& latency = registry.histogram("latency_seconds", "Latency");
+    latency.record(500);            // 0.5us
+    latency.record(2'000'000);      // 2ms
+    latency.record(20'000'000'000); // 20s, above every bound
+
+    const std::string text = registry.render_prometheus();
+    EXPECT_NE(text.find("# HELP requests_total Requests\\nserved\n# TYPE requests_total counter\n"
+                        "requests_total{path=\"/a\\\"b\"} 3\n"),
+              std::string::npos);
+    EXPECT_NE(text.find("# TYPE queue_depth gauge\nqueue_depth -2\n"), std::string::npos);
+    EXPECT_NE(text.find("# TYPE latency_seconds histogram\n"), std::string::npos);
+    EXPECT_NE(text.find("latency_seconds_bucket{le=\"1e-06\"} 1\n"), std::string::npos);
+    EXPECT_NE(text.find("latency_seconds_bucket{le=\"0.001\"} 1\n"), std::string::npos);
+    EXPECT_NE(text.find("latency_seconds_bucket{le=\"0.0025\"} 2\n"), std::string::npos);
+    EXPECT_NE(text.find("latency_seconds_bucket{le=\"10\"} 2\n"), std::string::npos);
+    EXPECT_NE(text.find("latency_seconds_bucket{le=\"+Inf\"} 3\n"), std::string::npos);
+    EXPECT_NE(text.find("latency_seconds_count 3\n"), std::string::npos);
+    EXPECT_NE(text.find("latency_seconds_sum 20.0020005\n"), std::string::npos);
+}
+
+TEST(HttpListenerTest, ServesOneRequestPerConnection) {
+    uv_loop_t loop;
+    uv_loop_init(&loop);
+    network::HttpListener listener(&loop, [](std::string_view method, std::string_view path) {
+        if (path != "/metrics") {
+            return network::HttpResponse{404, "text/plain", "missing\n"};
+        }
+        return network::HttpResponse{200, "text/plain", std::string(method) + " ok\n"};
+    });
+    ASSERT_EQ(listener.listen("127.0.0.1", 0), 0);
+
+    struct Client {
+        uv_tcp_t handle;
+        uv_connect_t connect;
+        uv_write_t write;
+        std::string request;
+        std::string response;
+        char buffer[1024];
+        network::HttpListener* listener;
+    } client;
+    client.request = "GET /metrics?x=1 HTTP/1.1\r\nHost: localhost\r\n\r\n";
+    client.listener = &listener;
+    client.handle.data = &client;
+    client.connect.data = &client;
+
+    sockaddr_in addr{};
+    uv_ip4_addr("127.0.0.1", listener.bound_port(), &addr);
+    uv_tcp_init(&loop, &client.handle);
+    uv_tcp_connect(&client.connect, &client.handle, reinterpret_cast<const sockaddr*>(&addr),
+                   [](uv_connect_t* req, int status) {
+                       ASSERT_EQ(status, 0);
+                       auto* client = static_cast<Client*>(req->data);
+                       auto* stream = reinterpret_cast<uv_stream_t*>(&client->handle);
+                       uv_buf_t buf = uv_buf_init(client->request.data(), static_cast<unsigned int>(client->request.size()));
+                       uv_write(&client->write, stream, &buf, 1, [](uv_write_t*, int) {});
+                       uv_read_start(
+                           stream,
+                           [](uv_handle_t* handle, size_t, uv_buf_t* buf) {
+                               auto* client = static_cast<Client*>(handle->data);
+                               *buf = uv_buf_init(client->buffer, sizeof(client->buffer));
+                           },
+                           [](uv_stream_t* stream, ssize_t nread, const uv_buf_t* buf) {
+                               auto* client = static_cast<Client*>(stream->data);
+                               if (nread > 0) {
+                                   client->response.append(buf->base, static_cast<size_t>(nread));
+                               } else if (nread < 0) {
+                                   // The server closes after responding
+                                   uv_close(reinterpret_cast<uv_handle_t*>(stream), nullptr);
+                                   client->listener->close();
+                               }
+                           });
+                   });
+    uv_run(&loop, UV_RUN_DEFAULT);
+
+    EXPECT_EQ(client.response.rfind("HTTP/1.1 200 OK\r\n", 0), 0u);
+    EXPECT_NE(client.response.find("Content-Length: 7\r\n"), std::string::npos);
+    EXPECT_NE(client.response.find("Connection: close\r\n"), std::string::npos);
+    EXPECT_EQ(client.response.substr(client.response.size() - 7), "GET ok\n");
+    EXPECT_EQ(uv_loop_close(&loop), 0);
+}
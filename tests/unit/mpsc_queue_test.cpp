@@ -0,0 +1,115 @@
+#include <gtest/gtest.h>
+#include <network/async_queue.h>
+#include <network/mpsc_queue.h>
+#include <uv.h>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace {
+    struct Item : network::MpscNode {
+        int producer;
+        int seq;
+    };
+}
+
+TEST(MpscQueueTest, FifoSingleThread) {
+    network::MpscQueue<Item> queue;
+    EXPECT_TRUE(queue.empty());
+    EXPECT_EQ(queue.pop(), nullptr);
+
+    Item items[3];
+    for (int i = 0; i < 3; ++i) {
+        items[i].seq = i;
+        queue.push(&items[i]);
+    }
+    EXPECT_FALSE(queue.empty());
+    for (int i = 0; i < 3; ++i) {
+        Item* item = queue.pop();
+        ASSERT_NE(item, nullptr);
+        EXPECT_EQ(item->seq, i);
+    }
+    EXPECT_EQ(queue.pop(), nullptr);
+    EXPECT_TRUE(queue.empty());
+}
+
+TEST(MpscQueueTest, ManyProducersKeepPerProducerOrder) {
+    constexpr int PRODUCERS = 4;
+    constexpr int PER_PRODUCER = 20000;
+
+    network::MpscQueue<Item> queue;
+    std::vector<Item> storage(PRODUCERS * PER_PRODUCER);
+
+    std::vector<std::thread> producers;
+    for (int p = 0; p < PRODUCERS; ++p) {
+        producers.emplace_back([&, p] {
+            for (int i = 0; i < PER_PRODUCER; ++i) {
+                Item& item = storage[p * PER_PRODUCER + i];
+                item.producer = p;
+                item.seq = i;
+                queue.push(&item);
+            }
+        });
+    }
+
+    std::vector<int> next(PRODUCERS, 0);
+    int received = 0;
+    while (received < PRODUCERS * PER_PRODUCER) {
+        Item* item = queue.pop();
+        if (!item) {
+            std::this_thread::yield();
+            continue;
+        }
+        ASSERT_EQ(item->seq, next[item->producer]);
+        next[item->producer]++;
+        received++;
+    }
+
+    for (auto& t : producers) {
+        t.join();
+    }
+    EXPECT_EQ(queue.pop(), nullptr);
+}
+
+TEST(AsyncQueueTest, DrainsCrossThreadPostsOnLoopThread) {
+    constexpr int PRODUCERS = 4;
+    constexpr int PER_PRODUCER = 5000;
+
+    uv_loop_t loop;
+    uv_loop_init(&loop);
+    const auto loop_thread = std::this_thread::get_id();
+
+    std::vector<int> next(PRODUCERS, 0);
+    int received = 0;
+    bool off_thread = false;
+    network::AsyncQueue<Item> mailbox(&loop, [&](std::unique_ptr<Item> item) {
+        off_thread |= std::this_thread::get_id() != loop_thread;
+        EXPECT_EQ(item->seq, next[item->producer]);
+        next[item->producer]++;
+        if (++received == PRODUCERS * PER_PRODUCER) {
+            uv_stop(&loop);
+        }
+    }, 64);
+
+    std::vector<std::thread> producers;
+    for (int p = 0; p < PRODUCERS; ++p) {
+        producers.emplace_back([&, p] {
+            for (int i = 0; i < PER_PRODUCER; ++i) {
+                auto item = std::make_unique<Item>();
+                item->producer = p;
+                item->seq = i;
+                mailbox.post(std::move(item));
+            }
+        });
+    }
+
+    uv_run(&loop, UV_RUN_DEFAULT);
+    for (auto& t : producers) {
+        t.join();
+    }
+    mailbox.close();
+    uv_run(&loop, UV_RUN_DEFAULT);
+    EXPECT_EQ(received, PRODUCERS * PER_PRODUCER);
+    EXPECT_FALSE(off_thread);
+    EXPECT_EQ(uv_loop_close(&loop), 0);
+}
@@ -0,0 +1,106 @@
+#include <gtest/gtest.h>
+#include <network/outbound_queue.h>
+#include <string>
+
+using network::OutboundQueue;
+using network::SharedPayload;
+using network::SlowConsumerPolicy;
+using Admission = network::OutboundQueue::Admission;
+
+namespace {
+    SharedPayload bytes(size_t n, char fill = 'x') {
+        return SharedPayload::copy_of(std::string(n, fill));
+    }
+
+    std::string front(const OutboundQueue& queue) {
+        uv_buf_t buf;
+        if (queue.gather(&buf, 1) == 0) {
+            return {};
+        }
+        return std::string(buf.base, buf.len);
+    }
+}
+
+TEST(OutboundQueueTest, ConsumeTracksPartialWrites) {
+    OutboundQueue queue;
+    queue.push(SharedPayload::copy_of("hello"));
+    queue.push(SharedPayload::copy_of("world"));
+    EXPECT_EQ(queue.pending_bytes(), 10u);
+
+    queue.consume(7);
+    EXPECT_EQ(queue.pending_messages(), 1u);
+    EXPECT_EQ(front(queue), "rld");
+    EXPECT_EQ(queue.stats().messages_sent, 1u);
+
+    SharedPayload taken[1];
+    EXPECT_EQ(queue.take(1, taken), 3u);
+    EXPECT_TRUE(queue.empty());
+    EXPECT_EQ(queue.queued_bytes(), 3u);
+    queue.complete(3);
+    EXPECT_EQ(queue.queued_bytes(), 0u);
+    EXPECT_EQ(queue.stats().bytes_sent, 10u);
+}
+
+TEST(OutboundQueueTest, DisconnectPolicyEvictsAtHighWatermark) {
+    OutboundQueue queue({.high_watermark = 100, .low_watermark = 20,
+                         .policy = SlowConsumerPolicy::Disconnect});
+    EXPECT_EQ(queue.push(bytes(60)), Admission::Queued);
+    EXPECT_EQ(queue.push(bytes(30)), Admission::Queued);
+    EXPECT_EQ(queue.push(bytes(30)), Admission::Evict);
+    EXPECT_EQ(queue.stats().messages_dropped, 1u);
+}
+
+TEST(OutboundQueueTest, DropOldestMakesRoom) {
+    OutboundQueue queue({.high_watermark = 100, .low_watermark = 20,
+                         .policy = SlowConsumerPolicy::DropOldest});
+    queue.push(bytes(40, 'a'));
+    queue.push(bytes(40, 'b'));
+    EXPECT_EQ(queue.push(bytes(40, 'c')), Admission::Queued);
+    EXPECT_EQ(queue.pending_messages(), 2u);
+    EXPECT_EQ(front(queue), std::string(40, 'b'));
+    EXPECT_EQ(queue.stats().messages_dropped, 1u);
+    EXPECT_EQ(queue.stats().bytes_dropped, 40u);
+}
+
+TEST(OutboundQueueTest, CoalesceReplacesSameKeyWhileCongested) {
+    OutboundQueue queue({.high_watermark = 100, .low_watermark = 20,
+                         .policy = SlowConsumerPolicy::Coalesce});
+    queue.push(bytes(50, 'a'), 7);
+    queue.push(bytes(50, 'b'));
+    EXPECT_TRUE(queue.congested());
+
+    EXPECT_EQ(queue.push(bytes(50, 'c'), 7), Admission::Coalesced);
+    EXPECT_EQ(front(queue), std::string(50, 'c'));
+    EXPECT_EQ(queue.push(bytes(10, 'd')), Admission::Dropped);
+    EXPECT_EQ(queue.pending_messages(), 2u);
+    EXPECT_EQ(queue.stats().messages_coalesced, 1u);
+}
+
+TEST(OutboundQueueTest, CongestionHasHysteresis) {
+    OutboundQueue queue({.high_watermark = 100, .low_watermark = 20,
+                         .policy = SlowConsumerPolicy::DropOldest});
+    for (int i = 0; i < 10; ++i) {
+        queue.push(bytes(10));
+    }
+    EXPECT_TRUE(queue.congested());
+    EXPECT_EQ(queue.stats().congestion_events, 1u);
+
+    queue.consume(50);
+    EXPECT_TRUE(queue.congested());
+    queue.consume(30);
+    EXPECT_FALSE(queue.congested());
+}
+
+TEST(OutboundQueueTest, RingGrowsAndWrapsInOrder) {
+    OutboundQueue queue({.high_watermark = 1 << 20});
+    for (int round = 0; round < 3; ++round) {
+        for (int i = 0; i < 40; ++i) {
+            queue.push(SharedPayload::copy_of(std::to_string(i)));
+        }
+        for (int i = 0; i < 40; ++i) {
+            ASSERT_EQ(front(queue), std::to_string(i));
+            queue.consume(std::to_string(i).size());
+        }
+    }
+    EXPECT_TRUE(queue.empty());
+}
@@ -0,0 +1,113 @@
+#include <gtest/gtest.h>
+#include <network/search_index.h>
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+using network::SearchIndex;
+using network::SearchIndexOptions;
+
+namespace {
+    std::string message_text(uint64_t n) {
+        std::string text = "message " + std::to_string(n);
+        if (n % 2 == 0) {
+            text += " even";
+        }
+        if (n % 10 == 0) {
+            text += " tens";
+        }
+        return text;
+    }
+}
+
+TEST(SearchIndexTest, TokenizesLowercasedWords) {
+    std::vector<std::string> terms;
+    SearchIndex::tokenize("[#lobby] [User7]: Hello,  WORLD! caf\xc3\xa9 x", [&](std::string_view t) {
+        terms.emplace_back(t);
+    });
+    EXPECT_EQ(terms, (std::vector<std::string>{"lobby", "user7", "hello", "world", "caf\xc3\xa9", "x"}));
+
+    terms.clear();
+    SearchIndex::tokenize(std::string(100, 'a'), [&](std::string_view t) { terms.emplace_back(t); });
+    ASSERT_EQ(terms.size(), 1u);
+    EXPECT_EQ(terms[0].size(), SearchIndex::MAX_TERM);
+}
+
+TEST(SearchIndexTest, MatchesAllTermsNewestFirst) {
+    SearchIndex index;
+    index.add(1, "deploy the build");
+    index.add(2, "the build is green");
+    index.add(3, "Build failed on deploy");
+    index.add(4, "lunch?");
+
+    EXPECT_EQ(index.search("build", 10), (std::vector<uint64_t>{3, 2, 1}));
+    EXPECT_EQ(index.search("DEPLOY build", 10), (std::vector<uint64_t>{3, 1}));
+    EXPECT_EQ(index.search("build", 2), (std::vector<uint64_t>{3, 2}));
+    EXPECT_TRUE(index.search("deploy lunch", 10).empty());
+    EXPECT_TRUE(index.search("missing", 10).empty());
+    EXPECT_TRUE(index.search("  !! ", 10).empty());
+
+    index.add(4, "build again");     // Ids must increase
+    EXPECT_EQ(index.document_count(), 4u);
+}
+
+// Results must not change as segments are sealed, encoded and merged
+TEST(SearchIndexTest, SameResultsAcrossSealingAndMerging) {
+    SearchIndexOptions options;
+    options.seal_docs = 8;
+    options.merge_fanin = 2;
+    SearchIndex index(options);
+
+    std::vector<uint64_t> even;
+    std::vector<uint64_t> tens;
+    for (uint64_t doc = 0; doc < 500; ++doc) {
+        index.add(doc * 3, message_text(doc));
+        if (doc % 2 == 0) {
+            even.insert(even.begin(), doc * 3);
+        }
+        if (doc % 10 == 0) {
+            tens.insert(tens.begin(), doc * 3);
+        }
+    }
+    auto check = [&] {
+        EXPECT_EQ(index.search("even", 1000), even);
+        EXPECT_EQ(index.search("tens even", 1000), tens);
+        EXPECT_EQ(index.search("message", 5), (std::vector<uint64_t>{1497, 1494, 1491, 1488, 1485}));
+    };
+    check();
+    ASSERT_TRUE(index.needs_compaction());
+    while (index.compact()) {
+    }
+    EXPECT_FALSE(index.needs_compaction());
+    EXPECT_LT(index.segment_count(), 10u);
+    EXPECT_GT(index.memory_bytes(), 0u);
+    check();
+}
+
+TEST(SearchIndexTest, CompactsWhileIngestingAndSearching) {
+    SearchIndexOptions options;
+    options.seal_docs = 16;
+    SearchIndex index(options);
+    std::atomic<bool> done{false};
+    std::thread compactor([&] {
+        while (!done.load()) {
+            if (!index.compact()) {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    for (uint64_t doc = 1; doc <= 5000; ++doc) {
+        index.add(doc, doc % 7 == 0 ? "needle hay" : "hay");
+        if (doc % 100 == 0) {
+            auto found = index.search("needle", SIZE_MAX);
+            ASSERT_EQ(found.size(), doc / 7);
+            EXPECT_EQ(found.front(), doc - doc % 7);
+        }
+    }
+    done = true;
+    compactor.join();
+    EXPECT_EQ(index.search("needle hay", SIZE_MAX).size(), 5000u / 7);
+}
@@ -0,0 +1,85 @@
+#include <gtest/gtest.h>
+#include <network/shared_payload.h>
+#include <network/write_request_pool.h>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using network::SharedPayload;
+
+TEST(SharedPayloadTest, CopiesShareOneBlock) {
+    SharedPayload payload = SharedPayload::copy_of("hello");
+    EXPECT_EQ(payload.view(), "hello");
+    EXPECT_EQ(payload.use_count(), 1u);
+
+    SharedPayload copy = payload;
+    EXPECT_EQ(copy.data(), payload.data());
+    EXPECT_EQ(payload.use_count(), 2u);
+
+    SharedPayload moved = std::move(copy);
+    EXPECT_FALSE(copy);
+    EXPECT_EQ(payload.use_count(), 2u);
+
+    moved.reset();
+    EXPECT_EQ(payload.use_count(), 1u);
+}
+
+TEST(SharedPayloadTest, ViewBorrowsAndKeepsOwnerAlive) {
+    auto owner = std::make_shared<std::string>("mapped bytes");
+    std::weak_ptr<std::string> watch = owner;
+
+    SharedPayload view = SharedPayload::view_of(owner, std::string_view(*owner).substr(7));
+    EXPECT_EQ(view.data(), owner->data() + 7);
+    EXPECT_EQ(view.view(), "bytes");
+
+    owner.reset();
+    SharedPayload copy = view;
+    view.reset();
+    EXPECT_FALSE(watch.expired());
+    EXPECT_EQ(copy.view(), "bytes");
+    copy.reset();
+    EXPECT_TRUE(watch.expired());
+}
+
+TEST(SharedPayloadTest, ReleasedFromManyThreads) {
+    SharedPayload payload = SharedPayload::copy_of("fan-out");
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([copy = payload]() mutable {
+            for (int i = 0; i < 10000; ++i) {
+                SharedPayload inner = copy;
+                ASSERT_EQ(inner.view(), "fan-out");
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    EXPECT_EQ(payload.use_count(), 1u);
+}
+
+TEST(WriteRequestPoolTest, RecyclesRequestsAndDropsPayloads) {
+    network::WriteRequestPool pool(4);
+    SharedPayload payload = SharedPayload::copy_of("x");
+
+    std::vector<network::WriteRequest*> requests;
+    for (int i = 0; i < 4; ++i) {
+        requests.push_back(pool.acquire());
+        requests.back()->payloads[0] = payload;
+        requests.back()->payload_count = 1;
+    }
+    EXPECT_EQ(pool.upstream_allocations(), 1u);
+    EXPECT_EQ(payload.use_count(), 5u);
+
+    for (auto* request : requests) {
+        pool.release(request);
+    }
+    EXPECT_EQ(payload.use_count(), 1u);
+    EXPECT_EQ(pool.in_use(), 0u);
+
+    for (int i = 0; i < 100; ++i) {
+        pool.release(pool.acquire());
+    }
+    EXPECT_EQ(pool.upstream_allocations(), 1u);
+}
@@ -0,0 +1,92 @@
+#include <gtest/gtest.h>
+#include <network/slot_map.h>
+#include <memory>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+using network::SlotHandle;
+using network::SlotMap;
+
+TEST(SlotMapTest, InsertLookupErase) {
+    SlotMap<int> map;
+    SlotHandle a = map.insert(1);
+    SlotHandle b = map.insert(2);
+    EXPECT_NE(a, b);
+    EXPECT_EQ(map.size(), 2u);
+    EXPECT_EQ(*map.get(a), 1);
+    EXPECT_EQ(*map.get(b), 2);
+
+    EXPECT_TRUE(map.erase(a));
+    EXPECT_FALSE(map.erase(a));
+    EXPECT_EQ(map.get(a), nullptr);
+    EXPECT_EQ(*map.get(b), 2);
+    EXPECT_EQ(map.size(), 1u);
+    EXPECT_EQ(map.get(SlotHandle{}), nullptr);
+}
+
+TEST(SlotMapTest, StaleHandleDoesNotResolveAfterSlotReuse) {
+    SlotMap<int> map;
+    SlotHandle old_handle = map.insert(1);
+    map.erase(old_handle);
+    SlotHandle new_handle = map.insert(2);
+
+    EXPECT_EQ(new_handle.index(), old_handle.index());
+    EXPECT_NE(new_handle.generation(), old_handle.generation());
+    EXPECT_EQ(map.get(old_handle), nullptr);
+    EXPECT_FALSE(map.erase(old_handle));
+    EXPECT_EQ(*map.get(new_handle), 2);
+    EXPECT_EQ(SlotHandle::from_bits(new_handle.bits()), new_handle);
+}
+
+TEST(SlotMapTest, ValuesStayDenseAcrossErase) {
+    SlotMap<std::unique_ptr<int>> map;
+    std::vector<SlotHandle> handles;
+    for (int i = 0; i < 5; ++i) {
+        handles.push_back(map.emplace(std::make_unique<int>(i)));
+    }
+    map.erase(handles[1]);
+    map.erase(handles[3]);
+
+    ASSERT_EQ(map.values().size(), 3u);
+    int sum = 0;
+    for (auto& value : map) {
+        sum += *value;
+    }
+    EXPECT_EQ(sum, 0 + 2 + 4);
+    for (size_t i = 0; i < map.size(); ++i) {
+        EXPECT_EQ(map.get(map.handle_at(i)), &map.values()[i]);
+    }
+}
+
+TEST(SlotMapTest, MatchesReferenceUnderRandomChurn) {
+    SlotMap<uint64_t> map;
+    std::unordered_map<uint64_t, uint64_t> reference;    // handle bits -> value
+    std::vector<SlotHandle> live;
+    std::vector<SlotHandle> dead;
+    std::mt19937 rng(7);
+
+    for (uint64_t step = 0; step < 20000; ++step) {
+        if (live.empty() || rng() % 3 != 0) {
+            SlotHandle handle = map.insert(step);
+            reference[handle.bits()] = step;
+            live.push_back(handle);
+        } else {
+            const size_t pick = rng() % live.size();
+            EXPECT_TRUE(map.erase(live[pick]));
+            reference.erase(live[pick].bits());
+            dead.push_back(live[pick]);
+            live[pick] = live.back();
+            live.pop_back();
+        }
+    }
+
+    ASSERT_EQ(map.size(), reference.size());
+    for (SlotHandle handle : live) {
+        ASSERT_NE(map.get(handle), nullptr);
+        EXPECT_EQ(*map.get(handle), reference[handle.bits()]);
+    }
+    for (SlotHandle handle : dead) {
+        EXPECT_EQ(map.get(handle), nullptr);
+    }
+}
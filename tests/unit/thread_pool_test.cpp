@@ -0,0 +1,159 @@
+#include <gtest/gtest.h>
+#include <foundation/thread_pool.h>
+#include <foundation/work_stealing_deque.h>
+#include <quant/model.hpp>
+#include <quant/monte_carlo.hpp>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+using foundation::ThreadPool;
+using foundation::ThreadPoolOptions;
+
+TEST(WorkStealingDequeTest, OwnerIsLifoThievesFifo) {
+    foundation::WorkStealingDeque<int> deque(2);
+    std::vector<int> items(10);
+    for (int& item : items) {
+        deque.push(&item);  // Grows past the initial ring
+    }
+    EXPECT_EQ(deque.size(), 10u);
+    EXPECT_EQ(deque.pop(), &items[9]);
+    EXPECT_EQ(deque.steal(), &items[0]);
+    EXPECT_EQ(deque.steal(), &items[1]);
+    EXPECT_EQ(deque.size(), 7u);
+    while (deque.pop()) {
+    }
+    EXPECT_EQ(deque.steal(), nullptr);
+}
+
+TEST(WorkStealingDequeTest, EveryItemTakenExactlyOnce) {
+    constexpr int ITEMS = 200000;
+    constexpr int THIEVES = 3;
+    std::vector<int> items(ITEMS);
+    std::vector<std::atomic<int>> taken(ITEMS);
+    foundation::WorkStealingDeque<int> deque(64);
+    std::atomic<bool> done{false};
+
+    auto take = [&](int* item) { taken[static_cast<size_t>(item - items.data())].fetch_add(1); };
+    std::vector<std::thread> thieves;
+    for (int t = 0; t < THIEVES; ++t) {
+        thieves.emplace_back([&] {
+            while (!done.load() || !deque.empty()) {
+                if (int* item = deque.steal()) {
+                    take(item);
+                }
+            }
+        });
+    }
+    for (int i = 0; i < ITEMS; ++i) {
+        deque.push(&items[i]);
+        if (i % 3 == 0) {
+            if (int* item = deque.pop()) {
+                take(item);
+            }
+        }
+    }
+    while (int* item = deque.pop()) {
+        take(item);
+    }
+    done = true;
+    for (auto& thief : thieves) {
+        thief.join();
+    }
+    for (int i = 0; i < ITEMS; ++i) {
+        ASSERT_EQ(taken[i].load(), 1) << "item " << i;
+    }
+}
+
+TEST(ThreadPoolTest, ParallelForCoversEveryIndexOnce) {
+    ThreadPool pool(ThreadPoolOptions{.threads = 4});
+    std::vector<std::atomic<int>> hits(100003);
+    foundation::parallel_for(pool, 0, hits.size(), 64, [&](size_t begin, size_t end) {
+        EXPECT_LE(end - begin, 64u);
+        for (size_t i = begin; i < end; ++i) {
+            hits[i].fetch_add(1, std::memory_order_relaxed);
+        }
+    });
+    for (const auto& hit : hits) {
+        ASSERT_EQ(hit.load(), 1);
+    }
+    foundation::parallel_for(pool, 5, 5, 0, [](size_t, size_t) { FAIL(); });
+}
+
+TEST(ThreadPoolTest, ParallelReduceIsDeterministic) {
+    std::vector<double> values(1 << 16);
+    for (size_t i = 0; i < values.size(); ++i) {
+        values[i] = 1.0 / static_cast<double>(i + 1);
+    }
+    auto sum = [&](ThreadPool& pool) {
+        return foundation::parallel_reduce(
+            pool, 0, values.size(), 1000, 0.0,
+            [&](size_t begin, size_t end) { return std::accumulate(&values[begin], &values[0] + end, 0.0); },
+            [](double a, double b) { return a + b; });
+    };
+    ThreadPool one(ThreadPoolOptions{.threads = 1});
+    ThreadPool four(ThreadPoolOptions{.threads = 4});
+    const double expected = sum(one);
+    EXPECT_NEAR(expected, std::accumulate(values.begin(), values.end(), 0.0), 1e-9);
+    for (int run = 0; run < 5; ++run) {
+        EXPECT_EQ(sum(four), expected);     // Bitwise: same chunks, same order
+    }
+}
+
+TEST(ThreadPoolTest, NestedGroupsJoin) {
+    ThreadPool pool(ThreadPoolOptions{.threads = 2});
+    std::atomic<int> leaves{0};
+    foundation::TaskGroup outer(pool);
+    for (int i = 0; i < 16; ++i) {
+        outer.run([&pool, &leaves] {
+            // Waits inside a worker by running other tasks
+            foundation::TaskGroup inner(pool);
+            for (int j = 0; j < 16; ++j) {
+                inner.run([&leaves] { leaves.fetch_add(1); });
+            }
+            inner.wait();
+            // Run by a worker, or by the test thread while it helps in wait()
+            EXPECT_TRUE(ThreadPool::current() == &pool || ThreadPool::current() == nullptr);
+        });
+    }
+    outer.wait();
+    EXPECT_EQ(leaves.load(), 256);
+    EXPECT_EQ(ThreadPool::current(), nullptr);
+}
+
+TEST(ThreadPoolTest, DestructorRunsSubmittedTasksAfterParking) {
+    std::atomic<int> ran{0};
+    {
+        ThreadPool pool(ThreadPoolOptions{.threads = 3, .spin_rounds = 1});
+        // Let every worker park, so the submissions below must wake them
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        for (int i = 0; i < 1000; ++i) {
+            pool.submit([&ran] { ran.fetch_add(1); });
+        }
+    }
+    EXPECT_EQ(ran.load(), 1000);
+}
+
+TEST(ThreadPoolTest, PinnedWorkersRun) {
+    ThreadPool pool(ThreadPoolOptions{.threads = 2, .pin_workers = true});
+    std::atomic<int> ran{0};
+    foundation::parallel_for(pool, 0, 100, 1, [&](size_t, size_t) { ran.fetch_add(1); });
+    EXPECT_EQ(ran.load(), 100);
+}
+
+TEST(MonteCarloTest, ConvergesToBlackScholesForAnyPoolSize) {
+    const double s = 100, k = 105, r = 0.03, v = 0.2, t = 0.75;
+    const double exact = quant::calculate_option_price(s, k, r, v, t);
+    EXPECT_NEAR(exact, 5.7414, 1e-4);
+
+    ThreadPool one(ThreadPoolOptions{.threads = 1});
+    ThreadPool four(ThreadPoolOptions{.threads = 4});
+    const quant::MonteCarloResult a = quant::monte_carlo_option_price(one, s, k, r, v, t, 200000);
+    const quant::MonteCarloResult b = quant::monte_carlo_option_price(four, s, k, r, v, t, 200000);
+    EXPECT_EQ(a.price, b.price);
+    EXPECT_GT(a.std_error, 0);
+    EXPECT_NEAR(a.price, exact, 4 * a.std_error);
+}
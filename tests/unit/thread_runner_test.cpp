@@ -0,0 +1,204 @@
+#include <gtest/gtest.h>
+#include <foundation/thread_runner.h>
+#include <network/event_loop.h>
+#include <network/tcp_server.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+#ifdef __linux__
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sched.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+using foundation::PollResult;
+using foundation::ThreadRunner;
+using foundation::ThreadRunnerOptions;
+
+TEST(ThreadRunnerTest, ParsesCpuLists) {
+    EXPECT_EQ(foundation::parse_cpu_list("0-3,8,10-11"), (std::vector<int>{0, 1, 2, 3, 8, 10, 11}));
+    EXPECT_EQ(foundation::parse_cpu_list("5,1-2,2"), (std::vector<int>{1, 2, 5}));
+    EXPECT_EQ(foundation::parse_cpu_list("x,4"), (std::vector<int>{4}));
+    EXPECT_TRUE(foundation::parse_cpu_list("").empty());
+    // Out of range or reversed ranges are dropped rather than expanded
+    EXPECT_EQ(foundation::parse_cpu_list("0-2147483647,3"), (std::vector<int>{3}));
+    EXPECT_EQ(foundation::parse_cpu_list("5-2,-1,1"), (std::vector<int>{1}));
+}
+
+TEST(ThreadRunnerTest, CountsBusyAndIdlePolls) {
+    ThreadRunner runner;
+    int calls = 0;
+    bool blocked = true;
+    runner.run([&](bool block) {
+        blocked = blocked && block;
+        ++calls;
+        if (calls == 10) {
+            return PollResult::Done;
+        }
+        if (calls % 3 == 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            return PollResult::Worked;
+        }
+        return PollResult::Idle;
+    });
+    EXPECT_TRUE(blocked);
+
+    const foundation::ThreadRunnerStats stats = runner.stats();
+    EXPECT_EQ(stats.polls, 10u);
+    EXPECT_EQ(stats.idle_polls, 6u);
+    EXPECT_GE(stats.busy_ns, 3'000'000u);
+    EXPECT_GT(stats.busy_ratio(), 0.5);
+    EXPECT_LE(stats.busy_ratio(), 1.0);
+}
+
+TEST(ThreadRunnerTest, BusyPollNeverBlocksAndBacksOff) {
+    ThreadRunnerOptions options;
+    options.busy_poll = true;
+    options.max_pause = 64;
+    options.yield_after = 1000;
+    ThreadRunner runner(options);
+    int calls = 0;
+    bool blocked = false;
+    runner.run([&](bool block) {
+        blocked = blocked || block;
+        return ++calls == 5000 ? PollResult::Done : PollResult::Idle;
+    });
+    EXPECT_FALSE(blocked);
+
+    const foundation::ThreadRunnerStats stats = runner.stats();
+    EXPECT_EQ(stats.polls, 5000u);
+    EXPECT_EQ(stats.idle_polls, 4999u);
+    EXPECT_EQ(stats.busy_ns, 0u);
+    EXPECT_GT(stats.idle_ns, 0u);
+}
+
+#ifdef __linux__
+TEST(ThreadRunnerTest, PinsItsThread) {
+    ThreadRunnerOptions options;
+    options.name = "pinned";
+    options.cpus = {0};
+    ThreadRunner runner(options);
+    int cpu = -1;
+    runner.start([&](bool) {
+        cpu = sched_getcpu();
+        return PollResult::Done;
+    });
+    runner.join();
+    EXPECT_EQ(cpu, 0);
+}
+#endif
+
+TEST(ThreadRunnerTest, BusyPollingEventLoopRunsTimersAndTasks) {
+    network::EventLoop loop;
+    ThreadRunnerOptions options;
+    options.name = "busy-loop";
+    options.busy_poll = true;
+    options.yield_after = 64;   // One vCPU in CI; let the test thread in
+    loop.start(options);
+
+    std::atomic<int> ran{0};
+    uv_timer_t timer;
+    loop.post([&] {
+        uv_timer_init(loop.get(), &timer);
+        timer.data = &ran;
+        uv_timer_start(&timer, [](uv_timer_t* t) {
+            static_cast<std::atomic<int>*>(t->data)->fetch_add(1);
+            uv_close(reinterpret_cast<uv_handle_t*>(t), nullptr);
+        }, 5, 0);
+    });
+    loop.post([&] { ran.fetch_add(1); });
+
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (ran.load() < 2 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    loop.stop();
+    loop.join();
+
+    EXPECT_EQ(ran.load(), 2);
+    const foundation::ThreadRunnerStats stats = loop.runner_stats();
+    EXPECT_GT(stats.polls, stats.idle_polls);
+    EXPECT_GT(stats.idle_polls, 0u);
+    EXPECT_GT(stats.busy_ns, 0u);
+}
+
+#ifdef __linux__
+namespace {
+    // Median echo round trip through an io_uring server on a runner-driven
+    // loop; a send queued by a callback must go out in the same iteration
+    std::chrono::microseconds uring_echo_round_trip(const ThreadRunnerOptions& options) {
+        network::EventLoop loop;
+        network::TcpServerOptions server_options;
+        server_options.host = "127.0.0.1";
+        server_options.port = 0;
+        server_options.backend = network::Backend::IoUring;
+        network::TcpServer server(loop.get(), server_options);
+        server.set_data_handler([](network::Connection& conn, std::span<const char> data) {
+            conn.send(std::string_view(data.data(), data.size()));
+        });
+        EXPECT_EQ(server.listen(), 0);
+        loop.start(options);
+
+        const int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(static_cast<uint16_t>(server.bound_port()));
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        EXPECT_EQ(::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)), 0);
+        int on = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+        timeval wait{1, 0};     // A send left unsubmitted fails the test rather than hanging it
+        setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &wait, sizeof(wait));
+
+        std::vector<std::chrono::microseconds> trips;
+        for (int i = 0; i < 50; ++i) {
+            const auto start = std::chrono::steady_clock::now();
+            char reply[4];
+            size_t got = 0;
+            if (::send(fd, "ping", 4, 0) != 4) {
+                break;
+            }
+            while (got < sizeof(reply)) {
+                const ssize_t n = ::recv(fd, reply + got, sizeof(reply) - got, 0);
+                if (n <= 0) {
+                    break;
+                }
+                got += static_cast<size_t>(n);
+            }
+            EXPECT_EQ(got, sizeof(reply));
+            trips.push_back(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start));
+        }
+        ::close(fd);
+
+        loop.post([&] { server.close(); });
+        loop.stop();
+        loop.join();
+        if (trips.empty()) {
+            return std::chrono::microseconds::max();
+        }
+        std::nth_element(trips.begin(), trips.begin() + trips.size() / 2, trips.end());
+        return trips[trips.size() / 2];
+    }
+}
+
+TEST(ThreadRunnerTest, IoUringEchoGoesOutInTheSameTick) {
+    if (!network::UringTransport::supported()) {
+        GTEST_SKIP() << "io_uring unavailable";
+    }
+    ThreadRunnerOptions blocking;
+    blocking.name = "uring-block";
+    blocking.cpus = {0};
+    EXPECT_LT(uring_echo_round_trip(blocking), std::chrono::milliseconds(10));
+
+    ThreadRunnerOptions busy = blocking;
+    busy.name = "uring-busy";
+    busy.busy_poll = true;
+    busy.yield_after = 64;   // Share the core with the client
+    EXPECT_LT(uring_echo_round_trip(busy), std::chrono::milliseconds(10));
+}
+#endif
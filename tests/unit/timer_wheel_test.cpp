@@ -0,0 +1,102 @@
+#include <gtest/gtest.h>
+#include <network/timer_wheel.h>
+#include <memory>
+#include <vector>
+
+using network::Timer;
+using network::TimerWheel;
+
+TEST(TimerWheelTest, FiresOnDeadlineTick) {
+    TimerWheel wheel(1000, 10);
+    int fired = 0;
+    Timer timer([&] { fired++; });
+
+    wheel.schedule(timer, 45);  // Rounded up to 5 ticks
+    EXPECT_TRUE(timer.armed());
+    EXPECT_EQ(wheel.advance(1040), 0u);
+    EXPECT_EQ(fired, 0);
+    EXPECT_EQ(wheel.advance(1050), 1u);
+    EXPECT_EQ(fired, 1);
+    EXPECT_FALSE(timer.armed());
+    EXPECT_TRUE(wheel.empty());
+}
+
+TEST(TimerWheelTest, CancelAndRearm) {
+    TimerWheel wheel(0, 10);
+    int fired = 0;
+    Timer timer([&] { fired++; });
+
+    wheel.schedule(timer, 100);
+    timer.cancel();
+    EXPECT_FALSE(timer.armed());
+    EXPECT_EQ(wheel.size(), 0u);
+    wheel.advance(200);
+    EXPECT_EQ(fired, 0);
+
+    wheel.schedule(timer, 100);
+    wheel.schedule(timer, 500);  // Moves the deadline to 200 + 500
+    EXPECT_EQ(wheel.size(), 1u);
+    wheel.advance(690);
+    EXPECT_EQ(fired, 0);
+    wheel.advance(700);
+    EXPECT_EQ(fired, 1);
+}
+
+TEST(TimerWheelTest, LongDelaysCascadeThroughLevels) {
+    TimerWheel wheel(0, 1);
+    std::vector<uint64_t> delays = {63, 64, 65, 4095, 4096, 4097, 300000};
+    std::vector<std::unique_ptr<Timer>> timers;
+    std::vector<uint64_t> fired_at;
+    uint64_t now = 0;
+
+    for (uint64_t delay : delays) {
+        timers.push_back(std::make_unique<Timer>([&] { fired_at.push_back(now); }));
+        wheel.schedule(*timers.back(), delay);
+    }
+
+    // Step one tick at a time so each firing is observed at its exact time
+    while (!wheel.empty() && now < 400000) {
+        wheel.advance(++now);
+    }
+    EXPECT_EQ(fired_at, delays);
+}
+
+TEST(TimerWheelTest, CallbackMayRearmItself) {
+    TimerWheel wheel(0, 10);
+    int fired = 0;
+    Timer timer;
+    timer.set_callback([&] {
+        if (++fired < 3) {
+            wheel.schedule(timer, 10);
+        }
+    });
+
+    wheel.schedule(timer, 10);
+    wheel.advance(1000);
+    EXPECT_EQ(fired, 3);
+    EXPECT_FALSE(timer.armed());
+}
+
+TEST(TimerWheelTest, CallbackMayCancelTimerInSameSlot) {
+    TimerWheel wheel(0, 10);
+    int second_fired = 0;
+    Timer second([&] { second_fired++; });
+    Timer first([&] { second.cancel(); });
+
+    wheel.schedule(first, 50);
+    wheel.schedule(second, 50);
+    EXPECT_EQ(wheel.advance(50), 1u);
+    EXPECT_EQ(second_fired, 0);
+    EXPECT_TRUE(wheel.empty());
+}
+
+TEST(TimerWheelTest, DestroyingArmedTimerUnlinksIt) {
+    TimerWheel wheel(0, 10);
+    {
+        Timer timer([] { FAIL(); });
+        wheel.schedule(timer, 20);
+        EXPECT_EQ(wheel.size(), 1u);
+    }
+    EXPECT_TRUE(wheel.empty());
+    EXPECT_EQ(wheel.advance(100), 0u);
+}
@@ -0,0 +1,163 @@
+#include <gtest/gtest.h>
+#include <foundation/trace.h>
+#include <barrier>
+#include <chrono>
+#include <csignal>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <regex>
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+    struct Zone {
+        uint32_t tid;
+        double ts;
+        double dur;
+    };
+
+    // The complete ("X") events named `name` in a dump
+    std::vector<Zone> zones(const std::string& json, const std::string& name) {
+        const std::regex event("\\{\"pid\":\\d+,\"tid\":(\\d+),\"ph\":\"X\",\"name\":\"" + name +
+                               "\",\"ts\":([0-9.]+),\"dur\":([0-9.]+)\\}");
+        std::vector<Zone> found;
+        for (std::sregex_iterator it(json.begin(), json.end(), event), end; it != end; ++it) {
+            found.push_back({static_cast<uint32_t>(std::stoul((*it)[1])), std::stod((*it)[2]), std::stod((*it)[3])});
+        }
+        return found;
+    }
+
+    volatile bool stop_recursing = false;
+
+    // Recurses until the stack runs out
+    [[gnu::noinline]] int overflow_stack(int depth) {
+        volatile char frame[1024];
+        frame[0] = static_cast<char>(depth);
+        if (stop_recursing) {
+            return frame[0];
+        }
+        return overflow_stack(depth + 1) + frame[0];
+    }
+
+    std::string read_file(const std::filesystem::path& path) {
+        std::ifstream in(path);
+        std::stringstream content;
+        content << in.rdbuf();
+        return content.str();
+    }
+}
+
+TEST(TraceTest, NestedZonesAppearInDump) {
+    std::thread([] {
+        foundation::set_trace_thread_name("trace \"test\"");
+        FTRACE_ZONE("trace_test_outer");
+        {
+            FTRACE_ZONE("trace_test_inner");
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        }
+    }).join();
+
+    const std::string json = foundation::trace_json();
+    EXPECT_EQ(json.rfind("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[", 0), 0u);
+    EXPECT_NE(json.find("\"name\":\"thread_name\",\"args\":{\"name\":\"trace \\\"test\\\"\"}"), std::string::npos);
+
+    const auto outer = zones(json, "trace_test_outer");
+    const auto inner = zones(json, "trace_test_inner");
+    ASSERT_EQ(outer.size(), 1u);
+    ASSERT_EQ(inner.size(), 1u);
+    EXPECT_EQ(outer[0].tid, inner[0].tid);
+    EXPECT_GE(inner[0].dur, 1500.0);    // Microseconds
+    EXPECT_LE(outer[0].ts, inner[0].ts);
+    EXPECT_GE(outer[0].ts + outer[0].dur, inner[0].ts + inner[0].dur);
+}
+
+TEST(TraceTest, RingKeepsNewestEvents) {
+    std::thread([] {
+        for (size_t i = 0; i < foundation::detail::TraceRing::CAPACITY + 100; ++i) {
+            FTRACE_ZONE("trace_test_wrap");
+        }
+        FTRACE_ZONE("trace_test_last");
+    }).join();
+
+    // The oldest slot is the next one written, so a dump skips it too
+    const std::string json = foundation::trace_json();
+    EXPECT_EQ(zones(json, "trace_test_wrap").size(), foundation::detail::TraceRing::CAPACITY - 2);
+    EXPECT_EQ(zones(json, "trace_test_last").size(), 1u);
+}
+
+TEST(TraceTest, ThreadsGetTheirOwnTracks) {
+    constexpr int THREADS = 4;
+    std::barrier all_started(THREADS);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < THREADS; ++t) {
+        threads.emplace_back([&all_started] {
+            // Alive together, so each owns a ring
+            all_started.arrive_and_wait();
+            for (int i = 0; i < 100; ++i) {
+                FTRACE_ZONE("trace_test_thread");
+            }
+            all_started.arrive_and_wait();
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    const auto found = zones(foundation::trace_json(), "trace_test_thread");
+    EXPECT_EQ(found.size(), static_cast<size_t>(THREADS * 100));
+    std::set<uint32_t> tids;
+    for (const Zone& zone : found) {
+        tids.insert(zone.tid);
+    }
+    EXPECT_EQ(tids.size(), static_cast<size_t>(THREADS));
+}
+
+TEST(TraceTest, DumpsToFileOnSignalAndCrash) {
+    const auto dir = std::filesystem::temp_directory_path() /
+                     ("trace_test_" + std::to_string(::testing::UnitTest::GetInstance()->random_seed()));
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+    {
+        FTRACE_ZONE("trace_test_file");
+    }
+    const auto written = dir / "direct.json";
+    ASSERT_TRUE(foundation::write_trace(written.c_str()));
+    EXPECT_EQ(zones(read_file(written), "trace_test_file").size(), 1u);
+    EXPECT_FALSE(foundation::write_trace((dir / "missing" / "x.json").c_str()));
+
+    foundation::install_trace_dumps({dir.string(), true, true});
+    std::raise(SIGUSR2);
+    const auto on_signal = dir / ("trace-" + std::to_string(::getpid()) + "-0.json");
+    for (int i = 0; i < 200 && !std::filesystem::exists(on_signal); ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    // The dumper thread may still be writing; wait for the closing bracket
+    std::string json;
+    for (int i = 0; i < 200 && json.find("]}") == std::string::npos; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        json = read_file(on_signal);
+    }
+    EXPECT_EQ(zones(json, "trace_test_file").size(), 1u);
+
+    // The crash path is fixed at install time, so the forked child writes
+    // under this process's pid
+    GTEST_FLAG_SET(death_test_style, "fast");
+    EXPECT_DEATH(std::abort(), "");
+    const auto crash_path = dir / ("trace-" + std::to_string(::getpid()) + "-crash.json");
+    const std::string crash = read_file(crash_path);
+    EXPECT_EQ(crash.substr(crash.size() - 3), "]}\n");
+    EXPECT_EQ(zones(crash, "trace_test_file").size(), 1u);
+
+    // With the stack used up the handler runs on the alternate stack
+    std::filesystem::remove(crash_path);
+    EXPECT_DEATH(overflow_stack(0), "");
+    const std::string overflow = read_file(crash_path);
+    ASSERT_GE(overflow.size(), 3u);
+    EXPECT_EQ(overflow.substr(overflow.size() - 3), "]}\n");
+    std::filesystem::remove_all(dir);
+}
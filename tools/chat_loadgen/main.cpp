@@ -0,0 +1,518 @@
+#include <foundation/histogram.h>
+#include <network/buffer_pool.h>
+#include <network/frame_codec.h>
+#include <network/framed_reader.h>
+#include <network/write_request_pool.h>
+#include <uv.h>
+#include <spdlog/spdlog.h>
+#include <fmt/core.h>
+#include <fmt/ranges.h>
+#include <sys/resource.h>
+#include <algorithm>
+#include <csignal>
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <charconv>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+struct LoadgenOptions {
+    std::string host = "127.0.0.1";
+    std::vector<int> ports = {8888};    // Connection i goes to ports[i % size]: one per cluster node
+    size_t connections = 1000;
+    size_t threads = 4;
+    size_t senders = 10;            // Connections that publish
+    size_t rooms = 0;               // Connection i joins room i % rooms; 0 keeps everyone in the lobby
+    double rate = 10;               // Messages per second per sender
+    size_t burst = 1;               // Messages sent back to back per send slot
+    size_t payload_size = 64;
+    double warmup_s = 2;
+    double duration_s = 10;
+    size_t source_ips = 1;          // Spread client sockets over 127.0.0.1..N
+    size_t connect_concurrency = 64;    // Handshakes in flight across all threads
+    network::FrameMode framing = network::FrameMode::LengthPrefixed;
+    std::string json_path;          // "-" for stdout
+};
+
+enum class Phase { Connecting, Running, Draining, Stopping };
+
+// Written by the main thread, read by every worker
+std::atomic<Phase> phase{Phase::Connecting};
+std::atomic<uint64_t> start_ns{0};
+std::atomic<uint64_t> window_begin_ns{0};   // Only messages sent inside the window are measured
+std::atomic<uint64_t> window_end_ns{0};
+
+bool in_window(uint64_t ns) {
+    return ns >= window_begin_ns.load(std::memory_order_relaxed) &&
+           ns < window_end_ns.load(std::memory_order_relaxed);
+}
+
+LoadgenOptions options;
+std::vector<sockaddr_in> server_addrs;  // By options.ports
+
+struct Worker;
+
+struct ClientConn {
+    uv_tcp_t handle;
+    uv_connect_t connect;
+    Worker* worker;
+    std::unique_ptr<network::FramedReader> reader;
+    size_t id;
+    bool ready = false;     // Welcome received, so the server has registered us
+    uint64_t seq = 0;
+};
+
+// One thread with its own loop and a slice of the connections
+struct Worker {
+    uv_loop_t loop;
+    uv_timer_t tick;
+    network::BufferPool pool;
+    network::WriteRequestPool requests;
+    std::vector<std::unique_ptr<ClientConn>> conns;
+    std::vector<ClientConn*> senders;
+    size_t next_connect = 0;
+    size_t connecting = 0;
+    std::thread thread;
+
+    // Polled by the main thread while the run is in progress
+    std::atomic<uint64_t> ready{0};
+    std::atomic<uint64_t> failed{0};
+    std::atomic<uint64_t> frames{0};
+
+    // Read after join()
+    foundation::Histogram latency;
+    uint64_t sent = 0;              // Inside the window
+    uint64_t delivered = 0;         // Deliveries of messages sent inside the window
+    uint64_t throttled = 0;         // Send slots skipped because the socket was backed up
+    uint64_t expected = 0;          // Deliveries owed for `sent` when rooms are in use
+    uint64_t bytes_received = 0;
+    uint64_t disconnects = 0;
+};
+
+constexpr size_t MAX_QUEUED_WRITE_BYTES = 1 << 20;
+constexpr std::string_view MARKER = "lg ";
+
+void close_conn(ClientConn* conn) {
+    auto* handle = reinterpret_cast<uv_handle_t*>(&conn->handle);
+    if (!uv_is_closing(handle)) {
+        conn->reader->release();
+        uv_close(handle, nullptr);
+    }
+}
+
+void write_frame(ClientConn* conn, const network::SharedPayload& payload) {
+    auto* request = conn->worker->requests.acquire();
+    request->payloads[0] = payload;
+    request->payload_count = 1;
+    uv_buf_t buf = uv_buf_init(const_cast<char*>(payload.data()), static_cast<unsigned int>(payload.size()));
+    uv_write(&request->req, reinterpret_cast<uv_stream_t*>(&conn->handle), &buf, 1,
+             [](uv_write_t* req, int) {
+                 auto* c = static_cast<ClientConn*>(req->handle->data);
+                 c->worker->requests.release(network::WriteRequest::from(req));
+             });
+}
+
+size_t room_of(const ClientConn* conn) {
+    return conn->id % options.rooms;
+}
+
+size_t room_size(size_t room) {
+    return options.connections / options.rooms + (room < options.connections % options.rooms ? 1 : 0);
+}
+
+// "[#room] [UserN]: lg <send_ns> <sender> <seq> xxxx"; anything else is server chatter
+void on_frame(ClientConn* conn, std::string_view frame) {
+    Worker* w = conn->worker;
+    w->frames.fetch_add(1, std::memory_order_relaxed);
+    if (!conn->ready) {
+        conn->ready = true;
+        w->ready.fetch_add(1, std::memory_order_relaxed);
+        if (options.rooms) {
+            write_frame(conn, network::encode_frame(options.framing, fmt::format("/join r{}", room_of(conn))));
+            write_frame(conn, network::encode_frame(options.framing, "/leave lobby"));
+        }
+    }
+    if (frame.empty()) {
+        write_frame(conn, network::encode_frame(options.framing, {}));
+        return;
+    }
+
+    const size_t at = frame.find(MARKER);
+    if (at == std::string_view::npos) {
+        return;
+    }
+    const char* first = frame.data() + at + MARKER.size();
+    uint64_t sent_ns = 0;
+    if (std::from_chars(first, frame.data() + frame.size(), sent_ns).ec != std::errc{}) {
+        return;
+    }
+    if (in_window(sent_ns)) {
+        w->latency.record(uv_hrtime() - sent_ns);
+        w->delivered++;
+    }
+}
+
+void on_alloc(uv_handle_t* handle, size_t, uv_buf_t* buf) {
+    *buf = static_cast<ClientConn*>(handle->data)->reader->prepare();
+}
+
+void on_read(uv_stream_t* stream, ssize_t nread, const uv_buf_t*) {
+    auto* conn = static_cast<ClientConn*>(stream->data);
+    if (nread > 0) {
+        conn->worker->bytes_received += static_cast<uint64_t>(nread);
+        if (conn->reader->commit(static_cast<size_t>(nread),
+                                 [conn](std::string_view frame) { on_frame(conn, frame); })) {
+            return;
+        }
+        spdlog::error("Malformed frame on connection {}", conn->id);
+    } else if (nread == 0) {
+        return;
+    }
+    if (phase.load(std::memory_order_relaxed) != Phase::Stopping) {
+        conn->worker->disconnects++;
+    }
+    close_conn(conn);
+}
+
+void start_connects(Worker& w);
+
+void on_connect(uv_connect_t* req, int status) {
+    auto* conn = static_cast<ClientConn*>(req->data);
+    Worker& w = *conn->worker;
+    w.connecting--;
+    if (status < 0) {
+        if (w.failed.fetch_add(1, std::memory_order_relaxed) == 0) {
+            spdlog::error("Connect failed: {}", uv_strerror(status));
+        }
+        close_conn(conn);
+    } else {
+        uv_read_start(reinterpret_cast<uv_stream_t*>(&conn->handle), on_alloc, on_read);
+    }
+    start_connects(w);
+}
+
+// Keep fewer handshakes in flight than the server's listen backlog: an
+// overflowing accept queue can silently lose connections
+void start_connects(Worker& w) {
+    if (phase.load(std::memory_order_relaxed) == Phase::Stopping) {
+        return;
+    }
+    const size_t limit = std::max<size_t>(1, options.connect_concurrency / options.threads);
+    while (w.connecting < limit && w.next_connect < w.conns.size()) {
+        ClientConn* conn = w.conns[w.next_connect++].get();
+        uv_tcp_init(&w.loop, &conn->handle);
+        uv_tcp_nodelay(&conn->handle, 1);
+        conn->handle.data = conn;
+        conn->connect.data = conn;
+
+        if (options.source_ips > 1) {
+            sockaddr_in local{};
+            const std::string ip = fmt::format("127.0.0.{}", 1 + conn->id % options.source_ips);
+            uv_ip4_addr(ip.c_str(), 0, &local);
+            uv_tcp_bind(&conn->handle, reinterpret_cast<const sockaddr*>(&local), 0);
+        }
+        int r = uv_tcp_connect(&conn->connect, &conn->handle,
+                               reinterpret_cast<const sockaddr*>(&server_addrs[conn->id % server_addrs.size()]),
+                               on_connect);
+        if (r < 0) {
+            w.failed.fetch_add(1, std::memory_order_relaxed);
+            close_conn(conn);
+            continue;
+        }
+        w.connecting++;
+    }
+}
+
+void send_message(Worker& w, ClientConn* conn, uint64_t now) {
+    char* body = nullptr;
+    network::SharedPayload payload = network::allocate_frame(options.framing, options.payload_size, &body);
+    auto prefix = fmt::format_to_n(body, options.payload_size, "{}{} {} {} ", MARKER, now, conn->id, conn->seq++);
+    const size_t written = std::min(prefix.size, options.payload_size);
+    std::memset(body + written, 'x', options.payload_size - written);
+
+    write_frame(conn, payload);
+    if (in_window(now)) {
+        w.sent++;
+        if (options.rooms) {
+            w.expected += room_size(room_of(conn)) - 1;
+        }
+    }
+}
+
+// Every sender owes floor(elapsed * rate) messages, released `burst` at a time.
+// Senders are staggered across one burst period so sends do not all land on one tick.
+void run_senders(Worker& w) {
+    const uint64_t now = uv_hrtime();
+    const double period_s = static_cast<double>(options.burst) / options.rate;
+    for (size_t i = 0; i < w.senders.size(); ++i) {
+        ClientConn* conn = w.senders[i];
+        if (!conn->ready || uv_is_closing(reinterpret_cast<uv_handle_t*>(&conn->handle))) {
+            continue;
+        }
+        const double offset_s = period_s * static_cast<double>(conn->id % options.senders) /
+                                static_cast<double>(options.senders);
+        const double elapsed_s = static_cast<double>(now - start_ns.load(std::memory_order_relaxed)) / 1e9 + offset_s;
+        const auto due = static_cast<uint64_t>(elapsed_s / period_s) * options.burst;
+
+        while (conn->seq < due) {
+            if (uv_stream_get_write_queue_size(reinterpret_cast<uv_stream_t*>(&conn->handle)) >
+                MAX_QUEUED_WRITE_BYTES) {
+                // The server is not keeping up; skip rather than queue without bound
+                w.throttled += due - conn->seq;
+                conn->seq = due;
+                break;
+            }
+            send_message(w, conn, now);
+        }
+    }
+}
+
+void on_tick(uv_timer_t* timer) {
+    Worker& w = *static_cast<Worker*>(timer->data);
+    switch (phase.load(std::memory_order_acquire)) {
+    case Phase::Connecting:
+    case Phase::Draining:
+        break;
+    case Phase::Running:
+        run_senders(w);
+        break;
+    case Phase::Stopping:
+        for (auto& conn : w.conns) {
+            if (conn->handle.data) {
+                close_conn(conn.get());
+            }
+        }
+        uv_close(reinterpret_cast<uv_handle_t*>(&w.tick), nullptr);
+        break;
+    }
+}
+
+void run_worker(Worker& w) {
+    uv_loop_init(&w.loop);
+    uv_timer_init(&w.loop, &w.tick);
+    w.tick.data = &w;
+    uv_timer_start(&w.tick, on_tick, 1, 1);
+    start_connects(w);
+    uv_run(&w.loop, UV_RUN_DEFAULT);
+    uv_loop_close(&w.loop);
+}
+
+template <typename Counter>
+uint64_t total(const std::vector<std::unique_ptr<Worker>>& workers, Counter counter) {
+    uint64_t sum = 0;
+    for (const auto& w : workers) {
+        sum += counter(*w);
+    }
+    return sum;
+}
+
+void raise_fd_limit(size_t needed) {
+    rlimit limit{};
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < limit.rlim_max) {
+        limit.rlim_cur = limit.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &limit);
+    }
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < needed) {
+        spdlog::warn("File descriptor limit {} is below the {} connections requested",
+                     static_cast<uint64_t>(limit.rlim_cur), needed);
+    }
+}
+
+void sleep_s(double seconds) {
+    std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+}
+
+int usage() {
+    fmt::print("Usage: chat_loadgen [--host H] [--port N[,N...]] [--connections N] [--threads N]\n"
+               "                    [--senders N] [--rooms N] [--rate MSGS_PER_SEC] [--burst N] [--size BYTES]\n"
+               "                    [--warmup SECONDS] [--duration SECONDS] [--source-ips N]\n"
+               "                    [--connect-concurrency N] [--text] [--json FILE|-]\n"
+               "Without --rooms every connection stays in the lobby and receives each message,\n"
+               "so fan-out is connections - 1; with --rooms N connection i moves to room i % N.\n"
+               "--source-ips lifts the ~28k ephemeral port limit per source address when\n"
+               "testing against loopback. Several ports spread the connections round-robin\n"
+               "over the nodes of a chat_server cluster.\n");
+    return 1;
+}
+
+int main(int argc, char** argv) {
+    // Sends to a server that went away fail with EPIPE instead
+    std::signal(SIGPIPE, SIG_IGN);
+
+    for (int i = 1; i < argc; ++i) {
+        std::string_view arg = argv[i];
+        const bool has_value = i + 1 < argc;
+        if (arg == "--host" && has_value) {
+            options.host = argv[++i];
+        } else if (arg == "--port" && has_value) {
+            options.ports.clear();
+            for (std::string_view list = argv[++i]; !list.empty();) {
+                const size_t comma = std::min(list.find(','), list.size());
+                options.ports.push_back(std::atoi(std::string(list.substr(0, comma)).c_str()));
+                list.remove_prefix(std::min(comma + 1, list.size()));
+            }
+            if (options.ports.empty()) {
+                return usage();
+            }
+        } else if (arg == "--connections" && has_value) {
+            options.connections = std::max<size_t>(1, std::strtoull(argv[++i], nullptr, 10));
+        } else if (arg == "--threads" && has_value) {
+            options.threads = std::max<size_t>(1, std::strtoull(argv[++i], nullptr, 10));
+        } else if (arg == "--senders" && has_value) {
+            options.senders = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--rooms" && has_value) {
+            options.rooms = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--rate" && has_value) {
+            options.rate = std::strtod(argv[++i], nullptr);
+        } else if (arg == "--burst" && has_value) {
+            options.burst = std::max<size_t>(1, std::strtoull(argv[++i], nullptr, 10));
+        } else if (arg == "--size" && has_value) {
+            // Room for the "lg <send_ns> <sender> <seq> " header
+            options.payload_size = std::max<size_t>(48, std::strtoull(argv[++i], nullptr, 10));
+        } else if (arg == "--warmup" && has_value) {
+            options.warmup_s = std::strtod(argv[++i], nullptr);
+        } else if (arg == "--duration" && has_value) {
+            options.duration_s = std::strtod(argv[++i], nullptr);
+        } else if (arg == "--source-ips" && has_value) {
+            options.source_ips = std::clamp<size_t>(std::strtoull(argv[++i], nullptr, 10), 1, 254);
+        } else if (arg == "--connect-concurrency" && has_value) {
+            options.connect_concurrency = std::max<size_t>(1, std::strtoull(argv[++i], nullptr, 10));
+        } else if (arg == "--text") {
+            options.framing = network::FrameMode::NewlineDelimited;
+        } else if (arg == "--json" && has_value) {
+            options.json_path = argv[++i];
+        } else {
+            return usage();
+        }
+    }
+    options.senders = std::min(options.senders, options.connections);
+    options.threads = std::min(options.threads, options.connections);
+    if (options.rate <= 0 || options.senders == 0) {
+        return usage();
+    }
+    for (int port : options.ports) {
+        if (uv_ip4_addr(options.host.c_str(), port, &server_addrs.emplace_back()) != 0) {
+            spdlog::error("Invalid IPv4 address: {}", options.host);
+            return 1;
+        }
+    }
+    raise_fd_limit(options.connections + 64);
+
+    // Connections are dealt round-robin, so the senders spread evenly over the threads
+    std::vector<std::unique_ptr<Worker>> workers;
+    for (size_t t = 0; t < options.threads; ++t) {
+        workers.push_back(std::make_unique<Worker>());
+    }
+    for (size_t id = 0; id < options.connections; ++id) {
+        Worker& w = *workers[id % options.threads];
+        auto conn = std::make_unique<ClientConn>();
+        conn->worker = &w;
+        conn->id = id;
+        conn->handle.data = nullptr;
+        conn->reader = std::make_unique<network::FramedReader>(
+            w.pool, network::FrameDecoder(options.framing), 16 * 1024);
+        if (id < options.senders) {
+            w.senders.push_back(conn.get());
+        }
+        w.conns.push_back(std::move(conn));
+    }
+
+    spdlog::info("Opening {} connections to {}:{} from {} thread(s)", options.connections,
+                 options.host, fmt::join(options.ports, ","), options.threads);
+    for (auto& w : workers) {
+        w->thread = std::thread(run_worker, std::ref(*w));
+    }
+
+    auto ready = [&] { return total(workers, [](Worker& w) { return w.ready.load(std::memory_order_relaxed); }); };
+    auto failed = [&] { return total(workers, [](Worker& w) { return w.failed.load(std::memory_order_relaxed); }); };
+    auto frames = [&] { return total(workers, [](Worker& w) { return w.frames.load(std::memory_order_relaxed); }); };
+
+    const auto connect_begin = std::chrono::steady_clock::now();
+    while (ready() + failed() < options.connections &&
+           std::chrono::steady_clock::now() - connect_begin < std::chrono::seconds(60)) {
+        sleep_s(0.05);
+    }
+    const double connect_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - connect_begin).count();
+    const uint64_t connected = ready();
+
+    // Join announcements fan out to everyone; start once that storm has passed
+    for (uint64_t last = frames(); connected > 0;) {
+        sleep_s(0.5);
+        const uint64_t now = frames();
+        if (now == last) {
+            break;
+        }
+        last = now;
+    }
+    spdlog::info("{} connected, {} failed in {:.2f}s; running {:.1f}s warm-up + {:.1f}s measurement",
+                 connected, failed(), connect_s, options.warmup_s, options.duration_s);
+
+    const uint64_t start = uv_hrtime();
+    const uint64_t window_begin = start + static_cast<uint64_t>(options.warmup_s * 1e9);
+    start_ns.store(start, std::memory_order_relaxed);
+    window_begin_ns.store(window_begin, std::memory_order_relaxed);
+    window_end_ns.store(window_begin + static_cast<uint64_t>(options.duration_s * 1e9), std::memory_order_relaxed);
+    phase.store(Phase::Running, std::memory_order_release);
+
+    sleep_s(options.warmup_s + options.duration_s);
+    phase.store(Phase::Draining, std::memory_order_release);
+    sleep_s(1.0);  // Grace period for deliveries still in flight
+    phase.store(Phase::Stopping, std::memory_order_release);
+    for (auto& w : workers) {
+        w->thread.join();
+    }
+
+    foundation::Histogram latency;
+    for (const auto& w : workers) {
+        latency.merge(w->latency);
+    }
+    const uint64_t sent = total(workers, [](Worker& w) { return w.sent; });
+    const uint64_t delivered = total(workers, [](Worker& w) { return w.delivered; });
+    const uint64_t expected = options.rooms ? total(workers, [](Worker& w) { return w.expected; })
+                                            : connected > 0 ? sent * (connected - 1) : 0;
+    const double us = 1e-3;
+
+    fmt::print("connections   {} ({} failed, {} dropped during run)\n", connected, failed(),
+               total(workers, [](Worker& w) { return w.disconnects; }));
+    fmt::print("sent          {} msgs ({:.0f}/s, {} throttled)\n", sent, sent / options.duration_s,
+               total(workers, [](Worker& w) { return w.throttled; }));
+    fmt::print("delivered     {} of {} expected ({:.0f}/s)\n", delivered, expected,
+               delivered / options.duration_s);
+    fmt::print("latency (us)  p50 {:.1f}  p99 {:.1f}  p99.9 {:.1f}  max {:.1f}\n", latency.percentile(50) * us,
+               latency.percentile(99) * us, latency.percentile(99.9) * us, latency.max() * us);
+
+    if (!options.json_path.empty()) {
+        std::FILE* out = options.json_path == "-" ? stdout : std::fopen(options.json_path.c_str(), "w");
+        if (!out) {
+            spdlog::error("Cannot write {}: {}", options.json_path, std::strerror(errno));
+            return 1;
+        }
+        fmt::print(out,
+                   "{{\"config\":{{\"connections\":{},\"threads\":{},\"senders\":{},\"rooms\":{},\"rate\":{},\"burst\":{},"
+                   "\"payload_size\":{},\"warmup_s\":{},\"duration_s\":{}}},"
+                   "\"connected\":{},\"connect_failures\":{},\"disconnects\":{},\"connect_s\":{:.3f},"
+                   "\"sent\":{},\"throttled\":{},\"delivered\":{},\"expected\":{},"
+                   "\"sent_per_s\":{:.1f},\"delivered_per_s\":{:.1f},\"received_bytes\":{},"
+                   "\"latency_us\":{{\"p50\":{:.1f},\"p90\":{:.1f},\"p99\":{:.1f},\"p999\":{:.1f},\"max\":{:.1f}}}}}\n",
+                   options.connections, options.threads, options.senders, options.rooms, options.rate, options.burst,
+                   options.payload_size, options.warmup_s, options.duration_s,
+                   connected, failed(), total(workers, [](Worker& w) { return w.disconnects; }), connect_s,
+                   sent, total(workers, [](Worker& w) { return w.throttled; }), delivered, expected,
+                   sent / options.duration_s, delivered / options.duration_s,
+                   total(workers, [](Worker& w) { return w.bytes_received; }),
+                   latency.percentile(50) * us, latency.percentile(90) * us, latency.percentile(99) * us,
+                   latency.percentile(99.9) * us, latency.max() * us);
+        if (out != stdout) {
+            std::fclose(out);
+        }
+    }
+    return connected > 0 ? 0 : 1;
+}